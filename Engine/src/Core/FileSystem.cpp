@@ -2,6 +2,7 @@
 
 #include "GFX/WinAPI.h"
 #include <array>
+#include <fstream>
 
 #include <iostream>
 
@@ -37,4 +38,43 @@ namespace engi
 		return getExecutablePath().parent_path().parent_path() / "Engine" / "src" / "Shaders";
 	}
 
+	std::filesystem::path FileSystem::getCachePath()
+	{
+		return getExecutablePath() / "Cache";
+	}
+
+	bool FileSystem::readFile(const std::filesystem::path& filepath, std::vector<uint8_t>& data) noexcept
+	{
+		std::ifstream stream(filepath, std::ios::binary | std::ios::ate);
+		if (!stream)
+			return false;
+
+		data.resize(static_cast<size_t>(stream.tellg()));
+		stream.seekg(0);
+		return stream.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())).good();
+	}
+
+	bool FileSystem::writeFileAtomic(const std::filesystem::path& filepath, const void* data, size_t size) noexcept
+	{
+		std::filesystem::path tempPath = filepath;
+		tempPath += ".tmp";
+
+		std::error_code error;
+		std::filesystem::create_directories(filepath.parent_path(), error);
+		{
+			std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+			if (!stream || !stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size)))
+				return false;
+		}
+
+		std::filesystem::rename(tempPath, filepath, error);
+		if (error)
+		{
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		return true;
+	}
+
 }; // engi namespace
\ No newline at end of file
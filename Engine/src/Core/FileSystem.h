@@ -1,6 +1,8 @@
 #pragma once
 
 #include <filesystem>
+#include <vector>
+#include <cstdint>
 
 namespace engi
 {
@@ -16,6 +18,14 @@ namespace engi
 		std::filesystem::path getExecutablePath();
 		std::filesystem::path getAssetsPath();
 		std::filesystem::path getShaderPath();
+		std::filesystem::path getCachePath(); // folder for files that are generated by the engine and can be safely deleted
+
+		// Reads the whole file, returns false if it cannot be opened or read
+		static bool readFile(const std::filesystem::path& filepath, std::vector<uint8_t>& data) noexcept;
+
+		// Writes into a temporary file next to the destination and renames it, so that a crash never leaves a half-written file behind.
+		// Missing parent folders are created
+		static bool writeFileAtomic(const std::filesystem::path& filepath, const void* data, size_t size) noexcept;
 
 	private:
 		std::string m_executablePath;
@@ -187,6 +187,9 @@ namespace engi
 			}
 			ImGuiIO& io = ImGui::GetIO();
 			ImGui::TextColored(ImVec4(0.6f, 0.9f, 0.9f, 1.0f), "frametime %.3f (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
+
+			const gfx::GpuStateCacheStats& stats = m_renderer->getStateCacheStats();
+			ImGui::TextColored(ImVec4(0.6f, 0.9f, 0.9f, 1.0f), "binds %llu (%llu filtered)", stats.numBinds, stats.numFiltered);
 			ImGui::EndMainMenuBar();
 		}
 
@@ -250,20 +253,8 @@ namespace engi
 		m_hasQueriedInstanceIntersection = true;
 		ModelInstanceRegistry* ir = m_scene->getSceneRenderer()->getInstanceRegistry();
 
-		InstanceIntersection result;
-		result.meshIntersection.reset();
-
 		uint32_t intersectedModelInstanceID = uint32_t(-1);
-		for (uint32_t modelInstanceID : ir->getAllModelInstanceIDs())
-		{
-			ModelInstance* instance = ir->getModelInstance(modelInstanceID);
-			InstanceIntersection i = instance->intersect(m_frameCursorRay);
-			if (i < result)
-			{
-				result = i;
-				intersectedModelInstanceID = modelInstanceID;
-			}
-		}
+		InstanceIntersection result = ir->intersect(m_frameCursorRay, &intersectedModelInstanceID);
 
 		m_intersectedInstanceID = intersectedModelInstanceID;
 		m_queriedIntersection = result;
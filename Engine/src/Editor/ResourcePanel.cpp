@@ -129,6 +129,11 @@ namespace engi
 	void ResourcePanel::drawAllShaders() noexcept
 	{
 		const auto& shaderPrograms = m_renderer->getShaderLibrary()->getAllShaders();
+		if (ImGui::SmallButton("Hot Reload All"))
+		{
+			m_renderer->getShaderLibrary()->recompileAll();
+		}
+
 		ImGuiTableFlags tableFlags = ImGuiTableFlags_Resizable | ImGuiTableFlags_Reorderable;
 		if (ImGui::BeginTable("##shader_table", 3, tableFlags))
 		{
@@ -217,6 +222,13 @@ namespace engi
 		return modelLoader->loadFromFBX(filepath, filename, material);
 	}
 
+	ModelLoadHandle ResourcePanel::LoadFromFBXAsync(const std::string& filename, const SharedHandle<Material>& material) noexcept
+	{
+		ModelLoader* modelLoader = m_renderer->getModelLoader();
+		std::string filepath = (m_modelsPath / filename).string();
+		return modelLoader->loadModelAsync(filepath, filename, material);
+	}
+
 	SharedHandle<Material> ResourcePanel::GetMaterial(MaterialType type) noexcept
 	{
 		return m_renderer->getMaterialRegistry()->getMaterial(type);
@@ -29,6 +29,7 @@ namespace engi
 		ShaderProgram* getSelectedShader() noexcept { return m_selectedProgram; }
 
 		ParsedModelInfo* LoadFromFBX(const std::string& filename, const SharedHandle<Material>& material = nullptr) noexcept;
+		ModelLoadHandle LoadFromFBXAsync(const std::string& filename, const SharedHandle<Material>& material = nullptr) noexcept;
 		SharedHandle<Material> GetMaterial(MaterialType type) noexcept;
 		Texture2D* GetTexture2D(const std::string& filename) noexcept;
 		Texture2D* GetTextureAtlas(const std::string& filename, uint32_t numWidth, uint32_t numHeight) noexcept;
@@ -350,6 +350,22 @@ namespace engi
 		return m_activeScene->getModelInstanceByID(modelInstanceID);
 	}
 
+	std::vector<uint32_t> SceneInspector::AddInstances(const std::string& name, SharedHandle<Model> model, ArrayView<const MaterialInstance> materials, ArrayView<const math::Transformation> transforms, const InstanceData& instanceData) noexcept
+	{
+		if (!m_activeScene)
+			return {};
+
+		return m_activeScene->addInstances(name, model, materials, transforms, instanceData);
+	}
+
+	uint32_t SceneInspector::AddInstanceGroup(SharedHandle<Model> model, ArrayView<const MaterialInstance> materials, ArrayView<const math::Transformation> transforms, const math::Vec3& color) noexcept
+	{
+		if (!m_activeScene)
+			return MeshManager::INVALID_GROUP;
+
+		return m_activeScene->addInstanceGroup(model, materials, transforms, color);
+	}
+
 	ModelInstance* SceneInspector::AddCube(const std::string& name, const MaterialInstance& material, const math::Transformation& transformation, const math::Vec3& color) noexcept
 	{
 		if (!m_activeScene)
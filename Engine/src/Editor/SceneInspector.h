@@ -40,6 +40,8 @@ namespace engi
 		void SetSceneLight(const math::Vec3& ambient, const math::Vec3& direction, float radius = 1.0f) noexcept;
 		
 		ModelInstance* AddInstance(const std::string& name, SharedHandle<Model> model, ArrayView<const MaterialInstance> materials, const InstanceData& instanceData) noexcept;
+		std::vector<uint32_t> AddInstances(const std::string& name, SharedHandle<Model> model, ArrayView<const MaterialInstance> materials, ArrayView<const math::Transformation> transforms, const InstanceData& instanceData = InstanceData()) noexcept;
+		uint32_t AddInstanceGroup(SharedHandle<Model> model, ArrayView<const MaterialInstance> materials, ArrayView<const math::Transformation> transforms, const math::Vec3& color = math::Vec3()) noexcept;
 		ModelInstance* AddCube(const std::string& name, const MaterialInstance& material, const math::Transformation& transformation, const math::Vec3& color = math::Vec3()) noexcept;
 		ModelInstance* AddSphere(const std::string& name, const MaterialInstance& material, const InstanceData& data) noexcept;
 		ModelInstance* AddPointLight(const std::string& name, const math::Vec3& translation, const math::Vec3& emissive, float intensity, float radius) noexcept;
@@ -10,6 +10,7 @@
 #include "Core/Input.h"
 #include "Core/Logger.h"
 #include "Utility/Timer.h"
+#include "Utility/JobSystem.h"
 
 namespace engi
 {
@@ -27,10 +28,12 @@ int32_t WINAPI WinMain(_In_ HINSTANCE instance, _In_opt_ HINSTANCE hPrevInstance
 	engi::Logger::init(level);
 	engi::Timer::initialize();
 	engi::EngiIO::init();
+	engi::JobSystem::init();
 
 	engi::Main(cmdline, cmdshow);
 	int32_t res = engi::Application::get().run(); // currently unused
 
+	engi::JobSystem::deinit();
 	engi::EngiIO::deinit();
 	engi::Timer::deinitialize();
 	engi::Application::destroy();
@@ -112,6 +112,9 @@ namespace engi::gfx
     {
         m_currentRenderPassDesc = desc;
 
+        // Binding render targets implicitly unbinds their shader resources, thus cached state is no longer valid
+        m_stateCache.invalidate();
+
         static constexpr size_t renderTargetCount = D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT;
         ID3D11DeviceContext4* devcon = getContext();
         ID3D11RenderTargetView* d3dRtvs[renderTargetCount]{};
@@ -174,6 +177,8 @@ namespace engi::gfx
     void D3D11Device::endRenderPass()
     {
         m_currentRenderPassDesc = {};
+        m_stateCache.invalidate();
+
         ID3D11DeviceContext4* devcon = getContext();
         devcon->OMSetRenderTargets(0, nullptr, nullptr);
     }
@@ -221,48 +226,63 @@ namespace engi::gfx
 
     void D3D11Device::setPipelineState(IGpuPipelineState* state)
     {
-        ID3D11DeviceContext* devcon = getContext();
-        if (!state)
+        ID3D11BlendState* blendState = nullptr;
+        ID3D11DepthStencilState* depthStencilState = nullptr;
+        UINT stencilRef = 0;
+        ID3D11RasterizerState* rasterizerState = nullptr;
+        D3D11_PRIMITIVE_TOPOLOGY topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+        ID3D11VertexShader* vs = nullptr;
+        ID3D11HullShader* hs = nullptr;
+        ID3D11DomainShader* ds = nullptr;
+        ID3D11GeometryShader* gs = nullptr;
+        ID3D11PixelShader* ps = nullptr;
+        ID3D11ComputeShader* cs = nullptr;
+        if (state)
         {
-            devcon->OMSetBlendState(nullptr, nullptr, 0xffffffff);
-            devcon->OMSetDepthStencilState(nullptr, 0);
-            devcon->RSSetState(nullptr);
-            devcon->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-            devcon->VSSetShader(nullptr, nullptr, 0);
-            devcon->HSSetShader(nullptr, nullptr, 0);
-            devcon->DSSetShader(nullptr, nullptr, 0);
-            devcon->GSSetShader(nullptr, nullptr, 0);
-            devcon->PSSetShader(nullptr, nullptr, 0);
-            devcon->CSSetShader(nullptr, nullptr, 0);
-            return;
+            ENGI_ASSERT(state->getDesc().vs || state->getDesc().cs && "Vertex shader (or Compite shader for that matter) cannot be nullptr in active pipeline state");
+            D3D11PipelineState* d3dState = (D3D11PipelineState*)state;
+            blendState = d3dState->getBlendState();
+            depthStencilState = d3dState->getDepthStencilState();
+            stencilRef = state->getDesc().depthStencil.stencilRef;
+            rasterizerState = d3dState->getRasterizerState();
+            topology = d3dState->getPrimitiveTopology();
+            vs = d3dState->getVertexShader();
+            hs = d3dState->getHullShader();
+            ds = d3dState->getDomainShader();
+            gs = d3dState->getGeometryShader();
+            ps = d3dState->getPixelShader();
+            cs = d3dState->getComputeShader();
         }
-        
-        ENGI_ASSERT(state->getDesc().vs || state->getDesc().cs && "Vertex shader (or Compite shader for that matter) cannot be nullptr in active pipeline state");
-        D3D11PipelineState* d3dState = (D3D11PipelineState*)state;
 
-        devcon->OMSetBlendState(d3dState->getBlendState(), nullptr, 0xffffffff);
-        devcon->OMSetDepthStencilState(d3dState->getDepthStencilState(), state->getDesc().depthStencil.stencilRef);
-        devcon->RSSetState(d3dState->getRasterizerState());
-        devcon->IASetPrimitiveTopology(d3dState->getPrimitiveTopology());
-        devcon->VSSetShader(d3dState->getVertexShader(), nullptr, 0);
-        devcon->HSSetShader(d3dState->getHullShader(), nullptr, 0);
-        devcon->DSSetShader(d3dState->getDomainShader(), nullptr, 0);
-        devcon->GSSetShader(d3dState->getGeometryShader(), nullptr, 0);
-        devcon->PSSetShader(d3dState->getPixelShader(), nullptr, 0);
-        devcon->CSSetShader(d3dState->getComputeShader(), nullptr, 0);
+        // Pipeline states usually share most of their components, thus every component is filtered on its own
+        ID3D11DeviceContext* devcon = getContext();
+        if (m_stateCache.filterState(GPU_STATE_BLEND, blendState))
+            devcon->OMSetBlendState(blendState, nullptr, 0xffffffff);
+        if (m_stateCache.filterState(GPU_STATE_DEPTH_STENCIL, depthStencilState, stencilRef))
+            devcon->OMSetDepthStencilState(depthStencilState, stencilRef);
+        if (m_stateCache.filterState(GPU_STATE_RASTERIZER, rasterizerState))
+            devcon->RSSetState(rasterizerState);
+        if (m_stateCache.filterState(GPU_STATE_TOPOLOGY, nullptr, topology))
+            devcon->IASetPrimitiveTopology(topology);
+        if (m_stateCache.filterState(GPU_STATE_VERTEX_SHADER, vs))
+            devcon->VSSetShader(vs, nullptr, 0);
+        if (m_stateCache.filterState(GPU_STATE_HULL_SHADER, hs))
+            devcon->HSSetShader(hs, nullptr, 0);
+        if (m_stateCache.filterState(GPU_STATE_DOMAIN_SHADER, ds))
+            devcon->DSSetShader(ds, nullptr, 0);
+        if (m_stateCache.filterState(GPU_STATE_GEOMETRY_SHADER, gs))
+            devcon->GSSetShader(gs, nullptr, 0);
+        if (m_stateCache.filterState(GPU_STATE_PIXEL_SHADER, ps))
+            devcon->PSSetShader(ps, nullptr, 0);
+        if (m_stateCache.filterState(GPU_STATE_COMPUTE_SHADER, cs))
+            devcon->CSSetShader(cs, nullptr, 0);
     }
 
     void D3D11Device::setInputLayout(IGpuInputLayout* inputLayout)
     {
-        ID3D11DeviceContext4* devcon = getContext();
-        if (!inputLayout)
-        {
-            devcon->IASetInputLayout(nullptr);
-            return;
-        }
-
-        ID3D11InputLayout* layout = (ID3D11InputLayout*)inputLayout->getHandle();
-        devcon->IASetInputLayout(layout);
+        ID3D11InputLayout* layout = (inputLayout) ? (ID3D11InputLayout*)inputLayout->getHandle() : nullptr;
+        if (m_stateCache.filterState(GPU_STATE_INPUT_LAYOUT, layout))
+            getContext()->IASetInputLayout(layout);
     }
 
     void D3D11Device::setVertexBuffer(IGpuBuffer* buffer, uint32_t slot, uint32_t stride, uint32_t offset)
@@ -270,7 +290,8 @@ namespace engi::gfx
         ENGI_ASSERT(buffer && "Buffer cannot be nullptr");
         ENGI_ASSERT((buffer->getDesc().pipelineFlags & VERTEX_BUFFER) == VERTEX_BUFFER && "Buffer must be bound to vertex buffer pipeline");
         ID3D11Buffer* d3dBuffer = (ID3D11Buffer*)buffer->getHandle();
-        getContext()->IASetVertexBuffers(slot, 1, &d3dBuffer, &stride, &offset);
+        if (m_stateCache.filterVertexBuffer(d3dBuffer, slot, stride, offset))
+            getContext()->IASetVertexBuffers(slot, 1, &d3dBuffer, &stride, &offset);
     }
 
     void D3D11Device::setIndexBuffer(IGpuBuffer* buffer, uint32_t offset)
@@ -278,13 +299,18 @@ namespace engi::gfx
         ENGI_ASSERT(buffer && "Buffer cannot be nullptr");
         ENGI_ASSERT((buffer->getDesc().pipelineFlags & INDEX_BUFFER) == INDEX_BUFFER && "Buffer must be bound to index buffer pipeline");
         ID3D11Buffer* d3dBuffer = (ID3D11Buffer*)buffer->getHandle();
-        getContext()->IASetIndexBuffer(d3dBuffer, DXGI_FORMAT_R32_UINT, offset);
+        if (m_stateCache.filterState(GPU_STATE_INDEX_BUFFER, d3dBuffer, offset))
+            getContext()->IASetIndexBuffer(d3dBuffer, DXGI_FORMAT_R32_UINT, offset);
     }
 
     void D3D11Device::setConstantBuffer(IGpuBuffer* buffer, uint32_t slot, uint32_t shaderTypes)
     {
         ENGI_ASSERT(buffer && "Buffer cannot be nullptr");
         ID3D11Buffer* d3dBuffer = (ID3D11Buffer*)buffer->getHandle();
+        shaderTypes = m_stateCache.filterConstantBuffer(d3dBuffer, slot, shaderTypes);
+        if (shaderTypes == 0)
+            return;
+
         ID3D11DeviceContext4* devcon = getContext();
         if ((shaderTypes & VERTEX_SHADER) != 0)
             devcon->VSSetConstantBuffers(slot, 1, &d3dBuffer);
@@ -300,10 +326,42 @@ namespace engi::gfx
             devcon->CSSetConstantBuffers(slot, 1, &d3dBuffer);
     }
 
+    void D3D11Device::setConstantBufferRange(IGpuBuffer* buffer, uint32_t slot, uint32_t shaderTypes, uint32_t byteOffset, uint32_t byteSize)
+    {
+        ENGI_ASSERT(buffer && "Buffer cannot be nullptr");
+        ENGI_ASSERT(byteOffset % CONSTANT_BUFFER_RANGE_ALIGNMENT == 0 && byteSize % CONSTANT_BUFFER_RANGE_ALIGNMENT == 0 && "Invalid constant buffer range");
+        ENGI_ASSERT(byteSize > 0 && byteOffset + byteSize <= buffer->getDesc().bytes && "Constant buffer range is out of bounds");
+        ID3D11Buffer* d3dBuffer = (ID3D11Buffer*)buffer->getHandle();
+        shaderTypes = m_stateCache.filterConstantBuffer(d3dBuffer, slot, shaderTypes, (static_cast<uint64_t>(byteOffset) << 32) | byteSize);
+        if (shaderTypes == 0)
+            return;
+
+        // Offsets and sizes are measured in shader constants (16 bytes each)
+        UINT firstConstant = byteOffset / 16;
+        UINT numConstants = byteSize / 16;
+        ID3D11DeviceContext4* devcon = getContext();
+        if ((shaderTypes & VERTEX_SHADER) != 0)
+            devcon->VSSetConstantBuffers1(slot, 1, &d3dBuffer, &firstConstant, &numConstants);
+        if ((shaderTypes & PIXEL_SHADER) != 0)
+            devcon->PSSetConstantBuffers1(slot, 1, &d3dBuffer, &firstConstant, &numConstants);
+        if ((shaderTypes & GEOMETRY_SHADER) != 0)
+            devcon->GSSetConstantBuffers1(slot, 1, &d3dBuffer, &firstConstant, &numConstants);
+        if ((shaderTypes & HULL_SHADER) != 0)
+            devcon->HSSetConstantBuffers1(slot, 1, &d3dBuffer, &firstConstant, &numConstants);
+        if ((shaderTypes & DOMAIN_SHADER) != 0)
+            devcon->DSSetConstantBuffers1(slot, 1, &d3dBuffer, &firstConstant, &numConstants);
+        if ((shaderTypes & COMPUTE_SHADER) != 0)
+            devcon->CSSetConstantBuffers1(slot, 1, &d3dBuffer, &firstConstant, &numConstants);
+    }
+
     void D3D11Device::setSRV(const IGpuDescriptor* descriptor, uint32_t slot, uint32_t shaderTypes)
     {
         D3D11ShaderResourceView* srv = (D3D11ShaderResourceView*)descriptor;
         ID3D11ShaderResourceView* d3dSrv = (srv) ? (ID3D11ShaderResourceView*)srv->getHandle() : nullptr;
+        shaderTypes = m_stateCache.filterSRV(d3dSrv, slot, shaderTypes);
+        if (shaderTypes == 0)
+            return;
+
         ID3D11DeviceContext4* devcon = getContext();
         if ((shaderTypes & VERTEX_SHADER) != 0)
             devcon->VSSetShaderResources(slot, 1, &d3dSrv);
@@ -325,6 +383,12 @@ namespace engi::gfx
         if (descriptor)
             d3dUav = (ID3D11UnorderedAccessView*)((D3D11UnorderedAccessView*)descriptor)->getHandle();
 
+        if (!m_stateCache.filterComputeUAV(d3dUav, slot))
+            return;
+
+        // Binding a resource as UAV implicitly unbinds its shader resources (and the ones bound while it is an output are forced to null)
+        m_stateCache.invalidateSRVs();
+
         UINT initialCounts = -1;
         getContext()->CSSetUnorderedAccessViews(slot, 1, &d3dUav, &initialCounts);
     }
@@ -333,6 +397,10 @@ namespace engi::gfx
     {
         D3D11Sampler* s = (D3D11Sampler*)sampler;
         ID3D11SamplerState* handle = (s) ? (ID3D11SamplerState*)s->getHandle() : nullptr;
+        shaderTypes = m_stateCache.filterSampler(handle, slot, shaderTypes);
+        if (shaderTypes == 0)
+            return;
+
         ID3D11DeviceContext4* devcon = getContext();
         if ((shaderTypes & VERTEX_SHADER) != 0)
             devcon->VSSetSamplers(slot, 1, &handle);
@@ -409,6 +477,17 @@ namespace engi::gfx
         devcon->CopySubresourceRegion(dstD3dBuffer, 0, dstOffset, 0, 0, srcD3dBuffer, 0, nullptr);
     }
 
+    void D3D11Device::copyBufferRegion(IGpuBuffer* src, uint32_t srcOffset, IGpuBuffer* dst, uint32_t dstOffset, uint32_t byteSize)
+    {
+        ENGI_ASSERT(src && dst);
+        ENGI_ASSERT(srcOffset + byteSize <= src->getDesc().bytes && dstOffset + byteSize <= dst->getDesc().bytes && "Copy is out of the buffer bounds");
+        ID3D11Buffer* srcD3dBuffer = (ID3D11Buffer*)src->getHandle();
+        ID3D11Buffer* dstD3dBuffer = (ID3D11Buffer*)dst->getHandle();
+        D3D11_BOX srcBox = { srcOffset, 0, 0, srcOffset + byteSize, 1, 1 };
+        ID3D11DeviceContext* devcon = getContext();
+        devcon->CopySubresourceRegion(dstD3dBuffer, 0, dstOffset, 0, 0, srcD3dBuffer, 0, &srcBox);
+    }
+
     void D3D11Device::updateBuffer(IGpuBuffer* buffer, uint32_t bufferOffset, const void* data, uint32_t byteSize)
     {
         ENGI_ASSERT(buffer && "Buffer cannot be nullptr");
@@ -43,6 +43,7 @@ namespace engi::gfx
 		virtual void setVertexBuffer(IGpuBuffer* buffer, uint32_t slot, uint32_t stride, uint32_t offset) override;
 		virtual void setIndexBuffer(IGpuBuffer* buffer, uint32_t offset) override;
 		virtual void setConstantBuffer(IGpuBuffer* buffer, uint32_t slot, uint32_t shaderTypes) override;
+		virtual void setConstantBufferRange(IGpuBuffer* buffer, uint32_t slot, uint32_t shaderTypes, uint32_t byteOffset, uint32_t byteSize) override;
 		virtual void setSRV(const IGpuDescriptor* descriptor, uint32_t slot, uint32_t shaderTypes) override;
 		virtual void setComputeUAV(const IGpuDescriptor* descriptor, uint32_t slot) override;
 		virtual void setSampler(const IGpuSampler* sampler, uint32_t slot, uint32_t shaderTypes) override;
@@ -51,6 +52,7 @@ namespace engi::gfx
 			IGpuTexture* src, uint32_t srcMipslice, uint32_t srcArrayslice, uint32_t srcX, uint32_t srcY, uint32_t srcZ,
 			uint32_t width, uint32_t height, uint32_t depth) override;
 		virtual void copyBuffer(IGpuBuffer* src, IGpuBuffer* dst, uint32_t dstOffset) override;
+        virtual void copyBufferRegion(IGpuBuffer* src, uint32_t srcOffset, IGpuBuffer* dst, uint32_t dstOffset, uint32_t byteSize) override;
 		virtual void updateBuffer(IGpuBuffer* buffer, uint32_t bufferOffset, const void* data, uint32_t byteSize) override;
 		virtual void mapBuffer(IGpuBuffer* buffer, void** mapping) override;
 		virtual void unmapBuffer(IGpuBuffer* buffer) override;
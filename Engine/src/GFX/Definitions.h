@@ -6,6 +6,15 @@
 namespace engi::gfx
 {
 
+	// Constant buffer ranges are specified in 16 constants of 16 bytes
+	inline constexpr uint32_t CONSTANT_BUFFER_RANGE_ALIGNMENT = 256;
+
+	enum GpuBackend
+	{
+		GPU_BACKEND_D3D11,
+		GPU_BACKEND_NULL, // no rendering, used for headless benchmarking and testing of the CPU side
+	};
+
 	enum GpuUsage
 	{
 		USAGE_UNKNOWN,
@@ -2,12 +2,16 @@
 
 #include "GFX/DX11/D3D11_Device.h"
 #include "GFX/DX11/DX11_ImGui.h"
+#include "GFX/Null/Null_Device.h"
 
 namespace engi::gfx
 {
 
-	UniqueHandle<IGpuDevice> createDevice()
+	UniqueHandle<IGpuDevice> createDevice(GpuBackend backend)
 	{
+		if (backend == GPU_BACKEND_NULL)
+			return makeUnique<IGpuDevice>(new NullDevice());
+
 		IGpuDevice* device = new D3D11Device();
 		if (!((D3D11Device*)device)->initialize())
 		{
@@ -19,6 +23,9 @@ namespace engi::gfx
 
 	UniqueHandle<IImGuiContext> createImGuiContext(void* handle, IGpuDevice* device)
 	{
+		if (dynamic_cast<NullDevice*>(device))
+			return nullptr;
+
 		IImGuiContext* context = new DX11ImGuiContext();
 		if (!context->initialize(handle, device))
 		{
@@ -6,7 +6,8 @@
 
 namespace engi::gfx
 {
-	UniqueHandle<IGpuDevice> createDevice();
+	UniqueHandle<IGpuDevice> createDevice(GpuBackend backend = GPU_BACKEND_D3D11);
 
+	// Returns nullptr for the null backend, as there is nothing to draw UI into
 	UniqueHandle<IImGuiContext> createImGuiContext(void* handle, IGpuDevice* device);
 }; 
\ No newline at end of file
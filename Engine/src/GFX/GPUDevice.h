@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GFX/Definitions.h"
+#include "GFX/GPUStateCache.h"
 
 namespace engi::gfx
 {
@@ -53,6 +54,8 @@ namespace engi::gfx
 		virtual void setVertexBuffer(IGpuBuffer* buffer, uint32_t slot, uint32_t stride, uint32_t offset) = 0;
 		virtual void setIndexBuffer(IGpuBuffer* buffer, uint32_t offset) = 0;
 		virtual void setConstantBuffer(IGpuBuffer* buffer, uint32_t slot, uint32_t shaderTypes) = 0;
+		// Binds byteSize bytes of the buffer starting at byteOffset, both must be multiples of CONSTANT_BUFFER_RANGE_ALIGNMENT
+		virtual void setConstantBufferRange(IGpuBuffer* buffer, uint32_t slot, uint32_t shaderTypes, uint32_t byteOffset, uint32_t byteSize) = 0;
 		virtual void setSRV(const IGpuDescriptor* descriptor, uint32_t slot, uint32_t shaderTypes) = 0;
 		virtual void setComputeUAV(const IGpuDescriptor* descriptor, uint32_t slot) = 0;
 		virtual void setSampler(const IGpuSampler* sampler, uint32_t slot, uint32_t shaderTypes) = 0;
@@ -61,12 +64,20 @@ namespace engi::gfx
 			IGpuTexture* src, uint32_t srcMipslice, uint32_t srcArrayslice, uint32_t srcX, uint32_t srcY, uint32_t srcZ, 
 			uint32_t width, uint32_t height, uint32_t depth) = 0;
 		virtual void copyBuffer(IGpuBuffer* src, IGpuBuffer* dst, uint32_t dstOffset) = 0;
+		// Regions must not overlap if src and dst are the same buffer
+		virtual void copyBufferRegion(IGpuBuffer* src, uint32_t srcOffset, IGpuBuffer* dst, uint32_t dstOffset, uint32_t byteSize) = 0;
 		virtual void updateBuffer(IGpuBuffer* buffer, uint32_t bufferOffset, const void* data, uint32_t byteSize) = 0;
 		virtual void mapBuffer(IGpuBuffer* buffer, void** mapping) = 0;
 		virtual void unmapBuffer(IGpuBuffer* buffer) = 0;
 
 		// TODO: Make non-virtual
 		virtual GpuResourceAllocator* getResourceAllocator() = 0;
+
+		// Backends filter redundant binds through the cache. Anyone binding states directly through the native API should invalidate it
+		inline GpuStateCache& getStateCache() noexcept { return m_stateCache; }
+
+	protected:
+		GpuStateCache m_stateCache;
 	}; // IGpuDevice class
 
 }; // engi::gfx namespace
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "GFX/GPUStateCache.h"
+
+#include <bit>
+#include <cstring>
+#include "Core/CommonDefinitions.h"
+
+namespace engi::gfx
+{
+
+	bool GpuStateCache::filterState(GpuStateSlot slot, const void* handle, uint64_t value) noexcept
+	{
+		ENGI_ASSERT(slot < GPU_STATE_NUM_SLOTS);
+		return filterBinding(m_states[slot], handle, value);
+	}
+
+	bool GpuStateCache::filterVertexBuffer(const void* handle, uint32_t slot, uint32_t stride, uint32_t offset) noexcept
+	{
+		if (slot >= MAX_VERTEX_BUFFERS)
+		{
+			++m_stats.numBinds;
+			return true;
+		}
+
+		return filterBinding(m_vertexBuffers[slot], handle, (static_cast<uint64_t>(stride) << 32) | offset);
+	}
+
+	bool GpuStateCache::filterComputeUAV(const void* handle, uint32_t slot) noexcept
+	{
+		++m_stats.numBinds;
+		if (slot >= MAX_COMPUTE_UAVS)
+			return true;
+
+		uintptr_t h = reinterpret_cast<uintptr_t>(handle);
+		if (m_computeUavs[slot] == h)
+		{
+			++m_stats.numFiltered;
+			return false;
+		}
+
+		m_computeUavs[slot] = h;
+		return true;
+	}
+
+	uint32_t GpuStateCache::filterConstantBuffer(const void* handle, uint32_t slot, uint32_t shaderTypes, uint64_t range) noexcept
+	{
+		if (slot >= MAX_CONSTANT_BUFFERS)
+		{
+			m_stats.numBinds += std::popcount(shaderTypes);
+			return shaderTypes;
+		}
+
+		return filterStages(m_constantBuffers[slot], handle, range, shaderTypes);
+	}
+
+	uint32_t GpuStateCache::filterSRV(const void* handle, uint32_t slot, uint32_t shaderTypes) noexcept
+	{
+		if (slot >= MAX_SRVS)
+		{
+			m_stats.numBinds += std::popcount(shaderTypes);
+			return shaderTypes;
+		}
+
+		return filterStages(m_srvs[slot], handle, shaderTypes);
+	}
+
+	uint32_t GpuStateCache::filterSampler(const void* handle, uint32_t slot, uint32_t shaderTypes) noexcept
+	{
+		if (slot >= MAX_SAMPLERS)
+		{
+			m_stats.numBinds += std::popcount(shaderTypes);
+			return shaderTypes;
+		}
+
+		return filterStages(m_samplers[slot], handle, shaderTypes);
+	}
+
+	void GpuStateCache::invalidate() noexcept
+	{
+		m_states.fill(Binding{ UNKNOWN, 0 });
+		m_vertexBuffers.fill(Binding{ UNKNOWN, 0 });
+		std::memset(m_constantBuffers, 0xff, sizeof(m_constantBuffers));
+		std::memset(m_samplers, 0xff, sizeof(m_samplers));
+		std::memset(m_computeUavs, 0xff, sizeof(m_computeUavs));
+		invalidateSRVs();
+	}
+
+	void GpuStateCache::invalidateSRVs() noexcept
+	{
+		std::memset(m_srvs, 0xff, sizeof(m_srvs));
+	}
+
+	bool GpuStateCache::filterBinding(Binding& cached, const void* handle, uint64_t value) noexcept
+	{
+		++m_stats.numBinds;
+
+		uintptr_t h = reinterpret_cast<uintptr_t>(handle);
+		if (cached.handle == h && cached.value == value)
+		{
+			++m_stats.numFiltered;
+			return false;
+		}
+
+		cached.handle = h;
+		cached.value = value;
+		return true;
+	}
+
+	uint32_t GpuStateCache::filterStages(uintptr_t (&cached)[NUM_STAGES], const void* handle, uint32_t shaderTypes) noexcept
+	{
+		uintptr_t h = reinterpret_cast<uintptr_t>(handle);
+		uint32_t result = 0;
+		for (uint32_t stage = 0; stage < NUM_STAGES; ++stage)
+		{
+			uint32_t stageBit = 1u << stage;
+			if ((shaderTypes & stageBit) == 0)
+				continue;
+
+			++m_stats.numBinds;
+			if (cached[stage] == h)
+			{
+				++m_stats.numFiltered;
+				continue;
+			}
+
+			cached[stage] = h;
+			result |= stageBit;
+		}
+
+		return result;
+	}
+
+	uint32_t GpuStateCache::filterStages(Binding (&cached)[NUM_STAGES], const void* handle, uint64_t value, uint32_t shaderTypes) noexcept
+	{
+		uint32_t result = 0;
+		for (uint32_t stage = 0; stage < NUM_STAGES; ++stage)
+		{
+			uint32_t stageBit = 1u << stage;
+			if ((shaderTypes & stageBit) == 0)
+				continue;
+
+			if (filterBinding(cached[stage], handle, value))
+				result |= stageBit;
+		}
+
+		return result;
+	}
+
+}; // engi::gfx namespace
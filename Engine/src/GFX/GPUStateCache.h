@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace engi::gfx
+{
+
+	// Pipeline states that are bound as a single object (with an optional value, that is compared together with the object)
+	enum GpuStateSlot
+	{
+		GPU_STATE_BLEND = 0,
+		GPU_STATE_DEPTH_STENCIL, // value is the stencil reference
+		GPU_STATE_RASTERIZER,
+		GPU_STATE_TOPOLOGY, // object is always nullptr, value is the topology
+		GPU_STATE_INPUT_LAYOUT,
+		GPU_STATE_VERTEX_SHADER,
+		GPU_STATE_PIXEL_SHADER,
+		GPU_STATE_GEOMETRY_SHADER,
+		GPU_STATE_HULL_SHADER,
+		GPU_STATE_DOMAIN_SHADER,
+		GPU_STATE_COMPUTE_SHADER,
+		GPU_STATE_INDEX_BUFFER, // value is the offset
+		GPU_STATE_NUM_SLOTS,
+	};
+
+	struct GpuStateCacheStats
+	{
+		uint64_t numBinds = 0; // every stage of a bind is counted separately
+		uint64_t numFiltered = 0;
+	};
+
+	// Shadow copy of the states that were bound through the IGpuDevice. Backends ask the cache before every bind and skip the ones
+	// that would not change anything. Objects are compared by their native handles, as a wrapper might swap its handle (e.g. on shader hot reload).
+	// Cache knows nothing about the backend, thus anything that binds states behind the device's back must invalidate it
+	class GpuStateCache
+	{
+	public:
+		static constexpr uint32_t NUM_STAGES = 6; // in order of GpuShaderType bits
+		static constexpr uint32_t MAX_VERTEX_BUFFERS = 16;
+		static constexpr uint32_t MAX_CONSTANT_BUFFERS = 16;
+		static constexpr uint32_t MAX_SRVS = 128;
+		static constexpr uint32_t MAX_SAMPLERS = 16;
+		static constexpr uint32_t MAX_COMPUTE_UAVS = 8;
+
+		GpuStateCache() { invalidate(); }
+
+		// Returns true if the state should be bound. Slots out of the cached range are never filtered
+		bool filterState(GpuStateSlot slot, const void* handle, uint64_t value = 0) noexcept;
+		bool filterVertexBuffer(const void* handle, uint32_t slot, uint32_t stride, uint32_t offset) noexcept;
+		bool filterComputeUAV(const void* handle, uint32_t slot) noexcept;
+
+		// Return the subset of shader types that the resource should be bound to. Range of a constant buffer is zero if the whole buffer is bound
+		uint32_t filterConstantBuffer(const void* handle, uint32_t slot, uint32_t shaderTypes, uint64_t range = 0) noexcept;
+		uint32_t filterSRV(const void* handle, uint32_t slot, uint32_t shaderTypes) noexcept;
+		uint32_t filterSampler(const void* handle, uint32_t slot, uint32_t shaderTypes) noexcept;
+
+		// Forgets everything, so that the next bind of every state reaches the backend
+		void invalidate() noexcept;
+
+		// Binding outputs might implicitly unbind shader resources of the same resource (as D3D11 does)
+		void invalidateSRVs() noexcept;
+
+		inline const GpuStateCacheStats& getStats() const noexcept { return m_stats; }
+		inline void resetStats() noexcept { m_stats = GpuStateCacheStats(); }
+
+	private:
+		// Value that no native handle can have, so that anything compares unequal to an invalidated slot (including nullptr)
+		static constexpr uintptr_t UNKNOWN = ~uintptr_t(0);
+
+		struct Binding
+		{
+			uintptr_t handle;
+			uint64_t value;
+		};
+
+		bool filterBinding(Binding& cached, const void* handle, uint64_t value) noexcept;
+		uint32_t filterStages(uintptr_t (&cached)[NUM_STAGES], const void* handle, uint32_t shaderTypes) noexcept;
+		uint32_t filterStages(Binding (&cached)[NUM_STAGES], const void* handle, uint64_t value, uint32_t shaderTypes) noexcept;
+
+		std::array<Binding, GPU_STATE_NUM_SLOTS> m_states;
+		std::array<Binding, MAX_VERTEX_BUFFERS> m_vertexBuffers; // value is the stride and the offset
+		Binding m_constantBuffers[MAX_CONSTANT_BUFFERS][NUM_STAGES]; // value is the bound range
+		uintptr_t m_srvs[MAX_SRVS][NUM_STAGES];
+		uintptr_t m_samplers[MAX_SAMPLERS][NUM_STAGES];
+		uintptr_t m_computeUavs[MAX_COMPUTE_UAVS];
+		GpuStateCacheStats m_stats;
+	};
+
+}; // engi::gfx namespace
@@ -0,0 +1,409 @@
+#include "GFX/Null/Null_Device.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include "Core/CommonDefinitions.h"
+#include "GFX/Null/Null_Resources.h"
+
+namespace engi::gfx
+{
+
+	namespace
+	{
+
+		// Size of a single element of the format, which is a 4x4 block for block-compressed formats
+		uint32_t getFormatElementBytes(GpuFormat format, bool& isBlockCompressed) noexcept
+		{
+			isBlockCompressed = false;
+			switch (format)
+			{
+			case RGBA32F: case RGBA32U: return 16;
+			case RGB32F: case RGB32U: return 12;
+			case RG32F: case RG32U: case RGBA16F: case RGBA16U: case RGBA16SN: return 8;
+			case R32F: case R32U: case R32T: case RG16F: case RG16U: case RGBA8TYPELESS: case RGBA8UN: case RGBA8UNSRGB: case RGBA8U:
+			case DEPTH_STENCIL_FORMAT: case R24G8T: case R24UNX8T: return 4;
+			case R16F: case R16U: case RG8UN: case RG8U: return 2;
+			case BC1_UNORM: case BC1_UNORM_SRGB: case BC4_UNORM: isBlockCompressed = true; return 8;
+			case BC3_TYPELESS: case BC3_UNORM: case BC3_UNORM_SRGB: case BC5_UNORM: case BC6_UF16: case BC7_TYPELESS: case BC7_UNORM: case BC7_UNORM_SRGB:
+				isBlockCompressed = true; return 16;
+			default: return 0;
+			}
+		}
+
+		// Bytes of initial data that D3D11 would read for the texture, i.e. all mips of all array slices packed tightly
+		uint64_t getTextureBytes(const GpuTextureDesc& desc) noexcept
+		{
+			bool isBlockCompressed;
+			uint32_t elementBytes = getFormatElementBytes(desc.format, isBlockCompressed);
+			uint32_t height = (desc.type == TEXTURE1D) ? 1 : desc.height;
+			uint32_t depth = (desc.type == TEXTURE3D) ? desc.depth : 1;
+			uint32_t arraySize = (desc.type == TEXTURE3D) ? 1 : std::max(desc.arraySize, 1u);
+
+			uint64_t bytes = 0;
+			for (uint32_t mip = 0; mip < std::max(desc.miplevels, 1u); ++mip)
+			{
+				uint64_t mipWidth = std::max(desc.width >> mip, 1u);
+				uint64_t mipHeight = std::max(height >> mip, 1u);
+				uint64_t mipDepth = std::max(depth >> mip, 1u);
+				if (isBlockCompressed)
+				{
+					mipWidth = (mipWidth + 3) / 4;
+					mipHeight = (mipHeight + 3) / 4;
+				}
+				bytes += mipWidth * mipHeight * mipDepth * elementBytes;
+			}
+			return bytes * arraySize;
+		}
+
+	}; // anonymous namespace
+
+	IGpuSwapchain* NullDevice::createSwapchain(const std::string& name, const GpuSwapchainDesc& desc)
+	{
+		NullSwapchain* swapchain = m_resourceAllocator.createResource<NullSwapchain>(name, this, desc);
+		if (!swapchain->initialize())
+			destroy((IGpuResource*&)swapchain);
+
+		return swapchain;
+	}
+
+	IGpuBuffer* NullDevice::createBuffer(const std::string& name, const GpuBufferDesc& desc, const void* initialData)
+	{
+		NullBuffer* buffer = m_resourceAllocator.createResource<NullBuffer>(name, this, desc);
+		if (!buffer->initialize(initialData))
+			destroy((IGpuResource*&)buffer);
+
+		if (buffer && initialData)
+			m_stats.bytesUploaded += desc.bytes;
+
+		return buffer;
+	}
+
+	IGpuShader* NullDevice::createShader(const std::string& name, const GpuShaderDesc& desc, void* bytecode)
+	{
+		NullShader* shader = m_resourceAllocator.createResource<NullShader>(name, this, desc);
+		if (!shader->initialize(bytecode))
+			destroy((IGpuResource*&)shader);
+
+		return shader;
+	}
+
+	IGpuTexture* NullDevice::createTexture(const std::string& name, const GpuTextureDesc& desc, const void* initialData)
+	{
+		NullTexture* texture = m_resourceAllocator.createResource<NullTexture>(name, this, desc);
+		if (texture && initialData)
+			m_stats.bytesUploaded += getTextureBytes(desc);
+
+		return texture;
+	}
+
+	IGpuPipelineState* NullDevice::createPipelineState(const std::string& name, const GpuPipelineStateDesc& desc)
+	{
+		return m_resourceAllocator.createResource<NullPipelineState>(name, this, desc);
+	}
+
+	IGpuSampler* NullDevice::createSampler(const std::string& name, const GpuSamplerDesc& desc)
+	{
+		return m_resourceAllocator.createResource<NullSampler>(name, this, desc);
+	}
+
+	IGpuInputLayout* NullDevice::createInputLayout(const std::string& name, const GpuInputAttributeDesc* attributes, uint32_t numAttributes, const GpuShaderBuffer& shaderBuffer)
+	{
+		return m_resourceAllocator.createResource<NullInputLayout>(name, this, attributes, numAttributes);
+	}
+
+	IGpuDescriptor* NullDevice::createSRV(const std::string& name, const GpuSrvDesc& desc, IGpuResource* resource)
+	{
+		ENGI_ASSERT(resource && "Resource cannot be nullptr");
+		return m_resourceAllocator.createResource<NullDescriptor>(name, this, resource);
+	}
+
+	IGpuDescriptor* NullDevice::createUAV(const std::string& name, const GpuUavDesc& desc, IGpuResource* resource)
+	{
+		ENGI_ASSERT(resource && "Resource cannot be nullptr");
+		return m_resourceAllocator.createResource<NullDescriptor>(name, this, resource);
+	}
+
+	void NullDevice::destroy(IGpuResource*& resource)
+	{
+		// Handles of null resources are their addresses, which might be reused right away, unlike bound D3D11 objects that are kept alive
+		m_stateCache.invalidate();
+		m_resourceAllocator.destroyResource(resource);
+	}
+
+	void NullDevice::beginRenderPass(const GpuRenderPassDesc& desc)
+	{
+		m_stateCache.invalidate();
+
+		uint32_t numRtvs = 0;
+		for (const GpuRenderTargetDesc& rtvDesc : desc.rtvs)
+		{
+			if (rtvDesc.rtv)
+				++numRtvs;
+		}
+
+		record(NULL_COMMAND_BEGIN_RENDER_PASS, desc.depthStencilBuffer, numRtvs);
+	}
+
+	void NullDevice::endRenderPass()
+	{
+		m_stateCache.invalidate();
+		record(NULL_COMMAND_END_RENDER_PASS, nullptr);
+	}
+
+	void NullDevice::draw(uint32_t numVertices, uint32_t vertexOffset)
+	{
+		++m_stats.numDraws;
+		record(NULL_COMMAND_DRAW, nullptr, numVertices, vertexOffset);
+	}
+
+	void NullDevice::drawIndexed(uint32_t numIndices, uint32_t indexOffset, uint32_t vertexOffset)
+	{
+		++m_stats.numDraws;
+		record(NULL_COMMAND_DRAW_INDEXED, nullptr, numIndices, indexOffset, vertexOffset);
+	}
+
+	void NullDevice::drawInstanced(uint32_t numVerticesPerInstance, uint32_t numInstances, uint32_t vertexOffset, uint32_t instanceOffset)
+	{
+		++m_stats.numDraws;
+		record(NULL_COMMAND_DRAW_INSTANCED, nullptr, numVerticesPerInstance, numInstances, vertexOffset, instanceOffset);
+	}
+
+	void NullDevice::drawIndexedInstanced(uint32_t numIndices, uint32_t numInstances, uint32_t indexOffset, uint32_t vertexOffset, uint32_t instanceOffset)
+	{
+		++m_stats.numDraws;
+		record(NULL_COMMAND_DRAW_INDEXED_INSTANCED, nullptr, numIndices, numInstances, indexOffset, vertexOffset, instanceOffset);
+	}
+
+	void NullDevice::drawIndexedInstancedIndirect(IGpuBuffer* buffer, uint32_t byteOffset)
+	{
+		ENGI_ASSERT(buffer);
+
+		++m_stats.numDraws;
+		record(NULL_COMMAND_DRAW_INDEXED_INSTANCED_INDIRECT, buffer, byteOffset);
+	}
+
+	void NullDevice::dispatch(uint32_t threadGroupsX, uint32_t threadGroupsY, uint32_t threadGroupsZ)
+	{
+		++m_stats.numDispatches;
+		record(NULL_COMMAND_DISPATCH, nullptr, threadGroupsX, threadGroupsY, threadGroupsZ);
+	}
+
+	void NullDevice::dispatchIndirect(IGpuBuffer* buffer, uint32_t byteOffset)
+	{
+		ENGI_ASSERT(buffer);
+
+		++m_stats.numDispatches;
+		record(NULL_COMMAND_DISPATCH_INDIRECT, buffer, byteOffset);
+	}
+
+	void NullDevice::setPipelineState(IGpuPipelineState* state)
+	{
+		const GpuPipelineStateDesc* desc = (state) ? &state->getDesc() : nullptr;
+		auto shaderHandle = [](IGpuShader* shader) -> const void* { return shader ? shader->getHandle() : nullptr; };
+
+		// Null pipeline states have no separate blend, depth and rasterizer objects, thus the pipeline stands for all of them
+		uint32_t numChanged = 0;
+		numChanged += m_stateCache.filterState(GPU_STATE_BLEND, state);
+		numChanged += m_stateCache.filterState(GPU_STATE_DEPTH_STENCIL, state, desc ? desc->depthStencil.stencilRef : 0);
+		numChanged += m_stateCache.filterState(GPU_STATE_RASTERIZER, state);
+		numChanged += m_stateCache.filterState(GPU_STATE_TOPOLOGY, nullptr, desc ? desc->primitiveTopology : TRIANGLELIST);
+		numChanged += m_stateCache.filterState(GPU_STATE_VERTEX_SHADER, desc ? shaderHandle(desc->vs) : nullptr);
+		numChanged += m_stateCache.filterState(GPU_STATE_HULL_SHADER, desc ? shaderHandle(desc->hs) : nullptr);
+		numChanged += m_stateCache.filterState(GPU_STATE_DOMAIN_SHADER, desc ? shaderHandle(desc->ds) : nullptr);
+		numChanged += m_stateCache.filterState(GPU_STATE_GEOMETRY_SHADER, desc ? shaderHandle(desc->gs) : nullptr);
+		numChanged += m_stateCache.filterState(GPU_STATE_PIXEL_SHADER, desc ? shaderHandle(desc->ps) : nullptr);
+		numChanged += m_stateCache.filterState(GPU_STATE_COMPUTE_SHADER, desc ? shaderHandle(desc->cs) : nullptr);
+		if (numChanged == 0)
+			return;
+
+		m_stats.numBinds += numChanged;
+		record(NULL_COMMAND_SET_PIPELINE_STATE, state, numChanged);
+	}
+
+	void NullDevice::setInputLayout(IGpuInputLayout* inputLayout)
+	{
+		if (!m_stateCache.filterState(GPU_STATE_INPUT_LAYOUT, inputLayout))
+			return;
+
+		++m_stats.numBinds;
+		record(NULL_COMMAND_SET_INPUT_LAYOUT, inputLayout);
+	}
+
+	void NullDevice::setVertexBuffer(IGpuBuffer* buffer, uint32_t slot, uint32_t stride, uint32_t offset)
+	{
+		ENGI_ASSERT(buffer && "Buffer cannot be nullptr");
+		ENGI_ASSERT((buffer->getDesc().pipelineFlags & VERTEX_BUFFER) == VERTEX_BUFFER && "Buffer must be bound to vertex buffer pipeline");
+		if (!m_stateCache.filterVertexBuffer(buffer, slot, stride, offset))
+			return;
+
+		++m_stats.numBinds;
+		record(NULL_COMMAND_SET_VERTEX_BUFFER, buffer, slot, stride, offset);
+	}
+
+	void NullDevice::setIndexBuffer(IGpuBuffer* buffer, uint32_t offset)
+	{
+		ENGI_ASSERT(buffer && "Buffer cannot be nullptr");
+		ENGI_ASSERT((buffer->getDesc().pipelineFlags & INDEX_BUFFER) == INDEX_BUFFER && "Buffer must be bound to index buffer pipeline");
+		if (!m_stateCache.filterState(GPU_STATE_INDEX_BUFFER, buffer, offset))
+			return;
+
+		++m_stats.numBinds;
+		record(NULL_COMMAND_SET_INDEX_BUFFER, buffer, offset);
+	}
+
+	void NullDevice::setConstantBuffer(IGpuBuffer* buffer, uint32_t slot, uint32_t shaderTypes)
+	{
+		ENGI_ASSERT(buffer && "Buffer cannot be nullptr");
+		shaderTypes = m_stateCache.filterConstantBuffer(buffer, slot, shaderTypes);
+		if (shaderTypes == 0)
+			return;
+
+		m_stats.numBinds += std::popcount(shaderTypes);
+		record(NULL_COMMAND_SET_CONSTANT_BUFFER, buffer, slot, shaderTypes);
+	}
+
+	void NullDevice::setConstantBufferRange(IGpuBuffer* buffer, uint32_t slot, uint32_t shaderTypes, uint32_t byteOffset, uint32_t byteSize)
+	{
+		ENGI_ASSERT(buffer && "Buffer cannot be nullptr");
+		ENGI_ASSERT(byteOffset % CONSTANT_BUFFER_RANGE_ALIGNMENT == 0 && byteSize % CONSTANT_BUFFER_RANGE_ALIGNMENT == 0 && "Invalid constant buffer range");
+		ENGI_ASSERT(byteSize > 0 && byteOffset + byteSize <= buffer->getDesc().bytes && "Constant buffer range is out of bounds");
+		shaderTypes = m_stateCache.filterConstantBuffer(buffer, slot, shaderTypes, (static_cast<uint64_t>(byteOffset) << 32) | byteSize);
+		if (shaderTypes == 0)
+			return;
+
+		m_stats.numBinds += std::popcount(shaderTypes);
+		record(NULL_COMMAND_SET_CONSTANT_BUFFER, buffer, slot, shaderTypes, byteOffset, byteSize);
+	}
+
+	void NullDevice::setSRV(const IGpuDescriptor* descriptor, uint32_t slot, uint32_t shaderTypes)
+	{
+		shaderTypes = m_stateCache.filterSRV(descriptor, slot, shaderTypes);
+		if (shaderTypes == 0)
+			return;
+
+		m_stats.numBinds += std::popcount(shaderTypes);
+		record(NULL_COMMAND_SET_SRV, descriptor, slot, shaderTypes);
+	}
+
+	void NullDevice::setComputeUAV(const IGpuDescriptor* descriptor, uint32_t slot)
+	{
+		if (!m_stateCache.filterComputeUAV(descriptor, slot))
+			return;
+
+		// Mirror D3D11, where binding a UAV unbinds shader resources of the same resource
+		m_stateCache.invalidateSRVs();
+
+		++m_stats.numBinds;
+		record(NULL_COMMAND_SET_COMPUTE_UAV, descriptor, slot);
+	}
+
+	void NullDevice::setSampler(const IGpuSampler* sampler, uint32_t slot, uint32_t shaderTypes)
+	{
+		shaderTypes = m_stateCache.filterSampler(sampler, slot, shaderTypes);
+		if (shaderTypes == 0)
+			return;
+
+		m_stats.numBinds += std::popcount(shaderTypes);
+		record(NULL_COMMAND_SET_SAMPLER, sampler, slot, shaderTypes);
+	}
+
+	void NullDevice::setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		record(NULL_COMMAND_SET_VIEWPORT, nullptr, x, y, width, height);
+	}
+
+	void NullDevice::copyTexture(IGpuTexture* dst, uint32_t dstMipslice, uint32_t dstArrayslice, uint32_t dstX, uint32_t dstY, uint32_t dstZ,
+		IGpuTexture* src, uint32_t srcMipslice, uint32_t srcArrayslice, uint32_t srcX, uint32_t srcY, uint32_t srcZ,
+		uint32_t width, uint32_t height, uint32_t depth)
+	{
+		ENGI_ASSERT(src && dst);
+		ENGI_ASSERT(dst->getDesc().usage != IMMUTABLE && "You can't use an Immutable resource as a destination");
+		record(NULL_COMMAND_COPY_TEXTURE, dst, dstMipslice, dstArrayslice, width, height, depth);
+	}
+
+	void NullDevice::copyBuffer(IGpuBuffer* src, IGpuBuffer* dst, uint32_t dstOffset)
+	{
+		ENGI_ASSERT(src && dst);
+		uint32_t srcBytes = src->getDesc().bytes;
+		uint32_t dstBytes = dst->getDesc().bytes;
+		ENGI_ASSERT(dstOffset <= dstBytes && srcBytes <= dstBytes - dstOffset && "Copy is out of the destination buffer bounds");
+		if (dstOffset <= dstBytes && srcBytes <= dstBytes - dstOffset)
+			std::memcpy(static_cast<NullBuffer*>(dst)->getStorage() + dstOffset, static_cast<NullBuffer*>(src)->getStorage(), srcBytes);
+
+		record(NULL_COMMAND_COPY_BUFFER, dst, dstOffset, srcBytes);
+	}
+
+	void NullDevice::copyBufferRegion(IGpuBuffer* src, uint32_t srcOffset, IGpuBuffer* dst, uint32_t dstOffset, uint32_t byteSize)
+	{
+		ENGI_ASSERT(src && dst);
+		bool inBounds = srcOffset + byteSize <= src->getDesc().bytes && dstOffset + byteSize <= dst->getDesc().bytes;
+		ENGI_ASSERT(inBounds && "Copy is out of the buffer bounds");
+		if (inBounds)
+			std::memmove(static_cast<NullBuffer*>(dst)->getStorage() + dstOffset, static_cast<NullBuffer*>(src)->getStorage() + srcOffset, byteSize);
+
+		record(NULL_COMMAND_COPY_BUFFER, dst, dstOffset, byteSize, srcOffset);
+	}
+
+	void NullDevice::updateBuffer(IGpuBuffer* buffer, uint32_t bufferOffset, const void* data, uint32_t byteSize)
+	{
+		ENGI_ASSERT(buffer && "Buffer cannot be nullptr");
+		if (!buffer)
+			return;
+
+		ENGI_ASSERT(buffer->getDesc().usage == GpuUsage::DEFAULT && "Cannot update buffer with non-default usage. Use map/unmap");
+		if (buffer->getDesc().usage != GpuUsage::DEFAULT)
+			return;
+
+		ENGI_ASSERT(bufferOffset + byteSize <= buffer->getDesc().bytes && "Update is out of the buffer bounds");
+		std::memcpy(static_cast<NullBuffer*>(buffer)->getStorage() + bufferOffset, data, byteSize);
+
+		m_stats.bytesUploaded += byteSize;
+		record(NULL_COMMAND_UPDATE_BUFFER, buffer, bufferOffset, byteSize);
+	}
+
+	void NullDevice::mapBuffer(IGpuBuffer* buffer, void** mapping)
+	{
+		if (!mapping)
+			return;
+
+		ENGI_ASSERT(buffer && "Buffer cannot be nullptr");
+		if (!buffer)
+			return;
+
+		ENGI_ASSERT((buffer->getDesc().cpuFlags & WRITE) != 0 && "Buffer must be writeable in order to uplod memory into it");
+		*mapping = static_cast<NullBuffer*>(buffer)->getStorage();
+
+		// Mapping cannot tell how much is written, thus the whole buffer is counted, as it is discarded on D3D11 anyway
+		m_stats.bytesUploaded += buffer->getDesc().bytes;
+		record(NULL_COMMAND_MAP_BUFFER, buffer, buffer->getDesc().bytes);
+	}
+
+	void NullDevice::unmapBuffer(IGpuBuffer* buffer)
+	{
+		if (!buffer)
+			return;
+
+		record(NULL_COMMAND_UNMAP_BUFFER, buffer);
+	}
+
+	void NullDevice::present()
+	{
+		record(NULL_COMMAND_PRESENT, nullptr, static_cast<uint32_t>(m_numFrames));
+		++m_numFrames;
+	}
+
+	void NullDevice::reset() noexcept
+	{
+		m_commands.clear();
+		m_stats = NullDeviceStats();
+	}
+
+	void NullDevice::record(NullCommandType type, const void* object, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3, uint32_t a4) noexcept
+	{
+		++m_stats.numCommands[type];
+		if (m_isRecording)
+			m_commands.push_back(NullCommand{ type, { a0, a1, a2, a3, a4 }, object });
+	}
+
+}; // engi::gfx namespace
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "GFX/GPUDevice.h"
+#include "GFX/GPUResourceAllocator.h"
+
+namespace engi::gfx
+{
+
+	enum NullCommandType : uint32_t
+	{
+		NULL_COMMAND_BEGIN_RENDER_PASS = 0,
+		NULL_COMMAND_END_RENDER_PASS,
+		NULL_COMMAND_DRAW,
+		NULL_COMMAND_DRAW_INDEXED,
+		NULL_COMMAND_DRAW_INSTANCED,
+		NULL_COMMAND_DRAW_INDEXED_INSTANCED,
+		NULL_COMMAND_DRAW_INDEXED_INSTANCED_INDIRECT,
+		NULL_COMMAND_DISPATCH,
+		NULL_COMMAND_DISPATCH_INDIRECT,
+		NULL_COMMAND_SET_PIPELINE_STATE,
+		NULL_COMMAND_SET_INPUT_LAYOUT,
+		NULL_COMMAND_SET_VERTEX_BUFFER,
+		NULL_COMMAND_SET_INDEX_BUFFER,
+		NULL_COMMAND_SET_CONSTANT_BUFFER,
+		NULL_COMMAND_SET_SRV,
+		NULL_COMMAND_SET_COMPUTE_UAV,
+		NULL_COMMAND_SET_SAMPLER,
+		NULL_COMMAND_SET_VIEWPORT,
+		NULL_COMMAND_COPY_TEXTURE,
+		NULL_COMMAND_COPY_BUFFER,
+		NULL_COMMAND_UPDATE_BUFFER,
+		NULL_COMMAND_MAP_BUFFER,
+		NULL_COMMAND_UNMAP_BUFFER,
+		NULL_COMMAND_PRESENT,
+		NULL_COMMAND_NUM_TYPES,
+	};
+
+	// Object is the resource the command operates on (if any), meaning of arguments is the same as of the IGpuDevice call
+	// (e.g. for NULL_COMMAND_SET_SRV those are slot and shader types that were not filtered out)
+	struct NullCommand
+	{
+		NullCommandType type;
+		uint32_t args[5];
+		const void* object;
+	};
+
+	struct NullDeviceStats
+	{
+		std::array<uint64_t, NULL_COMMAND_NUM_TYPES> numCommands{}; // only the calls that reached the device, after state filtering
+		uint64_t numDraws = 0;
+		uint64_t numDispatches = 0;
+		uint64_t numBinds = 0;
+		uint64_t bytesUploaded = 0; // through initial data, updateBuffer and mapBuffer
+	};
+
+	// Device that does no rendering at all. It accepts every call, allocates CPU-side stand-ins for the resources and counts
+	// what was submitted, optionally recording a command stream as well. Used to measure the CPU cost of a frame without a GPU
+	// and to check the amount of submitted work. Binds are filtered through the state cache as a real backend does
+	class NullDevice : public IGpuDevice
+	{
+	public:
+		NullDevice() = default;
+		NullDevice(const NullDevice&) = delete;
+		NullDevice& operator=(const NullDevice&) = delete;
+		virtual ~NullDevice() = default;
+
+		// Requests
+		virtual IGpuSwapchain* createSwapchain(const std::string& name, const GpuSwapchainDesc& desc) override;
+		virtual IGpuBuffer* createBuffer(const std::string& name, const GpuBufferDesc& desc, const void* initialData) override;
+		virtual IGpuShader* createShader(const std::string& name, const GpuShaderDesc& desc, void* bytecode) override;
+		virtual IGpuTexture* createTexture(const std::string& name, const GpuTextureDesc& desc, const void* initialData) override;
+		virtual IGpuPipelineState* createPipelineState(const std::string& name, const GpuPipelineStateDesc& desc) override;
+		virtual IGpuSampler* createSampler(const std::string& name, const GpuSamplerDesc& desc) override;
+		virtual IGpuInputLayout* createInputLayout(const std::string& name, const GpuInputAttributeDesc* attributes, uint32_t numAttributes, const GpuShaderBuffer& shaderBuffer) override;
+		virtual IGpuDescriptor* createSRV(const std::string& name, const GpuSrvDesc& desc, IGpuResource* resource) override;
+		virtual IGpuDescriptor* createUAV(const std::string& name, const GpuUavDesc& desc, IGpuResource* resource) override;
+		virtual void destroy(IGpuResource*& resource) override;
+
+		// Commands
+		virtual void beginRenderPass(const GpuRenderPassDesc& desc) override;
+		virtual void endRenderPass() override;
+		virtual void draw(uint32_t numVertices, uint32_t vertexOffset) override;
+		virtual void drawIndexed(uint32_t numIndices, uint32_t indexOffset, uint32_t vertexOffset) override;
+		virtual void drawInstanced(uint32_t numVerticesPerInstance, uint32_t numInstances, uint32_t vertexOffset, uint32_t instanceOffset) override;
+		virtual void drawIndexedInstanced(uint32_t numIndices, uint32_t numInstances, uint32_t indexOffset, uint32_t vertexOffset, uint32_t instanceOffset) override;
+		virtual void drawIndexedInstancedIndirect(IGpuBuffer* buffer, uint32_t byteOffset) override;
+		virtual void dispatch(uint32_t threadGroupsX, uint32_t threadGroupsY, uint32_t threadGroupsZ) override;
+		virtual void dispatchIndirect(IGpuBuffer* buffer, uint32_t byteOffset) override;
+
+		virtual void setPipelineState(IGpuPipelineState* state) override;
+		virtual void setInputLayout(IGpuInputLayout* inputLayout) override;
+		virtual void setVertexBuffer(IGpuBuffer* buffer, uint32_t slot, uint32_t stride, uint32_t offset) override;
+		virtual void setIndexBuffer(IGpuBuffer* buffer, uint32_t offset) override;
+		virtual void setConstantBuffer(IGpuBuffer* buffer, uint32_t slot, uint32_t shaderTypes) override;
+		virtual void setConstantBufferRange(IGpuBuffer* buffer, uint32_t slot, uint32_t shaderTypes, uint32_t byteOffset, uint32_t byteSize) override;
+		virtual void setSRV(const IGpuDescriptor* descriptor, uint32_t slot, uint32_t shaderTypes) override;
+		virtual void setComputeUAV(const IGpuDescriptor* descriptor, uint32_t slot) override;
+		virtual void setSampler(const IGpuSampler* sampler, uint32_t slot, uint32_t shaderTypes) override;
+		virtual void setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+		virtual void copyTexture(IGpuTexture* dst, uint32_t dstMipslice, uint32_t dstArrayslice, uint32_t dstX, uint32_t dstY, uint32_t dstZ,
+			IGpuTexture* src, uint32_t srcMipslice, uint32_t srcArrayslice, uint32_t srcX, uint32_t srcY, uint32_t srcZ,
+			uint32_t width, uint32_t height, uint32_t depth) override;
+		virtual void copyBuffer(IGpuBuffer* src, IGpuBuffer* dst, uint32_t dstOffset) override;
+		virtual void copyBufferRegion(IGpuBuffer* src, uint32_t srcOffset, IGpuBuffer* dst, uint32_t dstOffset, uint32_t byteSize) override;
+		virtual void updateBuffer(IGpuBuffer* buffer, uint32_t bufferOffset, const void* data, uint32_t byteSize) override;
+		virtual void mapBuffer(IGpuBuffer* buffer, void** mapping) override;
+		virtual void unmapBuffer(IGpuBuffer* buffer) override;
+
+		virtual GpuResourceAllocator* getResourceAllocator() override { return &m_resourceAllocator; }
+
+		// Called by the swapchain, marks the end of a frame in the command stream
+		void present();
+
+		// Recording is off by default, counters are always updated
+		inline void setRecording(bool recording) noexcept { m_isRecording = recording; }
+		inline bool isRecording() const noexcept { return m_isRecording; }
+
+		inline const std::vector<NullCommand>& getCommands() const noexcept { return m_commands; }
+		inline const NullDeviceStats& getStats() const noexcept { return m_stats; }
+		inline uint64_t getNumFrames() const noexcept { return m_numFrames; }
+
+		// Clears both the recorded commands and the counters
+		void reset() noexcept;
+
+	private:
+		void record(NullCommandType type, const void* object, uint32_t a0 = 0, uint32_t a1 = 0, uint32_t a2 = 0, uint32_t a3 = 0, uint32_t a4 = 0) noexcept;
+
+		GpuResourceAllocator m_resourceAllocator;
+		bool m_isRecording = false;
+		std::vector<NullCommand> m_commands;
+		NullDeviceStats m_stats;
+		uint64_t m_numFrames = 0;
+	}; // NullDevice class
+
+}; // engi::gfx namespace
@@ -0,0 +1,134 @@
+#include "GFX/Null/Null_Resources.h"
+
+#include <cstring>
+#include "Core/CommonDefinitions.h"
+#include "GFX/Null/Null_Device.h"
+
+namespace engi::gfx
+{
+
+	NullBuffer::NullBuffer(const std::string& name, NullDevice* device, const GpuBufferDesc& desc)
+	{
+		m_name = name;
+		m_device = device;
+		m_desc = desc;
+	}
+
+	bool NullBuffer::initialize(const void* initialData)
+	{
+		if (m_desc.bytes == 0)
+			return false;
+
+		m_storage.resize(m_desc.bytes);
+		if (initialData)
+			std::memcpy(m_storage.data(), initialData, m_desc.bytes);
+
+		return true;
+	}
+
+	NullTexture::NullTexture(const std::string& name, NullDevice* device, const GpuTextureDesc& desc)
+	{
+		m_name = name;
+		m_device = device;
+		m_desc = desc;
+	}
+
+	NullShader::NullShader(const std::string& name, NullDevice* device, const GpuShaderDesc& desc)
+	{
+		m_name = name;
+		m_device = device;
+		m_desc = desc;
+	}
+
+	NullSampler::NullSampler(const std::string& name, NullDevice* device, const GpuSamplerDesc& desc)
+	{
+		m_name = name;
+		m_device = device;
+		m_desc = desc;
+	}
+
+	NullInputLayout::NullInputLayout(const std::string& name, NullDevice* device, const GpuInputAttributeDesc* attributes, uint32_t numAttributes)
+	{
+		m_name = name;
+		m_device = device;
+
+		ENGI_ASSERT(attributes && numAttributes > 0 && "Invalid attribute data passed to NullInputLayout");
+		m_attributes = std::vector<GpuInputAttributeDesc>(attributes, attributes + numAttributes);
+	}
+
+	NullPipelineState::NullPipelineState(const std::string& name, NullDevice* device, const GpuPipelineStateDesc& desc)
+	{
+		m_name = name;
+		m_device = device;
+		m_desc = desc;
+	}
+
+	NullDescriptor::NullDescriptor(const std::string& name, NullDevice* device, IGpuResource* resource)
+		: m_resource(resource)
+	{
+		m_name = name;
+		m_device = device;
+	}
+
+	NullSwapchain::NullSwapchain(const std::string& name, NullDevice* device, const GpuSwapchainDesc& desc)
+	{
+		m_name = name;
+		m_device = device;
+		m_desc = desc;
+	}
+
+	NullSwapchain::~NullSwapchain()
+	{
+		m_device->getResourceAllocator()->destroyResource((IGpuResource*&)m_backbuffer);
+	}
+
+	bool NullSwapchain::initialize()
+	{
+		return createBackbuffer();
+	}
+
+	void NullSwapchain::present()
+	{
+		static_cast<NullDevice*>(m_device)->present();
+	}
+
+	bool NullSwapchain::resize(uint32_t width, uint32_t height)
+	{
+		if (m_desc.width == width && m_desc.height == height)
+		{
+			return false;
+		}
+
+		m_desc.width = width;
+		m_desc.height = height;
+
+		m_device->destroy((IGpuResource*&)m_backbuffer);
+		return createBackbuffer();
+	}
+
+	bool NullSwapchain::createBackbuffer()
+	{
+		if (m_desc.width == 0 || m_desc.height == 0)
+		{
+			return false;
+		}
+
+		GpuTextureDesc backbufferDesc;
+		backbufferDesc.type = TEXTURE2D;
+		backbufferDesc.width = m_desc.width;
+		backbufferDesc.height = m_desc.height;
+		backbufferDesc.depth = 1;
+		backbufferDesc.miplevels = 1;
+		backbufferDesc.arraySize = 1;
+		backbufferDesc.format = m_desc.format;
+		backbufferDesc.usage = GpuUsage::DEFAULT;
+		backbufferDesc.pipelineFlags = GpuBinding::RENDER_TARGET;
+		backbufferDesc.cpuFlags = CpuAccess::ACCESS_UNUSED;
+		backbufferDesc.otherFlags = 0;
+
+		m_backbuffer = m_device->createTexture(m_name + "::backbuffer", backbufferDesc, nullptr);
+		ENGI_ASSERT(m_backbuffer && "Failed to create backbuffer");
+		return true;
+	}
+
+}; // engi::gfx namespace
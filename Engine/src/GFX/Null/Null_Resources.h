@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "GFX/GPUBuffer.h"
+#include "GFX/GPUDescriptor.h"
+#include "GFX/GPUInputLayout.h"
+#include "GFX/GPUPipelineState.h"
+#include "GFX/GPUSampler.h"
+#include "GFX/GPUShader.h"
+#include "GFX/GPUSwapchain.h"
+#include "GFX/GPUTexture.h"
+
+namespace engi::gfx
+{
+
+	// CPU-side stand-ins for the resources of NullDevice. Handle of every resource is the resource itself, so that handles
+	// are unique and stable, as the state cache expects
+
+	class NullDevice;
+
+	class NullBuffer : public IGpuBuffer
+	{
+	public:
+		NullBuffer(const std::string& name, NullDevice* device, const GpuBufferDesc& desc);
+		virtual ~NullBuffer() = default;
+
+		bool initialize(const void* initialData);
+		virtual void* getHandle() override { return this; }
+
+		// Buffers keep their contents, thus mapping, updates and copies cost the same memory traffic they would on CPU side of a real device
+		inline uint8_t* getStorage() noexcept { return m_storage.data(); }
+
+	private:
+		std::vector<uint8_t> m_storage;
+	}; // NullBuffer class
+
+	// Textures do not store texels, only the description
+	class NullTexture : public IGpuTexture
+	{
+	public:
+		NullTexture(const std::string& name, NullDevice* device, const GpuTextureDesc& desc);
+		virtual ~NullTexture() = default;
+
+		virtual void* getHandle() override { return this; }
+		virtual void* getRTV(uint32_t mipSlice, uint32_t arraySlice) override { return this; }
+		virtual void* getDSV(uint32_t mipSlice, uint32_t arraySlice) override { return this; }
+	}; // NullTexture class
+
+	class NullShader : public IGpuShader
+	{
+	public:
+		NullShader(const std::string& name, NullDevice* device, const GpuShaderDesc& desc);
+		virtual ~NullShader() = default;
+
+		// Bytecode is backend-specific, null device does not keep it
+		virtual bool initialize(void* bytecode) override { return true; }
+		virtual GpuShaderBuffer getBytecode() override { return GpuShaderBuffer{ nullptr, 0 }; }
+		virtual void* getHandle() override { return this; }
+	}; // NullShader class
+
+	class NullSampler : public IGpuSampler
+	{
+	public:
+		NullSampler(const std::string& name, NullDevice* device, const GpuSamplerDesc& desc);
+		virtual ~NullSampler() = default;
+
+		virtual void* getHandle() override { return this; }
+	}; // NullSampler class
+
+	class NullInputLayout : public IGpuInputLayout
+	{
+	public:
+		NullInputLayout(const std::string& name, NullDevice* device, const GpuInputAttributeDesc* attributes, uint32_t numAttributes);
+		virtual ~NullInputLayout() = default;
+
+		virtual void* getHandle() override { return this; }
+	}; // NullInputLayout class
+
+	class NullPipelineState : public IGpuPipelineState
+	{
+	public:
+		NullPipelineState(const std::string& name, NullDevice* device, const GpuPipelineStateDesc& desc);
+		virtual ~NullPipelineState() = default;
+
+		virtual void* getHandle() override { return this; }
+	}; // NullPipelineState class
+
+	class NullDescriptor : public IGpuDescriptor
+	{
+	public:
+		NullDescriptor(const std::string& name, NullDevice* device, IGpuResource* resource);
+		virtual ~NullDescriptor() = default;
+
+		virtual void* getHandle() override { return this; }
+		inline IGpuResource* getResource() noexcept { return m_resource; }
+
+	private:
+		IGpuResource* m_resource;
+	}; // NullDescriptor class
+
+	class NullSwapchain : public IGpuSwapchain
+	{
+	public:
+		NullSwapchain(const std::string& name, NullDevice* device, const GpuSwapchainDesc& desc);
+		virtual ~NullSwapchain();
+
+		bool initialize();
+		virtual void* getHandle() override { return this; }
+		virtual void present() override;
+		virtual bool resize(uint32_t width, uint32_t height) override;
+		virtual IGpuTexture* getBackbuffer() override { return m_backbuffer; }
+
+	private:
+		bool createBackbuffer();
+
+		IGpuTexture* m_backbuffer = nullptr;
+	}; // NullSwapchain class
+
+}; // engi::gfx namespace
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include "Math/Vec3.h"
+#include "Math/Vec4.h"
+#include "Math/Mat4x4.h"
+#include "Math/AABB.h"
+
+namespace engi::math
+{
+
+	// Convex volume bounded by 6 planes. Each plane is stored as (normal, distance) with the normal pointing inside,
+	// so that a point p is inside of the plane if dot(normal, p) + distance >= 0
+	struct Frustum
+	{
+		enum PlaneIndex
+		{
+			PLANE_LEFT = 0,
+			PLANE_RIGHT,
+			PLANE_BOTTOM,
+			PLANE_TOP,
+			PLANE_NEAR,
+			PLANE_FAR,
+			NUM_PLANES,
+		};
+
+		Frustum() = default;
+
+		// Extracts planes from the view-projection matrix (Gribb-Hartmann). Works for both perspective and orthographic projections
+		// as well as for reversed depth, as the depth range is [0, 1] in every case
+		static Frustum fromMatrix(const Mat4x4& viewProj) noexcept;
+
+		bool intersects(const AABB& aabb) const noexcept;
+		bool intersects(const Vec3& center, float radius) const noexcept;
+
+		// Tests the box given in its local space, which is transformed to world by boxToWorld (an oriented box test, tighter than the
+		// world-space AABB of the transformed box)
+		bool intersects(const AABB& aabb, const Mat4x4& boxToWorld) const noexcept;
+
+		std::array<Vec4, NUM_PLANES> planes;
+	}; // Frustum struct
+
+}; // engi::math namespace
+
+#include "Math/Frustum.inl"
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Math/Frustum.h"
+
+namespace engi::math
+{
+
+	inline Frustum Frustum::fromMatrix(const Mat4x4& m) noexcept
+	{
+		// We use row-vectors, thus clip = v * M and planes are combinations of matrix columns
+		Vec4 c0(m._11, m._21, m._31, m._41);
+		Vec4 c1(m._12, m._22, m._32, m._42);
+		Vec4 c2(m._13, m._23, m._33, m._43);
+		Vec4 c3(m._14, m._24, m._34, m._44);
+
+		Frustum frustum;
+		frustum.planes[PLANE_LEFT] = c3 + c0;
+		frustum.planes[PLANE_RIGHT] = c3 - c0;
+		frustum.planes[PLANE_BOTTOM] = c3 + c1;
+		frustum.planes[PLANE_TOP] = c3 - c1;
+		frustum.planes[PLANE_NEAR] = c2;
+		frustum.planes[PLANE_FAR] = c3 - c2;
+
+		for (Vec4& plane : frustum.planes)
+		{
+			float length = Vec3(plane.x, plane.y, plane.z).length();
+			if (length > 0.0f)
+				plane /= length;
+		}
+		return frustum;
+	}
+
+	inline bool Frustum::intersects(const AABB& aabb) const noexcept
+	{
+		for (const Vec4& plane : planes)
+		{
+			// The most positive vertex along the plane normal
+			Vec3 p(plane.x >= 0.0f ? aabb.max.x : aabb.min.x,
+				plane.y >= 0.0f ? aabb.max.y : aabb.min.y,
+				plane.z >= 0.0f ? aabb.max.z : aabb.min.z);
+
+			if (plane.x * p.x + plane.y * p.y + plane.z * p.z + plane.w < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+	inline bool Frustum::intersects(const Vec3& center, float radius) const noexcept
+	{
+		for (const Vec4& plane : planes)
+		{
+			if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+				return false;
+		}
+		return true;
+	}
+
+	inline bool Frustum::intersects(const AABB& aabb, const Mat4x4& boxToWorld) const noexcept
+	{
+		Vec3 center = aabb.center() * boxToWorld;
+		Vec3 extents = aabb.size() * 0.5f;
+
+		// Rows of the matrix are the box axes in world space
+		Vec3 axisX(boxToWorld._11, boxToWorld._12, boxToWorld._13);
+		Vec3 axisY(boxToWorld._21, boxToWorld._22, boxToWorld._23);
+		Vec3 axisZ(boxToWorld._31, boxToWorld._32, boxToWorld._33);
+
+		for (const Vec4& plane : planes)
+		{
+			Vec3 normal(plane.x, plane.y, plane.z);
+			float radius = extents.x * std::abs(normal.dot(axisX))
+				+ extents.y * std::abs(normal.dot(axisY))
+				+ extents.z * std::abs(normal.dot(axisZ));
+
+			if (normal.dot(center) + plane.w < -radius)
+				return false;
+		}
+		return true;
+	}
+
+}; // engi::math namespace
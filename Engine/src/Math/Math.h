@@ -2,8 +2,6 @@
 
 #include <cmath>
 #include <DirectXMath.h>
-// TODO: Remove this when ray-tri collisions are replaced
-#include <DirectXCollision.h>
 
 #include "Math/Vec2.h"
 #include "Math/Vec3.h"
@@ -11,6 +9,7 @@
 #include "Math/Mat4x4.h"
 #include "Math/Numeric.h"
 #include "Math/AABB.h"
+#include "Math/Frustum.h"
 
 namespace engi::math
 {
@@ -42,6 +41,8 @@ namespace engi::math
 		Vec3 scale;
 	}; // Transformation struct
 
+	// Ray caches the reciprocal of its direction and its sign bits for slab tests.
+	// Thus origin and direction should be treated as read-only, construct a new ray instead of modifying them
 	struct Ray
 	{
 		Ray(const Vec3& origin = Vec3(0.0f), const Vec3& direction = Vec3(0.0f, 0.0f, 1.0f))
@@ -49,6 +50,10 @@ namespace engi::math
 			, direction(direction)
 		{
 			this->direction.normalize();
+			this->invDirection = Vec3(1.0f) / this->direction;
+			this->sign[0] = this->invDirection.x < 0.0f ? 1 : 0;
+			this->sign[1] = this->invDirection.y < 0.0f ? 1 : 0;
+			this->sign[2] = this->invDirection.z < 0.0f ? 1 : 0;
 		}
 
 		Ray(const Ray&) = default;
@@ -57,11 +62,14 @@ namespace engi::math
 		Ray(Ray&&) = default;
 		Ray& operator=(Ray&&) = default;
 
-		bool intersects(const Vec3& tri0, const Vec3& tri1, const Vec3& tri2, float* t) const noexcept;
+		// Moller-Trumbore, both sides of the triangle are hit. Barycentrics are (u, v) weights of tri1 and tri2
+		bool intersects(const Vec3& tri0, const Vec3& tri1, const Vec3& tri2, float* t, Vec2* barycentrics = nullptr) const noexcept;
 		bool intersects(const AABB& aabb, float* t) const noexcept;
 
 		Vec3 origin;
 		Vec3 direction;
+		Vec3 invDirection;
+		uint32_t sign[3];
 	}; // Ray struct
 
 }; // engi::math namespace
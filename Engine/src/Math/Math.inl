@@ -37,30 +37,65 @@ namespace engi::math
 		return std::lerp(from, to, s);
 	}
 
-	inline bool Ray::intersects(const Vec3& tri0, const Vec3& tri1, const Vec3& tri2, float* t) const noexcept
+	inline bool Ray::intersects(const Vec3& tri0, const Vec3& tri1, const Vec3& tri2, float* t, Vec2* barycentrics) const noexcept
 	{
-		const XMVECTOR v0 = (XMVECTOR)tri0;
-		const XMVECTOR v1 = (XMVECTOR)tri1;
-		const XMVECTOR v2 = (XMVECTOR)tri2;
-		const XMVECTOR o = (XMVECTOR)origin;
-		const XMVECTOR d = (XMVECTOR)direction;
-		float dummy; // to avoid nullptr dereference
-		return TriangleTests::Intersects(o, d, v0, v1, v2, t == nullptr ? dummy : *t);
+		Vec3 e1 = tri1 - tri0;
+		Vec3 e2 = tri2 - tri0;
+		Vec3 p = direction.cross(e2);
+		float det = e1.dot(p);
+
+		// Only rays parallel to the plane are rejected. Determinant scales with the product of edge lengths,
+		// thus an absolute threshold would also reject small triangles
+		if (det == 0.0f)
+			return false;
+
+		float invDet = 1.0f / det;
+		Vec3 s = origin - tri0;
+		float u = s.dot(p) * invDet;
+		if (u < 0.0f || u > 1.0f)
+			return false;
+
+		Vec3 q = s.cross(e1);
+		float v = direction.dot(q) * invDet;
+		if (v < 0.0f || u + v > 1.0f)
+			return false;
+
+		float distance = e2.dot(q) * invDet;
+		if (distance <= 0.0f)
+			return false;
+
+		if (t)
+			*t = distance;
+
+		if (barycentrics)
+			*barycentrics = Vec2(u, v);
+
+		return true;
 	}
 
 	inline bool Ray::intersects(const AABB& aabb, float* t) const noexcept
 	{
-		Vec3 invDir = Vec3(1.0f) / direction;
-		Vec3 tMin = (aabb.min - origin) * invDir;
-		Vec3 tMax = (aabb.max - origin) * invDir;
-		Vec3 t1 = Vec3::min(tMin, tMax);
-		Vec3 t2 = Vec3::max(tMin, tMax);
-		float tNear = t1.getMax();
-		float tFar = t2.getMin();
-		if (tNear > tFar)
-		{
+		// Sign bits select the near and the far slab of each axis, thus no swaps are needed
+		const Vec3* bounds[2] = { &aabb.min, &aabb.max };
+		float tNear = (bounds[sign[0]]->x - origin.x) * invDirection.x;
+		float tFar = (bounds[1 - sign[0]]->x - origin.x) * invDirection.x;
+		float tyNear = (bounds[sign[1]]->y - origin.y) * invDirection.y;
+		float tyFar = (bounds[1 - sign[1]]->y - origin.y) * invDirection.y;
+		if (tNear > tyFar || tyNear > tFar)
+			return false;
+
+		tNear = (tyNear > tNear) ? tyNear : tNear;
+		tFar = (tyFar < tFar) ? tyFar : tFar;
+
+		float tzNear = (bounds[sign[2]]->z - origin.z) * invDirection.z;
+		float tzFar = (bounds[1 - sign[2]]->z - origin.z) * invDirection.z;
+		if (tNear > tzFar || tzNear > tFar)
+			return false;
+
+		tNear = (tzNear > tNear) ? tzNear : tNear;
+		tFar = (tzFar < tFar) ? tzFar : tFar;
+		if (tFar < 0.0f)
 			return false;
-		}
 
 		if (t)
 		{
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <immintrin.h>
+#include "Math/Math.h"
+
+// 8-wide kernels are only compiled when the build targets AVX2 (/arch:AVX2), otherwise SSE 4-wide kernels are used
+#if defined(__AVX2__)
+#define ENGI_TRIANGLEPACKET_WIDTH 8
+#else
+#define ENGI_TRIANGLEPACKET_WIDTH 4
+#endif
+
+namespace engi::math
+{
+
+	struct TriangleHit
+	{
+		float t = Numeric::infinity();
+		float u = 0.0f; // barycentric weight of the second vertex
+		float v = 0.0f; // barycentric weight of the third vertex
+		uint32_t lane = uint32_t(-1);
+
+		inline constexpr bool isValid() const noexcept { return lane != uint32_t(-1); }
+	};
+
+	// Triangles stored in SoA layout as (v0, e1 = v1 - v0, e2 = v2 - v0), so that Width triangles are tested against a ray at once.
+	// Cleared lanes are degenerate triangles which are never hit, they are used to pad the last packet of a group
+	template<uint32_t Width>
+	struct alignas(32) TrianglePacket
+	{
+		static constexpr uint32_t WIDTH = Width;
+
+		TrianglePacket() noexcept { for (uint32_t lane = 0; lane < Width; ++lane) clear(lane); }
+
+		void set(uint32_t lane, const Vec3& p0, const Vec3& p1, const Vec3& p2) noexcept;
+		void clear(uint32_t lane) noexcept;
+
+		float v0[3][Width];
+		float e1[3][Width];
+		float e2[3][Width];
+	}; // TrianglePacket struct
+
+	using TrianglePacketN = TrianglePacket<ENGI_TRIANGLEPACKET_WIDTH>;
+
+	// Ray components broadcasted to SIMD registers, build it once per ray and reuse for every packet and box
+	struct RaySSE
+	{
+		explicit RaySSE(const Ray& ray) noexcept;
+
+		__m128 origin; // (x, y, z, 0)
+		__m128 invDirection; // (x, y, z, 0)
+		__m128 o[3];
+		__m128 d[3];
+	}; // RaySSE struct
+
+	// Moller-Trumbore against every lane of the packet, same rules as Ray::intersects. Returns true and overwrites the hit
+	// only if one of the triangles is closer than hit.t
+	bool intersects(const RaySSE& ray, const TrianglePacket<4>& packet, TriangleHit& hit) noexcept;
+
+#if defined(__AVX2__)
+	struct RayAVX
+	{
+		explicit RayAVX(const Ray& ray) noexcept;
+
+		__m256 o[3];
+		__m256 d[3];
+	}; // RayAVX struct
+
+	bool intersects(const RayAVX& ray, const TrianglePacket<8>& packet, TriangleHit& hit) noexcept;
+
+	using RayPacketN = RayAVX;
+#else
+	using RayPacketN = RaySSE;
+#endif
+
+	// Slab test of the box, returns the entry distance (clamped to 0 if the origin is inside) or infinity if the box is missed
+	// or is further than tMax. Reads 4 floats at both min and max, the fourth one is ignored
+	float intersectBox(const RaySSE& ray, const float* min, const float* max, float tMax) noexcept;
+
+}; // engi::math namespace
+
+#include "Math/TrianglePacket.inl"
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <bit>
+#include "Math/TrianglePacket.h"
+
+namespace engi::math
+{
+
+	template<uint32_t Width>
+	inline void TrianglePacket<Width>::set(uint32_t lane, const Vec3& p0, const Vec3& p1, const Vec3& p2) noexcept
+	{
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			v0[axis][lane] = p0[axis];
+			e1[axis][lane] = p1[axis] - p0[axis];
+			e2[axis][lane] = p2[axis] - p0[axis];
+		}
+	}
+
+	template<uint32_t Width>
+	inline void TrianglePacket<Width>::clear(uint32_t lane) noexcept
+	{
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			// Zero edges give zero determinant, which is always rejected
+			v0[axis][lane] = 0.0f;
+			e1[axis][lane] = 0.0f;
+			e2[axis][lane] = 0.0f;
+		}
+	}
+
+	inline RaySSE::RaySSE(const Ray& ray) noexcept
+		: origin(_mm_set_ps(0.0f, ray.origin.z, ray.origin.y, ray.origin.x))
+		, invDirection(_mm_set_ps(0.0f, ray.invDirection.z, ray.invDirection.y, ray.invDirection.x))
+	{
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			o[axis] = _mm_set1_ps(ray.origin[axis]);
+			d[axis] = _mm_set1_ps(ray.direction[axis]);
+		}
+	}
+
+	inline bool intersects(const RaySSE& ray, const TrianglePacket<4>& packet, TriangleHit& hit) noexcept
+	{
+		const __m128 e1x = _mm_load_ps(packet.e1[0]);
+		const __m128 e1y = _mm_load_ps(packet.e1[1]);
+		const __m128 e1z = _mm_load_ps(packet.e1[2]);
+		const __m128 e2x = _mm_load_ps(packet.e2[0]);
+		const __m128 e2y = _mm_load_ps(packet.e2[1]);
+		const __m128 e2z = _mm_load_ps(packet.e2[2]);
+
+		// p = direction x e2
+		__m128 px = _mm_sub_ps(_mm_mul_ps(ray.d[1], e2z), _mm_mul_ps(ray.d[2], e2y));
+		__m128 py = _mm_sub_ps(_mm_mul_ps(ray.d[2], e2x), _mm_mul_ps(ray.d[0], e2z));
+		__m128 pz = _mm_sub_ps(_mm_mul_ps(ray.d[0], e2y), _mm_mul_ps(ray.d[1], e2x));
+		__m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+		__m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+		// s = origin - v0
+		__m128 sx = _mm_sub_ps(ray.o[0], _mm_load_ps(packet.v0[0]));
+		__m128 sy = _mm_sub_ps(ray.o[1], _mm_load_ps(packet.v0[1]));
+		__m128 sz = _mm_sub_ps(ray.o[2], _mm_load_ps(packet.v0[2]));
+		__m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), invDet);
+
+		// q = s x e1
+		__m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+		__m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+		__m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+		__m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ray.d[0], qx), _mm_mul_ps(ray.d[1], qy)), _mm_mul_ps(ray.d[2], qz)), invDet);
+		__m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+		const __m128 zero = _mm_setzero_ps();
+		__m128 mask = _mm_cmpneq_ps(det, zero); // same rule as Ray::intersects, cleared lanes have zero determinant
+		mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+		mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+		mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+		mask = _mm_and_ps(mask, _mm_cmpgt_ps(t, zero));
+		mask = _mm_and_ps(mask, _mm_cmplt_ps(t, _mm_set1_ps(hit.t)));
+		if (_mm_movemask_ps(mask) == 0)
+			return false;
+
+		// Closest of the accepted lanes, the select is done with plain SSE2 as blendv requires SSE4.1
+		__m128 tMasked = _mm_or_ps(_mm_and_ps(mask, t), _mm_andnot_ps(mask, _mm_set1_ps(Numeric::infinity())));
+		__m128 tMin = _mm_min_ps(tMasked, _mm_shuffle_ps(tMasked, tMasked, _MM_SHUFFLE(2, 3, 0, 1)));
+		tMin = _mm_min_ps(tMin, _mm_shuffle_ps(tMin, tMin, _MM_SHUFFLE(1, 0, 3, 2)));
+		int closest = _mm_movemask_ps(_mm_and_ps(mask, _mm_cmpeq_ps(tMasked, tMin)));
+		uint32_t lane = static_cast<uint32_t>(std::countr_zero(static_cast<uint32_t>(closest)));
+
+		alignas(16) float us[4];
+		alignas(16) float vs[4];
+		_mm_store_ps(us, u);
+		_mm_store_ps(vs, v);
+		hit.t = _mm_cvtss_f32(tMin);
+		hit.u = us[lane];
+		hit.v = vs[lane];
+		hit.lane = lane;
+		return true;
+	}
+
+#if defined(__AVX2__)
+	inline RayAVX::RayAVX(const Ray& ray) noexcept
+	{
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			o[axis] = _mm256_set1_ps(ray.origin[axis]);
+			d[axis] = _mm256_set1_ps(ray.direction[axis]);
+		}
+	}
+
+	inline bool intersects(const RayAVX& ray, const TrianglePacket<8>& packet, TriangleHit& hit) noexcept
+	{
+		const __m256 e1x = _mm256_load_ps(packet.e1[0]);
+		const __m256 e1y = _mm256_load_ps(packet.e1[1]);
+		const __m256 e1z = _mm256_load_ps(packet.e1[2]);
+		const __m256 e2x = _mm256_load_ps(packet.e2[0]);
+		const __m256 e2y = _mm256_load_ps(packet.e2[1]);
+		const __m256 e2z = _mm256_load_ps(packet.e2[2]);
+
+		__m256 px = _mm256_fmsub_ps(ray.d[1], e2z, _mm256_mul_ps(ray.d[2], e2y));
+		__m256 py = _mm256_fmsub_ps(ray.d[2], e2x, _mm256_mul_ps(ray.d[0], e2z));
+		__m256 pz = _mm256_fmsub_ps(ray.d[0], e2y, _mm256_mul_ps(ray.d[1], e2x));
+		__m256 det = _mm256_fmadd_ps(e1z, pz, _mm256_fmadd_ps(e1y, py, _mm256_mul_ps(e1x, px)));
+		__m256 invDet = _mm256_div_ps(_mm256_set1_ps(1.0f), det);
+
+		__m256 sx = _mm256_sub_ps(ray.o[0], _mm256_load_ps(packet.v0[0]));
+		__m256 sy = _mm256_sub_ps(ray.o[1], _mm256_load_ps(packet.v0[1]));
+		__m256 sz = _mm256_sub_ps(ray.o[2], _mm256_load_ps(packet.v0[2]));
+		__m256 u = _mm256_mul_ps(_mm256_fmadd_ps(sz, pz, _mm256_fmadd_ps(sy, py, _mm256_mul_ps(sx, px))), invDet);
+
+		__m256 qx = _mm256_fmsub_ps(sy, e1z, _mm256_mul_ps(sz, e1y));
+		__m256 qy = _mm256_fmsub_ps(sz, e1x, _mm256_mul_ps(sx, e1z));
+		__m256 qz = _mm256_fmsub_ps(sx, e1y, _mm256_mul_ps(sy, e1x));
+		__m256 v = _mm256_mul_ps(_mm256_fmadd_ps(ray.d[2], qz, _mm256_fmadd_ps(ray.d[1], qy, _mm256_mul_ps(ray.d[0], qx))), invDet);
+		__m256 t = _mm256_mul_ps(_mm256_fmadd_ps(e2z, qz, _mm256_fmadd_ps(e2y, qy, _mm256_mul_ps(e2x, qx))), invDet);
+
+		const __m256 zero = _mm256_setzero_ps();
+		__m256 mask = _mm256_cmp_ps(det, zero, _CMP_NEQ_UQ);
+		mask = _mm256_and_ps(mask, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+		mask = _mm256_and_ps(mask, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+		mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(u, v), _mm256_set1_ps(1.0f), _CMP_LE_OQ));
+		mask = _mm256_and_ps(mask, _mm256_cmp_ps(t, zero, _CMP_GT_OQ));
+		mask = _mm256_and_ps(mask, _mm256_cmp_ps(t, _mm256_set1_ps(hit.t), _CMP_LT_OQ));
+		if (_mm256_movemask_ps(mask) == 0)
+			return false;
+
+		__m256 tMasked = _mm256_blendv_ps(_mm256_set1_ps(Numeric::infinity()), t, mask);
+		__m256 tMin = _mm256_min_ps(tMasked, _mm256_permute2f128_ps(tMasked, tMasked, 0x01));
+		tMin = _mm256_min_ps(tMin, _mm256_shuffle_ps(tMin, tMin, _MM_SHUFFLE(2, 3, 0, 1)));
+		tMin = _mm256_min_ps(tMin, _mm256_shuffle_ps(tMin, tMin, _MM_SHUFFLE(1, 0, 3, 2)));
+		int closest = _mm256_movemask_ps(_mm256_and_ps(mask, _mm256_cmp_ps(tMasked, tMin, _CMP_EQ_OQ)));
+		uint32_t lane = static_cast<uint32_t>(std::countr_zero(static_cast<uint32_t>(closest)));
+
+		alignas(32) float us[8];
+		alignas(32) float vs[8];
+		_mm256_store_ps(us, u);
+		_mm256_store_ps(vs, v);
+		hit.t = _mm256_cvtss_f32(tMin);
+		hit.u = us[lane];
+		hit.v = vs[lane];
+		hit.lane = lane;
+		return true;
+	}
+#endif
+
+	inline float intersectBox(const RaySSE& ray, const float* min, const float* max, float tMax) noexcept
+	{
+		__m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(min), ray.origin), ray.invDirection);
+		__m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(max), ray.origin), ray.invDirection);
+		__m128 tNear = _mm_min_ps(t1, t2);
+		__m128 tFar = _mm_max_ps(t1, t2);
+
+		// Replace the unused fourth lane with the first one, so that it does not affect horizontal min and max
+		tNear = _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(0, 2, 1, 0));
+		tFar = _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(0, 2, 1, 0));
+		tNear = _mm_max_ps(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(2, 3, 0, 1)));
+		tNear = _mm_max_ps(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(1, 0, 3, 2)));
+		tFar = _mm_min_ps(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(2, 3, 0, 1)));
+		tFar = _mm_min_ps(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(1, 0, 3, 2)));
+
+		float entry = _mm_cvtss_f32(tNear);
+		float exit = _mm_cvtss_f32(tFar);
+		if (entry > exit || exit < 0.0f || entry >= tMax)
+			return Numeric::infinity();
+
+		return (entry > 0.0f) ? entry : 0.0f;
+	}
+
+}; // engi::math namespace
@@ -5,8 +5,6 @@
 namespace engi::assimp
 {
 
-	Assimp::Importer g_importer = Assimp::Importer();
-
 	void convertToVec2(const aiVector3D& srcVec, math::Vec2& dstVec)
 	{
 		dstVec = math::Vec2(srcVec.x, srcVec.y);
@@ -38,9 +36,13 @@ namespace engi::assimp
 			meshFlags |= STATIC_MESH_FLAGS_TANGENTS;
 
 		dstMesh = StaticMesh(numVertices, numFaces, dstAABB, meshFlags, dstMeshName);
+
+		// Containers are filled in-place, the mesh is full after this function returns
+		StaticMesh::VertexContainerType& vertices = dstMesh.getVertices();
+		vertices.resize(numVertices);
 		for (uint32_t v = 0; v < numVertices; ++v)
 		{
-			StaticMeshVertex vertex;
+			StaticMeshVertex& vertex = vertices[v];
 			convertToVec3(srcMesh->mVertices[v], vertex.position);
 
 			if (dstMesh.hasNormals())
@@ -54,20 +56,19 @@ namespace engi::assimp
 				convertToVec3(srcMesh->mTangents[v], vertex.tangent);
 				convertToVec3(srcMesh->mBitangents[v], vertex.bitangent);
 			}
-
-			dstMesh.addVertex(vertex);
 		}
 
 		ENGI_ASSERT(srcMesh->HasFaces() && "Failed to parse a mesh. Mesh should always contain faces");
+		StaticMesh::TriangleContainerType& triangles = dstMesh.getTriangles();
+		triangles.resize(numFaces);
 		for (uint32_t f = 0; f < numFaces; ++f)
 		{
 			const aiFace& face = srcMesh->mFaces[f];
 			ENGI_ASSERT(face.mNumIndices == 3 && "Failed to parse a mesh. Engi only supportes triangular faces");
-			StaticMeshTriangle triangle{};
+			StaticMeshTriangle& triangle = triangles[f];
 			triangle.indices[0] = face.mIndices[0];
 			triangle.indices[1] = face.mIndices[1];
 			triangle.indices[2] = face.mIndices[2];
-			dstMesh.addTriangle(triangle);
 		}
 	}
 
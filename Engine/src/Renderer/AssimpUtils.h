@@ -10,8 +10,6 @@
 
 namespace engi::assimp
 {
-	extern Assimp::Importer g_importer;
-
 	void convertToVec2(const aiVector3D& srcVec, math::Vec2& dstVec);
 	void convertToVec3(const aiVector3D& srcVec, math::Vec3& dstVec);
 	void convertToMat4x4(const aiMatrix4x4& srcMat, math::Mat4x4& dstMat);
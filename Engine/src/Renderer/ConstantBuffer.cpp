@@ -39,6 +39,12 @@ namespace engi
 		m_device->setConstantBuffer(m_buffer.get(), slot, shaderTypes);
 	}
 
+	void ConstantBuffer::bindRange(uint32_t slot, uint32_t shaderTypes, uint32_t byteOffset, uint32_t byteSize)
+	{
+		ENGI_ASSERT(m_buffer && "Constant buffer was not initialized correctly");
+		m_device->setConstantBufferRange(m_buffer.get(), slot, shaderTypes, byteOffset, byteSize);
+	}
+
 	void ConstantBuffer::upload(uint32_t offset, const void* data, uint32_t size)
 	{
 		void* mapping;
@@ -17,6 +17,7 @@ namespace engi
 
 		bool initialize(uint32_t size);
 		void bind(uint32_t slot, uint32_t shaderTypes);
+		void bindRange(uint32_t slot, uint32_t shaderTypes, uint32_t byteOffset, uint32_t byteSize);
 		void upload(uint32_t offset, const void* data, uint32_t size);
 
 	private:
@@ -0,0 +1,172 @@
+#include "Renderer/GeometryPool.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "Core/CommonDefinitions.h"
+#include "Core/Logger.h"
+#include "GFX/GPUDevice.h"
+#include "GFX/GPUBuffer.h"
+
+namespace engi
+{
+
+	using namespace gfx;
+
+	GeometryPool::GeometryPool(const std::string& name, IGpuDevice* device)
+		: m_name(name)
+		, m_device(device)
+	{
+		ENGI_ASSERT(device && "Logical device cannot be nullptr");
+		m_vertexArena.elementSize = sizeof(StaticMeshVertex);
+		m_vertexArena.binding = GpuBinding::VERTEX_BUFFER;
+		m_indexArena.elementSize = sizeof(uint32_t);
+		m_indexArena.binding = GpuBinding::INDEX_BUFFER;
+	}
+
+	bool GeometryPool::init(uint32_t numVertices, uint32_t numIndices) noexcept
+	{
+		ENGI_ASSERT(numVertices > 0 && numIndices > 0 && "Geometry pool cannot be empty");
+		for (auto [arena, capacity] : { std::pair(&m_vertexArena, numVertices), std::pair(&m_indexArena, numIndices) })
+		{
+			arena->buffer = makeGpuHandle(createArenaBuffer(*arena, capacity), m_device->getResourceAllocator());
+			if (!arena->buffer)
+			{
+				ENGI_LOG_ERROR("Failed to create arena of geometry pool {}", m_name);
+				return false;
+			}
+			arena->allocator.reset(capacity);
+		}
+
+		return true;
+	}
+
+	uint32_t GeometryPool::allocate(const StaticMeshVertex* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numIndices) noexcept
+	{
+		ENGI_ASSERT(vertices && numVertices > 0 && indices && numIndices > 0 && "Geometry cannot be empty");
+		Entry entry;
+		entry.vertices = allocateFromArena(m_vertexArena, numVertices);
+		if (!entry.vertices.isValid())
+			return INVALID_ID;
+
+		entry.indices = allocateFromArena(m_indexArena, numIndices);
+		if (!entry.indices.isValid())
+		{
+			m_vertexArena.allocator.free(entry.vertices);
+			return INVALID_ID;
+		}
+
+		m_device->updateBuffer(m_vertexArena.buffer.get(), entry.vertices.offset * m_vertexArena.elementSize, vertices, numVertices * m_vertexArena.elementSize);
+		m_device->updateBuffer(m_indexArena.buffer.get(), entry.indices.offset * m_indexArena.elementSize, indices, numIndices * m_indexArena.elementSize);
+		return m_entries.insert(entry);
+	}
+
+	void GeometryPool::free(uint32_t id) noexcept
+	{
+		if (id == INVALID_ID || !m_entries.isOccupied(id))
+			return;
+
+		const Entry& entry = m_entries[id];
+		m_vertexArena.allocator.free(entry.vertices);
+		m_indexArena.allocator.free(entry.indices);
+		m_entries.erase(id);
+	}
+
+	void GeometryPool::defragment() noexcept
+	{
+		defragmentArena(m_vertexArena, &Entry::vertices);
+		defragmentArena(m_indexArena, &Entry::indices);
+	}
+
+	void GeometryPool::bind() const noexcept
+	{
+		ENGI_ASSERT(m_vertexArena.buffer && m_indexArena.buffer && "Geometry pool was not initialized");
+		m_device->setVertexBuffer(m_vertexArena.buffer.get(), 0, m_vertexArena.elementSize, 0);
+		m_device->setIndexBuffer(m_indexArena.buffer.get(), 0);
+	}
+
+	IGpuBuffer* GeometryPool::createArenaBuffer(const Arena& arena, uint32_t capacity) const noexcept
+	{
+		GpuBufferDesc desc;
+		desc.usage = GpuUsage::DEFAULT;
+		desc.bytes = capacity * arena.elementSize;
+		desc.pipelineFlags = arena.binding;
+		desc.cpuFlags = CpuAccess::ACCESS_UNUSED;
+		desc.byteStride = 0;
+		const char* suffix = (arena.binding == GpuBinding::VERTEX_BUFFER) ? "_Vertices" : "_Indices";
+		return m_device->createBuffer("GeometryPool_" + m_name + suffix, desc, nullptr);
+	}
+
+	OffsetAllocator::Allocation GeometryPool::allocateFromArena(Arena& arena, uint32_t numElements) noexcept
+	{
+		OffsetAllocator::Allocation allocation = arena.allocator.allocate(numElements);
+		if (allocation.isValid())
+			return allocation;
+
+		// Growing appends free space right after the last range, thus the allocation fits even if the end of the arena is used
+		uint32_t capacity = arena.allocator.getCapacity();
+		if (!growArena(arena, capacity + numElements))
+			return allocation;
+
+		return arena.allocator.allocate(numElements);
+	}
+
+	bool GeometryPool::growArena(Arena& arena, uint32_t minCapacity) noexcept
+	{
+		uint32_t oldCapacity = arena.allocator.getCapacity();
+		uint32_t newCapacity = std::max(minCapacity, oldCapacity * 2);
+		GpuHandle<IGpuBuffer> buffer = makeGpuHandle(createArenaBuffer(arena, newCapacity), m_device->getResourceAllocator());
+		if (!buffer)
+		{
+			ENGI_LOG_ERROR("Failed to grow arena of geometry pool {} to {} elements", m_name, newCapacity);
+			return false;
+		}
+
+		ENGI_LOG_INFO("Growing arena of geometry pool {} from {} to {} elements", m_name, oldCapacity, newCapacity);
+		m_device->copyBuffer(arena.buffer.get(), buffer.get(), 0);
+		arena.buffer = std::move(buffer);
+		arena.allocator.grow(newCapacity);
+		return true;
+	}
+
+	void GeometryPool::defragmentArena(Arena& arena, OffsetAllocator::Allocation Entry::* member) noexcept
+	{
+		std::vector<uint32_t> ids(m_entries.getAllIDs().begin(), m_entries.getAllIDs().end());
+		std::sort(ids.begin(), ids.end(), [&](uint32_t lhs, uint32_t rhs) { return (m_entries[lhs].*member).offset < (m_entries[rhs].*member).offset; });
+
+		uint32_t packedEnd = 0;
+		bool isPacked = true;
+		for (uint32_t id : ids)
+		{
+			const OffsetAllocator::Allocation& allocation = m_entries[id].*member;
+			isPacked = isPacked && (allocation.offset == packedEnd);
+			packedEnd += allocation.size;
+		}
+
+		if (isPacked)
+			return;
+
+		// Copies go to a fresh buffer, as source and destination regions of the same buffer may overlap
+		uint32_t capacity = arena.allocator.getCapacity();
+		GpuHandle<IGpuBuffer> buffer = makeGpuHandle(createArenaBuffer(arena, capacity), m_device->getResourceAllocator());
+		if (!buffer)
+		{
+			ENGI_LOG_ERROR("Failed to defragment arena of geometry pool {}", m_name);
+			return;
+		}
+
+		// Fresh allocator has a single free range, thus allocations in the order of offsets are packed one after another
+		arena.allocator.reset(capacity);
+		for (uint32_t id : ids)
+		{
+			OffsetAllocator::Allocation& allocation = m_entries[id].*member;
+			OffsetAllocator::Allocation packed = arena.allocator.allocate(allocation.size);
+			ENGI_ASSERT(packed.isValid() && "Defragmented ranges do not fit into the arena");
+			m_device->copyBufferRegion(arena.buffer.get(), allocation.offset * arena.elementSize, buffer.get(), packed.offset * arena.elementSize, allocation.size * arena.elementSize);
+			allocation = packed;
+		}
+
+		arena.buffer = std::move(buffer);
+	}
+
+}; // engi namespace
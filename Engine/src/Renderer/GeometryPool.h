@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include "GFX/GPUResourceAllocator.h"
+#include "Utility/OffsetAllocator.h"
+#include "Utility/SolidVector.h"
+#include "Renderer/StaticMesh.h"
+
+namespace engi
+{
+
+	namespace gfx
+	{
+		class IGpuDevice;
+		class IGpuBuffer;
+	}
+
+	struct GeometryRange
+	{
+		uint32_t baseVertex = 0;
+		uint32_t baseIndex = 0;
+	};
+
+	// Geometry pool is a single vertex buffer and a single index buffer that are shared by every model. Models suballocate
+	// their vertices and indices, thus the buffers are bound once per pass and draws of different models only differ in
+	// base vertex and start index. Arenas grow by reallocation and copy, freed ranges are reused and defragment() packs
+	// the live ranges together. Ranges move during growth and defragmentation, so owners keep the ID and query the range
+	class GeometryPool
+	{
+	public:
+		static constexpr uint32_t INVALID_ID = UINT32_MAX;
+
+		GeometryPool(const std::string& name, gfx::IGpuDevice* device);
+		GeometryPool(const GeometryPool&) = delete;
+		GeometryPool& operator=(const GeometryPool&) = delete;
+		~GeometryPool() = default;
+
+		bool init(uint32_t numVertices, uint32_t numIndices) noexcept;
+
+		// Returns INVALID_ID if arenas failed to grow
+		uint32_t allocate(const StaticMeshVertex* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numIndices) noexcept;
+		void free(uint32_t id) noexcept;
+
+		// Moves every live range to the beginning of the arenas, order of ranges is kept. Only GPU-side copies are made
+		void defragment() noexcept;
+
+		// Vertex arena is bound at slot 0
+		void bind() const noexcept;
+
+		inline GeometryRange getRange(uint32_t id) const noexcept { return GeometryRange{ m_entries[id].vertices.offset, m_entries[id].indices.offset }; }
+		inline uint32_t getNumVertices() const noexcept { return m_vertexArena.allocator.getCapacity() - m_vertexArena.allocator.getNumFreeUnits(); }
+		inline uint32_t getNumIndices() const noexcept { return m_indexArena.allocator.getCapacity() - m_indexArena.allocator.getNumFreeUnits(); }
+		inline uint32_t getVertexCapacity() const noexcept { return m_vertexArena.allocator.getCapacity(); }
+		inline uint32_t getIndexCapacity() const noexcept { return m_indexArena.allocator.getCapacity(); }
+
+	private:
+		struct Entry
+		{
+			OffsetAllocator::Allocation vertices;
+			OffsetAllocator::Allocation indices;
+		};
+
+		struct Arena
+		{
+			gfx::GpuHandle<gfx::IGpuBuffer> buffer = nullptr;
+			OffsetAllocator allocator;
+			uint32_t elementSize = 0;
+			uint32_t binding = 0;
+		};
+
+		gfx::IGpuBuffer* createArenaBuffer(const Arena& arena, uint32_t capacity) const noexcept;
+		OffsetAllocator::Allocation allocateFromArena(Arena& arena, uint32_t numElements) noexcept;
+		bool growArena(Arena& arena, uint32_t minCapacity) noexcept;
+		void defragmentArena(Arena& arena, OffsetAllocator::Allocation Entry::* member) noexcept;
+
+		std::string m_name;
+		gfx::IGpuDevice* m_device;
+		Arena m_vertexArena;
+		Arena m_indexArena;
+		SolidVector<Entry> m_entries;
+	};
+
+}; // engi namespace
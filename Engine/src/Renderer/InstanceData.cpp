@@ -1,39 +1,99 @@
 #include "Renderer/InstanceData.h"
 
+#include <DirectXPackedVector.h>
+
 namespace engi
 {
 	InstanceData::InstanceData(const math::Transformation& transform, const math::Vec3& color, const math::Vec3& emission, float emissionPow)
 		: modelToWorld(math::Mat4x4::toWorld(transform.translation, transform.rotation, transform.scale))
 		, worldToModel(this->modelToWorld.inverse())
 		, color(color)
-		, time(0.0f)
+		, spawnTime(0.0f)
+		, timeRate(1.0f)
 		, emission(emission)
 		, emissionPower(emissionPow)
 		, instanceID(uint32_t(-1))
 	{
 	}
 
-	std::array<gfx::GpuInputAttributeDesc, 16> InstanceData::getInputAttributes(uint32_t inputSlot) noexcept
+	std::array<gfx::GpuInputAttributeDesc, 5> GpuInstanceData::getInputAttributes(uint32_t inputSlot) noexcept
+	{
+		using namespace gfx;
+		std::array<GpuInputAttributeDesc, 5> attributes;
+		attributes[0] = gfx::GpuInputAttributeDesc("MODEL_TO_WORLD", 0, GpuFormat::RGBA32F, inputSlot, false, offsetof(GpuInstanceData, modelToWorldColumns) + 0);
+		attributes[1] = gfx::GpuInputAttributeDesc("MODEL_TO_WORLD", 1, GpuFormat::RGBA32F, inputSlot, false, offsetof(GpuInstanceData, modelToWorldColumns) + 16);
+		attributes[2] = gfx::GpuInputAttributeDesc("MODEL_TO_WORLD", 2, GpuFormat::RGBA32F, inputSlot, false, offsetof(GpuInstanceData, modelToWorldColumns) + 32);
+		attributes[3] = gfx::GpuInputAttributeDesc("INSTANCE_COLOR", 0, GpuFormat::RGBA16F, inputSlot, false, offsetof(GpuInstanceData, color));
+		attributes[4] = gfx::GpuInputAttributeDesc("INSTANCE_EMISSION", 0, GpuFormat::RGBA16F, inputSlot, false, offsetof(GpuInstanceData, emission));
+		return attributes;
+	}
+
+	GpuInstanceData GpuInstanceData::pack(const InstanceData& data) noexcept
+	{
+		using namespace DirectX::PackedVector;
+
+		GpuInstanceData result;
+		const math::Mat4x4& m = data.modelToWorld;
+		result.modelToWorldColumns[0] = math::Vec4(m._11, m._21, m._31, m._41);
+		result.modelToWorldColumns[1] = math::Vec4(m._12, m._22, m._32, m._42);
+		result.modelToWorldColumns[2] = math::Vec4(m._13, m._23, m._33, m._43);
+		result.color[0] = XMConvertFloatToHalf(data.color.x);
+		result.color[1] = XMConvertFloatToHalf(data.color.y);
+		result.color[2] = XMConvertFloatToHalf(data.color.z);
+		result.color[3] = XMConvertFloatToHalf(1.0f);
+		result.emission[0] = XMConvertFloatToHalf(data.emission.x);
+		result.emission[1] = XMConvertFloatToHalf(data.emission.y);
+		result.emission[2] = XMConvertFloatToHalf(data.emission.z);
+		result.emission[3] = XMConvertFloatToHalf(data.emissionPower);
+		return result;
+	}
+
+	void GpuInstanceData::unpack(InstanceData& data) const noexcept
+	{
+		using namespace DirectX::PackedVector;
+
+		const math::Vec4* c = modelToWorldColumns;
+		data.modelToWorld = math::Mat4x4(
+			c[0].x, c[1].x, c[2].x, 0.0f,
+			c[0].y, c[1].y, c[2].y, 0.0f,
+			c[0].z, c[1].z, c[2].z, 0.0f,
+			c[0].w, c[1].w, c[2].w, 1.0f);
+		data.worldToModel = data.modelToWorld.inverse();
+		data.color = math::Vec3(XMConvertHalfToFloat(color[0]), XMConvertHalfToFloat(color[1]), XMConvertHalfToFloat(color[2]));
+		data.emission = math::Vec3(XMConvertHalfToFloat(emission[0]), XMConvertHalfToFloat(emission[1]), XMConvertHalfToFloat(emission[2]));
+		data.emissionPower = XMConvertHalfToFloat(emission[3]);
+	}
+
+	std::array<gfx::GpuInputAttributeDesc, 5> GpuInstanceAnimation::getInputAttributes(uint32_t inputSlot) noexcept
 	{
 		using namespace gfx;
-		std::array<GpuInputAttributeDesc, 16> attributes;
-		attributes[0] = gfx::GpuInputAttributeDesc("MODEL_TO_WORLD", 0, GpuFormat::RGBA32F, inputSlot, false, offsetof(InstanceData, modelToWorld) + 0);
-		attributes[1] = gfx::GpuInputAttributeDesc("MODEL_TO_WORLD", 1, GpuFormat::RGBA32F, inputSlot, false, offsetof(InstanceData, modelToWorld) + 16);
-		attributes[2] = gfx::GpuInputAttributeDesc("MODEL_TO_WORLD", 2, GpuFormat::RGBA32F, inputSlot, false, offsetof(InstanceData, modelToWorld) + 32);
-		attributes[3] = gfx::GpuInputAttributeDesc("MODEL_TO_WORLD", 3, GpuFormat::RGBA32F, inputSlot, false, offsetof(InstanceData, modelToWorld) + 48);
-		attributes[4] = gfx::GpuInputAttributeDesc("WORLD_TO_MODEL", 0, GpuFormat::RGBA32F, inputSlot, false, offsetof(InstanceData, worldToModel) + 0);
-		attributes[5] = gfx::GpuInputAttributeDesc("WORLD_TO_MODEL", 1, GpuFormat::RGBA32F, inputSlot, false, offsetof(InstanceData, worldToModel) + 16);
-		attributes[6] = gfx::GpuInputAttributeDesc("WORLD_TO_MODEL", 2, GpuFormat::RGBA32F, inputSlot, false, offsetof(InstanceData, worldToModel) + 32);
-		attributes[7] = gfx::GpuInputAttributeDesc("WORLD_TO_MODEL", 3, GpuFormat::RGBA32F, inputSlot, false, offsetof(InstanceData, worldToModel) + 48);
-		attributes[8] = gfx::GpuInputAttributeDesc("INSTANCE_COLOR", 0, GpuFormat::RGB32F, inputSlot, false, offsetof(InstanceData, color));
-		attributes[9] = gfx::GpuInputAttributeDesc("INSTANCE_TIME", 0, GpuFormat::R32F, inputSlot, false, offsetof(InstanceData, time));
-		attributes[10] = gfx::GpuInputAttributeDesc("INSTANCE_TIMESTEP", 0, GpuFormat::R32F, inputSlot, false, offsetof(InstanceData, timestep));
-		attributes[11] = gfx::GpuInputAttributeDesc("INSTANCE_EMISSION", 0, GpuFormat::RGB32F, inputSlot, false, offsetof(InstanceData, emission));
-		attributes[12] = gfx::GpuInputAttributeDesc("INSTANCE_EMISSION_POW", 0, GpuFormat::R32F, inputSlot, false, offsetof(InstanceData, emissionPower));
-		attributes[13] = gfx::GpuInputAttributeDesc("INSTANCE_SPHERE_ORIGIN", 0, GpuFormat::RGB32F, inputSlot, false, offsetof(InstanceData, sphereOrigin));
-		attributes[14] = gfx::GpuInputAttributeDesc("INSTANCE_SPHERE_RADIUS_MAX", 0, GpuFormat::R32F, inputSlot, false, offsetof(InstanceData, sphereRadiusMax));
-		attributes[15] = gfx::GpuInputAttributeDesc("INSTANCE_ID", 0, GpuFormat::R32U, inputSlot, false, offsetof(InstanceData, instanceID));
+		std::array<GpuInputAttributeDesc, 5> attributes;
+		attributes[0] = gfx::GpuInputAttributeDesc("INSTANCE_SPHERE_ORIGIN", 0, GpuFormat::RGB32F, inputSlot, false, offsetof(GpuInstanceAnimation, sphereOrigin));
+		attributes[1] = gfx::GpuInputAttributeDesc("INSTANCE_SPHERE_RADIUS_MAX", 0, GpuFormat::R32F, inputSlot, false, offsetof(GpuInstanceAnimation, sphereRadiusMax));
+		attributes[2] = gfx::GpuInputAttributeDesc("INSTANCE_SPAWN_TIME", 0, GpuFormat::R32F, inputSlot, false, offsetof(GpuInstanceAnimation, spawnTime));
+		attributes[3] = gfx::GpuInputAttributeDesc("INSTANCE_TIME_RATE", 0, GpuFormat::R32F, inputSlot, false, offsetof(GpuInstanceAnimation, timeRate));
+		attributes[4] = gfx::GpuInputAttributeDesc("INSTANCE_ID", 0, GpuFormat::R32U, inputSlot, false, offsetof(GpuInstanceAnimation, instanceID));
 		return attributes;
 	}
 
-}; // engi namespace
\ No newline at end of file
+	GpuInstanceAnimation GpuInstanceAnimation::pack(const InstanceData& data) noexcept
+	{
+		GpuInstanceAnimation result;
+		result.sphereOrigin = data.sphereOrigin;
+		result.sphereRadiusMax = data.sphereRadiusMax;
+		result.spawnTime = data.spawnTime;
+		result.timeRate = data.timeRate;
+		result.instanceID = data.instanceID;
+		return result;
+	}
+
+	void GpuInstanceAnimation::unpack(InstanceData& data) const noexcept
+	{
+		data.sphereOrigin = sphereOrigin;
+		data.sphereRadiusMax = sphereRadiusMax;
+		data.spawnTime = spawnTime;
+		data.timeRate = timeRate;
+		data.instanceID = instanceID;
+	}
+
+}; // engi namespace
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <algorithm>
 #include "Math/Math.h"
 #include "GFX/Definitions.h"
 
@@ -12,14 +13,13 @@ namespace engi
 		InstanceData() = default;
 		InstanceData(const math::Transformation& transform, const math::Vec3& color = math::Vec3(), const math::Vec3& emission = math::Vec3(), float emissionPow = 0.0f);
 
-		static std::array<gfx::GpuInputAttributeDesc, 16> getInputAttributes(uint32_t inputSlot) noexcept;
-
 		math::Mat4x4 modelToWorld = math::Mat4x4();
 		math::Mat4x4 worldToModel = math::Mat4x4();
 		math::Vec3 color = math::Vec3();
 
-		float time = 0.0f;
-		float timestep = 0.0f; // timestep added to time at the current frame
+		// Instance time is derived from the scene time, so that it does not have to be advanced (and reuploaded) every frame
+		float spawnTime = 0.0f; // scene time the instance time is counted from
+		float timeRate = 1.0f;
 
 		math::Vec3 emission = math::Vec3();
 		float emissionPower = 0.0f;
@@ -28,6 +28,47 @@ namespace engi
 		float sphereRadiusMax = 0.0f;
 
 		uint32_t instanceID = uint32_t(-1);
+
+		// Same as getInstanceTime() of shaders, never negative
+		inline float getTime(float sceneTime) const noexcept { return std::max(0.0f, (sceneTime - spawnTime) * timeRate); }
+	};
+
+	// Instance as it is stored in the GPU instance buffer. InstanceData is too heavy to be uploaded as it is, thus only the first three columns
+	// of modelToWorld are stored (the last one of an affine transform is always (0, 0, 0, 1)) and shaders reconstruct the matrix with getModelToWorld().
+	// worldToModel is not needed by shaders. Color, emission and its power are stored as halfs, so HDR colors are kept
+	struct alignas(16) GpuInstanceData
+	{
+		static std::array<gfx::GpuInputAttributeDesc, 5> getInputAttributes(uint32_t inputSlot) noexcept;
+
+		static GpuInstanceData pack(const InstanceData& data) noexcept;
+
+		// Restores modelToWorld, worldToModel, color, emission and emissionPower of the instance
+		void unpack(InstanceData& data) const noexcept;
+
+		math::Vec4 modelToWorldColumns[3];
+		uint16_t color[4]; // half-precision RGB, alpha is unused
+		uint16_t emission[4]; // half-precision RGB and emission power
+	};
+	static_assert(sizeof(GpuInstanceData) == 64);
+
+	// Fields only used by animated materials (dissolution, incineration). They are uploaded as a separate stream and only change
+	// when an animation is restarted, so that moving an instance does not reupload them and vice versa. instanceID is stored here as well,
+	// as it never changes after the instance is added
+	struct GpuInstanceAnimation
+	{
+		static std::array<gfx::GpuInputAttributeDesc, 5> getInputAttributes(uint32_t inputSlot) noexcept;
+
+		static GpuInstanceAnimation pack(const InstanceData& data) noexcept;
+
+		// Restores spawnTime, timeRate, sphereOrigin, sphereRadiusMax and instanceID of the instance
+		void unpack(InstanceData& data) const noexcept;
+
+		math::Vec3 sphereOrigin;
+		float sphereRadiusMax;
+		float spawnTime;
+		float timeRate;
+		uint32_t instanceID;
 	};
+	static_assert(sizeof(GpuInstanceAnimation) == 28);
 
 }; // engi namespace
\ No newline at end of file
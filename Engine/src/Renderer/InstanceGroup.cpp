@@ -0,0 +1,145 @@
+#include "Renderer/InstanceGroup.h"
+
+#include <algorithm>
+#include "Core/CommonDefinitions.h"
+#include "Utility/RadixSort.h"
+
+namespace engi
+{
+
+	namespace
+	{
+
+		inline math::AABB combine(const math::AABB& a, const math::AABB& b) noexcept
+		{
+			return math::AABB(math::Vec3::min(a.min, b.min), math::Vec3::max(a.max, b.max));
+		}
+
+		// Spreads 10 lower bits of the value, so that there are two zero bits between each of them
+		uint32_t expandBits(uint32_t value) noexcept
+		{
+			value &= 0x3ff;
+			value = (value | (value << 16)) & 0x030000ff;
+			value = (value | (value << 8)) & 0x0300f00f;
+			value = (value | (value << 4)) & 0x030c30c3;
+			value = (value | (value << 2)) & 0x09249249;
+			return value;
+		}
+
+		// 30-bit Morton code of the point within the bounds, close points mostly get close codes
+		uint32_t getMortonCode(const math::Vec3& point, const math::AABB& bounds) noexcept
+		{
+			math::Vec3 extent = bounds.max - bounds.min;
+			auto quantize = [](float value, float min, float extent) -> uint32_t
+				{
+					float normalized = (extent > 0.0f) ? (value - min) / extent : 0.0f;
+					return static_cast<uint32_t>(math::clamp(normalized, 0.0f, 1.0f) * 1023.0f);
+				};
+
+			return (expandBits(quantize(point.x, bounds.min.x, extent.x)) << 2)
+				| (expandBits(quantize(point.y, bounds.min.y, extent.y)) << 1)
+				| expandBits(quantize(point.z, bounds.min.z, extent.z));
+		}
+
+	}; // anonymous namespace
+
+	InstanceGroup::InstanceGroup(const SharedHandle<Model>& model)
+		: m_model(model)
+	{
+		ENGI_ASSERT(model && model->getNumStaticMeshes() > 0 && "Weird model");
+
+		// Clusters are culled for every mesh of the model at once, thus their bounds enclose the whole model
+		const auto& meshEntries = model->getStaticMeshEntries();
+		m_modelAABB = meshEntries[0].mesh.getAABB().applyMatrix(meshEntries[0].mesh.getMeshToModel());
+		for (const auto& entry : meshEntries)
+			m_modelAABB = combine(m_modelAABB, entry.mesh.getAABB().applyMatrix(entry.mesh.getMeshToModel()));
+	}
+
+	void InstanceGroup::setInstances(ArrayView<const math::Transformation> transforms) noexcept
+	{
+		uint32_t numInstances = static_cast<uint32_t>(transforms.size());
+		m_translations.clear();
+		m_rotations.clear();
+		m_scales.clear();
+		m_clusters.clear();
+		if (numInstances == 0)
+			return;
+
+		math::AABB bounds(transforms[0].translation, transforms[0].translation);
+		for (const math::Transformation& transform : transforms)
+		{
+			bounds.min = math::Vec3::min(bounds.min, transform.translation);
+			bounds.max = math::Vec3::max(bounds.max, transform.translation);
+		}
+
+		// Instances are sorted along the Morton curve, thus consecutive instances are close to each other and form compact clusters.
+		// Code goes to the high half of the key and the index to the low one
+		std::vector<uint64_t> keys(numInstances);
+		std::vector<uint64_t> scratch;
+		for (uint32_t i = 0; i < numInstances; ++i)
+			keys[i] = (static_cast<uint64_t>(getMortonCode(transforms[i].translation, bounds)) << 32) | i;
+		radixSort(keys, scratch, [](uint64_t key) { return key; });
+
+		m_translations.reserve(numInstances);
+		m_rotations.reserve(numInstances);
+		m_scales.reserve(numInstances);
+		for (uint64_t key : keys)
+		{
+			const math::Transformation& transform = transforms[static_cast<uint32_t>(key)];
+			m_translations.push_back(transform.translation);
+			m_rotations.push_back(transform.rotation);
+			m_scales.push_back(transform.scale);
+		}
+
+		m_clusters.reserve((numInstances + CLUSTER_SIZE - 1) / CLUSTER_SIZE);
+		for (uint32_t first = 0; first < numInstances; first += CLUSTER_SIZE)
+		{
+			Cluster& cluster = m_clusters.emplace_back(Cluster{ first, std::min(CLUSTER_SIZE, numInstances - first), math::AABB() });
+			updateClusterBounds(cluster);
+		}
+	}
+
+	void InstanceGroup::setTransformation(uint32_t index, const math::Transformation& transform) noexcept
+	{
+		ENGI_ASSERT(index < getNumInstances() && "Invalid index provided");
+		m_translations[index] = transform.translation;
+		m_rotations[index] = transform.rotation;
+		m_scales[index] = transform.scale;
+		updateClusterBounds(m_clusters[index / CLUSTER_SIZE]);
+	}
+
+	math::Transformation InstanceGroup::getTransformation(uint32_t index) const noexcept
+	{
+		ENGI_ASSERT(index < getNumInstances() && "Invalid index provided");
+
+		// Rotation is already in radians, thus it is not passed to the constructor
+		math::Transformation transform(m_translations[index], math::Vec3(0.0f), m_scales[index]);
+		transform.rotation = m_rotations[index];
+		return transform;
+	}
+
+	void InstanceGroup::packInstances(GpuInstanceData* instances, uint32_t first, uint32_t count) const noexcept
+	{
+		ENGI_ASSERT(first + count <= getNumInstances() && "Invalid range provided");
+		InstanceData data;
+		data.color = m_color;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			data.modelToWorld = getModelToWorld(first + i);
+			instances[i] = GpuInstanceData::pack(data);
+		}
+	}
+
+	math::Mat4x4 InstanceGroup::getModelToWorld(uint32_t index) const noexcept
+	{
+		return math::Mat4x4::toWorld(m_translations[index], m_rotations[index], m_scales[index]);
+	}
+
+	void InstanceGroup::updateClusterBounds(Cluster& cluster) const noexcept
+	{
+		cluster.worldAABB = m_modelAABB.applyMatrix(getModelToWorld(cluster.first));
+		for (uint32_t i = cluster.first + 1; i < cluster.first + cluster.count; ++i)
+			cluster.worldAABB = combine(cluster.worldAABB, m_modelAABB.applyMatrix(getModelToWorld(i)));
+	}
+
+}; // engi namespace
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+#include "Math/Math.h"
+#include "Utility/Memory.h"
+#include "Utility/ArrayView.h"
+#include "Renderer/Model.h"
+#include "Renderer/InstanceData.h"
+
+namespace engi
+{
+
+	// Lightweight alternative to ModelInstance for large amounts of identical props (foliage, rocks, crowds). Instances of the group only
+	// have a transformation, stored in packed arrays (SoA), and share the color of the group. They have no InstanceTable entries, cannot be
+	// picked and do not own lights or emitters. Instances are sorted spatially and split into clusters that are culled as a whole.
+	// Group itself does not touch the GPU, MeshManager uploads its instances as a single contiguous range
+	class InstanceGroup
+	{
+	public:
+		static constexpr uint32_t CLUSTER_SIZE = 64;
+
+		// Contiguous run of spatially close instances
+		struct Cluster
+		{
+			uint32_t first;
+			uint32_t count;
+			math::AABB worldAABB;
+		};
+
+		InstanceGroup(const SharedHandle<Model>& model);
+		InstanceGroup(const InstanceGroup&) = delete;
+		InstanceGroup& operator=(const InstanceGroup&) = delete;
+		~InstanceGroup() = default;
+
+		// Replaces every instance of the group. Instances are reordered to build clusters, thus indices do not match the order of transforms
+		void setInstances(ArrayView<const math::Transformation> transforms) noexcept;
+
+		// Only bounds of the instance's cluster are updated, clusters are not rebuilt. Changes are uploaded after MeshManager::updateInstanceGroup()
+		void setTransformation(uint32_t index, const math::Transformation& transform) noexcept;
+		math::Transformation getTransformation(uint32_t index) const noexcept;
+
+		inline void setColor(const math::Vec3& color) noexcept { m_color = color; }
+		inline const math::Vec3& getColor() const noexcept { return m_color; }
+
+		// Packs count instances starting from the first one, in the format of the instance buffer streams
+		void packInstances(GpuInstanceData* instances, uint32_t first, uint32_t count) const noexcept;
+
+		inline const SharedHandle<Model>& getModel() const noexcept { return m_model; }
+		inline const math::AABB& getModelAABB() const noexcept { return m_modelAABB; }
+		inline uint32_t getNumInstances() const noexcept { return static_cast<uint32_t>(m_translations.size()); }
+		inline uint32_t getNumClusters() const noexcept { return static_cast<uint32_t>(m_clusters.size()); }
+		inline const auto& getClusters() const noexcept { return m_clusters; }
+
+	private:
+		math::Mat4x4 getModelToWorld(uint32_t index) const noexcept;
+		void updateClusterBounds(Cluster& cluster) const noexcept;
+
+		SharedHandle<Model> m_model;
+		math::AABB m_modelAABB;
+		math::Vec3 m_color = math::Vec3();
+		std::vector<math::Vec3> m_translations;
+		std::vector<math::Vec3> m_rotations; // in radians
+		std::vector<math::Vec3> m_scales;
+		std::vector<Cluster> m_clusters;
+	};
+
+}; // engi namespace
@@ -1,26 +1,105 @@
 #pragma once
 
+#include <vector>
 #include "Utility/SolidVector.h"
 #include "Renderer/InstanceData.h"
 
 namespace engi
 {
 
+	// Static instances are expected to change rarely, MeshManager keeps them in device-local buffers and uploads only what has changed.
+	// Dynamic instances are restreamed as a whole whenever any of them changes, which is cheaper for the few instances that move every frame
+	enum InstanceMobility : uint8_t
+	{
+		INSTANCE_MOBILITY_STATIC = 0,
+		INSTANCE_MOBILITY_DYNAMIC,
+	};
+
+	// Every non-const access to an instance marks it as dirty, so that consumers (MeshManager) may re-upload only modified instances.
+	// Read-only users should access the table through a const reference to avoid needless uploads
 	class InstanceTable
 	{
 	public:
 		InstanceTable() = default;
 		~InstanceTable() = default;
 
-		uint32_t addInstanceData(const InstanceData& data) noexcept { return m_instanceData.insert(data); }
-		void removeInstanceData(uint32_t id) noexcept { m_instanceData.erase(id); }
-		InstanceData& getInstanceData(uint32_t id) noexcept { return m_instanceData[id]; }
+		uint32_t addInstanceData(const InstanceData& data, InstanceMobility mobility = INSTANCE_MOBILITY_STATIC) noexcept;
+		void removeInstanceData(uint32_t id) noexcept { m_instanceData.erase(id); m_mobility[id] = INSTANCE_MOBILITY_STATIC; }
+		InstanceData& getInstanceData(uint32_t id) noexcept { markDirty(id); return m_instanceData[id]; }
+		const InstanceData& getInstanceData(uint32_t id) const noexcept { return m_instanceData[id]; }
 		bool isOccupied(uint32_t id) const noexcept { return m_instanceData.isOccupied(id); }
-		auto& getAllInstanceData() noexcept { return m_instanceData; }
+		uint32_t getNumInstances() const noexcept { return m_instanceData.size(); }
+		void reserve(uint32_t numInstances) noexcept { m_instanceData.reserve(numInstances); m_dirtyIDs.reserve(numInstances); }
 		auto& getAllInstanceData() const noexcept { return m_instanceData; }
 
+		// Bulk access to all of the instances, they are all treated as dirty
+		auto& getAllInstanceData() noexcept { markAllDirty(); return m_instanceData; }
+
+		// Changing mobility moves the instance to another buffer, thus it is meant for rare changes (e.g. while an instance is dragged)
+		InstanceMobility getMobility(uint32_t id) const noexcept { return m_mobility[id]; }
+		void setMobility(uint32_t id, InstanceMobility mobility) noexcept;
+		uint32_t getMobilityVersion() const noexcept { return m_mobilityVersion; } // changes whenever mobility of an instance changes
+
+		void markDirty(uint32_t id) noexcept;
+		void markAllDirty() noexcept { m_allDirty = true; }
+		bool isAllDirty() const noexcept { return m_allDirty; }
+		const auto& getDirtyIDs() const noexcept { return m_dirtyIDs; }
+		bool hasDirtyData() const noexcept { return m_allDirty || !m_dirtyIDs.empty(); }
+		void clearDirty() noexcept;
+
 	private:
 		SolidVector<InstanceData> m_instanceData;
+		std::vector<uint32_t> m_dirtyIDs;
+		std::vector<bool> m_isDirty;
+		bool m_allDirty = false;
+		std::vector<InstanceMobility> m_mobility;
+		uint32_t m_mobilityVersion = 0;
 	};
 
+	inline uint32_t InstanceTable::addInstanceData(const InstanceData& data, InstanceMobility mobility) noexcept
+	{
+		uint32_t id = m_instanceData.insert(data);
+		if (id >= m_mobility.size())
+			m_mobility.resize(static_cast<size_t>(id) + 1, INSTANCE_MOBILITY_STATIC);
+
+		m_mobility[id] = mobility;
+		markDirty(id);
+		return id;
+	}
+
+	inline void InstanceTable::setMobility(uint32_t id, InstanceMobility mobility) noexcept
+	{
+		ENGI_ASSERT(m_instanceData.isOccupied(id) && "Instance does not exist");
+		if (m_mobility[id] == mobility)
+			return;
+
+		m_mobility[id] = mobility;
+		++m_mobilityVersion;
+		markDirty(id);
+	}
+
+	inline void InstanceTable::markDirty(uint32_t id) noexcept
+	{
+		if (m_allDirty)
+			return;
+
+		if (id >= m_isDirty.size())
+			m_isDirty.resize(static_cast<size_t>(id) + 1, false);
+
+		if (m_isDirty[id])
+			return;
+
+		m_isDirty[id] = true;
+		m_dirtyIDs.push_back(id);
+	}
+
+	inline void InstanceTable::clearDirty() noexcept
+	{
+		for (uint32_t id : m_dirtyIDs)
+			m_isDirty[id] = false;
+
+		m_dirtyIDs.clear();
+		m_allDirty = false;
+	}
+
 }; // engi namespace
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include "GFX/GPUDevice.h"
+#include "Utility/Hash.h"
 #include "Renderer/Texture2D.h"
 #include "Renderer/TextureCube.h"
 
@@ -74,4 +75,25 @@ namespace engi
 		return true;
 	}
 
+	uint64_t MaterialInstance::getHash() const noexcept
+	{
+		const Material* material = m_material.get();
+		uint64_t hash = hashBytes(&material, sizeof(material));
+
+		// operator== compares the values as floats, thus both zeros have to produce the same hash
+		const float roughness = (m_materialData.roughness == 0.0f) ? 0.0f : m_materialData.roughness;
+		const float metallic = (m_materialData.metallic == 0.0f) ? 0.0f : m_materialData.metallic;
+		hash = hashBytes(&roughness, sizeof(float), hash);
+		hash = hashBytes(&metallic, sizeof(float), hash);
+
+		const bool isUsed[] = { m_materialData.useAlbedoTexture, m_materialData.useNormalMap, m_materialData.useMetalnessMap, m_materialData.useRoughnessMap };
+		for (size_t i = 0; i < m_textures.size(); ++i)
+		{
+			const Texture2D* texture = isUsed[i] ? m_textures[i] : nullptr;
+			hash = hashBytes(&isUsed[i], sizeof(bool), hash);
+			hash = hashBytes(&texture, sizeof(texture), hash);
+		}
+		return hash;
+	}
+
 }; // engi namespace
\ No newline at end of file
@@ -57,6 +57,9 @@ namespace engi
 		void bindTexture(TextureType type, uint32_t slot, uint32_t shaderTypes) const noexcept;
 		bool operator==(const MaterialInstance& other) const noexcept;
 
+		// Consistent with operator==, textures that are not used do not affect the hash
+		uint64_t getHash() const noexcept;
+
 	private:
 		std::string m_name;
 		std::array<Texture2D*, 4> m_textures{};
@@ -64,4 +67,9 @@ namespace engi
 		MaterialConstant m_materialData;
 	};
 
+	struct MaterialInstanceHasher
+	{
+		size_t operator()(const MaterialInstance& materialInstance) const noexcept { return static_cast<size_t>(materialInstance.getHash()); }
+	};
+
 }; // engi namespace
\ No newline at end of file
@@ -53,7 +53,7 @@ namespace engi
 		ShaderProgram* shader = library->createProgram(shadername, geometry, tesselation, true);
 		
 		ENGI_ASSERT(shader);
-		shader->setAttributeLayout(MeshManager::getInputAttributes(0, 1));
+		shader->setAttributeLayout(MeshManager::getInputAttributes(0, 1, 3));
 
 		return shader;
 	}
@@ -0,0 +1,325 @@
+#include "Renderer/MeshCache.h"
+
+#include <cstring>
+#include <format>
+#include <type_traits>
+#include "Core/CommonDefinitions.h"
+#include "Core/FileSystem.h"
+#include "Core/Logger.h"
+#include "Utility/Hash.h"
+#include "Utility/MappedFile.h"
+
+namespace engi
+{
+
+	namespace
+	{
+
+		struct FileHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t packetWidth; // BVH packets depend on the SIMD width of the build
+			uint32_t numMeshes;
+			uint64_t sourceSize;
+			int64_t sourceWriteTime;
+			uint64_t payloadSize;
+			uint64_t checksum; // of the payload, which follows the header
+		};
+
+		struct MeshHeader
+		{
+			uint32_t numVertices;
+			uint32_t numTriangles;
+			uint32_t numNodes;
+			uint32_t numPackets;
+			uint32_t flags;
+			uint32_t twoSided;
+			float roughness;
+			float metallic;
+			MeshRange range;
+			math::Vec3 aabbMin;
+			math::Vec3 aabbMax;
+			math::Mat4x4 meshToModel;
+			math::Mat4x4 modelToMesh;
+			uint32_t nameLength;
+			uint32_t materialNameLength;
+			std::array<uint32_t, 4> texturePathLengths;
+		};
+
+		// Arrays are aligned relative to the beginning of the file, mapped views are page-aligned, thus BVH nodes and packets
+		// may be read in place
+		static constexpr size_t ARRAY_ALIGNMENT = 32;
+
+		class CookWriter
+		{
+		public:
+			template<typename T>
+			void write(const T& value) noexcept { writeBytes(&value, sizeof(T)); }
+
+			template<typename T>
+			void writeArray(const T* values, size_t count) noexcept
+			{
+				static_assert(std::is_trivially_copyable_v<T>);
+				align();
+				writeBytes(values, sizeof(T) * count);
+			}
+
+			void writeString(const std::string& str) noexcept { writeBytes(str.data(), str.size()); }
+
+			void align() noexcept { m_bytes.resize((m_bytes.size() + ARRAY_ALIGNMENT - 1) & ~(ARRAY_ALIGNMENT - 1), 0); }
+
+			std::vector<uint8_t>& getBytes() noexcept { return m_bytes; }
+
+		private:
+			void writeBytes(const void* data, size_t size) noexcept
+			{
+				size_t offset = m_bytes.size();
+				m_bytes.resize(offset + size);
+				if (size > 0)
+					std::memcpy(m_bytes.data() + offset, data, size);
+			}
+
+			std::vector<uint8_t> m_bytes;
+		};
+
+		class CookReader
+		{
+		public:
+			CookReader(const uint8_t* data, uint64_t size, uint64_t offset)
+				: m_data(data)
+				, m_size(size)
+				, m_offset(offset)
+			{
+			}
+
+			template<typename T>
+			bool read(T& value) noexcept
+			{
+				if (!canRead(sizeof(T)))
+					return false;
+
+				std::memcpy(&value, m_data + m_offset, sizeof(T));
+				m_offset += sizeof(T);
+				return true;
+			}
+
+			// Returns a pointer into the mapped memory or nullptr if the file is truncated
+			template<typename T>
+			const T* readArray(size_t count) noexcept
+			{
+				m_offset = (m_offset + ARRAY_ALIGNMENT - 1) & ~(uint64_t(ARRAY_ALIGNMENT) - 1);
+				if (!canRead(sizeof(T) * count))
+					return nullptr;
+
+				const T* values = reinterpret_cast<const T*>(m_data + m_offset);
+				m_offset += sizeof(T) * count;
+				return values;
+			}
+
+			bool readString(std::string& str, uint32_t length) noexcept
+			{
+				if (!canRead(length))
+					return false;
+
+				str.assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+				m_offset += length;
+				return true;
+			}
+
+		private:
+			inline bool canRead(uint64_t size) const noexcept { return m_offset <= m_size && size <= m_size - m_offset; }
+
+			const uint8_t* m_data;
+			uint64_t m_size;
+			uint64_t m_offset;
+		};
+
+		bool getSourceStamp(const std::filesystem::path& sourcePath, uint64_t& size, int64_t& writeTime) noexcept
+		{
+			std::error_code error;
+			size = static_cast<uint64_t>(std::filesystem::file_size(sourcePath, error));
+			if (error)
+				return false;
+
+			std::filesystem::file_time_type time = std::filesystem::last_write_time(sourcePath, error);
+			if (error)
+				return false;
+
+			writeTime = static_cast<int64_t>(time.time_since_epoch().count());
+			return true;
+		}
+
+		uint8_t getMeshFlags(const StaticMesh& mesh) noexcept
+		{
+			uint8_t flags = STATIC_MESH_FLAGS_NONE;
+			if (mesh.hasNormals())
+				flags |= STATIC_MESH_FLAGS_NORMALS;
+			if (mesh.hasTexCoords())
+				flags |= STATIC_MESH_FLAGS_TEX_COORDS;
+			if (mesh.hasTangents())
+				flags |= STATIC_MESH_FLAGS_TANGENTS;
+			return flags;
+		}
+
+	}; // anonymous namespace
+
+	std::filesystem::path MeshCache::getCookedPath(const std::filesystem::path& sourcePath) noexcept
+	{
+		// Name includes the hash of the full path, so that assets with equal names from different folders do not collide
+		std::string fullpath = std::filesystem::absolute(sourcePath).generic_string();
+		std::string filename = std::format("{}_{:016x}.engimesh", sourcePath.stem().string(), hashString(fullpath));
+		return FileSystem::getInstance().getCachePath() / "Models" / filename;
+	}
+
+	bool MeshCache::load(const std::filesystem::path& sourcePath, CookedModel& cookedModel) noexcept
+	{
+		cookedModel.entries.clear();
+		cookedModel.materials.clear();
+
+		uint64_t sourceSize = 0;
+		int64_t sourceWriteTime = 0;
+		if (!getSourceStamp(sourcePath, sourceSize, sourceWriteTime))
+			return false;
+
+		std::filesystem::path cookedPath = getCookedPath(sourcePath);
+		MappedFile file;
+		if (!file.open(cookedPath) || file.getSize() < sizeof(FileHeader))
+			return false;
+
+		FileHeader header;
+		std::memcpy(&header, file.getData(), sizeof(FileHeader));
+		if (header.magic != MAGIC || header.version != VERSION || header.packetWidth != math::TrianglePacketN::WIDTH)
+		{
+			ENGI_LOG_INFO("Cooked mesh {} was made by a different build, it will be recooked", cookedPath.string());
+			return false;
+		}
+
+		if (header.sourceSize != sourceSize || header.sourceWriteTime != sourceWriteTime)
+		{
+			ENGI_LOG_INFO("Cooked mesh {} is outdated, it will be recooked", cookedPath.string());
+			return false;
+		}
+
+		if (header.payloadSize != file.getSize() - sizeof(FileHeader)
+			|| hashBytes(file.getData() + sizeof(FileHeader), header.payloadSize) != header.checksum)
+		{
+			ENGI_LOG_WARN("Cooked mesh {} is corrupted, it will be recooked", cookedPath.string());
+			return false;
+		}
+
+		cookedModel.entries.reserve(header.numMeshes);
+		cookedModel.materials.reserve(header.numMeshes);
+
+		CookReader reader(file.getData(), file.getSize(), sizeof(FileHeader));
+		for (uint32_t meshIndex = 0; meshIndex < header.numMeshes; ++meshIndex)
+		{
+			MeshHeader meshHeader = {};
+			bool valid = reader.read(meshHeader);
+
+			std::string meshName;
+			CookedMaterial& material = cookedModel.materials.emplace_back();
+			valid = valid && reader.readString(meshName, meshHeader.nameLength) && reader.readString(material.name, meshHeader.materialNameLength);
+			for (uint32_t i = 0; i < material.texturePaths.size(); ++i)
+				valid = valid && reader.readString(material.texturePaths[i], meshHeader.texturePathLengths[i]);
+
+			material.roughness = meshHeader.roughness;
+			material.metallic = meshHeader.metallic;
+			material.twoSided = meshHeader.twoSided != 0;
+
+			const StaticMeshVertex* vertices = reader.readArray<StaticMeshVertex>(meshHeader.numVertices);
+			const StaticMeshTriangle* triangles = reader.readArray<StaticMeshTriangle>(meshHeader.numTriangles);
+			const StaticMeshBVH::Node* nodes = reader.readArray<StaticMeshBVH::Node>(meshHeader.numNodes);
+			const math::TrianglePacketN* packets = reader.readArray<math::TrianglePacketN>(meshHeader.numPackets);
+			const uint32_t* packetTriangleIndices = reader.readArray<uint32_t>(static_cast<size_t>(meshHeader.numPackets) * math::TrianglePacketN::WIDTH);
+			if (!valid || !vertices || !triangles || !nodes || !packets || !packetTriangleIndices)
+			{
+				ENGI_LOG_WARN("Cooked mesh {} is truncated, it will be recooked", cookedPath.string());
+				cookedModel.entries.clear();
+				cookedModel.materials.clear();
+				return false;
+			}
+
+			math::AABB aabb(meshHeader.aabbMin, meshHeader.aabbMax);
+			StaticMesh mesh(meshHeader.numVertices, meshHeader.numTriangles, aabb, static_cast<uint8_t>(meshHeader.flags), meshName);
+			mesh.getVertices().assign(vertices, vertices + meshHeader.numVertices);
+			mesh.getTriangles().assign(triangles, triangles + meshHeader.numTriangles);
+			mesh.getMeshToModel() = meshHeader.meshToModel;
+			mesh.getModelToMesh() = meshHeader.modelToMesh;
+
+			StaticMeshEntry& entry = cookedModel.entries.emplace_back(std::move(mesh), meshHeader.range);
+			entry.bvh.initialize(nodes, meshHeader.numNodes, packets, meshHeader.numPackets, packetTriangleIndices);
+		}
+
+		return true;
+	}
+
+	bool MeshCache::save(const std::filesystem::path& sourcePath, ArrayView<const StaticMeshEntry> entries, ArrayView<const CookedMaterial> materials) noexcept
+	{
+		ENGI_ASSERT(entries.size() == materials.size() && "Every mesh entry should have a cooked material");
+
+		FileHeader header = {};
+		header.magic = MAGIC;
+		header.version = VERSION;
+		header.packetWidth = math::TrianglePacketN::WIDTH;
+		header.numMeshes = static_cast<uint32_t>(entries.size());
+		if (!getSourceStamp(sourcePath, header.sourceSize, header.sourceWriteTime))
+			return false;
+
+		CookWriter writer;
+		writer.write(header);
+		for (size_t meshIndex = 0; meshIndex < entries.size(); ++meshIndex)
+		{
+			const StaticMeshEntry& entry = entries[meshIndex];
+			const CookedMaterial& material = materials[meshIndex];
+			const StaticMesh& mesh = entry.mesh;
+			ENGI_ASSERT(entry.bvh.isInitialized() && "Mesh entries should be initialized before they are cooked");
+
+			MeshHeader meshHeader = {};
+			meshHeader.numVertices = mesh.getNumVertices();
+			meshHeader.numTriangles = mesh.getNumTriangles();
+			meshHeader.numNodes = entry.bvh.getNumNodes();
+			meshHeader.numPackets = entry.bvh.getNumPackets();
+			meshHeader.flags = getMeshFlags(mesh);
+			meshHeader.twoSided = material.twoSided ? 1 : 0;
+			meshHeader.roughness = material.roughness;
+			meshHeader.metallic = material.metallic;
+			meshHeader.range = entry.range;
+			meshHeader.aabbMin = mesh.getAABB().min;
+			meshHeader.aabbMax = mesh.getAABB().max;
+			meshHeader.meshToModel = mesh.getMeshToModel();
+			meshHeader.modelToMesh = mesh.getModelToMesh();
+			meshHeader.nameLength = static_cast<uint32_t>(mesh.getName().size());
+			meshHeader.materialNameLength = static_cast<uint32_t>(material.name.size());
+			for (uint32_t i = 0; i < material.texturePaths.size(); ++i)
+				meshHeader.texturePathLengths[i] = static_cast<uint32_t>(material.texturePaths[i].size());
+
+			writer.write(meshHeader);
+			writer.writeString(mesh.getName());
+			writer.writeString(material.name);
+			for (const std::string& texturePath : material.texturePaths)
+				writer.writeString(texturePath);
+
+			writer.writeArray(mesh.getVertices().data(), mesh.getVertices().size());
+			writer.writeArray(mesh.getTriangles().data(), mesh.getTriangles().size());
+			writer.writeArray(entry.bvh.getNodes().data(), entry.bvh.getNodes().size());
+			writer.writeArray(entry.bvh.getPackets().data(), entry.bvh.getPackets().size());
+			writer.writeArray(entry.bvh.getPacketTriangleIndices().data(), entry.bvh.getPacketTriangleIndices().size());
+		}
+
+		std::vector<uint8_t>& bytes = writer.getBytes();
+		header.payloadSize = bytes.size() - sizeof(FileHeader);
+		header.checksum = hashBytes(bytes.data() + sizeof(FileHeader), header.payloadSize);
+		std::memcpy(bytes.data(), &header, sizeof(FileHeader));
+
+		std::filesystem::path cookedPath = getCookedPath(sourcePath);
+		if (!FileSystem::writeFileAtomic(cookedPath, bytes.data(), bytes.size()))
+		{
+			ENGI_LOG_WARN("Failed to write the cooked mesh {}", cookedPath.string());
+			return false;
+		}
+
+		return true;
+	}
+
+}; // engi namespace
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "Utility/ArrayView.h"
+#include "Renderer/Model.h"
+
+namespace engi
+{
+
+	// Everything that is needed to recreate a MaterialInstance of a mesh without going through Assimp
+	struct CookedMaterial
+	{
+		std::string name;
+		float roughness = 0.0f;
+		float metallic = 0.0f;
+		bool twoSided = false;
+		std::array<std::string, 4> texturePaths; // indexed by TextureType, empty if the texture is not used
+	};
+
+	// Meshes with their prebuilt BVHs and materials of the imported model, ready to be added to a Model
+	struct CookedModel
+	{
+		std::vector<StaticMeshEntry> entries;
+		std::vector<CookedMaterial> materials; // one per entry
+	};
+
+	// On-disk cache of imported models. The cooked file is a header followed by raw arrays of vertices, triangles, BVH nodes and
+	// triangle packets of every mesh, so that loading it is a memory mapping followed by bulk copies.
+	// The file is versioned and checksummed, and it is rejected if the source asset's size or modification time has changed
+	class MeshCache
+	{
+	public:
+		static constexpr uint32_t MAGIC = 0x4D474E45; // "ENGM"
+		static constexpr uint32_t VERSION = 1;
+
+		static std::filesystem::path getCookedPath(const std::filesystem::path& sourcePath) noexcept;
+
+		// Returns false if there is no valid cooked file for the source asset
+		static bool load(const std::filesystem::path& sourcePath, CookedModel& cookedModel) noexcept;
+
+		// Entries should be initialized, so that their BVHs are built. Might be called from any thread
+		static bool save(const std::filesystem::path& sourcePath, ArrayView<const StaticMeshEntry> entries, ArrayView<const CookedMaterial> materials) noexcept;
+	};
+
+}; // engi namespace
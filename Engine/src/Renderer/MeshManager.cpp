@@ -1,11 +1,17 @@
 #include "Renderer/MeshManager.h"
 
+#include <algorithm>
+#include <cstring>
 #include "Math/Vec3.h"
 #include "Core/Logger.h"
 #include "Core/CommonDefinitions.h"
+#include "Utility/Parallel.h"
+#include "Utility/RadixSort.h"
 #include "Renderer/Renderer.h"
+#include "Renderer/ModelRegistry.h"
 #include "Renderer/InstanceTable.h"
 #include "Renderer/DynamicBuffer.h"
+#include "Renderer/LongLivedBuffer.h"
 #include "Renderer/ConstantBuffer.h"
 #include "Renderer/InstanceData.h"
 #include "Renderer/IndexBuffer.h"
@@ -14,106 +20,184 @@
 namespace engi
 {
 
-	RenderBatch::RenderBatch(const MaterialInstance& materialInstance)
-		: m_materialInstance(materialInstance)
+	namespace
 	{
-		ENGI_ASSERT(!materialInstance.isEmpty() && "Material instance cannot be empty");
-	}
 
-	void RenderBatch::submitInstanceData(uint32_t instanceDataId) noexcept
+		// Uploads the part of the staged slots that differs from what the buffer already holds (uploaded mirrors the buffer contents).
+		// Slots past the end of the mirror are considered unknown and are always uploaded. Returns the number of uploaded bytes
+		template<typename T>
+		uint32_t uploadChangedSlots(LongLivedBuffer* buffer, std::vector<T>& uploaded, const std::vector<T>& staging, uint32_t firstSlot) noexcept
+		{
+			uint32_t numKnown = static_cast<uint32_t>(uploaded.size());
+			uint32_t first = 0;
+			uint32_t last = static_cast<uint32_t>(staging.size());
+			while (first < last && firstSlot + first < numKnown && std::memcmp(&uploaded[firstSlot + first], &staging[first], sizeof(T)) == 0)
+				++first;
+
+			while (last > first && firstSlot + last - 1 < numKnown && std::memcmp(&uploaded[firstSlot + last - 1], &staging[last - 1], sizeof(T)) == 0)
+				--last;
+
+			if (first == last)
+				return 0;
+
+			if (uploaded.size() < firstSlot + last)
+				uploaded.resize(firstSlot + last);
+
+			std::copy(staging.begin() + first, staging.begin() + last, uploaded.begin() + firstSlot + first);
+			buffer->updateBuffer(firstSlot + first, staging.data() + first, last - first);
+			return static_cast<uint32_t>((last - first) * sizeof(T));
+		}
+
+	}; // anonymous namespace
+
+	CullingVolume CullingVolume::fromFrustum(const math::Frustum& frustum) noexcept
 	{
-		m_instanceDataIDs.push_back(instanceDataId);
+		CullingVolume volume;
+		volume.isCube = false;
+		volume.frustum = frustum;
+		return volume;
 	}
 
-	bool RenderBatch::removeInstanceData(uint32_t instanceDataId) noexcept
+	CullingVolume CullingVolume::fromCube(const math::Vec3& center, float radius, const std::array<math::Frustum, 6>& faces) noexcept
 	{
-		auto it = std::ranges::find(m_instanceDataIDs, instanceDataId);
-		if (it == m_instanceDataIDs.end())
-			return false;
-
-		m_instanceDataIDs.erase(it);
-		return true;
+		CullingVolume volume;
+		volume.isCube = true;
+		volume.center = center;
+		volume.radius = radius;
+		volume.faces = faces;
+		return volume;
 	}
 
-	RenderBatch* MeshGroup::getRenderBatch(const MaterialInstance& materialInstance) noexcept
+	uint32_t CullingVolume::test(const math::AABB& modelAABB, const math::Mat4x4& modelToWorld) const noexcept
 	{
-		auto it = std::ranges::find_if(this->renderBatches, [&](const auto& batch)
-			{
-				return batch.getMaterialInstance() == materialInstance;
-			});
-
-		if (it == this->renderBatches.end())
-			return nullptr;
-
-		return &(*it);
+		if (!isCube)
+			return frustum.intersects(modelAABB, modelToWorld) ? VIEW_MASK_ALL : 0;
+
+		// Reject boxes that are outside of the light's range first, it is cheaper than testing each face
+		math::AABB worldAABB = modelAABB.applyMatrix(modelToWorld);
+		float dx = (center.x < worldAABB.min.x) ? worldAABB.min.x - center.x : (center.x > worldAABB.max.x ? center.x - worldAABB.max.x : 0.0f);
+		float dy = (center.y < worldAABB.min.y) ? worldAABB.min.y - center.y : (center.y > worldAABB.max.y ? center.y - worldAABB.max.y : 0.0f);
+		float dz = (center.z < worldAABB.min.z) ? worldAABB.min.z - center.z : (center.z > worldAABB.max.z ? center.z - worldAABB.max.z : 0.0f);
+		if (dx * dx + dy * dy + dz * dz > radius * radius)
+			return 0;
+
+		uint32_t mask = 0;
+		for (uint32_t face = 0; face < 6; ++face)
+		{
+			if (faces[face].intersects(modelAABB, modelToWorld))
+				mask |= (1u << face);
+		}
+		return mask;
 	}
 
-	RenderBatch* MeshGroup::addRenderBatch(const MaterialInstance& materialInstance) noexcept
+	RenderBatch::RenderBatch(const MaterialInstance& materialInstance)
+		: m_materialInstance(materialInstance)
 	{
-		RenderBatch* batch = getRenderBatch(materialInstance);
-		if (batch)
-			return batch;
+		ENGI_ASSERT(!materialInstance.isEmpty() && "Material instance cannot be empty");
+	}
 
-		this->renderBatches.push_back(RenderBatch(materialInstance));
-		return &this->renderBatches.back();
+	void RenderBatch::submitInstanceData(uint32_t instanceDataId) noexcept
+	{
+		auto [it, inserted] = m_instancePositions.try_emplace(instanceDataId, getInstanceCount());
+		ENGI_ASSERT(inserted && "Instance is already submitted to the batch");
+		if (inserted)
+			m_instanceDataIDs.push_back(instanceDataId);
 	}
 
-	bool MeshGroup::removeRenderBatch(const MaterialInstance& materialInstance) noexcept
+	void RenderBatch::reserve(uint32_t numInstances) noexcept
 	{
-		auto it = std::ranges::find_if(this->renderBatches, [&](const auto& batch)
-			{
-				return batch.getMaterialInstance() == materialInstance;
-			});
+		m_instanceDataIDs.reserve(numInstances);
+		m_instancePositions.reserve(numInstances);
+	}
 
-		if (it == this->renderBatches.end())
+	bool RenderBatch::removeInstanceData(uint32_t instanceDataId) noexcept
+	{
+		auto it = m_instancePositions.find(instanceDataId);
+		if (it == m_instancePositions.end())
 			return false;
 
-		this->renderBatches.erase(it);
+		// swap-and-pop, order of instances within a batch does not matter as the layout is rebuilt after the removal anyway
+		uint32_t position = it->second;
+		uint32_t lastInstanceDataId = m_instanceDataIDs.back();
+		m_instanceDataIDs[position] = lastInstanceDataId;
+		m_instancePositions[lastInstanceDataId] = position;
+		m_instanceDataIDs.pop_back();
+		m_instancePositions.erase(instanceDataId);
+		m_numStaticInstances = std::min(m_numStaticInstances, getInstanceCount());
 		return true;
 	}
 
-	ModelGroup::ModelGroup(uint32_t numMeshes)
-		: m_meshes(static_cast<size_t>(numMeshes), MeshGroup())
+	void RenderBatch::partitionByMobility(const InstanceTable& instanceTable) noexcept
 	{
+		// Partition is stable, so that static instances keep their slots and are not reuploaded when another instance changes mobility
+		auto dynamicBegin = std::stable_partition(m_instanceDataIDs.begin(), m_instanceDataIDs.end(), [&](uint32_t instanceDataId)
+			{
+				return instanceTable.getMobility(instanceDataId) == INSTANCE_MOBILITY_STATIC;
+			});
+		m_numStaticInstances = static_cast<uint32_t>(dynamicBegin - m_instanceDataIDs.begin());
+
+		for (uint32_t position = 0; position < getInstanceCount(); ++position)
+			m_instancePositions[m_instanceDataIDs[position]] = position;
 	}
 
-	const MeshGroup* ModelGroup::getMeshGroup(uint32_t meshIndex) const noexcept
+	uint32_t RenderBatch::getBufferOffset(const DrawRange& range) const noexcept
 	{
-		ENGI_ASSERT(meshIndex < getNumMeshes());
-		return &m_meshes[meshIndex];
+		return isDynamicRange(range) ? m_dynamicBufferOffset + range.first - m_numStaticInstances : m_staticBufferOffset + range.first;
 	}
 
-	MeshGroup* ModelGroup::getMeshGroup(uint32_t meshIndex) noexcept
+	void RenderBatch::resetVisibility() noexcept
 	{
-		ENGI_ASSERT(meshIndex < getNumMeshes());
-		return &m_meshes[meshIndex];
+		uint32_t numInstances = getInstanceCount();
+		m_numVisibleInstances = numInstances;
+		m_viewMasks.assign(numInstances, CullingVolume::VIEW_MASK_ALL);
+		m_drawRanges.clear();
+		if (m_numStaticInstances > 0)
+			m_drawRanges.push_back(DrawRange{ 0, m_numStaticInstances });
+
+		if (numInstances > m_numStaticInstances)
+			m_drawRanges.push_back(DrawRange{ m_numStaticInstances, numInstances - m_numStaticInstances });
 	}
 
-	ModelGroup* MaterialGroup::getModelGroup(const SharedHandle<Model>& model) noexcept
+	void RenderBatch::cullInstances(const InstanceTable& instanceTable, const CullingVolume& volume, const math::AABB& modelAABB) noexcept
 	{
-		auto it = this->modelMap.find(model);
-		if (it == this->modelMap.end())
-			return nullptr;
-
-		return &(it->second);
+		uint32_t numInstances = getInstanceCount();
+		m_numVisibleInstances = 0;
+		m_viewMasks.resize(numInstances);
+		m_drawRanges.clear();
+		for (uint32_t i = 0; i < numInstances; ++i)
+		{
+			const InstanceData& data = instanceTable.getInstanceData(m_instanceDataIDs[i]);
+			uint32_t viewMask = volume.test(modelAABB, data.modelToWorld);
+			m_viewMasks[i] = viewMask;
+			if (viewMask == 0)
+				continue;
+
+			++m_numVisibleInstances;
+
+			// Instances are kept in their buffer order, thus visible ones are merged into draw ranges. Static and dynamic instances
+			// live in different buffers and are never merged
+			DrawRange* last = m_drawRanges.empty() ? nullptr : &m_drawRanges.back();
+			if (last && i - (last->first + last->count) <= MAX_DRAW_GAP && (i < m_numStaticInstances) == !isDynamicRange(*last))
+				last->count = i - last->first + 1;
+			else
+				m_drawRanges.push_back(DrawRange{ i, 1 });
+		}
 	}
 
-	ModelGroup* MaterialGroup::addModelGroup(const SharedHandle<Model>& model) noexcept
+	std::array<gfx::GpuInputAttributeDesc, 15> MeshManager::getInputAttributes(uint32_t perVertexSlot, uint32_t perInstanceSlot, uint32_t animationSlot) noexcept
 	{
-		ModelGroup* group = getModelGroup(model);
-		if (group)
-			return group;
-
-		ENGI_ASSERT(model->getNumStaticMeshes() != 0);
-		this->modelMap[model] = ModelGroup(model->getNumStaticMeshes());
-		return &this->modelMap.at(model);
+		std::array<gfx::GpuInputAttributeDesc, 15> layout;
+		std::ranges::copy(StaticMeshVertex::getInputAttributes(perVertexSlot), layout.begin());
+		std::ranges::copy(GpuInstanceData::getInputAttributes(perInstanceSlot), layout.begin() + 5);
+		std::ranges::copy(GpuInstanceAnimation::getInputAttributes(animationSlot), layout.begin() + 10);
+		return layout;
 	}
 
-	std::array<gfx::GpuInputAttributeDesc, 21> MeshManager::getInputAttributes(uint32_t perVertexSlot, uint32_t perInstanceSlot) noexcept
+	std::array<gfx::GpuInputAttributeDesc, 16> MeshManager::getInputAttributesWithViewMask(uint32_t perVertexSlot, uint32_t perInstanceSlot, uint32_t animationSlot, uint32_t viewMaskSlot) noexcept
 	{
-		std::array<gfx::GpuInputAttributeDesc, 21> layout;
-		std::ranges::copy(StaticMeshVertex::getInputAttributes(perVertexSlot), layout.begin());
-		std::ranges::copy(InstanceData::getInputAttributes(perInstanceSlot), layout.begin() + 5);
+		std::array<gfx::GpuInputAttributeDesc, 16> layout;
+		std::ranges::copy(getInputAttributes(perVertexSlot, perInstanceSlot, animationSlot), layout.begin());
+		layout[15] = gfx::GpuInputAttributeDesc("INSTANCE_VIEW_MASK", 0, gfx::GpuFormat::R32U, viewMaskSlot, false, 0);
 		return layout;
 	}
 
@@ -159,28 +243,68 @@ namespace engi
 
 	bool MeshManager::init() noexcept
 	{
-		m_materialMap.clear();
+		m_materialIDs.clear();
+		m_modelIDs.clear();
+		m_materialInstanceIDs.clear();
+		m_batches.clear();
+		m_batchLookup.clear();
+		m_draws.clear();
+		m_emptyBatches.clear();
 		m_bufferCapacity = 64;
 		m_bufferInstances = 0;
-
-		m_instanceBuffer.reset(m_renderer->createDynamicBuffer("MeshManager::InstanceBuffer", nullptr, m_bufferCapacity, sizeof(InstanceData)));
+		m_dynamicCapacity = 16;
+		m_numStaticSlots = 0;
+		m_numDynamicSlots = 0;
+		m_mobilityVersion = m_instanceTable->getMobilityVersion();
+		m_slotInstanceIDs.clear();
+		m_instanceSlots.clear();
+		m_dynamicSlotInstanceIDs.clear();
+		m_dynamicInstanceSlots.clear();
+		m_uploadedViewMasks.clear();
+		m_uploadedInstances.clear();
+		m_uploadedAnimations.clear();
+		m_groups.clear();
+		m_dirtyGroups.clear();
+		m_groupCapacity = 0;
+		m_numGroupSlots = 0;
+		m_groupLayoutRequested = false;
+		m_uploadedGroupInstances.clear();
+		m_uploadedGroupViewMasks.clear();
+
+		m_instanceBuffer.reset(m_renderer->createLongLivedBuffer("MeshManager::InstanceBuffer", nullptr, m_bufferCapacity, sizeof(GpuInstanceData)));
 		if (!m_instanceBuffer)
 		{
 			ENGI_LOG_ERROR("Failed to init instnace buffer");
 			return false;
 		}
 
-		m_meshData.reset(m_renderer->createConstantBuffer("MeshManager::MeshData", sizeof(MeshData)));
-		if (!m_meshData)
+		m_animationBuffer.reset(m_renderer->createLongLivedBuffer("MeshManager::AnimationBuffer", nullptr, m_bufferCapacity, sizeof(GpuInstanceAnimation)));
+		if (!m_animationBuffer)
+		{
+			ENGI_LOG_ERROR("Failed to init instance animation buffer");
+			return false;
+		}
+
+		m_viewMaskBuffer.reset(m_renderer->createDynamicBuffer("MeshManager::ViewMaskBuffer", nullptr, m_bufferCapacity, sizeof(uint32_t)));
+		if (!m_viewMaskBuffer)
+		{
+			ENGI_LOG_ERROR("Failed to init view mask buffer");
+			return false;
+		}
+
+		m_dynamicInstanceBuffer.reset(m_renderer->createDynamicBuffer("MeshManager::DynamicInstanceBuffer", nullptr, m_dynamicCapacity, sizeof(GpuInstanceData)));
+		m_dynamicAnimationBuffer.reset(m_renderer->createDynamicBuffer("MeshManager::DynamicAnimationBuffer", nullptr, m_dynamicCapacity, sizeof(GpuInstanceAnimation)));
+		if (!m_dynamicInstanceBuffer || !m_dynamicAnimationBuffer)
 		{
-			ENGI_LOG_ERROR("Failed to initialize mesh data");
+			ENGI_LOG_ERROR("Failed to init dynamic instance buffers");
 			return false;
 		}
 
-		m_materialData.reset(m_renderer->createConstantBuffer("MeshManager::MaterialData", sizeof(ENGI_MaterialData)));
-		if (!m_materialData)
+		m_drawConstantsCapacity = 64 * DRAW_CONSTANTS_ENTRY_SIZE;
+		m_drawConstants.reset(m_renderer->createConstantBuffer("MeshManager::DrawConstants", m_drawConstantsCapacity));
+		if (!m_drawConstants)
 		{
-			ENGI_LOG_ERROR("Failed to init material data");
+			ENGI_LOG_ERROR("Failed to init draw constants");
 			return false;
 		}
 		return true;
@@ -191,14 +315,8 @@ namespace engi
 		if (m_bufferUpdateRequested)
 			updateInstanceBuffer();
 
-		m_instanceBuffer->bind(1, 0);
-		uint32_t numRenderedInstances = 0;
-		for (auto& [material, materialGroup] : m_materialMap)
-		{
-			material->bind();
-			numRenderedInstances += renderMaterialGroup(materialGroup, numRenderedInstances);
-		}
-		ENGI_ASSERT(numRenderedInstances == m_bufferInstances && "Internal error");
+		uint32_t numRenderedInstances = renderDraws(true);
+		ENGI_ASSERT(numRenderedInstances >= m_numVisibleInstances && "Internal error");
 	}
 
 	void MeshManager::renderUsingMaterial(const SharedHandle<Material>& material) noexcept
@@ -209,13 +327,21 @@ namespace engi
 		if (m_bufferUpdateRequested)
 			updateInstanceBuffer();
 
-		m_instanceBuffer->bind(1, 0);
 		material->bind();
-		uint32_t numRenderedInstances = 0;
-		for (auto& [material, materialGroup] : m_materialMap)
-			numRenderedInstances += renderMaterialGroup(materialGroup, numRenderedInstances);
+		uint32_t numRenderedInstances = renderDraws(false);
+		ENGI_ASSERT(numRenderedInstances >= m_numVisibleInstances && "Internal error");
+	}
 
-		ENGI_ASSERT(numRenderedInstances == m_bufferInstances && "Internal error");
+	void MeshManager::setCullingVolume(const CullingVolume& volume) noexcept
+	{
+		m_cullingVolume = volume;
+		requestBufferUpdate();
+	}
+
+	void MeshManager::disableCulling() noexcept
+	{
+		m_cullingVolume.reset();
+		requestBufferUpdate();
 	}
 
 	bool MeshManager::submitInstance(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material, uint32_t instanceDataId) noexcept
@@ -223,46 +349,67 @@ namespace engi
 		if (!isValid(model, meshIndex, material, instanceDataId))
 			return false;
 
-		MaterialGroup& materialGroup = m_materialMap[material.getMaterial()];
-		ModelGroup* modelGroup = materialGroup.addModelGroup(model);
-		MeshGroup* meshGroup = modelGroup->getMeshGroup(meshIndex);
-		RenderBatch* rb = meshGroup->addRenderBatch(material);
-		rb->submitInstanceData(instanceDataId);
+		uint32_t batchId = findBatch(model, meshIndex, material);
+		if (batchId == INVALID_BATCH)
+			batchId = addBatch(model, meshIndex, material);
+
+		if (batchId == INVALID_BATCH)
+			return false;
+
+		m_batches[batchId].batch.submitInstanceData(instanceDataId);
 		++m_bufferInstances;
 
+		m_layoutUpdateRequested = true;
 		requestBufferUpdate();
 		return true;
 	}
 
-	bool MeshManager::removeInstance(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material, uint32_t instanceDataId) noexcept
+	bool MeshManager::submitInstances(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material, ArrayView<const uint32_t> instanceDataIds) noexcept
 	{
-		if (!isValid(model, meshIndex, material, instanceDataId))
+		if (instanceDataIds.empty() || !isValid(model, meshIndex, material, instanceDataIds.front()))
 			return false;
 
-		auto it = m_materialMap.find(material.getMaterial());
-		if (it == m_materialMap.end())
-			return false;
+		uint32_t batchId = findBatch(model, meshIndex, material);
+		if (batchId == INVALID_BATCH)
+			batchId = addBatch(model, meshIndex, material);
 
-		MaterialGroup& materialGroup = it->second;
-		ModelGroup* modelGroup = materialGroup.getModelGroup(model);
-		if (!modelGroup)
+		if (batchId == INVALID_BATCH)
 			return false;
 
-		MeshGroup* meshGroup = modelGroup->getMeshGroup(meshIndex);
-		if (!meshGroup)
+		uint32_t numInstances = static_cast<uint32_t>(instanceDataIds.size());
+		RenderBatch& rb = m_batches[batchId].batch;
+		rb.reserve(rb.getInstanceCount() + numInstances);
+		for (uint32_t instanceDataId : instanceDataIds)
+		{
+			ENGI_ASSERT(m_instanceTable->isOccupied(instanceDataId) && "Invalid id provided");
+			rb.submitInstanceData(instanceDataId);
+		}
+		m_bufferInstances += numInstances;
+
+		m_layoutUpdateRequested = true;
+		requestBufferUpdate();
+		return true;
+	}
+
+	bool MeshManager::removeInstance(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material, uint32_t instanceDataId) noexcept
+	{
+		if (!isValid(model, meshIndex, material, instanceDataId))
 			return false;
 
-		RenderBatch* rb = meshGroup->getRenderBatch(material);
-		if (!rb)
+		uint32_t batchId = findBatch(model, meshIndex, material);
+		if (batchId == INVALID_BATCH)
 			return false;
 
-		if (!rb->removeInstanceData(instanceDataId))
+		RenderBatch& rb = m_batches[batchId].batch;
+		if (!rb.removeInstanceData(instanceDataId))
 			return false;
 
-		if (rb->isEmpty())
-			meshGroup->removeRenderBatch(material);
+		// Empty batches are destroyed with the next layout update, an instance often comes back to its batch within the same frame
+		if (rb.isEmpty())
+			m_emptyBatches.push_back(batchId);
 
 		--m_bufferInstances;
+		m_layoutUpdateRequested = true;
 		requestBufferUpdate();
 		return true;
 	}
@@ -285,10 +432,98 @@ namespace engi
 		if (!isValid(model, meshIndex, material, instanceDataId))
 			return false;
 
+		m_instanceTable->markDirty(instanceDataId);
 		requestBufferUpdate();
 		return true;
 	}
 
+	uint32_t MeshManager::addInstanceGroup(const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, ArrayView<const math::Transformation> transforms, const math::Vec3& color) noexcept
+	{
+		if (!model || materials.empty() || transforms.empty())
+		{
+			ENGI_LOG_WARN("Failed to add instance group, model, materials and instances must be provided");
+			return INVALID_GROUP;
+		}
+
+		uint32_t numMeshes = model->getNumStaticMeshes();
+		uint32_t numMaterials = static_cast<uint32_t>(materials.size());
+		std::vector<uint32_t> batchIds;
+		batchIds.reserve(numMeshes);
+		for (uint32_t meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
+		{
+			const MaterialInstance& material = materials[(meshIndex >= numMaterials) ? numMaterials - 1 : meshIndex];
+			uint32_t batchId = material.isEmpty() ? INVALID_BATCH : findBatch(model, meshIndex, material);
+			if (batchId == INVALID_BATCH && !material.isEmpty())
+				batchId = addBatch(model, meshIndex, material);
+
+			if (batchId == INVALID_BATCH)
+			{
+				// Batches that were added for the group are removed with the next layout update
+				ENGI_LOG_WARN("Failed to add instance group of {} model, mesh {} could not be batched", model->getPath(), meshIndex);
+				m_emptyBatches.insert(m_emptyBatches.end(), batchIds.begin(), batchIds.end());
+				m_layoutUpdateRequested = true;
+				return INVALID_GROUP;
+			}
+			batchIds.push_back(batchId);
+		}
+
+		GroupEntry entry;
+		entry.group = makeUnique<InstanceGroup>(new InstanceGroup(model));
+		entry.group->setColor(color);
+		entry.group->setInstances(transforms);
+		entry.batchIds = std::move(batchIds);
+
+		uint32_t groupId = m_groups.insert(std::move(entry));
+		for (uint32_t batchId : m_groups[groupId].batchIds)
+			m_batches[batchId].groupIds.push_back(groupId);
+
+		// Group might have added batches, thus draws have to be resorted as well
+		m_layoutUpdateRequested = true;
+		m_groupLayoutRequested = true;
+		requestBufferUpdate();
+		return groupId;
+	}
+
+	void MeshManager::removeInstanceGroup(uint32_t groupId) noexcept
+	{
+		if (groupId == INVALID_GROUP || !m_groups.isOccupied(groupId))
+			return;
+
+		for (uint32_t batchId : m_groups[groupId].batchIds)
+		{
+			DrawBatch& drawBatch = m_batches[batchId];
+			std::erase(drawBatch.groupIds, groupId);
+			if (drawBatch.batch.isEmpty() && drawBatch.groupIds.empty())
+				m_emptyBatches.push_back(batchId);
+		}
+		m_groups.erase(groupId);
+
+		m_layoutUpdateRequested = true;
+		m_groupLayoutRequested = true;
+		requestBufferUpdate();
+	}
+
+	InstanceGroup* MeshManager::getInstanceGroup(uint32_t groupId) noexcept
+	{
+		if (groupId == INVALID_GROUP || !m_groups.isOccupied(groupId))
+			return nullptr;
+
+		return m_groups[groupId].group.get();
+	}
+
+	void MeshManager::updateInstanceGroup(uint32_t groupId) noexcept
+	{
+		if (groupId == INVALID_GROUP || !m_groups.isOccupied(groupId))
+			return;
+
+		const GroupEntry& entry = m_groups[groupId];
+		if (entry.group->getNumInstances() != entry.numSlots)
+			m_groupLayoutRequested = true;
+		else m_dirtyGroups.push_back(groupId);
+
+		requestBufferUpdate();
+	}
+
 	bool MeshManager::isValid(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material, uint32_t instanceDataId) const noexcept
 	{
 		if (!model || material.isEmpty())
@@ -303,105 +538,717 @@ namespace engi
 		return true;
 	}
 
+	uint32_t MeshManager::findBatch(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material) const noexcept
+	{
+		uint32_t materialId = m_materialIDs.find(material.getMaterial());
+		uint32_t modelId = m_modelIDs.find(model);
+		uint32_t materialInstanceId = m_materialInstanceIDs.find(material);
+		if (materialId == m_materialIDs.INVALID_ID || modelId == m_modelIDs.INVALID_ID || materialInstanceId == m_materialInstanceIDs.INVALID_ID)
+			return INVALID_BATCH;
+
+		auto it = m_batchLookup.find(DrawKey::make(materialId, modelId, meshIndex, materialInstanceId));
+		return (it == m_batchLookup.end()) ? INVALID_BATCH : it->second;
+	}
+
+	uint32_t MeshManager::addBatch(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material) noexcept
+	{
+		if (meshIndex >= (1u << DrawKey::MESH_BITS))
+		{
+			ENGI_LOG_WARN("Mesh index {} does not fit into a draw key", meshIndex);
+			return INVALID_BATCH;
+		}
+
+		uint32_t materialId = m_materialIDs.acquire(material.getMaterial());
+		uint32_t modelId = m_modelIDs.acquire(model);
+		uint32_t materialInstanceId = m_materialInstanceIDs.acquire(material);
+		ENGI_ASSERT(materialId < (1u << DrawKey::MATERIAL_BITS) && "Too many materials for a draw key");
+		ENGI_ASSERT(modelId < (1u << DrawKey::MODEL_BITS) && "Too many models for a draw key");
+		ENGI_ASSERT(materialInstanceId < (1u << DrawKey::MATERIAL_INSTANCE_BITS) && "Too many material instances for a draw key");
+
+		uint64_t key = DrawKey::make(materialId, modelId, meshIndex, materialInstanceId);
+		uint32_t batchId = m_batches.insert(DrawBatch{ key, model, meshIndex, RenderBatch(material) });
+		m_batchLookup.emplace(key, batchId);
+		m_drawSortRequested = true;
+		return batchId;
+	}
+
+	void MeshManager::removeBatch(uint32_t batchId) noexcept
+	{
+		DrawBatch& drawBatch = m_batches[batchId];
+		m_materialIDs.release(DrawKey::getMaterial(drawBatch.key));
+		m_modelIDs.release(DrawKey::getModel(drawBatch.key));
+		m_materialInstanceIDs.release(DrawKey::getMaterialInstance(drawBatch.key));
+		m_batchLookup.erase(drawBatch.key);
+		m_batches.erase(batchId);
+		m_drawSortRequested = true;
+	}
+
+	void MeshManager::removeEmptyBatches() noexcept
+	{
+		// A batch might have been emptied several times since the last update, it might also have been refilled
+		std::ranges::sort(m_emptyBatches);
+		auto [first, last] = std::ranges::unique(m_emptyBatches);
+		m_emptyBatches.erase(first, last);
+		for (uint32_t batchId : m_emptyBatches)
+		{
+			if (m_batches.isOccupied(batchId) && m_batches[batchId].batch.isEmpty() && m_batches[batchId].groupIds.empty())
+				removeBatch(batchId);
+		}
+		m_emptyBatches.clear();
+	}
+
+	void MeshManager::sortDraws() noexcept
+	{
+		m_drawSortRequested = false;
+		m_draws.clear();
+		for (uint32_t batchId : m_batches.getAllIDs())
+			m_draws.push_back(DrawItem{ m_batches[batchId].key, batchId, 0, 0 });
+
+		radixSort(m_draws, m_sortScratch, [](const DrawItem& draw) { return draw.key; });
+	}
+
+	bool MeshManager::updateDrawConstants() noexcept
+	{
+		static_assert(sizeof(MeshData) <= DRAW_CONSTANTS_ENTRY_SIZE && sizeof(ENGI_MaterialData) <= DRAW_CONSTANTS_ENTRY_SIZE);
+
+		// Constants only change together with the set of batches, thus they are uploaded once after the draws are sorted.
+		// Draws of the same mesh or material instance share an entry, so that rebinding it is filtered out by the state cache
+		std::unordered_map<uint64_t, uint32_t> meshEntries;
+		std::unordered_map<uint32_t, uint32_t> materialEntries;
+		m_drawConstantsStaging.clear();
+		auto allocateEntry = [this](const void* data, uint32_t size) -> uint32_t
+			{
+				uint32_t offset = static_cast<uint32_t>(m_drawConstantsStaging.size());
+				m_drawConstantsStaging.resize(offset + DRAW_CONSTANTS_ENTRY_SIZE, 0);
+				std::memcpy(m_drawConstantsStaging.data() + offset, data, size);
+				return offset;
+			};
+
+		for (DrawItem& draw : m_draws)
+		{
+			const DrawBatch& drawBatch = m_batches[draw.batchId];
+			auto [meshIt, isNewMesh] = meshEntries.try_emplace(DrawKey::getModelMesh(draw.key), 0);
+			if (isNewMesh)
+			{
+				const StaticMesh& mesh = drawBatch.model->getStaticMeshEntries()[drawBatch.meshIndex].mesh;
+				MeshData meshData;
+				meshData.meshToModel = mesh.getMeshToModel();
+				meshData.modelToMesh = mesh.getModelToMesh();
+				meshData.hasTexCoords = (uint32_t)mesh.hasTexCoords();
+				meshIt->second = allocateEntry(&meshData, sizeof(MeshData));
+			}
+
+			auto [materialIt, isNewMaterial] = materialEntries.try_emplace(DrawKey::getMaterialInstance(draw.key), 0);
+			if (isNewMaterial)
+			{
+				ENGI_MaterialData materialData(drawBatch.batch.getMaterialInstance().getData());
+				materialIt->second = allocateEntry(&materialData, sizeof(ENGI_MaterialData));
+			}
+
+			draw.meshConstants = meshIt->second;
+			draw.materialConstants = materialIt->second;
+		}
+
+		uint32_t numBytes = static_cast<uint32_t>(m_drawConstantsStaging.size());
+		if (numBytes == 0)
+			return true;
+
+		if (numBytes > m_drawConstantsCapacity)
+		{
+			uint32_t newCapacity = std::max(numBytes, m_drawConstantsCapacity * 2);
+			ConstantBuffer* buffer = m_renderer->createConstantBuffer("MeshManager::DrawConstants", newCapacity);
+			if (!buffer)
+			{
+				ENGI_LOG_WARN("Failed to resize draw constants");
+				return false;
+			}
+			m_drawConstants.reset(buffer);
+			m_drawConstantsCapacity = newCapacity;
+		}
+
+		m_drawConstants->upload(0, m_drawConstantsStaging.data(), numBytes);
+		m_numUploadedBytes += numBytes;
+		return true;
+	}
+
+	void MeshManager::cullInstances() noexcept
+	{
+		struct CullingEntry
+		{
+			RenderBatch* batch;
+			math::AABB modelAABB;
+		};
+
+		// Batches are culled independently
+		std::vector<CullingEntry> entries;
+		entries.reserve(m_batches.size());
+		for (DrawBatch& drawBatch : m_batches)
+		{
+			const StaticMesh& mesh = drawBatch.model->getStaticMeshEntries()[drawBatch.meshIndex].mesh;
+			entries.push_back(CullingEntry{ &drawBatch.batch, mesh.getAABB().applyMatrix(mesh.getMeshToModel()) });
+		}
+
+		if (m_cullingVolume)
+		{
+			const CullingVolume& volume = *m_cullingVolume;
+			const InstanceTable& instanceTable = *m_instanceTable;
+			parallelFor(0, static_cast<uint32_t>(entries.size()), [&](uint32_t entryIndex)
+				{
+					const CullingEntry& entry = entries[entryIndex];
+					entry.batch->cullInstances(instanceTable, volume, entry.modelAABB);
+				});
+		}
+		else
+		{
+			for (CullingEntry& entry : entries)
+				entry.batch->resetVisibility();
+		}
+
+		m_numVisibleInstances = 0;
+		for (const CullingEntry& entry : entries)
+			m_numVisibleInstances += entry.batch->getVisibleInstanceCount();
+
+		// Groups are culled per cluster, thus there are few enough tests to not go parallel. A group instance is drawn once per mesh
+		for (GroupEntry& entry : m_groups)
+		{
+			cullGroup(entry);
+			m_numVisibleInstances += entry.numVisibleInstances * static_cast<uint32_t>(entry.batchIds.size());
+		}
+	}
+
+	void MeshManager::cullGroup(GroupEntry& entry) const noexcept
+	{
+		const std::vector<InstanceGroup::Cluster>& clusters = entry.group->getClusters();
+		uint32_t numClusters = static_cast<uint32_t>(clusters.size());
+		entry.numVisibleInstances = 0;
+		entry.clusterViewMasks.resize(numClusters);
+		entry.drawRanges.clear();
+		for (uint32_t i = 0; i < numClusters; ++i)
+		{
+			// Cluster bounds are already in world space
+			const InstanceGroup::Cluster& cluster = clusters[i];
+			uint32_t viewMask = m_cullingVolume ? m_cullingVolume->test(cluster.worldAABB, math::Mat4x4()) : CullingVolume::VIEW_MASK_ALL;
+			entry.clusterViewMasks[i] = viewMask;
+			if (viewMask == 0)
+				continue;
+
+			entry.numVisibleInstances += cluster.count;
+
+			// Clusters follow each other in the group buffer, thus adjacent visible ones are drawn with a single range
+			RenderBatch::DrawRange* last = entry.drawRanges.empty() ? nullptr : &entry.drawRanges.back();
+			if (last && last->first + last->count == cluster.first)
+				last->count += cluster.count;
+			else
+				entry.drawRanges.push_back(RenderBatch::DrawRange{ cluster.first, cluster.count });
+		}
+	}
+
 	bool MeshManager::updateInstanceBuffer() noexcept
 	{
 		m_bufferUpdateRequested = false;
+		if (m_instanceTable->getMobilityVersion() != m_mobilityVersion)
+			m_layoutUpdateRequested = true;
+
+		if (m_layoutUpdateRequested)
+		{
+			if (!updateInstanceLayout())
+				return false;
+		}
+		else
+		{
+			uploadDirtyInstances();
+		}
+
+		if (m_groupLayoutRequested)
+		{
+			if (!updateGroupLayout())
+				return false;
+		}
+		else
+		{
+			uploadDirtyGroups();
+		}
+
+		this->cullInstances();
+		this->uploadViewMasks();
+		this->uploadGroupViewMasks();
+		return true;
+	}
+
+	bool MeshManager::updateInstanceLayout() noexcept
+	{
+		m_layoutUpdateRequested = false;
+		m_mobilityVersion = m_instanceTable->getMobilityVersion();
+		removeEmptyBatches();
+		if (m_drawSortRequested)
+		{
+			sortDraws();
+			if (!updateDrawConstants())
+				return false;
+		}
+
 		if (m_bufferInstances >= m_bufferCapacity)
 		{
 			if (!resizeInstanceBuffer())
 				return false;
 		}
-		uint32_t copiedInstances = 0;
-		InstanceData* mapping = reinterpret_cast<InstanceData*>(m_instanceBuffer->map());
-		for (auto& [material, matGroup] : m_materialMap)
+
+		// Instances of each batch are laid out contiguously in the order batches are rendered, static and dynamic ones in their own buffers
+		m_slotInstanceIDs.clear();
+		m_instanceSlots.clear();
+		m_dynamicSlotInstanceIDs.clear();
+		m_dynamicInstanceSlots.clear();
+		const InstanceTable& instanceTable = *m_instanceTable;
+		for (const DrawItem& draw : m_draws)
 		{
-			for (auto& [model, modelGroup] : matGroup.getAllModelGroups())
+			RenderBatch& rb = m_batches[draw.batchId].batch;
+			rb.partitionByMobility(instanceTable);
+			rb.setBufferOffsets(static_cast<uint32_t>(m_slotInstanceIDs.size()), static_cast<uint32_t>(m_dynamicSlotInstanceIDs.size()));
+
+			const std::vector<uint32_t>& instanceIDs = rb.getAllInstanceIDs();
+			for (uint32_t i = 0; i < rb.getInstanceCount(); ++i)
 			{
-				for (const MeshGroup& meshGroup : modelGroup.getAllMeshGroups())
-				{
-					for (const RenderBatch& rb : meshGroup.getAllRenderBatches())
-					{
-						for (uint32_t instanceDataId : rb.getAllInstanceIDs())
-						{
-							InstanceData& data = m_instanceTable->getInstanceData(instanceDataId);
-							mapping[copiedInstances] = data;
-							++copiedInstances;
-						}
-					}
-				}
+				bool isStatic = i < rb.getStaticInstanceCount();
+				std::vector<uint32_t>& slotInstanceIDs = isStatic ? m_slotInstanceIDs : m_dynamicSlotInstanceIDs;
+				std::vector<std::pair<uint32_t, uint32_t>>& instanceSlots = isStatic ? m_instanceSlots : m_dynamicInstanceSlots;
+				instanceSlots.emplace_back(instanceIDs[i], static_cast<uint32_t>(slotInstanceIDs.size()));
+				slotInstanceIDs.push_back(instanceIDs[i]);
+			}
+		}
+		m_numStaticSlots = static_cast<uint32_t>(m_slotInstanceIDs.size());
+		m_numDynamicSlots = static_cast<uint32_t>(m_dynamicSlotInstanceIDs.size());
+		ENGI_ASSERT(m_numStaticSlots + m_numDynamicSlots == m_bufferInstances && "Internal error");
+		std::ranges::sort(m_instanceSlots);
+		std::ranges::sort(m_dynamicInstanceSlots);
+
+		if (m_numDynamicSlots > m_dynamicCapacity)
+		{
+			if (!resizeDynamicInstanceBuffers())
+				return false;
+		}
+
+		// Mirrors still describe the contents of the static buffers, thus only the slots whose instance has moved are reuploaded
+		uploadInstanceRange(0, m_numStaticSlots);
+		uploadDynamicInstances();
+		m_uploadedViewMasks.clear();
+		m_instanceTable->clearDirty();
+		return true;
+	}
+
+	void MeshManager::uploadDirtyInstances() noexcept
+	{
+		if (!m_instanceTable->hasDirtyData())
+			return;
+
+		if (m_instanceTable->isAllDirty())
+		{
+			uploadInstanceRange(0, m_numStaticSlots);
+			uploadDynamicInstances();
+			m_instanceTable->clearDirty();
+			return;
+		}
+
+		std::vector<uint32_t> dirtySlots;
+		bool isDynamicDirty = false;
+		for (uint32_t instanceDataId : m_instanceTable->getDirtyIDs())
+		{
+			auto first = std::ranges::lower_bound(m_instanceSlots, std::make_pair(instanceDataId, 0u));
+			for (auto it = first; it != m_instanceSlots.end() && it->first == instanceDataId; ++it)
+				dirtySlots.push_back(it->second);
+
+			if (!isDynamicDirty)
+			{
+				auto dynamicSlot = std::ranges::lower_bound(m_dynamicInstanceSlots, std::make_pair(instanceDataId, 0u));
+				isDynamicDirty = (dynamicSlot != m_dynamicInstanceSlots.end() && dynamicSlot->first == instanceDataId);
+			}
+		}
+		m_instanceTable->clearDirty();
+
+		// Dynamic instances are expected to change every frame, they are restreamed as a whole instead of being tracked per slot
+		if (isDynamicDirty)
+			uploadDynamicInstances();
+
+		if (dirtySlots.empty())
+			return;
+
+		// Coalesce close slots into ranges, clean slots in small gaps are reuploaded as well
+		std::ranges::sort(dirtySlots);
+		uint32_t rangeBegin = dirtySlots[0];
+		uint32_t rangeEnd = rangeBegin + 1;
+		for (size_t i = 1; i < dirtySlots.size(); ++i)
+		{
+			uint32_t slot = dirtySlots[i];
+			if (slot - rangeEnd <= MAX_UPLOAD_GAP)
+			{
+				rangeEnd = slot + 1;
+				continue;
 			}
+
+			uploadInstanceRange(rangeBegin, rangeEnd - rangeBegin);
+			rangeBegin = slot;
+			rangeEnd = slot + 1;
+		}
+		uploadInstanceRange(rangeBegin, rangeEnd - rangeBegin);
+	}
+
+	void MeshManager::uploadInstanceRange(uint32_t firstSlot, uint32_t numSlots) noexcept
+	{
+		if (numSlots == 0)
+			return;
+
+		ENGI_ASSERT(firstSlot + numSlots <= m_slotInstanceIDs.size() && "Internal error");
+		const InstanceTable& instanceTable = *m_instanceTable;
+		m_uploadStaging.resize(numSlots);
+		m_animationStaging.resize(numSlots);
+		for (uint32_t i = 0; i < numSlots; ++i)
+		{
+			const InstanceData& data = instanceTable.getInstanceData(m_slotInstanceIDs[firstSlot + i]);
+			m_uploadStaging[i] = GpuInstanceData::pack(data);
+			m_animationStaging[i] = GpuInstanceAnimation::pack(data);
+		}
+
+		// Streams are updated independently, thus animating an instance does not reupload its transform and vice versa
+		m_numUploadedBytes += uploadChangedSlots(m_instanceBuffer.get(), m_uploadedInstances, m_uploadStaging, firstSlot);
+		m_numUploadedBytes += uploadChangedSlots(m_animationBuffer.get(), m_uploadedAnimations, m_animationStaging, firstSlot);
+	}
+
+	void MeshManager::uploadDynamicInstances() noexcept
+	{
+		if (m_numDynamicSlots == 0)
+			return;
+
+		const InstanceTable& instanceTable = *m_instanceTable;
+		GpuInstanceData* instances = reinterpret_cast<GpuInstanceData*>(m_dynamicInstanceBuffer->map());
+		GpuInstanceAnimation* animations = reinterpret_cast<GpuInstanceAnimation*>(m_dynamicAnimationBuffer->map());
+		for (uint32_t slot = 0; slot < m_numDynamicSlots; ++slot)
+		{
+			const InstanceData& data = instanceTable.getInstanceData(m_dynamicSlotInstanceIDs[slot]);
+			instances[slot] = GpuInstanceData::pack(data);
+			animations[slot] = GpuInstanceAnimation::pack(data);
+		}
+		m_dynamicInstanceBuffer->unmap();
+		m_dynamicAnimationBuffer->unmap();
+
+		m_numUploadedBytes += m_numDynamicSlots * (sizeof(GpuInstanceData) + sizeof(GpuInstanceAnimation));
+	}
+
+	void MeshManager::uploadViewMasks() noexcept
+	{
+		// Only cube volumes produce meaningful masks, other volumes leave the buffer as it is
+		if (!m_cullingVolume || !m_cullingVolume->isCube)
+			return;
+
+		std::vector<uint32_t> viewMasks(m_bufferInstances, 0);
+		for (const DrawBatch& drawBatch : m_batches)
+		{
+			const RenderBatch& rb = drawBatch.batch;
+			const std::vector<uint32_t>& batchMasks = rb.getViewMasks();
+			auto dynamicMasks = batchMasks.begin() + rb.getStaticInstanceCount();
+			std::copy(batchMasks.begin(), dynamicMasks, viewMasks.begin() + rb.getStaticBufferOffset());
+			std::copy(dynamicMasks, batchMasks.end(), viewMasks.begin() + m_numStaticSlots + rb.getDynamicBufferOffset());
 		}
-		ENGI_ASSERT(copiedInstances == m_bufferInstances && "Internal error");
-		m_instanceBuffer->unmap();
+
+		if (viewMasks == m_uploadedViewMasks)
+			return;
+
+		uint32_t* mapping = reinterpret_cast<uint32_t*>(m_viewMaskBuffer->map());
+		std::ranges::copy(viewMasks, mapping);
+		m_viewMaskBuffer->unmap();
+
+		m_numUploadedBytes += m_bufferInstances * sizeof(uint32_t);
+		m_uploadedViewMasks = std::move(viewMasks);
+	}
+
+	bool MeshManager::updateGroupLayout() noexcept
+	{
+		m_groupLayoutRequested = false;
+		m_dirtyGroups.clear();
+
+		// Groups are laid out one after another, each of them occupies a single range that is shared by all of its meshes
+		uint32_t numSlots = 0;
+		for (GroupEntry& entry : m_groups)
+		{
+			entry.bufferOffset = numSlots;
+			entry.numSlots = entry.group->getNumInstances();
+			numSlots += entry.numSlots;
+		}
+		m_numGroupSlots = numSlots;
+
+		if (m_numGroupSlots > m_groupCapacity)
+		{
+			if (!resizeGroupBuffers())
+				return false;
+		}
+
+		// Mirror still describes the contents of the buffer, thus groups that have not moved are not reuploaded
+		for (const GroupEntry& entry : m_groups)
+			uploadGroup(entry);
+
+		m_uploadedGroupViewMasks.clear();
 		return true;
 	}
 
+	void MeshManager::uploadDirtyGroups() noexcept
+	{
+		if (m_dirtyGroups.empty())
+			return;
+
+		std::ranges::sort(m_dirtyGroups);
+		auto [first, last] = std::ranges::unique(m_dirtyGroups);
+		m_dirtyGroups.erase(first, last);
+		for (uint32_t groupId : m_dirtyGroups)
+		{
+			if (m_groups.isOccupied(groupId))
+				uploadGroup(m_groups[groupId]);
+		}
+		m_dirtyGroups.clear();
+	}
+
+	void MeshManager::uploadGroup(const GroupEntry& entry) noexcept
+	{
+		if (entry.numSlots == 0)
+			return;
+
+		ENGI_ASSERT(entry.bufferOffset + entry.numSlots <= m_numGroupSlots && "Internal error");
+		m_groupStaging.resize(entry.numSlots);
+		entry.group->packInstances(m_groupStaging.data(), 0, entry.numSlots);
+		m_numUploadedBytes += uploadChangedSlots(m_groupInstanceBuffer.get(), m_uploadedGroupInstances, m_groupStaging, entry.bufferOffset);
+	}
+
+	void MeshManager::uploadGroupViewMasks() noexcept
+	{
+		// Same as with batches, only cube volumes produce meaningful masks. Every instance of a cluster gets the mask of the cluster
+		if (!m_cullingVolume || !m_cullingVolume->isCube || m_numGroupSlots == 0)
+			return;
+
+		std::vector<uint32_t> viewMasks(m_numGroupSlots, 0);
+		for (const GroupEntry& entry : m_groups)
+		{
+			const std::vector<InstanceGroup::Cluster>& clusters = entry.group->getClusters();
+			for (uint32_t i = 0; i < static_cast<uint32_t>(clusters.size()); ++i)
+				std::fill_n(viewMasks.begin() + entry.bufferOffset + clusters[i].first, clusters[i].count, entry.clusterViewMasks[i]);
+		}
+
+		if (viewMasks == m_uploadedGroupViewMasks)
+			return;
+
+		uint32_t* mapping = reinterpret_cast<uint32_t*>(m_groupViewMaskBuffer->map());
+		std::ranges::copy(viewMasks, mapping);
+		m_groupViewMaskBuffer->unmap();
+
+		m_numUploadedBytes += m_numGroupSlots * sizeof(uint32_t);
+		m_uploadedGroupViewMasks = std::move(viewMasks);
+	}
+
 	bool MeshManager::resizeInstanceBuffer() noexcept
 	{
 		uint32_t newCap = m_bufferCapacity * 2;
 		m_bufferCapacity = (m_bufferInstances > newCap) ? m_bufferInstances + 1 : newCap;
-		DynamicBuffer* buffer = m_renderer->createDynamicBuffer("MeshManager::InstanceBuffer", nullptr, m_bufferCapacity, sizeof(InstanceData));
+
+		// The whole buffer is reuploaded after the resize, there is nothing to copy
+		LongLivedBuffer* buffer = m_renderer->createLongLivedBuffer("MeshManager::InstanceBuffer", nullptr, m_bufferCapacity, sizeof(GpuInstanceData));
 		if (!buffer)
 		{
 			ENGI_LOG_WARN("Failed to resize instance buffer");
-			delete buffer;
 			return false;
 		}
-
-		buffer->copyFrom(m_instanceBuffer.get(), 0);
 		m_instanceBuffer.reset(buffer);
+
+		LongLivedBuffer* animationBuffer = m_renderer->createLongLivedBuffer("MeshManager::AnimationBuffer", nullptr, m_bufferCapacity, sizeof(GpuInstanceAnimation));
+		if (!animationBuffer)
+		{
+			ENGI_LOG_WARN("Failed to resize instance animation buffer");
+			return false;
+		}
+		m_animationBuffer.reset(animationBuffer);
+		m_uploadedInstances.clear();
+		m_uploadedAnimations.clear();
+
+		DynamicBuffer* maskBuffer = m_renderer->createDynamicBuffer("MeshManager::ViewMaskBuffer", nullptr, m_bufferCapacity, sizeof(uint32_t));
+		if (!maskBuffer)
+		{
+			ENGI_LOG_WARN("Failed to resize view mask buffer");
+			return false;
+		}
+		m_viewMaskBuffer.reset(maskBuffer);
 		return true;
 	}
 
-	uint32_t MeshManager::renderMaterialGroup(MaterialGroup& materialGroup, uint32_t instanceOffset) noexcept
+	bool MeshManager::resizeDynamicInstanceBuffers() noexcept
 	{
-		using namespace gfx;
+		m_dynamicCapacity = std::max(m_dynamicCapacity * 2, m_numDynamicSlots);
+
+		// Dynamic stream is rewritten as a whole after the resize
+		DynamicBuffer* buffer = m_renderer->createDynamicBuffer("MeshManager::DynamicInstanceBuffer", nullptr, m_dynamicCapacity, sizeof(GpuInstanceData));
+		if (!buffer)
+		{
+			ENGI_LOG_WARN("Failed to resize dynamic instance buffer");
+			return false;
+		}
+		m_dynamicInstanceBuffer.reset(buffer);
+
+		DynamicBuffer* animationBuffer = m_renderer->createDynamicBuffer("MeshManager::DynamicAnimationBuffer", nullptr, m_dynamicCapacity, sizeof(GpuInstanceAnimation));
+		if (!animationBuffer)
+		{
+			ENGI_LOG_WARN("Failed to resize dynamic instance animation buffer");
+			return false;
+		}
+		m_dynamicAnimationBuffer.reset(animationBuffer);
+		return true;
+	}
+
+	bool MeshManager::resizeGroupBuffers() noexcept
+	{
+		m_groupCapacity = std::max(m_groupCapacity * 2, m_numGroupSlots);
 
+		// The whole buffer is reuploaded after the resize, there is nothing to copy
+		LongLivedBuffer* buffer = m_renderer->createLongLivedBuffer("MeshManager::GroupInstanceBuffer", nullptr, m_groupCapacity, sizeof(GpuInstanceData));
+		if (!buffer)
+		{
+			ENGI_LOG_WARN("Failed to resize group instance buffer");
+			return false;
+		}
+		m_groupInstanceBuffer.reset(buffer);
+		m_uploadedGroupInstances.clear();
+
+		// Group instances are never animated and have no instance IDs, thus animation stream is filled once with the defaults
+		std::vector<GpuInstanceAnimation> animations(m_groupCapacity, GpuInstanceAnimation::pack(InstanceData()));
+		LongLivedBuffer* animationBuffer = m_renderer->createLongLivedBuffer("MeshManager::GroupAnimationBuffer", animations.data(), m_groupCapacity, sizeof(GpuInstanceAnimation));
+		if (!animationBuffer)
+		{
+			ENGI_LOG_WARN("Failed to resize group animation buffer");
+			return false;
+		}
+		m_groupAnimationBuffer.reset(animationBuffer);
+
+		DynamicBuffer* maskBuffer = m_renderer->createDynamicBuffer("MeshManager::GroupViewMaskBuffer", nullptr, m_groupCapacity, sizeof(uint32_t));
+		if (!maskBuffer)
+		{
+			ENGI_LOG_WARN("Failed to resize group view mask buffer");
+			return false;
+		}
+		m_groupViewMaskBuffer.reset(maskBuffer);
+		m_uploadedGroupViewMasks.clear();
+		return true;
+	}
+
+	uint32_t MeshManager::renderDraws(bool bindMaterials) noexcept
+	{
+		// Every model lives in the geometry pool, thus its buffers are bound once and draws only differ in base vertex and start index
+		m_renderer->getModelRegistry()->getGeometryPool()->bind();
+
+		// Partitions are drawn one after another, so that instance streams are only switched once
 		uint32_t resultOffset = 0;
-		for (auto& [model, modelGroup] : materialGroup.getAllModelGroups())
+		if (m_numStaticSlots > 0)
 		{
-			model->getVBO()->bind(0, 0);
-			model->getIBO()->bind(0);
+			m_instanceBuffer->bind(1, 0);
+			m_viewMaskBuffer->bind(2, 0);
+			m_animationBuffer->bind(3, 0);
+			resultOffset += renderPartition(false, bindMaterials);
+		}
 
-			uint32_t numMeshes = modelGroup.getNumMeshes();
-			for (uint32_t meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
-			{
-				const MeshGroup* meshGroup = modelGroup.getMeshGroup(meshIndex);
-				ENGI_ASSERT(meshGroup);
+		if (m_numDynamicSlots > 0)
+		{
+			m_dynamicInstanceBuffer->bind(1, 0);
+			m_viewMaskBuffer->bind(2, m_numStaticSlots);
+			m_dynamicAnimationBuffer->bind(3, 0);
+			resultOffset += renderPartition(true, bindMaterials);
+		}
+
+		if (m_numGroupSlots > 0)
+		{
+			m_groupInstanceBuffer->bind(1, 0);
+			m_groupViewMaskBuffer->bind(2, 0);
+			m_groupAnimationBuffer->bind(3, 0);
+			resultOffset += renderGroups(bindMaterials);
+		}
+		return resultOffset;
+	}
 
-				const StaticMeshEntry& meshEntry = model->getStaticMeshEntries()[meshIndex];
-				const MeshRange& meshRange = meshEntry.range;
+	uint32_t MeshManager::renderPartition(bool dynamic, bool bindMaterials) noexcept
+	{
+		// Draws are sorted by their keys, thus state is only rebound when the corresponding part of the key changes
+		uint64_t prevKey = NO_KEY;
+		uint32_t resultOffset = 0;
+		for (const DrawItem& draw : m_draws)
+		{
+			const DrawBatch& drawBatch = m_batches[draw.batchId];
+			const RenderBatch& rb = drawBatch.batch;
+			const std::vector<RenderBatch::DrawRange>& ranges = rb.getDrawRanges();
+
+			// Static ranges precede the dynamic ones
+			bool hasRanges = !ranges.empty() && (dynamic ? rb.isDynamicRange(ranges.back()) : !rb.isDynamicRange(ranges.front()));
+			if (!hasRanges)
+				continue;
+
+			bindDraw(draw, prevKey, bindMaterials);
+			prevKey = draw.key;
+
+			const SharedHandle<Model>& model = drawBatch.model;
+			const MeshRange& meshRange = model->getStaticMeshEntries()[drawBatch.meshIndex].range;
+			GeometryRange geometry = model->getGeometryRange();
+			uint32_t startIndex = geometry.baseIndex + meshRange.iboOffset;
+			uint32_t baseVertex = geometry.baseVertex + meshRange.vboOffset;
+			for (const RenderBatch::DrawRange& range : ranges)
+			{
+				if (rb.isDynamicRange(range) != dynamic)
+					continue;
 
-				MeshData meshData;
-				meshData.meshToModel = meshEntry.mesh.getMeshToModel();
-				meshData.modelToMesh = meshEntry.mesh.getModelToMesh();
-				meshData.hasTexCoords = (uint32_t)meshEntry.mesh.hasTexCoords();
-				m_meshData->upload(0, &meshData, sizeof(MeshData));
-				m_meshData->bind(1, VERTEX_SHADER | PIXEL_SHADER);
+				m_renderer->drawInstancedIndexed(meshRange.numIndices, range.count, startIndex, baseVertex, rb.getBufferOffset(range));
+				resultOffset += range.count;
+			}
+		}
+		return resultOffset;
+	}
 
-				for (const RenderBatch& rb : meshGroup->getAllRenderBatches())
+	uint32_t MeshManager::renderGroups(bool bindMaterials) noexcept
+	{
+		// Groups are drawn in the order of batches of their meshes, so that state is rebound as rarely as for the other partitions
+		uint64_t prevKey = NO_KEY;
+		uint32_t resultOffset = 0;
+		for (const DrawItem& draw : m_draws)
+		{
+			const DrawBatch& drawBatch = m_batches[draw.batchId];
+			bool hasRanges = std::ranges::any_of(drawBatch.groupIds, [this](uint32_t groupId) { return !m_groups[groupId].drawRanges.empty(); });
+			if (!hasRanges)
+				continue;
+
+			bindDraw(draw, prevKey, bindMaterials);
+			prevKey = draw.key;
+
+			const SharedHandle<Model>& model = drawBatch.model;
+			const MeshRange& meshRange = model->getStaticMeshEntries()[drawBatch.meshIndex].range;
+			GeometryRange geometry = model->getGeometryRange();
+			uint32_t startIndex = geometry.baseIndex + meshRange.iboOffset;
+			uint32_t baseVertex = geometry.baseVertex + meshRange.vboOffset;
+			for (uint32_t groupId : drawBatch.groupIds)
+			{
+				const GroupEntry& entry = m_groups[groupId];
+				for (const RenderBatch::DrawRange& range : entry.drawRanges)
 				{
-					uint32_t numInstances = rb.getInstanceCount();
-					if (numInstances == 0)
-						continue;
-
-					const MaterialInstance& mi = rb.getMaterialInstance();
-					mi.bindTexture(TEXTURE_ALBEDO, 0, PIXEL_SHADER);
-					mi.bindTexture(TEXTURE_NORMAL, 1, PIXEL_SHADER);
-					mi.bindTexture(TEXTURE_METALNESS, 2, PIXEL_SHADER);
-					mi.bindTexture(TEXTURE_ROUGHNESS, 3, PIXEL_SHADER);
-					
-					ENGI_MaterialData materialData(mi.getData());
-					m_materialData->upload(0, &materialData, sizeof(ENGI_MaterialData));
-					m_materialData->bind(2, VERTEX_SHADER | PIXEL_SHADER);
-
-					m_renderer->drawInstancedIndexed(meshRange.numIndices, numInstances, meshRange.iboOffset, meshRange.vboOffset, instanceOffset);
-					resultOffset += numInstances;
-					instanceOffset += numInstances;
+					m_renderer->drawInstancedIndexed(meshRange.numIndices, range.count, startIndex, baseVertex, entry.bufferOffset + range.first);
+					resultOffset += range.count;
 				}
 			}
 		}
 		return resultOffset;
 	}
 
+	void MeshManager::bindDraw(const DrawItem& draw, uint64_t prevKey, bool bindMaterials) noexcept
+	{
+		using namespace gfx;
+
+		const MaterialInstance& mi = m_batches[draw.batchId].batch.getMaterialInstance();
+		if (bindMaterials && (prevKey == NO_KEY || DrawKey::getMaterial(prevKey) != DrawKey::getMaterial(draw.key)))
+			mi.getMaterial()->bind();
+
+		m_drawConstants->bindRange(1, VERTEX_SHADER | PIXEL_SHADER, draw.meshConstants, DRAW_CONSTANTS_ENTRY_SIZE);
+		m_drawConstants->bindRange(2, VERTEX_SHADER | PIXEL_SHADER, draw.materialConstants, DRAW_CONSTANTS_ENTRY_SIZE);
+
+		mi.bindTexture(TEXTURE_ALBEDO, 0, PIXEL_SHADER);
+		mi.bindTexture(TEXTURE_NORMAL, 1, PIXEL_SHADER);
+		mi.bindTexture(TEXTURE_METALNESS, 2, PIXEL_SHADER);
+		mi.bindTexture(TEXTURE_ROUGHNESS, 3, PIXEL_SHADER);
+	}
+
 }; // engi namespace
\ No newline at end of file
@@ -1,13 +1,18 @@
 #pragma once
 
-#include <map>
+#include <unordered_map>
 #include <vector>
 #include "Utility/SolidVector.h"
 #include "Utility/Memory.h"
+#include "Utility/Optional.h"
+#include "Utility/ArrayView.h"
+#include "Math/Math.h"
 #include "Renderer/Model.h"
 #include "Renderer/Material.h"
 #include "Renderer/MaterialInstance.h"
 #include "Renderer/ShaderProgram.h"
+#include "Renderer/InstanceData.h"
+#include "Renderer/InstanceGroup.h"
 
 namespace engi
 {
@@ -15,65 +20,177 @@ namespace engi
 	class Renderer;
 	class ConstantBuffer;
 	class DynamicBuffer;
+	class LongLivedBuffer;
 	class InstanceTable;
 
+	// Volume that instances are culled against. Frustum volumes produce a single visibility bit, cube volumes (omnidirectional shadows)
+	// produce a bit per cube face. The resulting mask is available to shaders as INSTANCE_VIEW_MASK, it is only uploaded for cube volumes
+	struct CullingVolume
+	{
+		static constexpr uint32_t VIEW_MASK_ALL = uint32_t(-1);
+
+		static CullingVolume fromFrustum(const math::Frustum& frustum) noexcept;
+		static CullingVolume fromCube(const math::Vec3& center, float radius, const std::array<math::Frustum, 6>& faces) noexcept;
+
+		// Returns the view mask of the box given in model space, zero if the box is not visible at all
+		uint32_t test(const math::AABB& modelAABB, const math::Mat4x4& modelToWorld) const noexcept;
+
+		bool isCube = false;
+		math::Frustum frustum;
+		math::Vec3 center;
+		float radius = 0.0f;
+		std::array<math::Frustum, 6> faces;
+	};
+
 	class RenderBatch
 	{
 	public:
+		// Culled instances between two visible runs are still drawn if there are at most that many of them,
+		// it is cheaper than splitting the draw call
+		static constexpr uint32_t MAX_DRAW_GAP = 4;
+
+		// Contiguous run of instances to draw, relative to the beginning of the batch
+		struct DrawRange
+		{
+			uint32_t first;
+			uint32_t count;
+		};
+
 		RenderBatch(const MaterialInstance& materialInstance);
 		~RenderBatch() = default;
 
 		const MaterialInstance& getMaterialInstance() const noexcept { return m_materialInstance; }
 		uint32_t getInstanceCount() const noexcept { return static_cast<uint32_t>(m_instanceDataIDs.size()); }
 		void submitInstanceData(uint32_t instanceDataId) noexcept;
+		void reserve(uint32_t numInstances) noexcept;
 		bool removeInstanceData(uint32_t instanceDataId) noexcept;
 		const auto& getAllInstanceIDs() const noexcept { return m_instanceDataIDs; }
 		bool isEmpty() const noexcept { return getInstanceCount() == 0; }
 
+		// Static instances are kept at the front of the batch and dynamic ones at the back. Called by MeshManager when the layout is rebuilt
+		void partitionByMobility(const InstanceTable& instanceTable) noexcept;
+		uint32_t getStaticInstanceCount() const noexcept { return m_numStaticInstances; }
+
+		// Static instances of the batch occupy a contiguous range of the static instance buffer, dynamic ones a range of the dynamic
+		// instance stream. Offsets of the ranges are assigned by MeshManager
+		uint32_t getStaticBufferOffset() const noexcept { return m_staticBufferOffset; }
+		uint32_t getDynamicBufferOffset() const noexcept { return m_dynamicBufferOffset; }
+		void setBufferOffsets(uint32_t staticOffset, uint32_t dynamicOffset) noexcept { m_staticBufferOffset = staticOffset; m_dynamicBufferOffset = dynamicOffset; }
+
+		// Draw ranges never mix static and dynamic instances. Buffer offset is relative to the buffer of the range's partition
+		bool isDynamicRange(const DrawRange& range) const noexcept { return range.first >= m_numStaticInstances; }
+		uint32_t getBufferOffset(const DrawRange& range) const noexcept;
+
+		// Visibility is updated by MeshManager during culling. View masks are stored per instance of the batch, zero for culled ones
+		uint32_t getVisibleInstanceCount() const noexcept { return m_numVisibleInstances; }
+		const auto& getViewMasks() const noexcept { return m_viewMasks; }
+		const auto& getDrawRanges() const noexcept { return m_drawRanges; }
+		void resetVisibility() noexcept;
+		void cullInstances(const InstanceTable& instanceTable, const CullingVolume& volume, const math::AABB& modelAABB) noexcept;
+
 	private:
 		MaterialInstance m_materialInstance;
 		std::vector<uint32_t> m_instanceDataIDs;
+		std::unordered_map<uint32_t, uint32_t> m_instancePositions; // instanceDataId -> index in m_instanceDataIDs
+		uint32_t m_numStaticInstances = 0;
+		uint32_t m_staticBufferOffset = 0;
+		uint32_t m_dynamicBufferOffset = 0;
+		uint32_t m_numVisibleInstances = 0;
+		std::vector<uint32_t> m_viewMasks;
+		std::vector<DrawRange> m_drawRanges;
 	};
 
-	struct MeshGroup
+	// Draws are identified by 64-bit keys, sorting by a key groups draws by material, then by model, mesh and material instance,
+	// which is the order their state is bound in. Each component is a small ID assigned by MeshManager
+	struct DrawKey
 	{
-		RenderBatch* getRenderBatch(const MaterialInstance& materialInstance) noexcept;
-		RenderBatch* addRenderBatch(const MaterialInstance& materialInstance) noexcept;
-		bool removeRenderBatch(const MaterialInstance& materialInstance) noexcept;
-		const auto& getAllRenderBatches() const noexcept { return renderBatches; }
+		static constexpr uint32_t MATERIAL_BITS = 12;
+		static constexpr uint32_t MODEL_BITS = 20;
+		static constexpr uint32_t MESH_BITS = 12;
+		static constexpr uint32_t MATERIAL_INSTANCE_BITS = 20;
+
+		static constexpr uint32_t MATERIAL_SHIFT = MODEL_BITS + MESH_BITS + MATERIAL_INSTANCE_BITS;
+		static constexpr uint32_t MODEL_SHIFT = MESH_BITS + MATERIAL_INSTANCE_BITS;
+		static constexpr uint32_t MESH_SHIFT = MATERIAL_INSTANCE_BITS;
+
+		static constexpr uint64_t make(uint32_t material, uint32_t model, uint32_t mesh, uint32_t materialInstance) noexcept
+		{
+			return (static_cast<uint64_t>(material) << MATERIAL_SHIFT)
+				| (static_cast<uint64_t>(model) << MODEL_SHIFT)
+				| (static_cast<uint64_t>(mesh) << MESH_SHIFT)
+				| static_cast<uint64_t>(materialInstance);
+		}
 
-		std::vector<RenderBatch> renderBatches;
+		static constexpr uint32_t getMaterial(uint64_t key) noexcept { return static_cast<uint32_t>(key >> MATERIAL_SHIFT); }
+		static constexpr uint32_t getModel(uint64_t key) noexcept { return static_cast<uint32_t>(key >> MODEL_SHIFT) & ((1u << MODEL_BITS) - 1); }
+		static constexpr uint32_t getMaterialInstance(uint64_t key) noexcept { return static_cast<uint32_t>(key) & ((1u << MATERIAL_INSTANCE_BITS) - 1); }
+
+		// Model and mesh bits together, draws of the same mesh share them
+		static constexpr uint64_t getModelMesh(uint64_t key) noexcept { return key >> MESH_SHIFT; }
 	};
 
-	class ModelGroup
+	// Assigns small reusable IDs to keys (materials, models, material instances) that are referenced by draw keys.
+	// IDs are reference counted, the ID of a key is released once nothing references it anymore
+	template<typename Key, typename Hasher = std::hash<Key>>
+	class DrawKeyRegistry
 	{
 	public:
-		ModelGroup() = default; // TODO: Remove
-		ModelGroup(uint32_t numMeshes);
-		~ModelGroup() = default;
-
-		MeshGroup* getMeshGroup(uint32_t meshIndex) noexcept;
-		const MeshGroup* getMeshGroup(uint32_t meshIndex) const noexcept;
-		uint32_t getNumMeshes() const noexcept { return static_cast<uint32_t>(m_meshes.size()); }
-		const auto& getAllMeshGroups() const noexcept { return m_meshes; }
-	
-	private:
-		std::vector<MeshGroup> m_meshes;
-	};
+		static constexpr uint32_t INVALID_ID = uint32_t(-1);
 
-	struct MaterialGroup
-	{
-		ModelGroup* getModelGroup(const SharedHandle<Model>& model) noexcept;
-		ModelGroup* addModelGroup(const SharedHandle<Model>& model) noexcept;
-		const auto& getAllModelGroups() const noexcept { return modelMap; }
+		uint32_t find(const Key& key) const noexcept
+		{
+			auto it = m_lookup.find(key);
+			return (it == m_lookup.end()) ? INVALID_ID : it->second;
+		}
+
+		uint32_t acquire(const Key& key) noexcept
+		{
+			auto [it, inserted] = m_lookup.try_emplace(key, 0);
+			if (inserted)
+				it->second = m_entries.insert(Entry{ key, 0 });
+
+			++m_entries[it->second].refCount;
+			return it->second;
+		}
+
+		void release(uint32_t id) noexcept
+		{
+			Entry& entry = m_entries[id];
+			ENGI_ASSERT(entry.refCount > 0 && "Internal error");
+			if (--entry.refCount > 0)
+				return;
+
+			m_lookup.erase(entry.key);
+			m_entries.erase(id);
+		}
 
-		std::map<SharedHandle<Model>, ModelGroup> modelMap;
+		void clear() noexcept
+		{
+			m_lookup.clear();
+			m_entries.clear();
+		}
+
+	private:
+		struct Entry
+		{
+			Key key;
+			uint32_t refCount;
+		};
+
+		std::unordered_map<Key, uint32_t, Hasher> m_lookup;
+		SolidVector<Entry> m_entries;
 	};
 
 	class MeshManager
 	{
 	public:
-		static std::array<gfx::GpuInputAttributeDesc, 21> getInputAttributes(uint32_t perVertexSlot, uint32_t perInstanceSlot) noexcept;
+		static constexpr uint32_t INVALID_GROUP = uint32_t(-1);
+
+		// Per-instance data is split into two streams: GpuInstanceData at perInstanceSlot and GpuInstanceAnimation at animationSlot
+		static std::array<gfx::GpuInputAttributeDesc, 15> getInputAttributes(uint32_t perVertexSlot, uint32_t perInstanceSlot, uint32_t animationSlot) noexcept;
+
+		// Same as getInputAttributes, extended with INSTANCE_VIEW_MASK which is bound at viewMaskSlot
+		static std::array<gfx::GpuInputAttributeDesc, 16> getInputAttributesWithViewMask(uint32_t perVertexSlot, uint32_t perInstanceSlot, uint32_t animationSlot, uint32_t viewMaskSlot) noexcept;
 
 		MeshManager(Renderer* renderer, InstanceTable* instanceTable);
 		MeshManager(const MeshManager&) = delete;
@@ -85,33 +202,169 @@ namespace engi
 		void renderUsingMaterial(const SharedHandle<Material>& material) noexcept;
 		
 		bool submitInstance(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material, uint32_t instanceID) noexcept;
+
+		// Submits the mesh of all of the instances to the same batch with a single lookup. The layout is rebuilt and the instance buffer
+		// is resized at most once, on the next buffer update, no matter how many instances were submitted
+		bool submitInstances(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material, ArrayView<const uint32_t> instanceIDs) noexcept;
 		bool removeInstance(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material, uint32_t instanceID) noexcept;
 		bool updateInstance(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material, uint32_t instanceID, const MaterialInstance& newMat) noexcept;
 		bool updateInstance(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material, uint32_t instanceID) noexcept;
 		
+		// Instance groups are drawn with the batches of their meshes, but their instances live in a separate buffer, a contiguous range per group.
+		// Returns INVALID_GROUP if the group could not be added
+		uint32_t addInstanceGroup(const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, ArrayView<const math::Transformation> transforms, const math::Vec3& color = math::Vec3()) noexcept;
+		void removeInstanceGroup(uint32_t groupId) noexcept;
+		InstanceGroup* getInstanceGroup(uint32_t groupId) noexcept;
+
+		// Should be called whenever instances of the group were modified. Group is relaid out if the number of its instances has changed
+		void updateInstanceGroup(uint32_t groupId) noexcept;
+
 		inline InstanceTable* getInstanceTable() noexcept { return m_instanceTable; }
+		inline const InstanceTable* getInstanceTable() const noexcept { return m_instanceTable; }
 		inline constexpr uint32_t getNumInstances() const noexcept { return m_bufferInstances; }
 		inline constexpr void requestBufferUpdate() noexcept { m_bufferUpdateRequested = true; }
 
+		// Instances outside of the volume are skipped by subsequent render calls. Culling is performed when the instance buffer is updated
+		void setCullingVolume(const CullingVolume& volume) noexcept;
+		void setCullingFrustum(const math::Frustum& frustum) noexcept { setCullingVolume(CullingVolume::fromFrustum(frustum)); }
+		void disableCulling() noexcept;
+		inline constexpr uint32_t getNumVisibleInstances() const noexcept { return m_numVisibleInstances; }
+
+		// Number of instance slots of each partition, an instance occupies a slot per mesh of its model
+		inline constexpr uint32_t getNumStaticSlots() const noexcept { return m_numStaticSlots; }
+		inline constexpr uint32_t getNumDynamicSlots() const noexcept { return m_numDynamicSlots; }
+		inline constexpr uint32_t getNumGroupSlots() const noexcept { return m_numGroupSlots; }
+
+		// Number of bytes uploaded to the GPU (instances, their animation data and view masks) since the last reset
+		inline constexpr uint32_t getNumUploadedBytes() const noexcept { return m_numUploadedBytes; }
+		inline constexpr void resetUploadStatistics() noexcept { m_numUploadedBytes = 0; }
+
 	private:
+		// Dirty instances that are at most that many slots apart are uploaded with a single update
+		static constexpr uint32_t MAX_UPLOAD_GAP = 8;
+
+		// Every unique (model, mesh, material instance) combination is drawn with a single batch
+		struct DrawBatch
+		{
+			uint64_t key;
+			SharedHandle<Model> model;
+			uint32_t meshIndex;
+			RenderBatch batch;
+			std::vector<uint32_t> groupIds; // instance groups that are drawn with the batch
+		};
+
+		// Visibility of a group is computed per cluster. Draw ranges are relative to the group's range of the group buffer
+		struct GroupEntry
+		{
+			UniqueHandle<InstanceGroup> group;
+			std::vector<uint32_t> batchIds; // batch of every mesh of the group's model
+			uint32_t bufferOffset = 0;
+			uint32_t numSlots = 0; // number of instances the layout was built for
+			uint32_t numVisibleInstances = 0;
+			std::vector<uint32_t> clusterViewMasks;
+			std::vector<RenderBatch::DrawRange> drawRanges;
+		};
+
+		// Entry of the sorted draw list, batches are referenced by their ID. Constants are byte offsets into the draw constants buffer
+		struct DrawItem
+		{
+			uint64_t key;
+			uint32_t batchId;
+			uint32_t meshConstants;
+			uint32_t materialConstants;
+		};
+
+		// Every mesh and material instance constants entry occupies its own bindable range
+		static constexpr uint32_t DRAW_CONSTANTS_ENTRY_SIZE = gfx::CONSTANT_BUFFER_RANGE_ALIGNMENT;
+
+		static constexpr uint32_t INVALID_BATCH = uint32_t(-1);
+		static constexpr uint64_t NO_KEY = uint64_t(-1);
+
 		bool isValid(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material, uint32_t instanceDataId) const noexcept;
+		uint32_t findBatch(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material) const noexcept;
+		uint32_t addBatch(const SharedHandle<Model>& model, uint32_t meshIndex, const MaterialInstance& material) noexcept;
+		void removeBatch(uint32_t batchId) noexcept;
+		void removeEmptyBatches() noexcept;
+		void sortDraws() noexcept;
+		bool updateDrawConstants() noexcept;
+		void cullInstances() noexcept;
+		void cullGroup(GroupEntry& entry) const noexcept;
 		bool updateInstanceBuffer() noexcept;
+		bool updateInstanceLayout() noexcept;
+		void uploadDirtyInstances() noexcept;
+		void uploadInstanceRange(uint32_t firstSlot, uint32_t numSlots) noexcept;
+		void uploadDynamicInstances() noexcept;
+		void uploadViewMasks() noexcept;
+		bool updateGroupLayout() noexcept;
+		void uploadDirtyGroups() noexcept;
+		void uploadGroup(const GroupEntry& entry) noexcept;
+		void uploadGroupViewMasks() noexcept;
 		bool resizeInstanceBuffer() noexcept;
-		uint32_t renderMaterialGroup(MaterialGroup& materialGroup, uint32_t instanceOffset) noexcept;
+		bool resizeDynamicInstanceBuffers() noexcept;
+		bool resizeGroupBuffers() noexcept;
+		uint32_t renderDraws(bool bindMaterials) noexcept;
+		uint32_t renderPartition(bool dynamic, bool bindMaterials) noexcept;
+		uint32_t renderGroups(bool bindMaterials) noexcept;
+
+		// Material is only bound if it differs from the material of the previous draw
+		void bindDraw(const DrawItem& draw, uint64_t prevKey, bool bindMaterials) noexcept;
 
 		Renderer* m_renderer;
 		InstanceTable* m_instanceTable;
 
 		uint32_t m_bufferCapacity = 0;
 		uint32_t m_bufferInstances = 0;
+		uint32_t m_dynamicCapacity = 0;
+		uint32_t m_numStaticSlots = 0;
+		uint32_t m_numDynamicSlots = 0;
+		uint32_t m_groupCapacity = 0;
+		uint32_t m_numGroupSlots = 0;
+		uint32_t m_mobilityVersion = 0; // mobility version of the instance table the layout was built for
+		uint32_t m_numVisibleInstances = 0;
+		uint32_t m_numUploadedBytes = 0;
 		bool m_bufferUpdateRequested = false;
+		bool m_layoutUpdateRequested = false;
+		bool m_drawSortRequested = false;
+		bool m_groupLayoutRequested = false;
+		Optional<CullingVolume> m_cullingVolume;
+
+		// Persistent layout of the instance buffers. A single instance might occupy several slots, one per mesh of its model
+		std::vector<uint32_t> m_slotInstanceIDs;
+		std::vector<std::pair<uint32_t, uint32_t>> m_instanceSlots; // (instanceDataId, slot) pairs sorted by instanceDataId
+		std::vector<uint32_t> m_dynamicSlotInstanceIDs;
+		std::vector<std::pair<uint32_t, uint32_t>> m_dynamicInstanceSlots; // same as m_instanceSlots, for slots of the dynamic stream
+		std::vector<GpuInstanceData> m_uploadStaging;
+		std::vector<GpuInstanceAnimation> m_animationStaging;
+		std::vector<GpuInstanceData> m_uploadedInstances; // contents of the instance buffer, per slot
+		std::vector<GpuInstanceAnimation> m_uploadedAnimations; // contents of the animation buffer, per slot
+		std::vector<uint32_t> m_uploadedViewMasks;
+		std::vector<GpuInstanceData> m_groupStaging;
+		std::vector<GpuInstanceData> m_uploadedGroupInstances; // contents of the group instance buffer, per slot
+		std::vector<uint32_t> m_uploadedGroupViewMasks;
 		
 		ShaderProgram* m_layoutProgram = nullptr;
-		UniqueHandle<DynamicBuffer> m_instanceBuffer = nullptr;
-		UniqueHandle<ConstantBuffer> m_meshData = nullptr; // TODO: Remove this
-		UniqueHandle<ConstantBuffer> m_materialData = nullptr;
-		
-		std::map<SharedHandle<Material>, MaterialGroup> m_materialMap;
+		UniqueHandle<LongLivedBuffer> m_instanceBuffer = nullptr;
+		UniqueHandle<LongLivedBuffer> m_animationBuffer = nullptr;
+		UniqueHandle<DynamicBuffer> m_dynamicInstanceBuffer = nullptr; // rewritten with discard whenever a dynamic instance changes
+		UniqueHandle<DynamicBuffer> m_dynamicAnimationBuffer = nullptr;
+		UniqueHandle<DynamicBuffer> m_viewMaskBuffer = nullptr; // masks of dynamic slots follow the masks of static ones
+		UniqueHandle<LongLivedBuffer> m_groupInstanceBuffer = nullptr; // created with the first instance group
+		UniqueHandle<LongLivedBuffer> m_groupAnimationBuffer = nullptr; // group instances are not animated, it only holds the defaults
+		UniqueHandle<DynamicBuffer> m_groupViewMaskBuffer = nullptr;
+		UniqueHandle<ConstantBuffer> m_drawConstants = nullptr; // mesh and material instance constants of all draws
+		uint32_t m_drawConstantsCapacity = 0;
+		std::vector<uint8_t> m_drawConstantsStaging;
+
+		DrawKeyRegistry<SharedHandle<Material>> m_materialIDs;
+		DrawKeyRegistry<SharedHandle<Model>> m_modelIDs;
+		DrawKeyRegistry<MaterialInstance, MaterialInstanceHasher> m_materialInstanceIDs;
+		SolidVector<DrawBatch> m_batches;
+		std::unordered_map<uint64_t, uint32_t> m_batchLookup; // draw key -> batch ID
+		std::vector<uint32_t> m_emptyBatches; // batches that became empty since the last layout update
+		std::vector<DrawItem> m_draws; // rebuilt and sorted by key when batches are added or removed
+		std::vector<DrawItem> m_sortScratch;
+		SolidVector<GroupEntry> m_groups;
+		std::vector<uint32_t> m_dirtyGroups; // groups whose instances were modified since the last buffer update
 	};
 
 }; // engi namespace
\ No newline at end of file
@@ -2,10 +2,9 @@
 
 #include <type_traits>
 #include <algorithm>
+#include <cstring>
 #include "Core/CommonDefinitions.h"
-#include "GFX/GPUDevice.h"
-#include "Renderer/IndexBuffer.h"
-#include "Renderer/ImmutableBuffer.h"
+#include "Utility/JobSystem.h"
 
 // TODO: Remove this header
 #include <iostream>
@@ -21,19 +20,24 @@ namespace engi
 
 	bool StaticMeshEntry::initialize() noexcept
 	{
-		return bvh.initialize(&this->mesh);
+		// BVH might be already restored from the cooked mesh cache
+		return bvh.isInitialized() || bvh.initialize(&this->mesh);
 	}
 
-	Model::Model(const std::string& name, gfx::IGpuDevice* device, uint32_t staticMeshEntries)
+	Model::Model(const std::string& name, const SharedHandle<GeometryPool>& geometryPool, uint32_t staticMeshEntries)
 		: m_name(name)
-		, m_device(device)
+		, m_geometryPool(geometryPool)
 		, m_staticEntriesCapacity(staticMeshEntries)
 	{
+		ENGI_ASSERT(geometryPool && "Geometry pool cannot be nullptr");
 		m_staticMeshes.reserve(static_cast<size_t>(staticMeshEntries));
 	}
 
 	Model::~Model()
 	{
+		// Moved-from models do not own the pool's range
+		if (m_geometryPool)
+			m_geometryPool->free(m_geometryID);
 	}
 
 	bool Model::addStaticMeshEntry(StaticMeshEntry&& meshEntry) noexcept
@@ -68,6 +72,10 @@ namespace engi
 		//ENGI_ASSERT(validType && "StaticMesh indexing type is not suitable for Engi's index buffer");
 		uint32_t numVertices = 0;
 		uint32_t numIndices = 0;
+		std::vector<uint32_t> vertexOffsets;
+		std::vector<uint32_t> indexOffsets;
+		vertexOffsets.reserve(m_staticMeshes.size());
+		indexOffsets.reserve(m_staticMeshes.size());
 		for (StaticMeshEntry& entry : m_staticMeshes)
 		{
 			if (!entry.isValid())
@@ -76,38 +84,34 @@ namespace engi
 				return false;
 			}
 
-			entry.initialize();
+			vertexOffsets.push_back(numVertices);
+			indexOffsets.push_back(numIndices);
 			numVertices += entry.mesh.getNumVertices();
 			numIndices += entry.mesh.getNumTriangles() * 3;
 		}
 
-		std::vector<StaticMeshVertex> modelVertices;
-		std::vector<StaticMeshTriangle::IndexType> modelIndices;
-		modelVertices.reserve(numVertices);
-		modelIndices.reserve(numIndices);
-		for (const StaticMeshEntry& entry : m_staticMeshes)
-		{
-			std::ranges::copy(entry.mesh.getVertices(), std::back_inserter(modelVertices));
-
-			const StaticMesh::TriangleContainerType& triangles = entry.mesh.getTriangles();
-			for (const StaticMeshTriangle& tri : triangles)
+		// Every entry owns its slice of the shared buffers, thus BVH builds and copies of entries run in parallel, while the order is kept
+		static_assert(sizeof(StaticMeshTriangle) == 3 * sizeof(StaticMeshTriangle::IndexType), "Triangles should be tightly packed indices");
+		std::vector<StaticMeshVertex> modelVertices(numVertices);
+		std::vector<StaticMeshTriangle::IndexType> modelIndices(numIndices);
+		JobCounter counter;
+		JobSystem::get().dispatch(counter, static_cast<uint32_t>(m_staticMeshes.size()), 1, [&](uint32_t, uint32_t entryIndex)
 			{
-				modelIndices.push_back(tri.indices[0]);
-				modelIndices.push_back(tri.indices[1]);
-				modelIndices.push_back(tri.indices[2]);
-			}
-		}
-
-		m_vbo.reset(new ImmutableBuffer("Model_VBO_" + this->getPath(), m_device));
-		if (!m_vbo || !m_vbo->init(modelVertices.data(), numVertices, sizeof(StaticMeshVertex)))
-		{
-			std::cout << "Failed to create model's vertex buffer\n";
-			return false;
-		}
-		m_ibo.reset(new IndexBuffer("Model_IBO_" + this->getPath(), m_device));
-		if (!m_ibo || !m_ibo->initialize(modelIndices.data(), numIndices))
+				StaticMeshEntry& entry = m_staticMeshes[entryIndex];
+				entry.initialize();
+
+				const StaticMesh::VertexContainerType& vertices = entry.mesh.getVertices();
+				const StaticMesh::TriangleContainerType& triangles = entry.mesh.getTriangles();
+				std::memcpy(modelVertices.data() + vertexOffsets[entryIndex], vertices.data(), vertices.size() * sizeof(StaticMeshVertex));
+				std::memcpy(modelIndices.data() + indexOffsets[entryIndex], triangles.data(), triangles.size() * sizeof(StaticMeshTriangle));
+			});
+		JobSystem::get().wait(counter);
+
+		m_geometryPool->free(m_geometryID);
+		m_geometryID = m_geometryPool->allocate(modelVertices.data(), numVertices, modelIndices.data(), numIndices);
+		if (m_geometryID == GeometryPool::INVALID_ID)
 		{
-			std::cout << "Failed to create model's index buffer\n";
+			std::cout << "Failed to allocate model's geometry in the geometry pool\n";
 			return false;
 		}
 
@@ -2,16 +2,14 @@
 
 #include <vector>
 #include "Utility/Memory.h"
-#include "Renderer/StaticMeshTriangleOctree.h"
+#include "Renderer/StaticMeshBVH.h"
 #include "Renderer/StaticMesh.h"
+#include "Renderer/GeometryPool.h"
 
 namespace engi
 {
 
-	namespace gfx { class IGpuDevice; }
-	class ImmutableBuffer;
-	class IndexBuffer;
-
+	// Offsets are relative to the model's range in the geometry pool
 	struct MeshRange
 	{
 		uint32_t vboOffset;
@@ -31,16 +29,17 @@ namespace engi
 		inline constexpr bool isValid() const noexcept { return !mesh.isEmpty() && mesh.isVertexFull() && mesh.isTriangleFull(); }
 
 		StaticMesh mesh;
-		StaticMeshTriangleOctree bvh;
+		StaticMeshBVH bvh;
 		MeshRange range;
 	};
 
-	// Model is a container of immutable meshes with gpu objects needed to render it
+	// Model is a container of immutable meshes. Their geometry is suballocated from the shared geometry pool on initialization
+	// and given back when the model is destroyed
 	class Model
 	{
 	public:
 
-		Model(const std::string& name, gfx::IGpuDevice* device, uint32_t staticMeshEntries);
+		Model(const std::string& name, const SharedHandle<GeometryPool>& geometryPool, uint32_t staticMeshEntries);
 		Model(Model&&) = default;
 		Model& operator=(Model&&) = default;
 		~Model();
@@ -49,8 +48,9 @@ namespace engi
 		bool initialize() noexcept;
 		inline const auto& getStaticMeshEntries() const noexcept { return m_staticMeshes; };
 		inline auto& getStaticMeshEntries() noexcept { return m_staticMeshes; }; // TODO: Somehow get rid of this
-		inline ImmutableBuffer* getVBO() noexcept { return m_vbo.get(); }
-		inline IndexBuffer* getIBO() noexcept { return m_ibo.get(); }
+		// Base vertex and start index of the model in the geometry pool. Pool might move the model, thus the range should not be cached
+		inline GeometryRange getGeometryRange() const noexcept { return m_geometryPool->getRange(m_geometryID); }
+		inline bool isResident() const noexcept { return m_geometryID != GeometryPool::INVALID_ID; }
 		inline uint32_t getNumStaticMeshes() const noexcept { return static_cast<uint32_t>(m_staticMeshes.size()); }
 		inline constexpr const std::string& getName() const noexcept { return m_name; }
 		inline constexpr const std::string& getPath() const noexcept { return m_filepath; }
@@ -60,9 +60,8 @@ namespace engi
 	private:
 		std::string m_name;
 		std::string m_filepath;
-		gfx::IGpuDevice* m_device;
-		UniqueHandle<ImmutableBuffer> m_vbo = nullptr;
-		UniqueHandle<IndexBuffer> m_ibo = nullptr;
+		SharedHandle<GeometryPool> m_geometryPool;
+		uint32_t m_geometryID = GeometryPool::INVALID_ID;
 		uint32_t m_staticEntriesCapacity;
 		std::vector<StaticMeshEntry> m_staticMeshes;
 	};
@@ -1,8 +1,12 @@
 #include "Renderer/ModelLoader.h"
 
+#include <chrono>
+#include <algorithm>
+#include "Core/FileSystem.h"
 #include "Core/Logger.h"
 #include "Core/CommonDefinitions.h"
 #include "Renderer/AssimpUtils.h"
+#include "Renderer/MeshCache.h"
 
 namespace engi
 {
@@ -12,18 +16,25 @@ namespace engi
 		, m_modelRegistry(modelRegistry)
 		, m_materialRegistry(materialRegistry)
 	{
+		// Importers are created lazily by the thread that owns the slot, as most of the threads never import anything
+		m_importers.resize(JobSystem::get().numThreads());
 	}
 
-	static void processInstances(aiNode* node, SharedHandle<Model> model)
+	ModelLoader::~ModelLoader()
+	{
+		// JobSystem drains its jobs on deinit, so pending requests are always completed by now
+		for (const ModelLoadHandle& request : m_pendingLoads)
+			ENGI_ASSERT(request->m_counter.isDone() && "Model loader should outlive its pending requests");
+	}
+
+	static void processInstances(aiNode* node, std::vector<StaticMeshEntry>& entries)
 	{
 		ENGI_ASSERT(node && "Node cannot be nullptr");
-		ENGI_ASSERT(model && "Model cannot be nullptr");
 
 		math::Mat4x4 nodeToParent;
 		assimp::convertToMat4x4(node->mTransformation.Transpose(), nodeToParent);
 		math::Mat4x4 parentToNode = nodeToParent.inverse();
 
-		auto& entries = model->getStaticMeshEntries();
 		uint32_t numMeshes = node->mNumMeshes;
 		for (uint32_t i = 0; i < numMeshes; ++i)
 		{
@@ -36,65 +47,103 @@ namespace engi
 		uint32_t numChildren = node->mNumChildren;
 		for (uint32_t child = 0; child < numChildren; ++child)
 		{
-			processInstances(node->mChildren[child], model);
+			processInstances(node->mChildren[child], entries);
 		}
 	}
 
-	static void processTexture(TextureLoader* textureLoader,
-		const std::filesystem::path& modelFolder, aiMaterial* meshMaterial, aiTextureType assimpType, TextureType type, MaterialInstance& instance)
+	static std::string getTexturePath(const std::filesystem::path& modelFolder, aiMaterial* meshMaterial, aiTextureType assimpType)
 	{
 		aiString filename;
-		if (meshMaterial->GetTexture(assimpType, 0, &filename) == aiReturn_SUCCESS)
+		if (meshMaterial->GetTexture(assimpType, 0, &filename) != aiReturn_SUCCESS)
+			return std::string();
+
+		return (modelFolder / filename.C_Str()).string();
+	}
+
+	static void prefetchTextures(const CookedModel& cookedModel, std::vector<PrefetchedTexture>& textures)
+	{
+		std::vector<std::string> paths;
+		for (const CookedMaterial& material : cookedModel.materials)
 		{
-			std::string texturepath = (modelFolder / filename.C_Str()).string();
-			Texture2D* texture = textureLoader->getLibrary()->getTexture2D(texturepath);
-			if (!texture)
+			for (const std::string& path : material.texturePaths)
 			{
-				texture = textureLoader->loadTexture2D(texturepath, true);
-				if (!texture)
-					ENGI_LOG_ERROR("Failed to parse the {} texture", texturepath);
+				if (!path.empty())
+					paths.push_back(path);
 			}
-			instance.setTexture(type, texture);
 		}
+
+		std::sort(paths.begin(), paths.end());
+		paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+
+		textures.clear();
+		textures.resize(paths.size());
+		for (size_t i = 0; i < paths.size(); ++i)
+			textures[i].path = std::move(paths[i]);
+
+		// Texture files are read here, while DDS parsing and GPU upload are left to the main thread. Missing files are reported by it
+		JobCounter counter;
+		JobSystem::get().dispatch(counter, static_cast<uint32_t>(textures.size()), 1, [&textures](uint32_t, uint32_t textureIndex)
+			{
+				PrefetchedTexture& texture = textures[textureIndex];
+				if (!FileSystem::readFile(texture.path, texture.data))
+					texture.data.clear();
+			});
+		JobSystem::get().wait(counter);
 	}
 
-	ParsedModelInfo* ModelLoader::loadFromFBX(const std::string& filepath, const std::string& name, const SharedHandle<Material>& material) noexcept
+	static void processTexture(TextureLoader* textureLoader, const std::string& texturepath, TextureType type, MaterialInstance& instance, const std::vector<PrefetchedTexture>& textures)
 	{
-		ENGI_ASSERT(std::filesystem::path(filepath).extension() == ".fbx");
-		// try to find a cached fbx model info
-		ParsedModelInfo* cachedInfo = getParsedModel(filepath);
-		if (cachedInfo)
-			return cachedInfo;
+		if (texturepath.empty())
+			return;
+
+		Texture2D* texture = textureLoader->getLibrary()->getTexture2D(texturepath);
+		if (!texture)
+		{
+			auto it = std::find_if(textures.begin(), textures.end(), [&texturepath](const PrefetchedTexture& prefetched) { return prefetched.path == texturepath; });
+			if (it != textures.end() && !it->data.empty())
+				texture = textureLoader->loadTexture2D(texturepath, it->data.data(), it->data.size(), true);
+			else
+				texture = textureLoader->loadTexture2D(texturepath, true);
 
+			if (!texture)
+				ENGI_LOG_ERROR("Failed to parse the {} texture", texturepath);
+		}
+		instance.setTexture(type, texture);
+	}
+
+	static bool importWithAssimp(Assimp::Importer& importer, const std::string& filepath, CookedModel& cookedModel)
+	{
 		std::filesystem::path fullpath(filepath);
 		std::filesystem::path modelFolder = fullpath.parent_path();
 		uint32_t flags = aiProcess_Triangulate | aiProcess_GenBoundingBoxes | aiProcess_ConvertToLeftHanded | aiProcess_CalcTangentSpace;
-		const aiScene* scene = assimp::g_importer.ReadFile(filepath, flags);
-		if (!scene)
+		if (!importer.ReadFile(filepath, flags))
 		{
 			ENGI_LOG_ERROR("Assimp model loader failed to parse a model at {}. Aborting", filepath);
-			return nullptr;
+			return false;
 		}
 
+		// Waiting for the conversion jobs below might run another import on this thread's importer, thus the scene is taken from it
+		UniqueHandle<aiScene> sceneHandle = makeUnique<aiScene>(importer.GetOrphanedScene());
+		const aiScene* scene = sceneHandle.get();
+
 		ENGI_LOG_INFO("Parsing the {} model", filepath);
 		uint32_t numMeshes = scene->mNumMeshes;
+		cookedModel.entries.clear();
+		cookedModel.materials.clear();
+		cookedModel.entries.reserve(numMeshes);
+		cookedModel.materials.reserve(numMeshes);
 
-		SharedHandle<Model> model = m_modelRegistry->addModel(name, filepath, numMeshes);
-		ENGI_ASSERT(model->hasPath());
-
-		std::vector<MaterialInstance> materialInstances;
-		materialInstances.reserve(numMeshes);
-
+		// Ranges and materials are cheap, thus they are gathered first, so that meshes might be converted independently
+		std::vector<MeshRange> ranges(numMeshes);
 		uint32_t currentIndexOffset = 0;
 		uint32_t currentVertexOffset = 0;
 		for (uint32_t meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
 		{
 			const aiMesh* srcMesh = scene->mMeshes[meshIndex];
 			uint32_t numVertices = srcMesh->mNumVertices;
-			uint32_t numFaces = srcMesh->mNumFaces;
-			uint32_t numIndices = numFaces * 3; // assert triangles
+			uint32_t numIndices = srcMesh->mNumFaces * 3; // assert triangles
 
-			MeshRange dstRange;
+			MeshRange& dstRange = ranges[meshIndex];
 			dstRange.vboOffset = currentVertexOffset;
 			dstRange.iboOffset = currentIndexOffset;
 			dstRange.numVertices = numVertices;
@@ -102,44 +151,198 @@ namespace engi
 			currentVertexOffset += numVertices;
 			currentIndexOffset += numIndices;
 
-			StaticMesh dstMesh;
-			assimp::convertToStaticMesh(srcMesh, dstMesh, numVertices, numFaces, numIndices);
+			aiMaterial* meshMaterial = scene->mMaterials[srcMesh->mMaterialIndex];
+			CookedMaterial& cookedMaterial = cookedModel.materials.emplace_back();
+			cookedMaterial.name = std::string(meshMaterial->GetName().C_Str());
+			meshMaterial->Get(AI_MATKEY_METALLIC_FACTOR, cookedMaterial.metallic);
+			meshMaterial->Get(AI_MATKEY_ROUGHNESS_FACTOR, cookedMaterial.roughness);
+
+			int32_t twosided = 0;
+			meshMaterial->Get(AI_MATKEY_TWOSIDED, twosided);
+			cookedMaterial.twoSided = (bool)twosided;
+
+			cookedMaterial.texturePaths[TEXTURE_ALBEDO] = getTexturePath(modelFolder, meshMaterial, aiTextureType_DIFFUSE);
+			cookedMaterial.texturePaths[TEXTURE_NORMAL] = getTexturePath(modelFolder, meshMaterial, aiTextureType_NORMALS);
+			cookedMaterial.texturePaths[TEXTURE_METALNESS] = getTexturePath(modelFolder, meshMaterial, aiTextureType_METALNESS);
+			cookedMaterial.texturePaths[TEXTURE_ROUGHNESS] = getTexturePath(modelFolder, meshMaterial, aiTextureType_SHININESS);
+		}
+
+		// The scene is read-only at this point, every job writes only its own mesh
+		std::vector<StaticMesh> meshes(numMeshes);
+		JobCounter counter;
+		JobSystem::get().dispatch(counter, numMeshes, 1, [scene, &meshes, &ranges](uint32_t, uint32_t meshIndex)
+			{
+				const aiMesh* srcMesh = scene->mMeshes[meshIndex];
+				assimp::convertToStaticMesh(srcMesh, meshes[meshIndex], srcMesh->mNumVertices, srcMesh->mNumFaces, ranges[meshIndex].numIndices);
+			});
+		JobSystem::get().wait(counter);
+
+		for (uint32_t meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
+		{
+			StaticMesh& dstMesh = meshes[meshIndex];
 			ENGI_ASSERT(!dstMesh.isEmpty() && dstMesh.isVertexFull() && dstMesh.isTriangleFull() && "Mesh was loaded incorrectly");
+			cookedModel.entries.emplace_back(std::move(dstMesh), ranges[meshIndex]);
+		}
 
-			aiMaterial* meshMaterial = scene->mMaterials[srcMesh->mMaterialIndex];
-			float roughness = 0.0f;
-			float metallic = 0.0f;
-			meshMaterial->Get(AI_MATKEY_METALLIC_FACTOR, metallic);
-			meshMaterial->Get(AI_MATKEY_ROUGHNESS_FACTOR, roughness);
+		processInstances(scene->mRootNode, cookedModel.entries);
+		return true;
+	}
+
+	ParsedModelInfo* ModelLoader::loadFromFBX(const std::string& filepath, const std::string& name, const SharedHandle<Material>& material) noexcept
+	{
+		ENGI_ASSERT(std::filesystem::path(filepath).extension() == ".fbx");
+		// try to find a cached fbx model info
+		ParsedModelInfo* cachedInfo = getParsedModel(filepath);
+		if (cachedInfo)
+			return cachedInfo;
+
+		// The model might be already in flight, then there is no point to parse it twice
+		for (auto it = m_pendingLoads.begin(); it != m_pendingLoads.end(); ++it)
+		{
+			ModelLoadHandle request = *it;
+			if (request->m_filepath != filepath)
+				continue;
+
+			JobSystem::get().wait(request->m_counter);
+			m_pendingLoads.erase(it);
+			finalizeRequest(*request);
+			return request->m_result;
+		}
+
+		CookedModel cookedModel;
+		std::vector<PrefetchedTexture> textures;
+		if (!parseModel(filepath, cookedModel, textures, JobSystem::getThreadIndex()))
+			return nullptr;
+
+		return finalizeModel(filepath, name, material, cookedModel, textures);
+	}
+
+	ModelLoadHandle ModelLoader::loadModelAsync(const std::string& filepath, const std::string& name, const SharedHandle<Material>& material) noexcept
+	{
+		ENGI_ASSERT(std::filesystem::path(filepath).extension() == ".fbx");
+		ModelLoadHandle request = makeShared<ModelLoadRequest>(new ModelLoadRequest());
+		request->m_filepath = filepath;
+
+		ParsedModelInfo* cachedInfo = getParsedModel(filepath);
+		if (cachedInfo)
+		{
+			request->m_status = MODEL_LOAD_READY;
+			request->m_result = cachedInfo;
+			return request;
+		}
+
+		for (const ModelLoadHandle& pendingRequest : m_pendingLoads)
+		{
+			if (pendingRequest->m_filepath == filepath)
+				return pendingRequest;
+		}
+
+		request->m_name = name;
+		request->m_material = material;
+		m_pendingLoads.push_back(request);
+
+		// The request is kept alive by m_pendingLoads until the job is done, thus the raw pointer is safe to capture
+		ModelLoadRequest* requestPtr = request.get();
+		JobSystem::get().schedule(requestPtr->m_counter, [this, requestPtr](uint32_t threadIndex)
+			{
+				requestPtr->m_isParsed = parseModel(requestPtr->m_filepath, requestPtr->m_cookedModel, requestPtr->m_textures, threadIndex);
+			});
+		return request;
+	}
+
+	void ModelLoader::update() noexcept
+	{
+		for (size_t i = 0; i < m_pendingLoads.size();)
+		{
+			ModelLoadHandle request = m_pendingLoads[i];
+			if (!request->m_counter.isDone())
+			{
+				++i;
+				continue;
+			}
+
+			m_pendingLoads.erase(m_pendingLoads.begin() + i);
+			finalizeRequest(*request);
+		}
+	}
+
+	bool ModelLoader::parseModel(const std::string& filepath, CookedModel& cookedModel, std::vector<PrefetchedTexture>& textures, uint32_t threadIndex) noexcept
+	{
+		// Assimp import is only needed when there is no valid cooked file, which is written after the first successful import
+		auto loadBegin = std::chrono::steady_clock::now();
+		bool isCooked = MeshCache::load(filepath, cookedModel);
+		if (!isCooked)
+		{
+			ENGI_ASSERT(threadIndex < m_importers.size());
+			UniqueHandle<Assimp::Importer>& importer = m_importers[threadIndex];
+			if (!importer)
+				importer = makeUnique<Assimp::Importer>(new Assimp::Importer());
+
+			if (!importWithAssimp(*importer, filepath, cookedModel))
+				return false;
+
+			// BVHs are the most expensive part of the import, they are built here so that the main thread only creates GPU buffers
+			JobCounter counter;
+			std::vector<StaticMeshEntry>& entries = cookedModel.entries;
+			JobSystem::get().dispatch(counter, static_cast<uint32_t>(entries.size()), 1, [&entries](uint32_t, uint32_t entryIndex)
+				{
+					StaticMeshEntry& entry = entries[entryIndex];
+					if (entry.isValid())
+						entry.initialize();
+				});
+			JobSystem::get().wait(counter);
+
+			if (!MeshCache::save(filepath, cookedModel.entries, cookedModel.materials))
+				ENGI_LOG_WARN("Failed to cook the {} model, it will be imported with Assimp on the next load", filepath);
+		}
+
+		prefetchTextures(cookedModel, textures);
+
+		float loadTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - loadBegin).count();
+		ENGI_LOG_INFO("Parsed the {} model {} in {:.2f} ms", filepath, isCooked ? "from the cooked cache" : "with Assimp", loadTime);
+		return true;
+	}
+
+	ParsedModelInfo* ModelLoader::finalizeModel(const std::string& filepath, const std::string& name, const SharedHandle<Material>& material,
+		CookedModel& cookedModel, const std::vector<PrefetchedTexture>& textures) noexcept
+	{
+		uint32_t numMeshes = static_cast<uint32_t>(cookedModel.entries.size());
+		SharedHandle<Model> model = m_modelRegistry->addModel(name, filepath, numMeshes);
+		ENGI_ASSERT(model->hasPath());
+
+		std::vector<MaterialInstance> materialInstances;
+		materialInstances.reserve(numMeshes);
+		for (uint32_t meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
+		{
+			StaticMeshEntry& entry = cookedModel.entries[meshIndex];
+			const CookedMaterial& cookedMaterial = cookedModel.materials[meshIndex];
 
 			SharedHandle<Material> meshShading = nullptr;
 			if (!material)
 			{
-				int32_t twosided = 0;
-				meshMaterial->Get(AI_MATKEY_TWOSIDED, twosided);
-				dstMesh.setTwoSided((bool)twosided);
-				meshShading = m_materialRegistry->getMaterial(dstMesh.isTwoSided() ? MATERIAL_BRDF_PBR_NO_CULLING : MATERIAL_BRDF_PBR);
+				entry.mesh.setTwoSided(cookedMaterial.twoSided);
+				meshShading = m_materialRegistry->getMaterial(entry.mesh.isTwoSided() ? MATERIAL_BRDF_PBR_NO_CULLING : MATERIAL_BRDF_PBR);
 			}
 			else meshShading = material;
 
-			MaterialInstance currentMaterialInstance(std::string(meshMaterial->GetName().C_Str()), meshShading);
-			currentMaterialInstance.setRoughness(roughness);
-			currentMaterialInstance.setMetallic(metallic);
-			
-			processTexture(m_textureLoader, modelFolder, meshMaterial, aiTextureType_DIFFUSE, TEXTURE_ALBEDO, currentMaterialInstance);
-			processTexture(m_textureLoader, modelFolder, meshMaterial, aiTextureType_NORMALS, TEXTURE_NORMAL, currentMaterialInstance);
-			processTexture(m_textureLoader, modelFolder, meshMaterial, aiTextureType_METALNESS, TEXTURE_METALNESS, currentMaterialInstance);
-			processTexture(m_textureLoader, modelFolder, meshMaterial, aiTextureType_SHININESS, TEXTURE_ROUGHNESS, currentMaterialInstance);
-			if (currentMaterialInstance.isNormalMapUsed() && !dstMesh.hasTangents())
+			MaterialInstance currentMaterialInstance(cookedMaterial.name, meshShading);
+			currentMaterialInstance.setRoughness(cookedMaterial.roughness);
+			currentMaterialInstance.setMetallic(cookedMaterial.metallic);
+
+			processTexture(m_textureLoader, cookedMaterial.texturePaths[TEXTURE_ALBEDO], TEXTURE_ALBEDO, currentMaterialInstance, textures);
+			processTexture(m_textureLoader, cookedMaterial.texturePaths[TEXTURE_NORMAL], TEXTURE_NORMAL, currentMaterialInstance, textures);
+			processTexture(m_textureLoader, cookedMaterial.texturePaths[TEXTURE_METALNESS], TEXTURE_METALNESS, currentMaterialInstance, textures);
+			processTexture(m_textureLoader, cookedMaterial.texturePaths[TEXTURE_ROUGHNESS], TEXTURE_ROUGHNESS, currentMaterialInstance, textures);
+			if (currentMaterialInstance.isNormalMapUsed() && !entry.mesh.hasTangents())
 			{
 				ENGI_ASSERT(false && "Failed to correctly load the tangents for normal map");
 			}
 
 			materialInstances.push_back(std::move(currentMaterialInstance));
-			model->addStaticMeshEntry(StaticMeshEntry(std::move(dstMesh), dstRange));
+			model->addStaticMeshEntry(std::move(entry));
 		}
 
-		processInstances(scene->mRootNode, model);
+		// BVHs are already built by parseModel(), thus it only creates GPU buffers
 		if (!model->initialize())
 		{
 			ENGI_LOG_ERROR("Failed to initialize model {}", filepath);
@@ -153,6 +356,19 @@ namespace engi
 		return &info;
 	}
 
+	void ModelLoader::finalizeRequest(ModelLoadRequest& request) noexcept
+	{
+		ENGI_ASSERT(request.m_counter.isDone() && "Request should be parsed before it is finalized");
+		if (request.m_isParsed)
+			request.m_result = finalizeModel(request.m_filepath, request.m_name, request.m_material, request.m_cookedModel, request.m_textures);
+
+		request.m_status = request.m_result ? MODEL_LOAD_READY : MODEL_LOAD_FAILED;
+		request.m_cookedModel = CookedModel();
+		request.m_textures = std::vector<PrefetchedTexture>();
+		if (!request.m_result)
+			ENGI_LOG_ERROR("Failed to asynchronously load the {} model", request.m_filepath);
+	}
+
 	ParsedModelInfo* ModelLoader::getParsedModel(const std::string& filepath) noexcept
 	{
 		auto it = m_parsedFiles.find(filepath);
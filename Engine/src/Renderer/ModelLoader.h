@@ -9,6 +9,10 @@
 #include "Renderer/ModelRegistry.h"
 #include "Renderer/TextureLoader.h"
 #include "Renderer/MaterialRegistry.h"
+#include "Renderer/MeshCache.h"
+#include "Utility/JobSystem.h"
+
+namespace Assimp { class Importer; }
 
 namespace engi
 {
@@ -21,15 +25,73 @@ namespace engi
 		std::vector<MaterialInstance> materials;
 	};
 
+	// Texture file that was read by the job system, the GPU texture is created from it on the main thread
+	struct PrefetchedTexture
+	{
+		std::string path;
+		std::vector<uint8_t> data;
+	};
+
+	enum ModelLoadStatus
+	{
+		MODEL_LOAD_PENDING = 0,
+		MODEL_LOAD_READY,
+		MODEL_LOAD_FAILED,
+	};
+
+	// Handle of an asynchronous model load. It is completed by ModelLoader::update(), thus it should only be queried from the main thread
+	class ModelLoadRequest
+	{
+	public:
+		inline constexpr ModelLoadStatus getStatus() const noexcept { return m_status; }
+		inline constexpr bool isDone() const noexcept { return m_status != MODEL_LOAD_PENDING; }
+		inline constexpr bool isReady() const noexcept { return m_status == MODEL_LOAD_READY; }
+		inline constexpr ParsedModelInfo* getResult() const noexcept { return m_result; } // nullptr until the request is ready
+		inline constexpr const std::string& getPath() const noexcept { return m_filepath; }
+
+	private:
+		friend class ModelLoader;
+
+		std::string m_filepath;
+		std::string m_name;
+		SharedHandle<Material> m_material = nullptr;
+		CookedModel m_cookedModel;
+		std::vector<PrefetchedTexture> m_textures;
+		JobCounter m_counter;
+		bool m_isParsed = false; // written by the worker, read only after the counter is done
+		ModelLoadStatus m_status = MODEL_LOAD_PENDING;
+		ParsedModelInfo* m_result = nullptr;
+	};
+
+	using ModelLoadHandle = SharedHandle<ModelLoadRequest>;
+
 	class ModelLoader
 	{
 	public:
 		ModelLoader(TextureLoader* textureLoader, ModelRegistry* modelRegistry, MaterialRegistry* materialRegistry);
+		~ModelLoader();
 
 		ParsedModelInfo* loadFromFBX(const std::string& filepath, const std::string& name, const SharedHandle<Material>& material) noexcept;
+
+		// Import (or cache load) and BVH builds are done by the job system, GPU buffers and textures are created by update() on the main thread.
+		// Loading a model that is already loaded returns a ready handle, loading a model that is in flight returns its pending handle
+		ModelLoadHandle loadModelAsync(const std::string& filepath, const std::string& name, const SharedHandle<Material>& material) noexcept;
+
+		// Finalizes asynchronous loads whose CPU part is done. Should be called once per frame
+		void update() noexcept;
+
 		ParsedModelInfo* getParsedModel(const std::string& filepath) noexcept;
 
 	private:
+		// Might be called from any thread, threadIndex selects the Assimp importer. Meshes, BVHs and texture files are processed in parallel
+		bool parseModel(const std::string& filepath, CookedModel& cookedModel, std::vector<PrefetchedTexture>& textures, uint32_t threadIndex) noexcept;
+		ParsedModelInfo* finalizeModel(const std::string& filepath, const std::string& name, const SharedHandle<Material>& material,
+			CookedModel& cookedModel, const std::vector<PrefetchedTexture>& textures) noexcept;
+		void finalizeRequest(ModelLoadRequest& request) noexcept;
+
+		// Assimp importers are not thread-safe, thus there is one per job system thread
+		std::vector<UniqueHandle<Assimp::Importer>> m_importers;
+		std::vector<ModelLoadHandle> m_pendingLoads;
 		TextureLoader* m_textureLoader;
 		ModelRegistry* m_modelRegistry;
 		MaterialRegistry* m_materialRegistry;
@@ -39,6 +39,12 @@ namespace engi
 	bool loadSphere(ModelRegistry* modelRegistry);
 	bool ModelRegistry::init() noexcept
 	{
+		// Arenas grow on demand, initial capacity only covers the default models and a few small meshes
+		static constexpr uint32_t INITIAL_POOL_VERTICES = 1 << 18;
+		static constexpr uint32_t INITIAL_POOL_INDICES = 1 << 20;
+		m_geometryPool = makeShared<GeometryPool>(new GeometryPool("ModelRegistry", m_device));
+		if (!m_geometryPool->init(INITIAL_POOL_VERTICES, INITIAL_POOL_INDICES)) return false;
+
 		if (!loadCube(this)) return false;
 		if (!loadSphere(this)) return false;
 		return true;
@@ -50,7 +56,7 @@ namespace engi
 		if (model)
 			return model;
 
-		model = makeShared<Model>(new Model(name, m_device, numMeshes));
+		model = makeShared<Model>(new Model(name, m_geometryPool, numMeshes));
 		m_loadedModels[name] = model;
 		return model;
 	}
@@ -87,6 +93,7 @@ namespace engi
 
 	bool ModelRegistry::removeModel(const std::string& filepath) noexcept
 	{
+		// Geometry of the model is given back to the pool once the last handle to it is released
 		return m_loadedModels.erase(filepath) == 1;
 	}
 
@@ -37,9 +37,11 @@ namespace engi
 		bool removeModel(ModelType type) noexcept;
 		inline const uint32_t getNumModels() const noexcept { return static_cast<uint32_t>(m_loadedModels.size()); }
 		const auto& getAllModels() const noexcept { return m_loadedModels; }
+		inline GeometryPool* getGeometryPool() noexcept { return m_geometryPool.get(); }
 
 	private:
 		gfx::IGpuDevice* m_device;
+		SharedHandle<GeometryPool> m_geometryPool = nullptr; // shared with the models, which might outlive the registry
 		std::unordered_map<std::string, SharedHandle<Model>> m_loadedModels;
 	};
 
@@ -44,19 +44,22 @@ namespace engi
 			m_imguiContext->deinitialize();
 	}
 
-	bool Renderer::init(void* handle, uint32_t width, uint32_t height) noexcept
+	bool Renderer::init(void* handle, uint32_t width, uint32_t height, gfx::GpuBackend backend) noexcept
 	{
-		ENGI_ASSERT(handle && "Window handle is nullptr");
+		ENGI_ASSERT((handle || backend == gfx::GPU_BACKEND_NULL) && "Window handle is nullptr");
 
 		m_width = width;
 		m_height = height;
 
-		if (!this->createDevice())
+		if (!this->createDevice(backend))
 			return false;
 
 		// Initialize imgui context
-		m_imguiContext = gfx::createImGuiContext(handle, m_device.get());
-		ENGI_ASSERT(m_imguiContext && "Failed to create ImGui context");
+		if (backend != gfx::GPU_BACKEND_NULL)
+		{
+			m_imguiContext = gfx::createImGuiContext(handle, m_device.get());
+			ENGI_ASSERT(m_imguiContext && "Failed to create ImGui context");
+		}
 
 		// Firstly we want to initialize Shader manager, materials, samplers and texture manager
 		bool firstStage = initRegistries()
@@ -130,6 +133,12 @@ namespace engi
 
 	void Renderer::beginFrame()
 	{
+		gfx::GpuStateCache& stateCache = m_device->getStateCache();
+		m_stateCacheStats = stateCache.getStats();
+		stateCache.resetStats();
+
+		// Models that finished loading in the background get their GPU buffers before the frame is recorded
+		m_modelLoader->update();
 	}
 
 	void Renderer::endFrame()
@@ -233,6 +242,18 @@ namespace engi
 		return buffer;
 	}
 
+	LongLivedBuffer* Renderer::createLongLivedBuffer(const std::string& name, const void* data, uint32_t numVertices, uint32_t vertexSize) noexcept
+	{
+		LongLivedBuffer* buffer = new LongLivedBuffer(name, m_device.get());
+		if (!buffer->init(data, numVertices, vertexSize))
+		{
+			ENGI_LOG_WARN("Failed to create long-lived buffer {}", name);
+			delete buffer;
+			return nullptr;
+		}
+		return buffer;
+	}
+
 	IndexBuffer* Renderer::createIndexBuffer(const std::string& name, const uint32_t* indices, uint32_t numIndices) noexcept
 	{
 		ENGI_ASSERT(indices && numIndices > 0);
@@ -418,9 +439,9 @@ namespace engi
 		m_device->dispatchIndirect(buffer->getHandle(), byteOffset);
 	}
 
-	bool Renderer::createDevice()
+	bool Renderer::createDevice(gfx::GpuBackend backend)
 	{
-		m_device = gfx::createDevice();
+		m_device = gfx::createDevice(backend);
 		ENGI_ASSERT(m_device && "Failed to create logical device");
 		return true;
 	}
@@ -502,6 +523,35 @@ namespace engi
 		gfx::IGpuDevice* device = m_device.get();
 		m_shaderLibrary.reset(new ShaderLibrary(device));
 
+		// Programs of the engine are compiled in a single parallel batch, so that their createProgram() calls are cache hits.
+		// A program that is missing from this list is simply compiled on its first createProgram()
+		const ShaderProgramStages enginePrograms[] =
+		{
+			{ "GBuffer_Hologram.hlsl", true, true },
+			{ "NormalColor.hlsl" },
+			{ "AlbedoColor.hlsl" },
+			{ "GBuffer_Emissive.hlsl" },
+			{ "GBuffer_Opaque.hlsl" },
+			{ "GBuffer_Dissolution.hlsl" },
+			{ "GBuffer_Incineration.hlsl" },
+			{ "GBuffer_Decal.hlsl" },
+			{ "NormalVis.hlsl", true },
+			{ "Depthmap_Texture2D.hlsl", false, false, false },
+			{ "Depthmap_TextureCube.hlsl", true, false, false },
+			{ "PBR.hlsl" },
+			{ "Emissive.hlsl" },
+			{ "Incineration_Particles.hlsl", false, false, true, true },
+			{ "Skybox.hlsl" },
+			{ "SmokeEmitter.hlsl" },
+			{ "PostProcessor.hlsl" },
+			{ "FXAA.hlsl" },
+			{ "IBL_Diffuse_Precompute.hlsl" },
+			{ "IBL_Specular_Precompute.hlsl" },
+			{ "IBL_LUT_Precompute.hlsl" },
+			{ "DebugDrawLine.hlsl" },
+		};
+		m_shaderLibrary->precompile(enginePrograms);
+
 		m_materialRegistry = makeUnique<MaterialRegistry>(new MaterialRegistry(device, m_shaderLibrary.get()));
 		if (!m_materialRegistry->init())
 			return false;
@@ -4,12 +4,14 @@
 #include "Utility/Memory.h"
 #include "GFX/Definitions.h"
 #include "GFX/GPUResourceAllocator.h"
+#include "GFX/GPUStateCache.h"
 
 // TODO: WIP DEBUG RENDERER
 #include "IndexBuffer.h"
 #include "Buffer.h"
 #include "ConstantBuffer.h"
 #include "DynamicBuffer.h"
+#include "LongLivedBuffer.h"
 #include "Sampler.h"
 #include "RenderPass.h"
 
@@ -46,7 +48,8 @@ namespace engi
 		Renderer& operator=(const Renderer&) = delete;
 		~Renderer();
 
-		bool init(void* handle, uint32_t width, uint32_t height) noexcept;
+		// Null backend needs no window handle and renders no UI
+		bool init(void* handle, uint32_t width, uint32_t height, gfx::GpuBackend backend = gfx::GPU_BACKEND_D3D11) noexcept;
 		void resize(uint32_t width, uint32_t height) noexcept;
 
 		void beginFrame();
@@ -63,6 +66,9 @@ namespace engi
 		inline constexpr uint32_t getBackbufferWidth() const noexcept { return m_width; }
 		inline constexpr uint32_t getBackbufferHeight() const noexcept { return m_height; }
 
+		// Meant for tools and tests that inspect the backend (e.g. counters of the null device), rendering code should go through the renderer
+		inline gfx::IGpuDevice* getDevice() noexcept { return m_device.get(); }
+
 		inline MaterialRegistry* getMaterialRegistry() noexcept { return m_materialRegistry.get(); }
 		inline ModelRegistry* getModelRegistry() noexcept { return m_modelRegistry.get(); }
 		inline ShaderLibrary* getShaderLibrary() noexcept { return m_shaderLibrary.get(); }
@@ -79,10 +85,14 @@ namespace engi
 		Buffer* createResourceBuffer(const std::string& name) noexcept;
 		ConstantBuffer* createConstantBuffer(const std::string& name, uint32_t size) noexcept;
 		DynamicBuffer* createDynamicBuffer(const std::string& name, const void* data, uint32_t numVertices, uint32_t vertexSize) noexcept;
+		LongLivedBuffer* createLongLivedBuffer(const std::string& name, const void* data, uint32_t numVertices, uint32_t vertexSize) noexcept;
 
 		inline PostProcessor* getPostProcessor() noexcept { return m_postProcessor.get(); }
 		inline bool isImGuiInitialized() const noexcept { return m_imguiContext != nullptr; }
 
+		// Binds that went through the device during the previous frame and how many of them were redundant
+		inline const gfx::GpuStateCacheStats& getStateCacheStats() const noexcept { return m_stateCacheStats; }
+
 		inline Sampler* getNearestSampler() noexcept { return m_samplerNearest.get(); }
 		inline Sampler* getLinearSampler() noexcept { return m_samplerLinear.get(); }
 		inline Sampler* getLinearSamplerWithClamping() noexcept { return m_samplerLinearClamp.get(); }
@@ -124,7 +134,7 @@ namespace engi
 
 	private:
 		// WIP: New renderer render passes
-		bool createDevice();
+		bool createDevice(gfx::GpuBackend backend);
 		bool createSwapchain(void* handle, uint32_t width, uint32_t height);
 		bool initHDRRenderTarget();
 		bool initDepthStencil();
@@ -142,6 +152,7 @@ namespace engi
 		UniqueHandle<ShaderLibrary> m_shaderLibrary = nullptr;
 		uint32_t m_width;
 		uint32_t m_height;
+		gfx::GpuStateCacheStats m_stateCacheStats;
 
 		gfx::GpuHandle<gfx::IGpuSwapchain> m_swapchain = nullptr;
 		Texture2D* m_depthStencilTexture = nullptr;
@@ -0,0 +1,202 @@
+#include "Renderer/ShaderBytecodeCache.h"
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include "Core/CommonDefinitions.h"
+#include "Core/FileSystem.h"
+#include "Core/Logger.h"
+#include "Utility/Hash.h"
+
+namespace engi
+{
+
+	namespace
+	{
+
+		struct BlobHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint64_t key;
+			uint64_t size;
+			uint64_t checksum; // of the bytecode, which follows the header
+		};
+
+	}; // anonymous namespace
+
+	ShaderBytecodeCache::ShaderBytecodeCache(const std::filesystem::path& cacheFolder, uint32_t compilerVersion)
+		: m_cacheFolder(cacheFolder)
+		, m_compilerVersion(compilerVersion)
+	{
+	}
+
+	bool ShaderBytecodeCache::computeKey(const std::filesystem::path& filepath, const std::string& entrypoint, const std::string& target, uint32_t flags, uint64_t& key) noexcept
+	{
+		uint64_t hash = HASH_SEED;
+		std::unordered_set<std::string> visited;
+		{
+			// Hashing is cheap compared to compilation, thus a single lock for the whole include graph is fine
+			std::lock_guard lock(m_filesMutex);
+			if (!hashIncludeGraph(filepath, visited, hash))
+				return false;
+		}
+
+		hash = hashString(entrypoint, hash);
+		hash = hashString(target, hash);
+		hash = hashBytes(&flags, sizeof(flags), hash);
+		hash = hashBytes(&m_compilerVersion, sizeof(m_compilerVersion), hash);
+		hash = hashBytes(&VERSION, sizeof(VERSION), hash);
+		key = hash;
+		return true;
+	}
+
+	bool ShaderBytecodeCache::load(uint64_t key, std::vector<uint8_t>& bytecode) const noexcept
+	{
+		std::ifstream stream(getBlobPath(key), std::ios::binary);
+		if (!stream)
+			return false;
+
+		BlobHeader header = {};
+		if (!stream.read(reinterpret_cast<char*>(&header), sizeof(BlobHeader)))
+			return false;
+
+		if (header.magic != MAGIC || header.version != VERSION || header.key != key || header.size == 0)
+			return false;
+
+		bytecode.resize(static_cast<size_t>(header.size));
+		if (!stream.read(reinterpret_cast<char*>(bytecode.data()), static_cast<std::streamsize>(bytecode.size())))
+			return false;
+
+		if (hashBytes(bytecode.data(), bytecode.size()) != header.checksum)
+		{
+			ENGI_LOG_WARN("Shader blob {:016x} is corrupted, the shader will be recompiled", key);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool ShaderBytecodeCache::store(uint64_t key, const void* bytecode, size_t size) const noexcept
+	{
+		ENGI_ASSERT(bytecode && size > 0);
+
+		BlobHeader header = {};
+		header.magic = MAGIC;
+		header.version = VERSION;
+		header.key = key;
+		header.size = size;
+		header.checksum = hashBytes(bytecode, size);
+
+		std::vector<uint8_t> blob(sizeof(BlobHeader) + size);
+		std::memcpy(blob.data(), &header, sizeof(BlobHeader));
+		std::memcpy(blob.data() + sizeof(BlobHeader), bytecode, size);
+		return FileSystem::writeFileAtomic(getBlobPath(key), blob.data(), blob.size());
+	}
+
+	std::filesystem::path ShaderBytecodeCache::getBlobPath(uint64_t key) const noexcept
+	{
+		return m_cacheFolder / std::format("{:016x}.engishader", key);
+	}
+
+	void ShaderBytecodeCache::parseIncludes(std::string_view source, std::vector<std::string>& includes) noexcept
+	{
+		auto skipSpaces = [&source](size_t pos)
+			{
+				while (pos < source.size() && (source[pos] == ' ' || source[pos] == '\t'))
+					++pos;
+				return pos;
+			};
+
+		static constexpr std::string_view INCLUDE = "include";
+		size_t lineBegin = 0;
+		while (lineBegin < source.size())
+		{
+			size_t lineEnd = source.find('\n', lineBegin);
+			if (lineEnd == std::string_view::npos)
+				lineEnd = source.size();
+
+			size_t pos = skipSpaces(lineBegin);
+			if (pos < lineEnd && source[pos] == '#')
+			{
+				pos = skipSpaces(pos + 1);
+				if (source.compare(pos, INCLUDE.size(), INCLUDE) == 0)
+				{
+					pos = skipSpaces(pos + INCLUDE.size());
+					if (pos < lineEnd && (source[pos] == '"' || source[pos] == '<'))
+					{
+						char closing = (source[pos] == '"') ? '"' : '>';
+						size_t nameEnd = source.find(closing, pos + 1);
+						if (nameEnd != std::string_view::npos && nameEnd < lineEnd)
+							includes.emplace_back(source.substr(pos + 1, nameEnd - pos - 1));
+					}
+				}
+			}
+
+			lineBegin = lineEnd + 1;
+		}
+	}
+
+	const ShaderBytecodeCache::FileEntry* ShaderBytecodeCache::getFileEntry(const std::filesystem::path& fullpath) noexcept
+	{
+		std::error_code error;
+		uint64_t size = static_cast<uint64_t>(std::filesystem::file_size(fullpath, error));
+		if (error)
+			return nullptr;
+
+		std::filesystem::file_time_type time = std::filesystem::last_write_time(fullpath, error);
+		if (error)
+			return nullptr;
+
+		int64_t writeTime = static_cast<int64_t>(time.time_since_epoch().count());
+		FileEntry& entry = m_files[fullpath.generic_string()];
+		if (entry.contentHash != 0 && entry.size == size && entry.writeTime == writeTime)
+			return &entry;
+
+		std::vector<uint8_t> data;
+		if (!FileSystem::readFile(fullpath, data))
+		{
+			m_files.erase(fullpath.generic_string());
+			return nullptr;
+		}
+
+		std::string_view contents(reinterpret_cast<const char*>(data.data()), data.size());
+		std::vector<std::string> includes;
+		parseIncludes(contents, includes);
+
+		entry.size = size;
+		entry.writeTime = writeTime;
+		entry.contentHash = hashString(contents);
+		entry.includes.clear();
+		for (const std::string& include : includes)
+			entry.includes.push_back(fullpath.parent_path() / include);
+
+		return &entry;
+	}
+
+	bool ShaderBytecodeCache::hashIncludeGraph(const std::filesystem::path& filepath, std::unordered_set<std::string>& visited, uint64_t& hash) noexcept
+	{
+		std::error_code error;
+		std::filesystem::path fullpath = std::filesystem::weakly_canonical(filepath, error);
+		if (error)
+			return false;
+
+		// Files are hashed in the include order, every file only once, which also breaks include cycles
+		if (!visited.insert(fullpath.generic_string()).second)
+			return true;
+
+		const FileEntry* entry = getFileEntry(fullpath);
+		if (!entry)
+			return false;
+
+		hash = hashBytes(&entry->contentHash, sizeof(entry->contentHash), hash);
+		for (const std::filesystem::path& include : entry->includes)
+		{
+			if (!hashIncludeGraph(include, visited, hash))
+				return false;
+		}
+
+		return true;
+	}
+
+}; // engi namespace
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace engi
+{
+
+	// On-disk cache of compiled shader bytecode. Blobs are keyed by a hash of the shader source, contents of all the files it
+	// includes transitively and compilation parameters, thus editing any of them simply misses the cache. Cache knows nothing about
+	// the compiler itself, it only hashes files and stores blobs. Might be used from many threads at once
+	class ShaderBytecodeCache
+	{
+	public:
+		static constexpr uint32_t MAGIC = 0x53474E45; // "ENGS"
+		static constexpr uint32_t VERSION = 1;
+
+		// Blobs of a different compiler version are never reused
+		ShaderBytecodeCache(const std::filesystem::path& cacheFolder, uint32_t compilerVersion);
+
+		// Returns false if the shader or one of its includes cannot be read, then the shader should be compiled without caching
+		bool computeKey(const std::filesystem::path& filepath, const std::string& entrypoint, const std::string& target, uint32_t flags, uint64_t& key) noexcept;
+
+		// Returns false if there is no valid blob for the key
+		bool load(uint64_t key, std::vector<uint8_t>& bytecode) const noexcept;
+		bool store(uint64_t key, const void* bytecode, size_t size) const noexcept;
+
+		std::filesystem::path getBlobPath(uint64_t key) const noexcept;
+
+		// Extracts file names of #include directives of the HLSL source. Directives inside of comments are not filtered out,
+		// which at worst makes the key depend on one more file
+		static void parseIncludes(std::string_view source, std::vector<std::string>& includes) noexcept;
+
+	private:
+		struct FileEntry
+		{
+			uint64_t size = 0;
+			int64_t writeTime = 0;
+			uint64_t contentHash = 0;
+			std::vector<std::filesystem::path> includes; // resolved relative to the folder of the file, as the standard include handler does
+		};
+
+		// Files are memoized by their size and modification time, so that includes shared by many shaders are read once
+		const FileEntry* getFileEntry(const std::filesystem::path& fullpath) noexcept;
+		bool hashIncludeGraph(const std::filesystem::path& filepath, std::unordered_set<std::string>& visited, uint64_t& hash) noexcept;
+
+		std::filesystem::path m_cacheFolder;
+		uint32_t m_compilerVersion;
+		std::mutex m_filesMutex;
+		std::unordered_map<std::string, FileEntry> m_files;
+	};
+
+}; // engi namespace
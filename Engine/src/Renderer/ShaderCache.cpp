@@ -1,8 +1,12 @@
 #include "Renderer/ShaderCache.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <vector>
 #include "Core/CommonDefinitions.h"
 #include "Core/FileSystem.h"
 #include "GFX/GPUDevice.h"
+#include "Renderer/ShaderCompiler.h"
 
 namespace engi
 {
@@ -24,6 +28,54 @@ namespace engi
 		return it == m_compiledShaders.end() ? nullptr : it->second.get();
 	}
 
+	bool ShaderCache::loadShaders(ShaderCompiler* compiler, std::span<const gfx::GpuShaderDesc> descs, std::span<gfx::IGpuShader*> shaders) noexcept
+	{
+		ENGI_ASSERT(compiler);
+		ENGI_ASSERT(descs.size() == shaders.size());
+
+		std::vector<gfx::GpuShaderDesc> missingDescs;
+		std::vector<size_t> missingIndices;
+		for (size_t i = 0; i < descs.size(); ++i)
+		{
+			shaders[i] = getShader(descs[i]);
+			if (shaders[i])
+				continue;
+
+			// The same stage might be requested twice within a batch, there is no point to compile it twice
+			auto it = std::find_if(missingDescs.begin(), missingDescs.end(), [&](const gfx::GpuShaderDesc& desc) { return EqComparator{}(desc, descs[i]); });
+			if (it == missingDescs.end())
+				missingDescs.push_back(descs[i]);
+			missingIndices.push_back(i);
+		}
+
+		if (missingDescs.empty())
+			return true;
+
+		std::vector<void*> bytecodes(missingDescs.size(), nullptr);
+		compiler->compileBatch(missingDescs, bytecodes);
+
+		// Shader objects are created on the calling thread, as the device is not thread-safe
+		for (size_t i = 0; i < missingDescs.size(); ++i)
+		{
+			if (!bytecodes[i])
+				continue;
+
+			const gfx::GpuShaderDesc& desc = missingDescs[i];
+			std::string name = std::filesystem::path(desc.filepath).filename().string();
+			gfx::IGpuShader* shader = m_device->createShader(name, desc, bytecodes[i]);
+			if (shader)
+				addShader(shader);
+		}
+
+		bool succeeded = true;
+		for (size_t i : missingIndices)
+		{
+			shaders[i] = getShader(descs[i]);
+			succeeded = succeeded && shaders[i];
+		}
+		return succeeded;
+	}
+
 	void ShaderCache::removeShader(gfx::IGpuShader* shader) noexcept
 	{
 		[[maybe_unused]] size_t erased = m_compiledShaders.erase(shader->getDesc());
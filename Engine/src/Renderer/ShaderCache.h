@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <unordered_map>
 #include "GFX/Definitions.h"
 #include "GFX/GPUShader.h"
@@ -38,6 +39,7 @@ namespace engi
 	}; // detail namespace
 
 	class gfx::IGpuDevice;
+	class ShaderCompiler;
 
 	// TODO: As we use one shader file per many shader types it is more efficient to use a shader code cache,
 	// so that we don't read a shader file multiple times by using D3DReadFromFile
@@ -58,6 +60,10 @@ namespace engi
 		void removeShader(gfx::IGpuShader* shader) noexcept;
 		gfx::IGpuShader* getShader(const gfx::GpuShaderDesc& desc) noexcept;
 
+		// Writes the shader of every desc into shaders. Shaders that are not cached yet are compiled in a single parallel batch and added
+		// to the cache, shaders that failed to compile are nullptr. Returns false if any shader is missing
+		bool loadShaders(ShaderCompiler* compiler, std::span<const gfx::GpuShaderDesc> descs, std::span<gfx::IGpuShader*> shaders) noexcept;
+
 	private:
 		gfx::IGpuDevice* m_device;
 		ShaderCacheContainer m_compiledShaders;
@@ -3,7 +3,15 @@
 #include <d3dcompiler.h>
 #include <fstream>
 #include <cstdint>
+#include <cstring>
+#include <format>
+#include <algorithm>
+#include "Core/CommonDefinitions.h"
+#include "Core/FileSystem.h"
+#include "Core/Logger.h"
 #include "GFX/GPUDevice.h"
+#include "Utility/JobSystem.h"
+#include "Utility/Memory.h"
 
 // TODO: Remove this header
 #include <iostream>
@@ -25,40 +33,126 @@ namespace engi
         }
     }
 
+    ShaderCompiler::ShaderCompiler()
+        : m_bytecodeCache(FileSystem::getInstance().getCachePath() / "Shaders", D3D_COMPILER_VERSION)
+    {
+    }
+
     void* ShaderCompiler::compileFromHLSLFile(const std::string& filepath, const std::string& entrypoint, gfx::GpuShaderType shaderType) noexcept
 	{
-		std::ifstream stream(filepath);
-		if (!stream.is_open())
+		gfx::GpuShaderDesc desc;
+		desc.filepath = filepath;
+		desc.entrypoint = entrypoint;
+		desc.type = shaderType;
+		return compileFromHLSLFile(desc);
+	}
+
+    void* ShaderCompiler::compileFromHLSLFile(const gfx::GpuShaderDesc& desc) noexcept
+    {
+		void* bytecode = nullptr;
+		compileBatch(std::span(&desc, 1), std::span(&bytecode, 1));
+		return bytecode;
+    }
+
+	bool ShaderCompiler::compileBatch(std::span<const gfx::GpuShaderDesc> descs, std::span<void*> bytecodes) noexcept
+	{
+		ENGI_ASSERT(descs.size() == bytecodes.size());
+
+		// Programs usually have all their stages in a single file, thus stages share the source
+		std::vector<UniqueHandle<SourceFile>> sources;
+		std::vector<SourceFile*> descSources(descs.size());
+		for (size_t i = 0; i < descs.size(); ++i)
 		{
-			std::cout << "Failed to open the file " << filepath << std::endl;
-			return nullptr;
+			auto it = std::find_if(sources.begin(), sources.end(), [&descs, i](const UniqueHandle<SourceFile>& source) { return source->filepath == descs[i].filepath; });
+			if (it == sources.end())
+			{
+				it = sources.insert(sources.end(), makeUnique<SourceFile>(new SourceFile()));
+				(*it)->filepath = descs[i].filepath;
+			}
+			descSources[i] = it->get();
 		}
 
-		std::string src = std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
-		stream.close();
+		std::vector<std::string> logs(descs.size());
+		JobCounter counter;
+		JobSystem::get().dispatch(counter, static_cast<uint32_t>(descs.size()), 1, [&](uint32_t, uint32_t descIndex)
+			{
+				bytecodes[descIndex] = compileShader(descs[descIndex], *descSources[descIndex], logs[descIndex]);
+			});
+		JobSystem::get().wait(counter);
+
+		bool succeeded = true;
+		for (size_t i = 0; i < descs.size(); ++i)
+		{
+			if (!logs[i].empty())
+				std::cout << logs[i];
+
+			succeeded = succeeded && bytecodes[i];
+		}
+		return succeeded;
+	}
+
+	void ShaderCompiler::releaseBytecode(void* bytecode) noexcept
+	{
+		if (bytecode)
+			static_cast<ID3D10Blob*>(bytecode)->Release();
+	}
 
+	void* ShaderCompiler::compileShader(const gfx::GpuShaderDesc& desc, SourceFile& source, std::string& log) noexcept
+	{
+		const std::string& filepath = desc.filepath;
+		const std::string& entrypoint = desc.entrypoint;
 		uint32_t flags = D3DCOMPILE_ENABLE_STRICTNESS;
 #if !defined(_NDEBUG)
 		flags |= D3DCOMPILE_DEBUG;
 #endif
 
+        // If the key cannot be computed (e.g. a missing include) the shader is compiled as usual, so that the compiler reports the error
+        uint64_t key = 0;
+        bool isCacheable = m_bytecodeCache.computeKey(filepath, entrypoint, d3dShaderTarget(desc.type), flags, key);
+        if (isCacheable)
+        {
+            std::vector<uint8_t> cachedBytecode;
+            ID3D10Blob* cachedBlob = nullptr;
+            if (m_bytecodeCache.load(key, cachedBytecode) && SUCCEEDED(D3DCreateBlob(cachedBytecode.size(), &cachedBlob)))
+            {
+                std::memcpy(cachedBlob->GetBufferPointer(), cachedBytecode.data(), cachedBytecode.size());
+                return cachedBlob;
+            }
+        }
+
+		std::call_once(source.readFlag, [&source]()
+			{
+				std::ifstream stream(source.filepath);
+				if (!stream.is_open())
+					return;
+
+				source.contents = std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+				source.isRead = true;
+			});
+
+		if (!source.isRead)
+		{
+			log += std::format("Failed to open the file {}\n", filepath);
+			return nullptr;
+		}
+
+		const std::string& src = source.contents;
         ID3D10Blob* shaderBytecode = nullptr;
         ID3D10Blob* shaderErrors = nullptr;
         HRESULT hr = D3DCompile(src.data(), src.length(), filepath.data(), nullptr,
             D3D_COMPILE_STANDARD_FILE_INCLUDE,
             entrypoint.c_str(),
-            d3dShaderTarget(shaderType),
+            d3dShaderTarget(desc.type),
             flags,
             0, &shaderBytecode, &shaderErrors);
 
         if (FAILED(hr))
         {
-            std::cout << "Error while compiling " << filepath << " as HLSL\n";
+            log += std::format("Error while compiling {} as HLSL\n", filepath);
             if (shaderErrors)
             {
-                // TODO: Add Logger
-                std::cout << "Failed to compile " << filepath << "::" << entrypoint << " shader:\n";
-                std::cout << (char*)shaderErrors->GetBufferPointer();
+                log += std::format("Failed to compile {}::{} shader:\n", filepath, entrypoint);
+                log += (char*)shaderErrors->GetBufferPointer();
                 shaderErrors->Release();
             }
             if (shaderBytecode)
@@ -68,12 +162,13 @@ namespace engi
             return nullptr;
         }
 
+        if (shaderErrors)
+            shaderErrors->Release(); // warnings
+
+        if (isCacheable && !m_bytecodeCache.store(key, shaderBytecode->GetBufferPointer(), shaderBytecode->GetBufferSize()))
+            ENGI_LOG_WARN("Failed to cache the bytecode of {}::{}", filepath, entrypoint);
+
         return shaderBytecode;
 	}
 
-    void* ShaderCompiler::compileFromHLSLFile(const gfx::GpuShaderDesc& desc) noexcept
-    {
-        return compileFromHLSLFile(desc.filepath, desc.entrypoint, desc.type);
-    }
-
 }; // engi namespace
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <string>
+#include <span>
+#include <mutex>
 #include "GFX/Definitions.h"
+#include "Renderer/ShaderBytecodeCache.h"
 
 namespace engi
 {
@@ -9,10 +12,32 @@ namespace engi
 	class ShaderCompiler
 	{
 	public:
-		ShaderCompiler() = default;
+		ShaderCompiler();
 		
+		// Bytecode is taken from the on-disk cache if neither the shader nor its includes have changed since the last compilation
 		[[nodiscard]] void* compileFromHLSLFile(const std::string& filepath, const std::string& entrypoint, gfx::GpuShaderType shaderType) noexcept;
 		[[nodiscard]] void* compileFromHLSLFile(const gfx::GpuShaderDesc& desc) noexcept;
+
+		// Compiles shaders in parallel on the job system, every source file is read at most once. Bytecodes are written in the order of descs,
+		// nullptr for the shaders that failed to compile. Errors are reported per shader in the same order. Returns false if any shader failed
+		bool compileBatch(std::span<const gfx::GpuShaderDesc> descs, std::span<void*> bytecodes) noexcept;
+
+		// Releases the bytecode that was not passed to the shader, e.g. when other stages of the program failed to compile
+		static void releaseBytecode(void* bytecode) noexcept;
+
+	private:
+		struct SourceFile
+		{
+			std::string filepath;
+			std::string contents;
+			std::once_flag readFlag;
+			bool isRead = false;
+		};
+
+		// Might be called from any thread. Errors are appended to the log instead of being printed, so that the batch reports them in order
+		void* compileShader(const gfx::GpuShaderDesc& desc, SourceFile& source, std::string& log) noexcept;
+
+		ShaderBytecodeCache m_bytecodeCache;
 	};
 
 }; // engi namespace
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Renderer/ShaderLibrary.h"
 
+#include <unordered_set>
+#include <vector>
 #include "Core/Logger.h"
 #include "Core/FileSystem.h"
 #include "Renderer/ShaderCache.h"
@@ -69,4 +71,55 @@ namespace engi
 		return it == m_shaders.end() ? nullptr : it->second.get();
 	}
 
+	void ShaderLibrary::precompile(std::span<const ShaderProgramStages> programs) noexcept
+	{
+		std::vector<gfx::GpuShaderDesc> descs;
+		for (const ShaderProgramStages& program : programs)
+		{
+			std::string filepath = (m_shaderFolder / program.shadername).string();
+			ShaderProgram::getStageDescs(filepath, program.geometryStage, program.tesselationStage, program.pixelStage, descs);
+			if (program.computeStage)
+				descs.push_back(ShaderProgram::getStageDesc(filepath, gfx::GpuShaderType::COMPUTE_SHADER));
+		}
+
+		// Failures are reported by the compiler and once again by createProgram()
+		std::vector<gfx::IGpuShader*> shaders(descs.size(), nullptr);
+		m_shaderCache.loadShaders(&m_compiler, descs, shaders);
+	}
+
+	bool ShaderLibrary::recompileAll() noexcept
+	{
+		// Programs might share stages through the shader cache, every stage is compiled once
+		std::vector<gfx::IGpuShader*> programShaders;
+		for (auto& [shadername, program] : m_shaders)
+			program->getShaders(programShaders);
+
+		std::vector<gfx::IGpuShader*> shaders;
+		std::unordered_set<gfx::IGpuShader*> visited;
+		for (gfx::IGpuShader* shader : programShaders)
+		{
+			if (visited.insert(shader).second)
+				shaders.push_back(shader);
+		}
+
+		std::vector<gfx::GpuShaderDesc> descs;
+		descs.reserve(shaders.size());
+		for (gfx::IGpuShader* shader : shaders)
+			descs.push_back(shader->getDesc());
+
+		std::vector<void*> bytecodes(descs.size(), nullptr);
+		bool succeeded = m_compiler.compileBatch(descs, bytecodes);
+		for (size_t i = 0; i < shaders.size(); ++i)
+		{
+			if (bytecodes[i])
+				shaders[i]->initialize(bytecodes[i]);
+		}
+
+		if (succeeded)
+			ENGI_LOG_INFO("Successfully recompiled {} shaders of {} programs", shaders.size(), m_shaders.size());
+		else ENGI_LOG_ERROR("Failed to recompile some of the shaders, they keep their previous bytecode");
+
+		return succeeded;
+	}
+
 }; // engi namespace
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <filesystem>
+#include <span>
 #include <unordered_map>
 #include "Utility/Memory.h"
 #include "Renderer/ShaderProgram.h"
@@ -12,6 +13,16 @@ namespace engi
 
 	namespace gfx { class IGpuDevice; }
 
+	// Stages of a program that is going to be created, so that many programs might be compiled in a single batch
+	struct ShaderProgramStages
+	{
+		std::string shadername;
+		bool geometryStage = false;
+		bool tesselationStage = false;
+		bool pixelStage = true;
+		bool computeStage = false; // in addition to the graphics stages, as initCompute() does
+	};
+
 	class ShaderLibrary
 	{
 	public:
@@ -23,6 +34,12 @@ namespace engi
 		ShaderProgram* createProgram(const std::string& shadername, bool geometryStage, bool tesselationStage, bool pixelStage = true) noexcept;
 		ShaderProgram* createComputeProgram(const std::string& shadername) noexcept;
 		ShaderProgram* getProgram(const std::string& shadername) noexcept;
+
+		// Compiles stages of all the programs in parallel and caches them, thus following createProgram() calls do not compile anything
+		void precompile(std::span<const ShaderProgramStages> programs) noexcept;
+
+		// Hot reloads all the programs at once. Shaders that failed to compile keep their previous bytecode. Returns false if any shader failed
+		bool recompileAll() noexcept;
 		const auto& getAllShaders() const noexcept { return m_shaders; }
 	
 	private:
@@ -1,5 +1,6 @@
 #include "Renderer/ShaderProgram.h"
 
+#include <vector>
 #include "Core/Logger.h"
 #include "Core/CommonDefinitions.h"
 #include "GFX/Definitions.h"
@@ -27,53 +28,37 @@ namespace engi
 
 	bool ShaderProgram::init(const std::string& filepath, bool geometryStage, bool tesselationStage, bool pixelStage) noexcept
 	{
-		gfx::IGpuShader* vs = loadShader(filepath, "vs_main", gfx::GpuShaderType::VERTEX_SHADER);
-		if (!vs)
-		{
-			ENGI_LOG_ERROR("Failed to parse vertex shader of a {} program", getName());
-			return false;
-		}
-		m_vs = vs;
-
-		if (pixelStage)
-		{
-			gfx::IGpuShader* ps = loadShader(filepath, "ps_main", gfx::GpuShaderType::PIXEL_SHADER);
-			if (!ps)
-			{
-				ENGI_LOG_ERROR("Failed to parse pixel shader of a {} program", getName());
-				return false;
-			}
-			m_ps = ps;
-		}
+		std::vector<gfx::GpuShaderDesc> descs;
+		getStageDescs(filepath, geometryStage, tesselationStage, pixelStage, descs);
 
-		if (geometryStage)
+		// Stages are compiled in parallel, but failures are still reported per stage
+		std::vector<gfx::IGpuShader*> shaders(descs.size(), nullptr);
+		if (!m_cache->loadShaders(m_compiler, descs, shaders))
 		{
-			gfx::IGpuShader* gs = loadShader(filepath, "gs_main", gfx::GpuShaderType::GEOMETRY_SHADER);
-			if (!gs)
+			for (size_t i = 0; i < descs.size(); ++i)
 			{
-				ENGI_LOG_ERROR("Failed to parse geometry shader of a {} program", getName());
-				return false;
+				if (!shaders[i])
+					ENGI_LOG_ERROR("Failed to parse {} of a {} program", descs[i].entrypoint, getName());
 			}
-			m_gs = gs;
+			return false;
 		}
-		else m_gs = nullptr;
 
-		if (tesselationStage)
+		m_vs = nullptr;
+		m_ps = nullptr;
+		m_gs = nullptr;
+		m_hs = nullptr;
+		m_ds = nullptr;
+		for (gfx::IGpuShader* shader : shaders)
 		{
-			gfx::IGpuShader* ds = loadShader(filepath, "ds_main", gfx::GpuShaderType::DOMAIN_SHADER);
-			gfx::IGpuShader* hs = loadShader(filepath, "hs_main", gfx::GpuShaderType::HULL_SHADER);
-			if (!hs || !ds)
+			switch (shader->getDesc().type)
 			{
-				ENGI_LOG_ERROR("Failed to parse either hull of domain shader of a {} program", getName());
-				return false;
+			case gfx::GpuShaderType::VERTEX_SHADER: m_vs = shader; break;
+			case gfx::GpuShaderType::PIXEL_SHADER: m_ps = shader; break;
+			case gfx::GpuShaderType::GEOMETRY_SHADER: m_gs = shader; break;
+			case gfx::GpuShaderType::HULL_SHADER: m_hs = shader; break;
+			case gfx::GpuShaderType::DOMAIN_SHADER: m_ds = shader; break;
+			default: ENGI_ASSERT(false && "Unexpected shader stage"); break;
 			}
-			m_hs = hs;
-			m_ds = ds;
-		}
-		else
-		{
-			m_hs = nullptr;
-			m_ds = nullptr;
 		}
 
 		m_filepath = filepath;
@@ -82,8 +67,9 @@ namespace engi
 
 	bool ShaderProgram::initCompute(const std::string& filepath) noexcept
 	{
-		gfx::IGpuShader* cs = loadShader(filepath, "cs_main", gfx::GpuShaderType::COMPUTE_SHADER);
-		if (!cs)
+		gfx::GpuShaderDesc desc = getStageDesc(filepath, gfx::GpuShaderType::COMPUTE_SHADER);
+		gfx::IGpuShader* cs = nullptr;
+		if (!m_cache->loadShaders(m_compiler, std::span(&desc, 1), std::span(&cs, 1)))
 		{
 			ENGI_LOG_WARN("Failed to parse compute shader of a {} program", getName());
 			return false;
@@ -94,6 +80,38 @@ namespace engi
 		return true;
 	}
 
+	gfx::GpuShaderDesc ShaderProgram::getStageDesc(const std::string& filepath, gfx::GpuShaderType shaderType) noexcept
+	{
+		gfx::GpuShaderDesc desc;
+		desc.filepath = filepath;
+		desc.type = shaderType;
+		switch (shaderType)
+		{
+		case gfx::GpuShaderType::VERTEX_SHADER: desc.entrypoint = "vs_main"; break;
+		case gfx::GpuShaderType::PIXEL_SHADER: desc.entrypoint = "ps_main"; break;
+		case gfx::GpuShaderType::GEOMETRY_SHADER: desc.entrypoint = "gs_main"; break;
+		case gfx::GpuShaderType::HULL_SHADER: desc.entrypoint = "hs_main"; break;
+		case gfx::GpuShaderType::DOMAIN_SHADER: desc.entrypoint = "ds_main"; break;
+		case gfx::GpuShaderType::COMPUTE_SHADER: desc.entrypoint = "cs_main"; break;
+		default: ENGI_ASSERT(false && "Unexpected shader stage"); break;
+		}
+		return desc;
+	}
+
+	void ShaderProgram::getStageDescs(const std::string& filepath, bool geometryStage, bool tesselationStage, bool pixelStage, std::vector<gfx::GpuShaderDesc>& descs) noexcept
+	{
+		descs.push_back(getStageDesc(filepath, gfx::GpuShaderType::VERTEX_SHADER));
+		if (pixelStage)
+			descs.push_back(getStageDesc(filepath, gfx::GpuShaderType::PIXEL_SHADER));
+		if (geometryStage)
+			descs.push_back(getStageDesc(filepath, gfx::GpuShaderType::GEOMETRY_SHADER));
+		if (tesselationStage)
+		{
+			descs.push_back(getStageDesc(filepath, gfx::GpuShaderType::HULL_SHADER));
+			descs.push_back(getStageDesc(filepath, gfx::GpuShaderType::DOMAIN_SHADER));
+		}
+	}
+
 	void ShaderProgram::setAttributeLayout(std::span<const gfx::GpuInputAttributeDesc> attributes) noexcept
 	{
 		// TODO: Add check if the shader program is compute program and does not require any attributes
@@ -115,106 +133,44 @@ namespace engi
 
 	bool ShaderProgram::recompileAll() noexcept
 	{
-		if (!m_vs && !m_cs)
+		std::vector<gfx::IGpuShader*> shaders;
+		getShaders(shaders);
+		if (shaders.empty())
 		{
 			ENGI_LOG_WARN("Cannot recompile the shader");
 			return false;
 		}
 
-		void* vsBytecode = nullptr;
-		if (m_vs)
-		{
-			vsBytecode = getBytecode(m_vs->getDesc());
-		}
+		std::vector<gfx::GpuShaderDesc> descs;
+		descs.reserve(shaders.size());
+		for (gfx::IGpuShader* shader : shaders)
+			descs.push_back(shader->getDesc());
 
-		if (!vsBytecode)
+		// Either all the stages are replaced or none of them, so that the program never mixes old and new stages
+		std::vector<void*> bytecodes(descs.size(), nullptr);
+		if (!m_compiler->compileBatch(descs, bytecodes))
 		{
+			for (void* bytecode : bytecodes)
+				ShaderCompiler::releaseBytecode(bytecode);
+
 			ENGI_LOG_ERROR("Failed to recompile the program");
 			return false;
 		}
 
-		void* psBytecode = nullptr;
-		void* gsBytecode = nullptr;
-		void* hsBytecode = nullptr;
-		void* dsBytecode = nullptr;
-		void* csBytecode = getBytecode(m_cs->getDesc());
-
-		if (hasPixelStage())
-		{
-			psBytecode = getBytecode(m_ps->getDesc());
-			if (!psBytecode)
-			{
-				ENGI_LOG_ERROR("Failed to recompile the program");
-				return false;
-			}
-		}
-
-		if (hasGeometryStage())
-		{
-			gsBytecode = getBytecode(m_gs->getDesc());
-			if (!gsBytecode)
-			{
-				ENGI_LOG_ERROR("Failed to recompile the program");
-				return false;
-			}
-		}
+		for (size_t i = 0; i < shaders.size(); ++i)
+			recompile(shaders[i], bytecodes[i]);
 
-		if (hasTesselationStage())
-		{
-			hsBytecode = getBytecode(m_hs->getDesc());
-			dsBytecode = getBytecode(m_ds->getDesc());
-			if (!hsBytecode || !dsBytecode)
-			{
-				ENGI_LOG_ERROR("Failed to recompile the program");
-				return false;
-			}
-		}
-
-		if (hasComputeStage())
-		{
-			csBytecode = getBytecode(m_cs->getDesc());
-			if (!csBytecode)
-			{
-				ENGI_LOG_ERROR("Failed to recompile the program");
-				return false;
-			}
-		}
-
-		recompile(m_vs, vsBytecode);
-		recompile(m_ps, psBytecode);
-		recompile(m_hs, hsBytecode);
-		recompile(m_ds, dsBytecode);
-		recompile(m_gs, gsBytecode);
-		recompile(m_cs, csBytecode);
 		ENGI_LOG_INFO("Successfully recompiled the {} program", getName());
 		return true;
 	}
 
-	gfx::IGpuShader* ShaderProgram::loadShader(const std::string& filepath, const std::string& entrypoint, gfx::GpuShaderType shaderType) noexcept
+	void ShaderProgram::getShaders(std::vector<gfx::IGpuShader*>& shaders) noexcept
 	{
-		gfx::GpuShaderDesc desc;
-		desc.filepath = filepath;
-		desc.entrypoint = entrypoint;
-		desc.type = shaderType;
-		gfx::IGpuShader* shader = m_cache->getShader(desc);
-		if (!shader)
+		for (gfx::IGpuShader* shader : { m_vs, m_ps, m_gs, m_hs, m_ds, m_cs })
 		{
-			void* bytecode = m_compiler->compileFromHLSLFile(desc);
-			if (!bytecode)
-				return nullptr;
-
-			shader = m_device->createShader(m_name, desc, bytecode);
-			if (!shader)
-				return nullptr;
-
-			m_cache->addShader(shader);
+			if (shader)
+				shaders.push_back(shader);
 		}
-		return shader;
-	}
-
-	void* ShaderProgram::getBytecode(const gfx::GpuShaderDesc& desc) noexcept
-	{
-		return m_compiler->compileFromHLSLFile(desc);
 	}
 
 	void ShaderProgram::recompile(gfx::IGpuShader* shader, void* bytecode) noexcept
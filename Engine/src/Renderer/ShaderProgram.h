@@ -2,6 +2,7 @@
 
 #include <string>
 #include <span>
+#include <vector>
 #include "Utility/Memory.h"
 #include "GFX/Definitions.h"
 #include "GFX/GPUResourceAllocator.h"
@@ -39,6 +40,9 @@ namespace engi
 		constexpr gfx::IGpuShader* getDS() noexcept { return m_ds; }
 		constexpr gfx::IGpuShader* getCS() noexcept { return m_cs; }
 		bool recompileAll() noexcept;
+
+		// Appends all the stages of the program
+		void getShaders(std::vector<gfx::IGpuShader*>& shaders) noexcept;
 		
 		gfx::IGpuInputLayout* getAttributeLayout() noexcept { return m_inputLayout.get(); }
 		const std::string& getName() const noexcept { return m_name; }
@@ -48,10 +52,13 @@ namespace engi
 		constexpr bool hasPixelStage() const noexcept { return m_ps; }
 		constexpr bool hasComputeStage() const noexcept { return m_cs; }
 
+		static gfx::GpuShaderDesc getStageDesc(const std::string& filepath, gfx::GpuShaderType shaderType) noexcept;
+
+		// Descs of the stages that init() loads, so that stages of many programs might be compiled in a single batch
+		static void getStageDescs(const std::string& filepath, bool geometryStage, bool tesselationStage, bool pixelStage, std::vector<gfx::GpuShaderDesc>& descs) noexcept;
+
 	private:
-		gfx::IGpuShader* loadShader(const std::string& filepath, const std::string& entrypoint, gfx::GpuShaderType shaderType) noexcept;
 		void recompile(gfx::IGpuShader* shader, void* bytecode) noexcept;
-		void* getBytecode(const gfx::GpuShaderDesc& desc) noexcept;
 
 		std::string m_name;
 		gfx::IGpuDevice* m_device;
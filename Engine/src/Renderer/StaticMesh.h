@@ -87,6 +87,9 @@ namespace engi
 	{
 		float t = math::Numeric::infinity();
 		math::Vec3 hitpos;
+		math::Vec3 normal; // geometric normal of the hit triangle, normalized
+		math::Vec2 barycentrics; // weights of the second and the third vertex of the triangle
+		uint32_t triangleIndex = uint32_t(-1); // index into StaticMesh::getTriangles()
 
 		inline constexpr void reset() noexcept { t = math::Numeric::infinity(); }
 		inline constexpr bool isValid() const noexcept { return math::Numeric::isFinite(t); }
@@ -0,0 +1,404 @@
+#include "Renderer/StaticMeshBVH.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include "Core/CommonDefinitions.h"
+
+namespace engi
+{
+
+	using namespace math;
+
+	namespace
+	{
+
+		// Plain float box, it is grown a lot during the build, thus it avoids going through vector loads and stores
+		struct BuildBox
+		{
+			float min[3] = { Numeric::infinity(), Numeric::infinity(), Numeric::infinity() };
+			float max[3] = { -Numeric::infinity(), -Numeric::infinity(), -Numeric::infinity() };
+
+			inline void grow(const BuildBox& other) noexcept
+			{
+				for (uint32_t axis = 0; axis < 3; ++axis)
+				{
+					min[axis] = (other.min[axis] < min[axis]) ? other.min[axis] : min[axis];
+					max[axis] = (other.max[axis] > max[axis]) ? other.max[axis] : max[axis];
+				}
+			}
+
+			inline void grow(const float* point) noexcept
+			{
+				for (uint32_t axis = 0; axis < 3; ++axis)
+				{
+					min[axis] = (point[axis] < min[axis]) ? point[axis] : min[axis];
+					max[axis] = (point[axis] > max[axis]) ? point[axis] : max[axis];
+				}
+			}
+
+			// Half of the surface area, which is enough for SAH as only ratios matter
+			inline float area() const noexcept
+			{
+				if (min[0] > max[0])
+					return 0.0f;
+
+				float dx = max[0] - min[0];
+				float dy = max[1] - min[1];
+				float dz = max[2] - min[2];
+				return dx * dy + dy * dz + dz * dx;
+			}
+		};
+
+	}; // anonymous namespace
+
+	struct StaticMeshBVH::BuildData
+	{
+		std::vector<BuildBox> triangleBoxes;
+		std::vector<std::array<float, 3>> centroids;
+		std::vector<uint32_t> triangleIndices; // reordered during the build, so that each node references a contiguous range
+	};
+
+	bool StaticMeshBVH::initialize(const StaticMesh* mesh) noexcept
+	{
+		m_nodes.clear();
+		m_packets.clear();
+		m_packetTriangleIndices.clear();
+
+		if (!mesh || mesh->isEmpty() || !mesh->isTriangleFull() || !mesh->isVertexFull())
+			return false;
+
+		uint32_t numTriangles = mesh->getNumTriangles();
+		if (numTriangles == 0)
+			return false;
+
+		const StaticMesh::VertexContainerType& vertices = mesh->getVertices();
+		const StaticMesh::TriangleContainerType& triangles = mesh->getTriangles();
+
+		BuildData data;
+		data.triangleBoxes.resize(numTriangles);
+		data.centroids.resize(numTriangles);
+		data.triangleIndices.resize(numTriangles);
+		for (uint32_t triIndex = 0; triIndex < numTriangles; ++triIndex)
+		{
+			const StaticMeshTriangle& meshTri = triangles[triIndex];
+			const Vec3& p0 = vertices[meshTri.indices[0]].position;
+			const Vec3& p1 = vertices[meshTri.indices[1]].position;
+			const Vec3& p2 = vertices[meshTri.indices[2]].position;
+
+			BuildBox& box = data.triangleBoxes[triIndex];
+			box.grow(&p0.x);
+			box.grow(&p1.x);
+			box.grow(&p2.x);
+			for (uint32_t axis = 0; axis < 3; ++axis)
+				data.centroids[triIndex][axis] = (p0[axis] + p1[axis] + p2[axis]) / 3.0f;
+
+			data.triangleIndices[triIndex] = triIndex;
+		}
+
+		// Binary tree has at most 2n - 1 nodes, plus one unused node after the root to keep siblings in pairs
+		m_nodes.reserve(static_cast<size_t>(numTriangles) * 2);
+		Node& root = m_nodes.emplace_back();
+		root.leftFirst = 0;
+		root.numTriangles = numTriangles;
+		updateNodeBounds(0, data);
+		m_nodes.emplace_back();
+
+		std::vector<std::pair<uint32_t, uint32_t>> stack; // (nodeIndex, depth)
+		stack.emplace_back(0, 0);
+		while (!stack.empty())
+		{
+			auto [nodeIndex, depth] = stack.back();
+			stack.pop_back();
+
+			if (depth + 1 >= StaticMeshBVHTraits::maxDepth() || !subdivide(nodeIndex, data))
+				continue;
+
+			uint32_t leftIndex = m_nodes[nodeIndex].leftFirst;
+			stack.emplace_back(leftIndex, depth + 1);
+			stack.emplace_back(leftIndex + 1, depth + 1);
+		}
+		m_nodes.shrink_to_fit();
+
+		buildPackets(mesh, data);
+		return true;
+	}
+
+	bool StaticMeshBVH::initialize(const Node* nodes, uint32_t numNodes, const TrianglePacketN* packets, uint32_t numPackets, const uint32_t* packetTriangleIndices) noexcept
+	{
+		m_nodes.clear();
+		m_packets.clear();
+		m_packetTriangleIndices.clear();
+
+		if (!nodes || numNodes == 0 || !packets || numPackets == 0 || !packetTriangleIndices)
+			return false;
+
+		m_nodes.assign(nodes, nodes + numNodes);
+		m_packets.assign(packets, packets + numPackets);
+		m_packetTriangleIndices.assign(packetTriangleIndices, packetTriangleIndices + static_cast<size_t>(numPackets) * TrianglePacketN::WIDTH);
+		return true;
+	}
+
+	void StaticMeshBVH::updateNodeBounds(uint32_t nodeIndex, const BuildData& data) noexcept
+	{
+		Node& node = m_nodes[nodeIndex];
+		BuildBox bounds;
+		for (uint32_t i = 0; i < node.numTriangles; ++i)
+			bounds.grow(data.triangleBoxes[data.triangleIndices[node.leftFirst + i]]);
+
+		node.min = Vec3(bounds.min[0], bounds.min[1], bounds.min[2]);
+		node.max = Vec3(bounds.max[0], bounds.max[1], bounds.max[2]);
+	}
+
+	bool StaticMeshBVH::findSplit(const Node& node, const BuildData& data, Split& split) const noexcept
+	{
+		static constexpr uint32_t NUM_BINS = StaticMeshBVHTraits::numBins();
+
+		struct Bin
+		{
+			BuildBox bounds;
+			uint32_t numTriangles = 0;
+		};
+
+		BuildBox centroidBounds;
+		for (uint32_t i = 0; i < node.numTriangles; ++i)
+			centroidBounds.grow(data.centroids[data.triangleIndices[node.leftFirst + i]].data());
+
+		split.cost = Numeric::infinity();
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			float centroidMin = centroidBounds.min[axis];
+			float extent = centroidBounds.max[axis] - centroidMin;
+			if (extent <= 0.0f)
+				continue;
+
+			float binScale = static_cast<float>(NUM_BINS) / extent;
+			std::array<Bin, NUM_BINS> bins;
+			for (uint32_t i = 0; i < node.numTriangles; ++i)
+			{
+				uint32_t triIndex = data.triangleIndices[node.leftFirst + i];
+				uint32_t binIndex = static_cast<uint32_t>((data.centroids[triIndex][axis] - centroidMin) * binScale);
+				binIndex = (binIndex < NUM_BINS - 1) ? binIndex : NUM_BINS - 1;
+				bins[binIndex].bounds.grow(data.triangleBoxes[triIndex]);
+				++bins[binIndex].numTriangles;
+			}
+
+			// Sweep from both sides to get the cost of every plane between bins
+			std::array<float, NUM_BINS - 1> leftCost;
+			std::array<uint32_t, NUM_BINS - 1> leftCount;
+			BuildBox leftBox;
+			uint32_t count = 0;
+			for (uint32_t i = 0; i < NUM_BINS - 1; ++i)
+			{
+				leftBox.grow(bins[i].bounds);
+				count += bins[i].numTriangles;
+				leftCount[i] = count;
+				leftCost[i] = leftBox.area() * static_cast<float>(count);
+			}
+
+			BuildBox rightBox;
+			uint32_t rightCount = 0;
+			for (uint32_t i = NUM_BINS - 1; i > 0; --i)
+			{
+				rightBox.grow(bins[i].bounds);
+				rightCount += bins[i].numTriangles;
+				if (leftCount[i - 1] == 0 || rightCount == 0)
+					continue;
+
+				float cost = leftCost[i - 1] + rightBox.area() * static_cast<float>(rightCount);
+				if (cost < split.cost)
+				{
+					split.axis = axis;
+					split.bin = i - 1;
+					split.centroidMin = centroidMin;
+					split.binScale = binScale;
+					split.cost = cost;
+				}
+			}
+		}
+
+		return Numeric::isFinite(split.cost);
+	}
+
+	bool StaticMeshBVH::subdivide(uint32_t nodeIndex, BuildData& data) noexcept
+	{
+		Node node = m_nodes[nodeIndex];
+		if (node.numTriangles <= StaticMeshBVHTraits::maxLeafTriangles())
+			return false;
+
+		Split split;
+		if (!findSplit(node, data, split))
+			return false;
+
+		// Compare SAH cost of the split with the cost of keeping the node as a leaf
+		BuildBox nodeBox;
+		nodeBox.grow(&node.min.x);
+		nodeBox.grow(&node.max.x);
+		float nodeArea = nodeBox.area();
+		float leafCost = StaticMeshBVHTraits::intersectionCost() * static_cast<float>(node.numTriangles);
+		float splitCost = StaticMeshBVHTraits::traversalCost() + StaticMeshBVHTraits::intersectionCost() * split.cost / (nodeArea > 0.0f ? nodeArea : 1.0f);
+		if (splitCost >= leafCost)
+			return false;
+
+		// Partition triangles with exactly the same binning that was used to evaluate the split
+		auto first = data.triangleIndices.begin() + node.leftFirst;
+		auto last = first + node.numTriangles;
+		auto middle = std::partition(first, last, [&](uint32_t triIndex)
+			{
+				uint32_t binIndex = static_cast<uint32_t>((data.centroids[triIndex][split.axis] - split.centroidMin) * split.binScale);
+				return binIndex <= split.bin;
+			});
+
+		uint32_t leftCount = static_cast<uint32_t>(middle - first);
+		if (leftCount == 0 || leftCount == node.numTriangles)
+			return false;
+
+		uint32_t leftIndex = static_cast<uint32_t>(m_nodes.size());
+		Node& left = m_nodes.emplace_back();
+		left.leftFirst = node.leftFirst;
+		left.numTriangles = leftCount;
+
+		Node& right = m_nodes.emplace_back();
+		right.leftFirst = node.leftFirst + leftCount;
+		right.numTriangles = node.numTriangles - leftCount;
+
+		m_nodes[nodeIndex].leftFirst = leftIndex;
+		m_nodes[nodeIndex].numTriangles = 0;
+		updateNodeBounds(leftIndex, data);
+		updateNodeBounds(leftIndex + 1, data);
+		return true;
+	}
+
+	void StaticMeshBVH::buildPackets(const StaticMesh* mesh, const BuildData& data) noexcept
+	{
+		static constexpr uint32_t WIDTH = TrianglePacketN::WIDTH;
+
+		const StaticMesh::VertexContainerType& vertices = mesh->getVertices();
+		const StaticMesh::TriangleContainerType& triangles = mesh->getTriangles();
+
+		// Every leaf gets its own packets, the last one is padded with cleared lanes. After this leaves reference packets instead of triangles
+		uint32_t numPackets = 0;
+		for (const Node& node : m_nodes)
+			numPackets += node.getNumPackets();
+
+		m_packets.resize(numPackets);
+		m_packetTriangleIndices.assign(static_cast<size_t>(numPackets) * WIDTH, uint32_t(-1));
+
+		uint32_t packetIndex = 0;
+		for (Node& node : m_nodes)
+		{
+			if (!node.isLeaf())
+				continue;
+
+			for (uint32_t i = 0; i < node.numTriangles; ++i)
+			{
+				uint32_t triIndex = data.triangleIndices[node.leftFirst + i];
+				const StaticMeshTriangle& meshTri = triangles[triIndex];
+				uint32_t packet = packetIndex + i / WIDTH;
+				uint32_t lane = i % WIDTH;
+				m_packets[packet].set(lane, vertices[meshTri.indices[0]].position, vertices[meshTri.indices[1]].position, vertices[meshTri.indices[2]].position);
+				m_packetTriangleIndices[packet * WIDTH + lane] = triIndex;
+			}
+
+			node.leftFirst = packetIndex;
+			packetIndex += node.getNumPackets();
+		}
+	}
+
+	StaticMeshBVH::IntersectionType StaticMeshBVH::intersect(const Ray& meshRay) const noexcept
+	{
+		IntersectionType result;
+		result.reset();
+
+		if (m_nodes.empty())
+			return result;
+
+		const RaySSE boxRay(meshRay);
+		if (!Numeric::isFinite(intersectBox(boxRay, &m_nodes[0].min.x, &m_nodes[0].max.x, result.t)))
+			return result;
+
+		const RayPacketN packetRay(meshRay);
+		TriangleHit hit;
+		uint32_t hitPacket = uint32_t(-1);
+
+		struct StackEntry
+		{
+			uint32_t nodeIndex;
+			float t;
+		};
+
+		std::array<StackEntry, StaticMeshBVHTraits::maxDepth()> stack;
+		uint32_t stackSize = 0;
+		uint32_t nodeIndex = 0;
+		while (true)
+		{
+			const Node& node = m_nodes[nodeIndex];
+			if (node.isLeaf())
+			{
+				uint32_t numPackets = node.getNumPackets();
+				for (uint32_t i = 0; i < numPackets; ++i)
+				{
+					if (intersects(packetRay, m_packets[node.leftFirst + i], hit))
+						hitPacket = node.leftFirst + i;
+				}
+				result.t = hit.t;
+			}
+			else
+			{
+				// Visit the closer child first, the further one is postponed and might be skipped later
+				uint32_t nearIndex = node.leftFirst;
+				uint32_t farIndex = node.leftFirst + 1;
+				float tNear = intersectBox(boxRay, &m_nodes[nearIndex].min.x, &m_nodes[nearIndex].max.x, result.t);
+				float tFar = intersectBox(boxRay, &m_nodes[farIndex].min.x, &m_nodes[farIndex].max.x, result.t);
+				if (tFar < tNear)
+				{
+					std::swap(nearIndex, farIndex);
+					std::swap(tNear, tFar);
+				}
+
+				if (Numeric::isFinite(tNear))
+				{
+					if (Numeric::isFinite(tFar))
+					{
+						ENGI_ASSERT(stackSize < stack.size() && "BVH is deeper than expected");
+						stack[stackSize++] = StackEntry{ farIndex, tFar };
+					}
+
+					nodeIndex = nearIndex;
+					continue;
+				}
+			}
+
+			// Pop the next node that is still closer than the closest hit
+			bool found = false;
+			while (stackSize > 0)
+			{
+				const StackEntry& entry = stack[--stackSize];
+				if (entry.t < result.t)
+				{
+					nodeIndex = entry.nodeIndex;
+					found = true;
+					break;
+				}
+			}
+
+			if (!found)
+				break;
+		}
+
+		if (result.isValid())
+		{
+			const TrianglePacketN& packet = m_packets[hitPacket];
+			Vec3 e1(packet.e1[0][hit.lane], packet.e1[1][hit.lane], packet.e1[2][hit.lane]);
+			Vec3 e2(packet.e2[0][hit.lane], packet.e2[1][hit.lane], packet.e2[2][hit.lane]);
+			result.hitpos = meshRay.origin + (meshRay.direction * result.t);
+			result.normal = e1.cross(e2);
+			result.normal.normalize();
+			result.barycentrics = Vec2(hit.u, hit.v);
+			result.triangleIndex = getMeshTriangleIndex(hitPacket, hit.lane);
+		}
+
+		return result;
+	}
+
+}; // engi namespace
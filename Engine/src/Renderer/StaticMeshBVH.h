@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+#include "Math/Math.h"
+#include "Math/TrianglePacket.h"
+#include "Renderer/StaticMesh.h"
+
+// leave them as defines, for different builds. Leaves are stored as triangle packets, thus the leaf size follows the packet width
+#define ENGI_MESHBVH_MAX_LEAF_TRIANGLES ENGI_TRIANGLEPACKET_WIDTH
+#define ENGI_MESHBVH_NUM_BINS 16
+
+namespace engi
+{
+
+	struct StaticMeshBVHTraits
+	{
+		static inline constexpr uint32_t maxLeafTriangles() { return static_cast<uint32_t>(ENGI_MESHBVH_MAX_LEAF_TRIANGLES); }
+		static inline constexpr uint32_t numBins() { return static_cast<uint32_t>(ENGI_MESHBVH_NUM_BINS); }
+		static inline constexpr float traversalCost() { return 1.0f; }
+		static inline constexpr float intersectionCost() { return 1.0f; }
+		static inline constexpr uint32_t maxDepth() { return 64; } // also bounds the traversal stack
+	};
+
+	// Bounding volume hierarchy over triangles of a single mesh, built with binned SAH.
+	// Nodes are stored in a single array and siblings are adjacent, so that both children of a node share one cache line.
+	// Triangles of every leaf are copied into SIMD packets, thus the BVH does not reference the mesh after the build
+	class StaticMeshBVH
+	{
+	public:
+		using IntersectionType = StaticMeshIntersection;
+
+		struct alignas(32) Node
+		{
+			math::Vec3 min;
+			uint32_t leftFirst = 0; // index of the left child for inner nodes, index of the first packet for leaves
+			math::Vec3 max;
+			uint32_t numTriangles = 0; // zero for inner nodes
+
+			inline constexpr bool isLeaf() const noexcept { return numTriangles != 0; }
+			inline constexpr uint32_t getNumPackets() const noexcept { return (numTriangles + math::TrianglePacketN::WIDTH - 1) / math::TrianglePacketN::WIDTH; }
+		};
+
+		StaticMeshBVH() = default;
+		StaticMeshBVH(const StaticMeshBVH&) = delete;
+		StaticMeshBVH& operator=(const StaticMeshBVH&) = delete;
+		StaticMeshBVH(StaticMeshBVH&&) = default;
+		StaticMeshBVH& operator=(StaticMeshBVH&&) = default;
+		~StaticMeshBVH() = default;
+
+		bool initialize(const StaticMesh* mesh) noexcept;
+		IntersectionType intersect(const math::Ray& ray) const noexcept;
+
+		// Restores a BVH that was built before (e.g. read from the cooked mesh cache), nothing is validated except for sizes
+		bool initialize(const Node* nodes, uint32_t numNodes, const math::TrianglePacketN* packets, uint32_t numPackets, const uint32_t* packetTriangleIndices) noexcept;
+		inline bool isInitialized() const noexcept { return !m_nodes.empty(); }
+		inline const std::vector<Node>& getNodes() const noexcept { return m_nodes; }
+		inline const std::vector<math::TrianglePacketN>& getPackets() const noexcept { return m_packets; }
+		inline const std::vector<uint32_t>& getPacketTriangleIndices() const noexcept { return m_packetTriangleIndices; }
+
+		inline uint32_t getNumNodes() const noexcept { return static_cast<uint32_t>(m_nodes.size()); }
+		inline uint32_t getNumPackets() const noexcept { return static_cast<uint32_t>(m_packets.size()); }
+
+		// Maps a lane of a packet to the triangle index in the mesh, padding lanes are mapped to uint32_t(-1)
+		inline uint32_t getMeshTriangleIndex(uint32_t packetIndex, uint32_t lane) const noexcept { return m_packetTriangleIndices[packetIndex * math::TrianglePacketN::WIDTH + lane]; }
+
+	private:
+		struct BuildData;
+
+		// Split between bins along the axis. Triangles with centroids in bins [0, bin] go to the left child
+		struct Split
+		{
+			uint32_t axis = 0;
+			uint32_t bin = 0;
+			float centroidMin = 0.0f;
+			float binScale = 0.0f;
+			float cost = math::Numeric::infinity();
+		};
+
+		void updateNodeBounds(uint32_t nodeIndex, const BuildData& data) noexcept;
+		bool findSplit(const Node& node, const BuildData& data, Split& split) const noexcept;
+		bool subdivide(uint32_t nodeIndex, BuildData& data) noexcept;
+		void buildPackets(const StaticMesh* mesh, const BuildData& data) noexcept;
+
+		std::vector<Node> m_nodes;
+		std::vector<math::TrianglePacketN> m_packets;
+		std::vector<uint32_t> m_packetTriangleIndices;
+	};
+
+}; // engi namespace
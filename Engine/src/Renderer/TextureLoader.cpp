@@ -149,7 +149,12 @@ namespace engi
 
 	Texture2D* TextureLoader::loadTexture2D(const std::string& filepath, bool requestSrv) noexcept
 	{
-		IGpuTexture* gpuTexture = loadGPUTextureFromDDS(filepath);
+		return this->loadTexture2D(filepath, nullptr, 0, requestSrv);
+	}
+
+	Texture2D* TextureLoader::loadTexture2D(const std::string& filepath, const uint8_t* ddsData, size_t ddsSize, bool requestSrv) noexcept
+	{
+		IGpuTexture* gpuTexture = loadGPUTextureFromDDS(filepath, ddsData, ddsSize);
 		if (!gpuTexture)
 			return nullptr;
 
@@ -213,7 +218,7 @@ namespace engi
 		return true;
 	}
 
-	gfx::IGpuTexture* TextureLoader::loadGPUTextureFromDDS(const std::string& filepath) noexcept
+	gfx::IGpuTexture* TextureLoader::loadGPUTextureFromDDS(const std::string& filepath, const uint8_t* ddsData, size_t ddsSize) noexcept
 	{
 		D3D11Device* device = dynamic_cast<D3D11Device*>(m_device);
 		if (!device)
@@ -227,17 +232,34 @@ namespace engi
 
 		UINT bindFlags = D3D11_BIND_SHADER_RESOURCE;
 		D3D11Texture* gpuTexture = (D3D11Texture*)texture;
-		std::wstring wfilepath(filepath.begin(), filepath.end());
-		HRESULT hr = DirectX::CreateDDSTextureFromFileEx(
-			device->getHandle(),
-			wfilepath.c_str(), 0,
-			D3D11_USAGE_IMMUTABLE,
-			bindFlags,
-			0,
-			0,
-			DirectX::DDS_LOADER_DEFAULT,
-			gpuTexture->m_handle.GetAddressOf(),
-			nullptr);
+		HRESULT hr = S_OK;
+		if (ddsData)
+		{
+			hr = DirectX::CreateDDSTextureFromMemoryEx(
+				device->getHandle(),
+				ddsData, ddsSize, 0,
+				D3D11_USAGE_IMMUTABLE,
+				bindFlags,
+				0,
+				0,
+				DirectX::DDS_LOADER_DEFAULT,
+				gpuTexture->m_handle.GetAddressOf(),
+				nullptr);
+		}
+		else
+		{
+			std::wstring wfilepath(filepath.begin(), filepath.end());
+			hr = DirectX::CreateDDSTextureFromFileEx(
+				device->getHandle(),
+				wfilepath.c_str(), 0,
+				D3D11_USAGE_IMMUTABLE,
+				bindFlags,
+				0,
+				0,
+				DirectX::DDS_LOADER_DEFAULT,
+				gpuTexture->m_handle.GetAddressOf(),
+				nullptr);
+		}
 		if (FAILED(hr))
 		{
 			gpuAllocator->destroyResource((IGpuResource*&)gpuTexture);
@@ -40,13 +40,17 @@ namespace engi
 
 		Texture2D* loadTextureAtlas(const std::string& filepath, uint32_t numWidthTextures, uint32_t numHeightTextures, bool requestSrv) noexcept;
 		Texture2D* loadTexture2D(const std::string& filepath, bool requestSrv) noexcept;
+
+		// Creates the texture from the contents of a DDS file that was already read into memory, filepath is only used to name the texture
+		Texture2D* loadTexture2D(const std::string& filepath, const uint8_t* ddsData, size_t ddsSize, bool requestSrv) noexcept;
 		TextureCube* loadTextureCube(const std::string& filepath, bool requestSrv) noexcept;
 		bool saveToFile(Texture2D* texture, const std::string& filepath, bool mips, CompressionFormat format = COMPRESSION_NONE) noexcept;
 		bool saveToFile(TextureCube* texture, const std::string& filepath, bool mips, CompressionFormat format = COMPRESSION_NONE) noexcept;
 		TextureLibrary* getLibrary() noexcept { return m_textureLibrary; }
 
 	private:
-		gfx::IGpuTexture* loadGPUTextureFromDDS(const std::string& filepath) noexcept;
+		// If ddsData is nullptr the file is read from the filepath
+		gfx::IGpuTexture* loadGPUTextureFromDDS(const std::string& filepath, const uint8_t* ddsData = nullptr, size_t ddsSize = 0) noexcept;
 		bool saveGPUTextureToDDS(gfx::IGpuTexture* texture, const std::string& filepath, bool mips, CompressionFormat format) noexcept;
 
 		gfx::IGpuDevice* m_device;
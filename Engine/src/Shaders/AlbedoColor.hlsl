@@ -13,7 +13,7 @@ struct VS_OUTPUT
 VS_OUTPUT vs_main(VS_INPUT input)
 {    
     float4x4 viewProj = mul(g_views[0], g_proj);
-    float4 pos = mul(mul(float4(input.meshPosition, 1.0f), g_meshToModel), mul(input.modelToWorld, viewProj));
+    float4 pos = mul(mul(float4(input.meshPosition, 1.0f), g_meshToModel), mul(getModelToWorld(input), viewProj));
     VS_OUTPUT output;
     output.pos = pos;
     output.texUvs = input.meshTexCoords;
@@ -4,14 +4,17 @@
 struct VS_OUTPUT
 {
     float4 worldPos : WORLD_POS;
+    nointerpolation uint viewMask : INSTANCE_VIEW_MASK;
 };
 
-VS_OUTPUT vs_main(VS_INPUT input)
+// viewMask contains a bit per cube face the instance is visible from, it is computed during CPU culling
+VS_OUTPUT vs_main(VS_INPUT input, uint viewMask : INSTANCE_VIEW_MASK)
 {
     float4 modelPos = mul(float4(input.meshPosition, 1.0f), g_meshToModel);
-    float4 worldPos = mul(modelPos, input.modelToWorld);
+    float4 worldPos = mul(modelPos, getModelToWorld(input));
     VS_OUTPUT output;
     output.worldPos = worldPos;
+    output.viewMask = viewMask;
     return output;
 }
 
@@ -26,6 +29,9 @@ void gs_main(triangle VS_OUTPUT input[3], inout TriangleStream<GS_OUTPUT> output
 {
     for (uint arrayslice = 0; arrayslice < 6; ++arrayslice)
     {
+        if ((input[0].viewMask & (1u << arrayslice)) == 0)
+            continue;
+        
         for (uint i = 0; i < 3; ++i)
         {
             float4x4 viewProj = mul(g_views[arrayslice], g_proj);
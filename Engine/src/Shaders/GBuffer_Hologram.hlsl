@@ -24,8 +24,8 @@ VS_OUTPUT vs_main(VS_INPUT input)
     output.modelPosition = modelPos;
     output.modelNormal = modelNormal;
     output.cameraPos = g_viewsInv[0][3].xyz;
-    output.modelToWorld = float4x4(input.modelToWorld);
-    output.emission = input.emission * input.emissionPow;
+    output.modelToWorld = getModelToWorld(input);
+    output.emission = input.emission.rgb * input.emission.a;
     output.instanceID = input.instanceID;
     return output;
 }
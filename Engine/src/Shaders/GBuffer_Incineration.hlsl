@@ -66,14 +66,14 @@ void Incineration_SpawnParticle(float3 worldPos, float3 worldNormal, float3 emis
 
 VS_OUTPUT vs_main(VS_INPUT input, uint vid : SV_VertexID)
 {
-    float3 worldNormal = convertToOrthogonalBasis(input.modelToWorld, convertToOrthogonalBasis(g_meshToModel, input.meshNormal));
+    float3 worldNormal = convertToOrthogonalBasis(getModelToWorld(input), convertToOrthogonalBasis(g_meshToModel, input.meshNormal));
     float3 modelPos = mul(float4(input.meshPosition, 1.0f), g_meshToModel).xyz;
-    float3 worldPos = mul(float4(modelPos, 1.0f), input.modelToWorld).xyz;
+    float3 worldPos = mul(float4(modelPos, 1.0f), getModelToWorld(input)).xyz;
     
     float4x4 viewProj = mul(g_views[0], g_proj);
     float4 pos = mul(float4(worldPos, 1.0f), viewProj);
     
-    float3 emission = input.emission * input.emissionPow;
+    float3 emission = input.emission.rgb * input.emission.a;
     
     VS_OUTPUT output;
     output.pos = pos;
@@ -84,13 +84,14 @@ VS_OUTPUT vs_main(VS_INPUT input, uint vid : SV_VertexID)
     output.color = input.color;
     output.emission = emission;
     
-    output.TBN = constructTBN(input.modelToWorld, input.meshTangent, input.meshBitangent, worldNormal);
-    output.time = input.time;
+    output.TBN = constructTBN(getModelToWorld(input), input.meshTangent, input.meshBitangent, worldNormal);
+    float instanceTime = getInstanceTime(input, g_time);
+    output.time = instanceTime;
     
     // Incineration sphere radii
     float invIncinerationTime = 1.0 / g_incinerationTime;
-    float prevFrameTime = max(0.0, input.time - input.timestep);
-    float iSphereRadius = lerp(0.0, input.sphereRadiusMax, saturate(input.time * invIncinerationTime));
+    float prevFrameTime = getInstanceTime(input, g_time - g_timestep);
+    float iSphereRadius = lerp(0.0, input.sphereRadiusMax, saturate(instanceTime * invIncinerationTime));
     float iSpherePrevFrameRadius = lerp(0.0, input.sphereRadiusMax, saturate(prevFrameTime * invIncinerationTime));
     
     // Incineration
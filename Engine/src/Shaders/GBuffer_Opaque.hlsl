@@ -16,9 +16,9 @@ struct VS_OUTPUT
 
 VS_OUTPUT vs_main(VS_INPUT input)
 {
-    float3 worldNormal = convertToOrthogonalBasis(input.modelToWorld, convertToOrthogonalBasis(g_meshToModel, input.meshNormal));
+    float3 worldNormal = convertToOrthogonalBasis(getModelToWorld(input), convertToOrthogonalBasis(g_meshToModel, input.meshNormal));
     float3 modelPos = mul(float4(input.meshPosition, 1.0f), g_meshToModel).xyz;
-    float3 worldPos = mul(float4(modelPos, 1.0f), input.modelToWorld).xyz;
+    float3 worldPos = mul(float4(modelPos, 1.0f), getModelToWorld(input)).xyz;
     
     float4x4 viewProj = mul(g_views[0], g_proj);
     float4 pos = mul(float4(worldPos, 1.0f), viewProj);
@@ -30,7 +30,7 @@ VS_OUTPUT vs_main(VS_INPUT input)
     
     output.color = input.color;
     
-    output.TBN = constructTBN(input.modelToWorld, input.meshTangent, input.meshBitangent, worldNormal);
+    output.TBN = constructTBN(getModelToWorld(input), input.meshTangent, input.meshBitangent, worldNormal);
     
     output.instanceID = input.instanceID;
     return output;
@@ -23,7 +23,7 @@ VS_OUTPUT vs_main(VS_INPUT input)
     output.modelPosition = modelPos;
     output.modelNormal = modelNormal;
     output.cameraPos = g_viewsInv[0][3].xyz;
-    output.modelToWorld = float4x4(input.modelToWorld);
+    output.modelToWorld = getModelToWorld(input);
     output.color = input.color;
     return output;
 }
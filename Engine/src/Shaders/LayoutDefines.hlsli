@@ -10,16 +10,25 @@ struct VS_INPUT
     float2 meshTexCoords : STATIC_MESH_TEXUV;
     float3 meshTangent : STATIC_MESH_TANGENT;
     float3 meshBitangent : STATIC_MESH_BITANGENT;
-    float4x4 modelToWorld : MODEL_TO_WORLD;
-    float4x4 worldToModel : WORLD_TO_MODEL;
+    float4 modelToWorldColumns[3] : MODEL_TO_WORLD; // first three columns of modelToWorld, use getModelToWorld()
     float3 color : INSTANCE_COLOR;
-    float time : INSTANCE_TIME;
-    float timestep : INSTANCE_TIMESTEP;
-    float3 emission : INSTANCE_EMISSION;
-    float emissionPow : INSTANCE_EMISSION_POW;
+    float4 emission : INSTANCE_EMISSION; // rgb is emission color, a is its power
+    uint instanceID : INSTANCE_ID;
     float3 sphereOrigin : INSTANCE_SPHERE_ORIGIN;
     float sphereRadiusMax : INSTANCE_SPHERE_RADIUS_MAX;
-    uint instanceID : INSTANCE_ID;
+    float spawnTime : INSTANCE_SPAWN_TIME;
+    float timeRate : INSTANCE_TIME_RATE;
 };
 
+float4x4 getModelToWorld(VS_INPUT input)
+{
+    return transpose(float4x4(input.modelToWorldColumns[0], input.modelToWorldColumns[1], input.modelToWorldColumns[2], float4(0.0f, 0.0f, 0.0f, 1.0f)));
+}
+
+// Time of the instance at the given scene time (g_time), never negative
+float getInstanceTime(VS_INPUT input, float sceneTime)
+{
+    return max(0.0f, (sceneTime - input.spawnTime) * input.timeRate);
+}
+
 #endif // __ENGI_LAYOUTS_HLSL__
\ No newline at end of file
@@ -16,17 +16,17 @@ struct VS_OUTPUT
 
 VS_OUTPUT vs_main(VS_INPUT input)
 {
-    float3 worldNormal = convertToOrthogonalBasis(input.modelToWorld, convertToOrthogonalBasis(g_meshToModel, input.meshNormal));
+    float3 worldNormal = convertToOrthogonalBasis(getModelToWorld(input), convertToOrthogonalBasis(g_meshToModel, input.meshNormal));
     float3 modelPos = mul(float4(input.meshPosition, 1.0f), g_meshToModel).xyz;
     
     float4x4 viewProj = mul(g_views[0], g_proj);
     VS_OUTPUT output;
-    output.position = mul(float4(modelPos, 1.0f), mul(input.modelToWorld, viewProj));
+    output.position = mul(float4(modelPos, 1.0f), mul(getModelToWorld(input), viewProj));
     output.worldNormal = worldNormal;
     output.texCoords = input.meshTexCoords;
     if (g_useNormalMap)
     {
-        float3x3 TBN = constructTBN(input.modelToWorld, input.meshTangent, input.meshBitangent, worldNormal);
+        float3x3 TBN = constructTBN(getModelToWorld(input), input.meshTangent, input.meshBitangent, worldNormal);
         output.TBN = TBN;
     }
     return output;
@@ -12,7 +12,7 @@ VS_OUTPUT vs_main(VS_INPUT input)
     float4 modelPos = mul(float4(input.meshPosition, 1.0), g_meshToModel);
     
     VS_OUTPUT output;
-    output.worldPos = mul(modelPos, input.modelToWorld).xyz;
+    output.worldPos = mul(modelPos, getModelToWorld(input)).xyz;
     output.viewProj = mul(g_views[0], g_proj);
     return output;
 }
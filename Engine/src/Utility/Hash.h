@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace engi
+{
+
+	inline constexpr uint64_t HASH_SEED = 0xcbf29ce484222325ull;
+
+	// FNV-1a variant that consumes 8 bytes per step, it is used to checksum cached files and to name them, not for security
+	inline uint64_t hashBytes(const void* data, size_t size, uint64_t seed = HASH_SEED) noexcept
+	{
+		static constexpr uint64_t PRIME = 0x100000001b3ull;
+
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		uint64_t hash = seed;
+		size_t offset = 0;
+		for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t))
+		{
+			uint64_t word;
+			std::memcpy(&word, bytes + offset, sizeof(uint64_t));
+			hash = (hash ^ word) * PRIME;
+			hash ^= hash >> 32;
+		}
+
+		for (; offset < size; ++offset)
+			hash = (hash ^ bytes[offset]) * PRIME;
+
+		return hash;
+	}
+
+	inline uint64_t hashString(std::string_view str, uint64_t seed = HASH_SEED) noexcept
+	{
+		return hashBytes(str.data(), str.size(), seed);
+	}
+
+}; // engi namespace
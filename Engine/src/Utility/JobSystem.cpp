@@ -0,0 +1,155 @@
+#include "Utility/JobSystem.h"
+
+namespace engi
+{
+
+	// Initialize the max amount of threads for the current OS
+	const uint32_t JobSystem::s_maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	UniqueHandle<JobSystem> JobSystem::s_instance = nullptr;
+
+	// Threads that do not belong to the job system (including the main one) are treated as the main thread
+	static thread_local uint32_t s_threadIndex = JobSystem::MAIN_THREAD_INDEX;
+
+	bool JobSystem::init(uint32_t numWorkers) noexcept
+	{
+		if (s_instance)
+			return true;
+
+		s_instance = makeUnique<JobSystem>(new JobSystem(numWorkers));
+		return true;
+	}
+
+	void JobSystem::deinit() noexcept
+	{
+		s_instance.reset();
+	}
+
+	JobSystem& JobSystem::get() noexcept
+	{
+		ENGI_ASSERT(s_instance && "JobSystem is not initialized");
+		return *s_instance;
+	}
+
+	JobSystem::JobSystem(uint32_t numWorkers)
+	{
+		m_queues.reserve(numWorkers + 1);
+		for (uint32_t i = 0; i < numWorkers + 1; ++i)
+			m_queues.push_back(makeUnique<JobQueue>(new JobQueue()));
+
+		m_workers.reserve(numWorkers);
+		for (uint32_t i = 1; i <= numWorkers; ++i)
+		{
+			m_workers.emplace_back([this, i]() { workLoop(i); });
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		// Drain whatever is left before stopping workers, so that no counter remains incomplete
+		while (m_numPendingJobs.load(std::memory_order_acquire) > 0)
+			tryExecute(MAIN_THREAD_INDEX);
+
+		{
+			std::lock_guard lock(m_sleepMutex);
+			m_isLooping = false;
+		}
+		m_sleepCV.notify_all();
+
+		for (std::thread& t : m_workers)
+			t.join();
+	}
+
+	void JobSystem::wait(const JobCounter& counter) noexcept
+	{
+		uint32_t threadIndex = getThreadIndex();
+		while (!counter.isDone())
+		{
+			if (!tryExecute(threadIndex))
+				std::this_thread::yield();
+		}
+	}
+
+	uint32_t JobSystem::getThreadIndex() noexcept
+	{
+		return s_threadIndex;
+	}
+
+	void JobSystem::push(const Job& job) noexcept
+	{
+		JobQueue& queue = *m_queues[getThreadIndex()];
+		{
+			std::lock_guard lock(queue.mutex);
+			queue.jobs.push_back(job);
+		}
+
+		{
+			// Incrementing under the sleep mutex, so that a worker cannot miss the notification between its check and its wait
+			std::lock_guard lock(m_sleepMutex);
+			m_numPendingJobs.fetch_add(1, std::memory_order_release);
+		}
+		m_sleepCV.notify_one();
+	}
+
+	bool JobSystem::pop(uint32_t threadIndex, Job& job) noexcept
+	{
+		JobQueue& queue = *m_queues[threadIndex];
+		std::lock_guard lock(queue.mutex);
+		if (queue.jobs.empty())
+			return false;
+
+		job = queue.jobs.back();
+		queue.jobs.pop_back();
+		return true;
+	}
+
+	bool JobSystem::steal(uint32_t threadIndex, Job& job) noexcept
+	{
+		uint32_t numQueues = this->numThreads();
+		for (uint32_t i = 1; i < numQueues; ++i)
+		{
+			JobQueue& victim = *m_queues[(threadIndex + i) % numQueues];
+			std::unique_lock lock(victim.mutex, std::try_to_lock);
+			if (!lock.owns_lock() || victim.jobs.empty())
+				continue;
+
+			job = victim.jobs.front();
+			victim.jobs.pop_front();
+			return true;
+		}
+		return false;
+	}
+
+	bool JobSystem::tryExecute(uint32_t threadIndex) noexcept
+	{
+		Job job;
+		if (!pop(threadIndex, job) && !steal(threadIndex, job))
+			return false;
+
+		m_numPendingJobs.fetch_sub(1, std::memory_order_relaxed);
+		execute(job, threadIndex);
+		return true;
+	}
+
+	void JobSystem::execute(Job& job, uint32_t threadIndex) noexcept
+	{
+		ENGI_ASSERT(job.invoke && job.counter);
+		job.invoke(job.storage, threadIndex);
+		job.counter->m_value.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	void JobSystem::workLoop(uint32_t threadIndex) noexcept
+	{
+		s_threadIndex = threadIndex;
+		while (true)
+		{
+			if (tryExecute(threadIndex))
+				continue;
+
+			std::unique_lock lock(m_sleepMutex);
+			m_sleepCV.wait(lock, [this]() { return !m_isLooping || m_numPendingJobs.load(std::memory_order_acquire) > 0; });
+			if (!m_isLooping)
+				return;
+		}
+	}
+
+}; // engi namespace
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+#include <utility>
+
+#include "Core/CommonDefinitions.h"
+#include "Utility/Memory.h"
+
+namespace engi
+{
+
+	// Counter of jobs that are still in flight. Every scheduled job increments it and decrements it after completion,
+	// thus a single counter might track a whole tree of jobs as long as children are scheduled with the same counter
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		inline bool isDone() const noexcept { return m_value.load(std::memory_order_acquire) == 0; }
+		inline uint32_t getValue() const noexcept { return m_value.load(std::memory_order_acquire); }
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<uint32_t> m_value = 0;
+	};
+
+	// Fixed-size job with an in-place storage for the functor. No heap allocations and no std::function involved
+	// Functors are invoked as void(uint32_t threadIndex)
+	struct alignas(64) Job
+	{
+		static constexpr size_t STORAGE_SIZE = 48;
+		using invoke_func_type = void(*)(void* storage, uint32_t threadIndex);
+
+		invoke_func_type invoke = nullptr;
+		JobCounter* counter = nullptr;
+		alignas(16) std::byte storage[STORAGE_SIZE];
+	};
+
+	// Work-stealing scheduler. Each thread owns a deque, it pushes and pops jobs from its back (LIFO, cache-friendly),
+	// while idle threads steal from the front of other deques (FIFO, takes the oldest and usually the biggest piece of work).
+	// Thread with index 0 is the thread that called JobSystem::init (the main thread), workers are indexed from 1
+	class JobSystem
+	{
+	public:
+		static constexpr uint32_t MAIN_THREAD_INDEX = 0;
+
+		static bool init(uint32_t numWorkers = getMaxThreads() - 1) noexcept;
+		static void deinit() noexcept;
+		static JobSystem& get() noexcept;
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		~JobSystem();
+
+		// Schedules a job on the calling thread's deque. The job is allowed to schedule child jobs with the same counter
+		template<typename Func>
+		void schedule(JobCounter& counter, Func&& func) noexcept;
+
+		// Splits [0, numTasks) into batches of tasksPerBatch and schedules a job per batch.
+		// Func is invoked as void(uint32_t threadIndex, uint32_t taskIndex) and must outlive the counter
+		template<typename Func>
+		void dispatch(JobCounter& counter, uint32_t numTasks, uint32_t tasksPerBatch, const Func& func) noexcept;
+
+		// Blocks until the counter reaches zero. The calling thread keeps executing pending jobs instead of parking
+		void wait(const JobCounter& counter) noexcept;
+
+		// Total number of threads that execute jobs, including the main thread
+		inline uint32_t numThreads() const noexcept { return static_cast<uint32_t>(m_queues.size()); }
+
+		// Returns the index of a calling thread within the job system. Threads outside of the job system share the main thread's index
+		static uint32_t getThreadIndex() noexcept;
+
+	public:
+		// 100% CPU occupation, it may cause OS hitches.
+		// No point to have more threads than the number of CPU logical cores.
+		static inline uint32_t getMaxThreads() noexcept { return s_maxThreads; }
+
+		// 50-100% CPU occupation
+		static inline uint32_t getHalfThreads() noexcept { return s_maxThreads > 1 ? s_maxThreads / 2 : 1; }
+
+	private:
+		JobSystem(uint32_t numWorkers);
+
+		struct alignas(64) JobQueue
+		{
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		void push(const Job& job) noexcept;
+		bool pop(uint32_t threadIndex, Job& job) noexcept;
+		bool steal(uint32_t threadIndex, Job& job) noexcept;
+		bool tryExecute(uint32_t threadIndex) noexcept;
+		void execute(Job& job, uint32_t threadIndex) noexcept;
+		void workLoop(uint32_t threadIndex) noexcept;
+
+		std::vector<UniqueHandle<JobQueue>> m_queues;
+		std::vector<std::thread> m_workers;
+
+		std::atomic<uint32_t> m_numPendingJobs = 0;
+		std::atomic<bool> m_isLooping = true;
+		std::mutex m_sleepMutex;
+		std::condition_variable m_sleepCV;
+
+		static const uint32_t s_maxThreads;
+		static UniqueHandle<JobSystem> s_instance;
+	}; // JobSystem class
+
+	template<typename Func>
+	void JobSystem::schedule(JobCounter& counter, Func&& func) noexcept
+	{
+		using functor_type = std::decay_t<Func>;
+		static_assert(sizeof(functor_type) <= Job::STORAGE_SIZE, "Job functor is too big, capture by reference or pointer instead");
+		static_assert(alignof(functor_type) <= 16, "Job functor is overaligned");
+		static_assert(std::is_invocable_v<functor_type&, uint32_t>, "Job functor should be invocable as void(uint32_t threadIndex)");
+
+		// Jobs are moved between deques by a bitwise copy and never destroyed
+		static_assert(std::is_trivially_copyable_v<functor_type>, "Job functor should be trivially copyable, capture by reference or pointer instead");
+
+		Job job;
+		job.counter = &counter;
+		job.invoke = [](void* storage, uint32_t threadIndex)
+		{
+			functor_type* f = std::launder(reinterpret_cast<functor_type*>(storage));
+			(*f)(threadIndex);
+		};
+		new (job.storage) functor_type(std::forward<Func>(func));
+
+		counter.m_value.fetch_add(1, std::memory_order_relaxed);
+		push(job);
+	}
+
+	template<typename Func>
+	void JobSystem::dispatch(JobCounter& counter, uint32_t numTasks, uint32_t tasksPerBatch, const Func& func) noexcept
+	{
+		if (numTasks == 0)
+			return;
+
+		ENGI_ASSERT(tasksPerBatch > 0);
+
+		const Func* f = &func;
+		uint32_t numBatches = (numTasks + tasksPerBatch - 1) / tasksPerBatch;
+		for (uint32_t batchIndex = 0; batchIndex < numBatches; ++batchIndex)
+		{
+			uint32_t begin = batchIndex * tasksPerBatch;
+			uint32_t end = begin + tasksPerBatch;
+			if (end > numTasks)
+				end = numTasks;
+
+			this->schedule(counter, [f, begin, end](uint32_t threadIndex)
+				{
+					for (uint32_t taskIndex = begin; taskIndex < end; ++taskIndex)
+						(*f)(threadIndex, taskIndex);
+				});
+		}
+	}
+
+}; // engi namespace
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+namespace engi
+{
+
+	// Read-only memory mapping of a whole file. Pages are loaded by the OS on first access, thus opening is cheap
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		~MappedFile();
+
+		bool open(const std::filesystem::path& filepath) noexcept;
+		void close() noexcept;
+
+		inline constexpr bool isOpen() const noexcept { return m_data != nullptr; }
+		inline constexpr const uint8_t* getData() const noexcept { return m_data; }
+		inline constexpr uint64_t getSize() const noexcept { return m_size; }
+
+	private:
+		void* m_file = nullptr;
+		void* m_mapping = nullptr;
+		const uint8_t* m_data = nullptr;
+		uint64_t m_size = 0;
+	};
+
+}; // engi namespace
@@ -0,0 +1,295 @@
+#include "Utility/OffsetAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include "Core/CommonDefinitions.h"
+
+namespace engi
+{
+
+	namespace
+	{
+		static constexpr uint32_t LEAF_BITS = 3;
+		static constexpr uint32_t LEAF_MASK = (1 << LEAF_BITS) - 1;
+
+		// Bins are a tiny float of the size: exponent selects the top bin and 3 bits of mantissa select the leaf bin.
+		// Sizes below 8 are stored exactly
+		uint32_t getBinRoundDown(uint32_t size) noexcept
+		{
+			if (size <= LEAF_MASK)
+				return size;
+
+			uint32_t highestBit = 31 - std::countl_zero(size);
+			uint32_t mantissaStart = highestBit - LEAF_BITS;
+			uint32_t exponent = mantissaStart + 1;
+			uint32_t mantissa = (size >> mantissaStart) & LEAF_MASK;
+			return (exponent << LEAF_BITS) | mantissa;
+		}
+
+		// Every range in the returned bin (and above) is at least size units
+		uint32_t getBinRoundUp(uint32_t size) noexcept
+		{
+			if (size <= LEAF_MASK)
+				return size;
+
+			uint32_t highestBit = 31 - std::countl_zero(size);
+			uint32_t mantissaStart = highestBit - LEAF_BITS;
+			uint32_t bin = getBinRoundDown(size);
+			uint32_t lowBits = (1u << mantissaStart) - 1;
+			return (size & lowBits) ? bin + 1 : bin;
+		}
+
+		// Returns index of the lowest set bit at or above startBit, 32 if there is none
+		uint32_t findLowestSetBitAfter(uint32_t mask, uint32_t startBit) noexcept
+		{
+			if (startBit >= 32)
+				return 32;
+
+			return std::countr_zero(mask & (~0u << startBit));
+		}
+	}
+
+	OffsetAllocator::OffsetAllocator(uint32_t capacity) noexcept
+	{
+		reset(capacity);
+	}
+
+	void OffsetAllocator::reset(uint32_t capacity) noexcept
+	{
+		m_capacity = capacity;
+		m_numFreeUnits = 0;
+		m_numAllocations = 0;
+		m_lastNode = INVALID_NODE;
+		m_topBinMask = 0;
+		m_leafBinMasks.fill(0);
+		m_binHeads.fill(INVALID_NODE);
+		m_nodes.clear();
+		m_freeNodes.clear();
+
+		if (capacity == 0)
+			return;
+
+		m_lastNode = createNode(0, capacity);
+		insertFreeNode(m_lastNode);
+	}
+
+	OffsetAllocator::Allocation OffsetAllocator::allocate(uint32_t size) noexcept
+	{
+		if (size == 0 || size > m_numFreeUnits)
+			return Allocation{};
+
+		uint32_t minBin = getBinRoundUp(size);
+		uint32_t nodeIndex = findFreeNode(minBin);
+		if (nodeIndex == INVALID_NODE)
+		{
+			// Bin of the size itself is skipped by the search, as some of its ranges are smaller than the size.
+			// Others may still fit though, which matters when the arena is nearly full
+			for (nodeIndex = m_binHeads[getBinRoundDown(size)]; nodeIndex != INVALID_NODE; nodeIndex = m_nodes[nodeIndex].binNext)
+			{
+				if (m_nodes[nodeIndex].size >= size)
+					break;
+			}
+
+			if (nodeIndex == INVALID_NODE)
+				return Allocation{};
+		}
+
+		ENGI_ASSERT(m_nodes[nodeIndex].size >= size && "Bin masks are out of sync with the bins");
+		removeFreeNode(nodeIndex);
+
+		// Remainder goes back to the free bins as a new neighbour right after the allocated range
+		uint32_t remainder = m_nodes[nodeIndex].size - size;
+		if (remainder > 0)
+		{
+			uint32_t remainderIndex = createNode(m_nodes[nodeIndex].offset + size, remainder);
+			Node& node = m_nodes[nodeIndex];
+			Node& remainderNode = m_nodes[remainderIndex];
+			node.size = size;
+			remainderNode.neighborPrev = nodeIndex;
+			remainderNode.neighborNext = node.neighborNext;
+			if (node.neighborNext != INVALID_NODE)
+				m_nodes[node.neighborNext].neighborPrev = remainderIndex;
+			else m_lastNode = remainderIndex;
+			node.neighborNext = remainderIndex;
+			insertFreeNode(remainderIndex);
+		}
+
+		Node& node = m_nodes[nodeIndex];
+		node.isUsed = true;
+		++m_numAllocations;
+		return Allocation{ node.offset, node.size, nodeIndex };
+	}
+
+	void OffsetAllocator::free(const Allocation& allocation) noexcept
+	{
+		if (!allocation.isValid())
+			return;
+
+		uint32_t nodeIndex = allocation.node;
+		ENGI_ASSERT(nodeIndex < m_nodes.size() && m_nodes[nodeIndex].isUsed && "Allocation was already freed or belongs to another allocator");
+		ENGI_ASSERT(m_nodes[nodeIndex].offset == allocation.offset && "Allocation is stale");
+
+		m_nodes[nodeIndex].isUsed = false;
+		--m_numAllocations;
+
+		uint32_t prevIndex = m_nodes[nodeIndex].neighborPrev;
+		if (prevIndex != INVALID_NODE && !m_nodes[prevIndex].isUsed)
+		{
+			removeFreeNode(prevIndex);
+			Node& prev = m_nodes[prevIndex];
+			Node& node = m_nodes[nodeIndex];
+			node.offset = prev.offset;
+			node.size += prev.size;
+			node.neighborPrev = prev.neighborPrev;
+			if (prev.neighborPrev != INVALID_NODE)
+				m_nodes[prev.neighborPrev].neighborNext = nodeIndex;
+			destroyNode(prevIndex);
+		}
+
+		uint32_t nextIndex = m_nodes[nodeIndex].neighborNext;
+		if (nextIndex != INVALID_NODE && !m_nodes[nextIndex].isUsed)
+		{
+			removeFreeNode(nextIndex);
+			Node& next = m_nodes[nextIndex];
+			Node& node = m_nodes[nodeIndex];
+			node.size += next.size;
+			node.neighborNext = next.neighborNext;
+			if (next.neighborNext != INVALID_NODE)
+				m_nodes[next.neighborNext].neighborPrev = nodeIndex;
+			else m_lastNode = nodeIndex;
+			destroyNode(nextIndex);
+		}
+
+		insertFreeNode(nodeIndex);
+	}
+
+	void OffsetAllocator::grow(uint32_t newCapacity) noexcept
+	{
+		if (newCapacity <= m_capacity)
+			return;
+
+		uint32_t extraUnits = newCapacity - m_capacity;
+		if (m_lastNode != INVALID_NODE && !m_nodes[m_lastNode].isUsed)
+		{
+			removeFreeNode(m_lastNode);
+			m_nodes[m_lastNode].size += extraUnits;
+			insertFreeNode(m_lastNode);
+		}
+		else
+		{
+			uint32_t nodeIndex = createNode(m_capacity, extraUnits);
+			m_nodes[nodeIndex].neighborPrev = m_lastNode;
+			if (m_lastNode != INVALID_NODE)
+				m_nodes[m_lastNode].neighborNext = nodeIndex;
+			m_lastNode = nodeIndex;
+			insertFreeNode(nodeIndex);
+		}
+
+		m_capacity = newCapacity;
+	}
+
+	uint32_t OffsetAllocator::getLargestFreeRange() const noexcept
+	{
+		if (m_topBinMask == 0)
+			return 0;
+
+		// Only the highest bin has to be scanned, as bins are ordered by size
+		uint32_t topBin = 31 - std::countl_zero(m_topBinMask);
+		uint32_t leafBin = 31 - std::countl_zero(static_cast<uint32_t>(m_leafBinMasks[topBin]));
+		uint32_t largest = 0;
+		for (uint32_t nodeIndex = m_binHeads[(topBin << LEAF_BITS) | leafBin]; nodeIndex != INVALID_NODE; nodeIndex = m_nodes[nodeIndex].binNext)
+			largest = std::max(largest, m_nodes[nodeIndex].size);
+
+		return largest;
+	}
+
+	uint32_t OffsetAllocator::findFreeNode(uint32_t minBin) const noexcept
+	{
+		if (minBin >= NUM_BINS)
+			return INVALID_NODE;
+
+		uint32_t topBin = minBin >> LEAF_BITS;
+		uint32_t leafBin = findLowestSetBitAfter(m_leafBinMasks[topBin], minBin & LEAF_MASK);
+		if (leafBin >= NUM_LEAF_BINS)
+		{
+			topBin = findLowestSetBitAfter(m_topBinMask, topBin + 1);
+			if (topBin >= NUM_TOP_BINS)
+				return INVALID_NODE;
+
+			leafBin = std::countr_zero(static_cast<uint32_t>(m_leafBinMasks[topBin]));
+		}
+
+		return m_binHeads[(topBin << LEAF_BITS) | leafBin];
+	}
+
+	uint32_t OffsetAllocator::createNode(uint32_t offset, uint32_t size) noexcept
+	{
+		uint32_t nodeIndex;
+		if (!m_freeNodes.empty())
+		{
+			nodeIndex = m_freeNodes.back();
+			m_freeNodes.pop_back();
+		}
+		else
+		{
+			nodeIndex = static_cast<uint32_t>(m_nodes.size());
+			m_nodes.emplace_back();
+		}
+
+		Node& node = m_nodes[nodeIndex];
+		node = Node{};
+		node.offset = offset;
+		node.size = size;
+		return nodeIndex;
+	}
+
+	void OffsetAllocator::destroyNode(uint32_t node) noexcept
+	{
+		m_nodes[node] = Node{};
+		m_freeNodes.push_back(node);
+	}
+
+	void OffsetAllocator::insertFreeNode(uint32_t nodeIndex) noexcept
+	{
+		Node& node = m_nodes[nodeIndex];
+		uint32_t bin = getBinRoundDown(node.size);
+		uint32_t topBin = bin >> LEAF_BITS;
+		uint32_t leafBin = bin & LEAF_MASK;
+
+		node.binPrev = INVALID_NODE;
+		node.binNext = m_binHeads[bin];
+		if (node.binNext != INVALID_NODE)
+			m_nodes[node.binNext].binPrev = nodeIndex;
+		m_binHeads[bin] = nodeIndex;
+
+		m_leafBinMasks[topBin] |= static_cast<uint8_t>(1 << leafBin);
+		m_topBinMask |= 1u << topBin;
+		m_numFreeUnits += node.size;
+	}
+
+	void OffsetAllocator::removeFreeNode(uint32_t nodeIndex) noexcept
+	{
+		Node& node = m_nodes[nodeIndex];
+		uint32_t bin = getBinRoundDown(node.size);
+
+		if (node.binPrev != INVALID_NODE)
+			m_nodes[node.binPrev].binNext = node.binNext;
+		else m_binHeads[bin] = node.binNext;
+
+		if (node.binNext != INVALID_NODE)
+			m_nodes[node.binNext].binPrev = node.binPrev;
+
+		if (m_binHeads[bin] == INVALID_NODE)
+		{
+			uint32_t topBin = bin >> LEAF_BITS;
+			m_leafBinMasks[topBin] &= static_cast<uint8_t>(~(1 << (bin & LEAF_MASK)));
+			if (m_leafBinMasks[topBin] == 0)
+				m_topBinMask &= ~(1u << topBin);
+		}
+
+		node.binPrev = INVALID_NODE;
+		node.binNext = INVALID_NODE;
+		m_numFreeUnits -= node.size;
+	}
+
+}; // engi namespace
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace engi
+{
+
+	// Two-level segregated fit (TLSF) allocator of ranges in [0, capacity). It does not own any memory, only hands out offsets,
+	// thus the same allocator manages units of any buffer (vertices, indices, bytes). Free ranges are kept in 240 bins, 8 linearly
+	// spaced bins per power of two, and found with two bit scans. Freed ranges are merged with their free neighbours immediately.
+	// Both allocation and freeing are O(1), unless the only fitting ranges share the bin with smaller ones
+	class OffsetAllocator
+	{
+	public:
+		static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+		static constexpr uint32_t NUM_LEAF_BINS = 8;
+		static constexpr uint32_t NUM_TOP_BINS = 30;
+		static constexpr uint32_t NUM_BINS = NUM_TOP_BINS * NUM_LEAF_BINS;
+
+		struct Allocation
+		{
+			inline constexpr bool isValid() const noexcept { return node != INVALID_NODE; }
+
+			uint32_t offset = 0;
+			uint32_t size = 0;
+			uint32_t node = INVALID_NODE;
+		};
+
+		explicit OffsetAllocator(uint32_t capacity = 0) noexcept;
+		OffsetAllocator(const OffsetAllocator&) = default;
+		OffsetAllocator& operator=(const OffsetAllocator&) = default;
+		~OffsetAllocator() = default;
+
+		// Drops every allocation
+		void reset(uint32_t capacity) noexcept;
+
+		// Returns invalid allocation if there is no free range of the requested size
+		Allocation allocate(uint32_t size) noexcept;
+		void free(const Allocation& allocation) noexcept;
+
+		// Appends free space to the end of the range, existing allocations are kept
+		void grow(uint32_t newCapacity) noexcept;
+
+		inline constexpr uint32_t getCapacity() const noexcept { return m_capacity; }
+		inline constexpr uint32_t getNumFreeUnits() const noexcept { return m_numFreeUnits; }
+		inline constexpr uint32_t getNumAllocations() const noexcept { return m_numAllocations; }
+		uint32_t getLargestFreeRange() const noexcept;
+
+	private:
+		struct Node
+		{
+			uint32_t offset = 0;
+			uint32_t size = 0;
+			uint32_t binPrev = INVALID_NODE;
+			uint32_t binNext = INVALID_NODE;
+			uint32_t neighborPrev = INVALID_NODE;
+			uint32_t neighborNext = INVALID_NODE;
+			bool isUsed = false;
+		};
+
+		// Returns the first free node in the lowest non-empty bin at or above minBin
+		uint32_t findFreeNode(uint32_t minBin) const noexcept;
+		uint32_t createNode(uint32_t offset, uint32_t size) noexcept;
+		void destroyNode(uint32_t node) noexcept;
+		void insertFreeNode(uint32_t node) noexcept;
+		void removeFreeNode(uint32_t node) noexcept;
+
+		uint32_t m_capacity = 0;
+		uint32_t m_numFreeUnits = 0;
+		uint32_t m_numAllocations = 0;
+		uint32_t m_lastNode = INVALID_NODE; // node at the end of the range, grow() extends it
+		uint32_t m_topBinMask = 0;
+		std::array<uint8_t, NUM_TOP_BINS> m_leafBinMasks{};
+		std::array<uint32_t, NUM_BINS> m_binHeads{};
+		std::vector<Node> m_nodes;
+		std::vector<uint32_t> m_freeNodes;
+	};
+
+}; // engi namespace
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+
+#include "Core/CommonDefinitions.h"
+#include "Utility/ArrayView.h"
+#include "Utility/JobSystem.h"
+
+// Header-only data-parallel primitives on top of the JobSystem. Functors are taken by reference and inlined into the job body,
+// there is no type erasure per element. All of the functions block until the work is finished
+
+namespace engi
+{
+
+	namespace detail
+	{
+
+		// Desired duration of a single chunk. Smaller chunks balance better, bigger ones amortize the scheduling overhead
+		static constexpr int64_t PARALLEL_TARGET_CHUNK_NANOSECONDS = 50'000;
+
+		// Number of elements that are executed serially by the caller to estimate the cost of a single element
+		static constexpr uint32_t PARALLEL_PROBE_SIZE = 32;
+
+		// Reduction uses a chunking that only depends on the number of elements, so that the order of operations
+		// and thus the result (even for floating-point types) is the same on every machine and every run
+		static constexpr uint32_t PARALLEL_REDUCE_MIN_GRAIN = 1024;
+		static constexpr uint32_t PARALLEL_REDUCE_MAX_CHUNKS = 256;
+
+		static constexpr uint32_t PARALLEL_SORT_MIN_SIZE = 8192;
+
+		template<typename Func>
+		void executeChunks(uint32_t begin, uint32_t end, uint32_t grain, const Func& func) noexcept
+		{
+			// func is invoked as void(uint32_t chunkBegin, uint32_t chunkEnd)
+			JobSystem& jobSystem = JobSystem::get();
+			JobCounter counter;
+
+			const Func* f = &func;
+			for (uint32_t chunkBegin = begin; chunkBegin < end; chunkBegin += grain)
+			{
+				uint32_t chunkEnd = (end - chunkBegin > grain) ? chunkBegin + grain : end;
+				jobSystem.schedule(counter, [f, chunkBegin, chunkEnd](uint32_t) { (*f)(chunkBegin, chunkEnd); });
+			}
+			jobSystem.wait(counter);
+		}
+
+	}; // detail namespace
+
+	// Invokes func(uint32_t index) for every index in [begin, end).
+	// The grain is picked adaptively: a few elements are executed on the calling thread first to measure the cost of one element
+	template<typename Func>
+	void parallelFor(uint32_t begin, uint32_t end, const Func& func) noexcept
+	{
+		using clock = std::chrono::steady_clock;
+
+		if (begin >= end)
+			return;
+
+		uint32_t probeEnd = (end - begin > detail::PARALLEL_PROBE_SIZE) ? begin + detail::PARALLEL_PROBE_SIZE : end;
+		clock::time_point probeBegin = clock::now();
+		for (uint32_t i = begin; i < probeEnd; ++i)
+			func(i);
+
+		if (probeEnd == end)
+			return;
+
+		int64_t probeTime = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - probeBegin).count();
+		int64_t elementTime = probeTime / (probeEnd - begin);
+		if (elementTime < 1)
+			elementTime = 1;
+
+		uint32_t numRemaining = end - probeEnd;
+		int64_t grain = detail::PARALLEL_TARGET_CHUNK_NANOSECONDS / elementTime;
+		if (grain < 1)
+			grain = 1;
+
+		// Whole range is cheaper than a single chunk, it is not worth to be split
+		if (grain >= numRemaining || JobSystem::get().numThreads() == 1)
+		{
+			for (uint32_t i = probeEnd; i < end; ++i)
+				func(i);
+			return;
+		}
+
+		detail::executeChunks(probeEnd, end, static_cast<uint32_t>(grain), [&func](uint32_t chunkBegin, uint32_t chunkEnd)
+			{
+				for (uint32_t i = chunkBegin; i < chunkEnd; ++i)
+					func(i);
+			});
+	}
+
+	// Reduces transform(uint32_t index) over [begin, end) with reduce(T, T), starting from identity.
+	// The result is deterministic: partial results are always combined in the same order, regardless of the number of threads
+	template<typename T, typename TransformFunc, typename ReduceFunc>
+	T parallelReduce(uint32_t begin, uint32_t end, const T& identity, const TransformFunc& transform, const ReduceFunc& reduce) noexcept
+	{
+		if (begin >= end)
+			return identity;
+
+		uint32_t numElements = end - begin;
+		uint32_t grain = (numElements + detail::PARALLEL_REDUCE_MAX_CHUNKS - 1) / detail::PARALLEL_REDUCE_MAX_CHUNKS;
+		if (grain < detail::PARALLEL_REDUCE_MIN_GRAIN)
+			grain = detail::PARALLEL_REDUCE_MIN_GRAIN;
+
+		uint32_t numChunks = (numElements + grain - 1) / grain;
+		std::vector<T> partials(numChunks, identity);
+
+		auto reduceChunk = [&](uint32_t chunkBegin, uint32_t chunkEnd)
+		{
+			T& partial = partials[(chunkBegin - begin) / grain];
+			for (uint32_t i = chunkBegin; i < chunkEnd; ++i)
+				partial = reduce(partial, transform(i));
+		};
+
+		if (numChunks == 1 || JobSystem::get().numThreads() == 1)
+		{
+			for (uint32_t chunkBegin = begin; chunkBegin < end; chunkBegin += grain)
+				reduceChunk(chunkBegin, (end - chunkBegin > grain) ? chunkBegin + grain : end);
+		}
+		else
+		{
+			detail::executeChunks(begin, end, grain, reduceChunk);
+		}
+
+		T result = identity;
+		for (const T& partial : partials)
+			result = reduce(result, partial);
+
+		return result;
+	}
+
+	// Sorts chunks in parallel and then merges them pairwise, every merge round is executed in parallel as well
+	template<typename T, typename Compare = std::less<>>
+	void parallelSort(ArrayView<T> data, const Compare& compare = Compare()) noexcept
+	{
+		uint32_t numElements = static_cast<uint32_t>(data.size());
+		uint32_t numThreads = JobSystem::get().numThreads();
+		if (numElements < detail::PARALLEL_SORT_MIN_SIZE || numThreads == 1)
+		{
+			std::sort(data.begin(), data.end(), compare);
+			return;
+		}
+
+		// Power-of-two number of runs, around two per thread
+		uint32_t numRuns = 1;
+		while (numRuns < numThreads * 2 && numElements / (numRuns * 2) >= detail::PARALLEL_SORT_MIN_SIZE / 2)
+			numRuns *= 2;
+
+		uint32_t runSize = (numElements + numRuns - 1) / numRuns;
+		auto runBounds = [numElements](uint32_t first, uint32_t size) -> uint32_t
+		{
+			return (numElements - first > size) ? first + size : numElements;
+		};
+
+		detail::executeChunks(0, numElements, runSize, [&](uint32_t runBegin, uint32_t runEnd)
+			{
+				std::sort(data.begin() + runBegin, data.begin() + runEnd, compare);
+			});
+
+		std::vector<T> scratch(data.begin(), data.end());
+		bool resultInScratch = false;
+
+		// Every round merges adjacent pairs of sorted runs into runs of double size
+		for (uint32_t width = runSize; width < numElements; width *= 2)
+		{
+			T* from = resultInScratch ? scratch.data() : data.data();
+			T* to = resultInScratch ? data.data() : scratch.data();
+
+			detail::executeChunks(0, numElements, width * 2, [&, from, to, width](uint32_t mergeBegin, uint32_t mergeEnd)
+				{
+					uint32_t middle = runBounds(mergeBegin, width);
+					if (middle > mergeEnd)
+						middle = mergeEnd;
+
+					std::merge(from + mergeBegin, from + middle, from + middle, from + mergeEnd, to + mergeBegin, compare);
+				});
+
+			resultInScratch = !resultInScratch;
+		}
+
+		if (resultInScratch)
+			std::copy(scratch.begin(), scratch.end(), data.begin());
+	}
+
+}; // engi namespace
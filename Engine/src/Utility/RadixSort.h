@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace engi
+{
+
+	// Stable LSD radix sort of values by 64-bit keys, 8 bits per pass. Passes in which every key has the same digit are skipped,
+	// thus keys that only use their low bits are sorted in fewer passes. Scratch is resized as needed and might be reused between calls
+	template<typename T, typename KeyFunc>
+	void radixSort(std::vector<T>& values, std::vector<T>& scratch, KeyFunc&& getKey) noexcept
+	{
+		static constexpr uint32_t NUM_PASSES = sizeof(uint64_t);
+
+		uint32_t numValues = static_cast<uint32_t>(values.size());
+		if (numValues < 2)
+			return;
+
+		std::array<std::array<uint32_t, 256>, NUM_PASSES> histograms{};
+		for (const T& value : values)
+		{
+			uint64_t key = getKey(value);
+			for (uint32_t pass = 0; pass < NUM_PASSES; ++pass)
+				++histograms[pass][(key >> (pass * 8)) & 0xff];
+		}
+
+		scratch.resize(numValues);
+		for (uint32_t pass = 0; pass < NUM_PASSES; ++pass)
+		{
+			std::array<uint32_t, 256>& histogram = histograms[pass];
+			uint32_t shift = pass * 8;
+			if (histogram[(getKey(values[0]) >> shift) & 0xff] == numValues)
+				continue;
+
+			uint32_t offset = 0;
+			for (uint32_t& count : histogram)
+			{
+				uint32_t bucketSize = count;
+				count = offset;
+				offset += bucketSize;
+			}
+
+			for (T& value : values)
+				scratch[histogram[(getKey(value) >> shift) & 0xff]++] = std::move(value);
+
+			values.swap(scratch);
+		}
+	}
+
+}; // engi namespace
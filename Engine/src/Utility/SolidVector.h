@@ -33,6 +33,7 @@ namespace engi
         IdType insert(T&& value) noexcept;
         void erase(IdType id) noexcept;
         void clear() noexcept;
+        void reserve(uint32_t capacity) noexcept;
 
         constexpr auto begin() noexcept { return m_data.begin(); }
         constexpr auto end() noexcept { return m_data.end(); }
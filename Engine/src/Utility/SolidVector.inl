@@ -144,4 +144,13 @@ namespace engi
 		m_nextId = 0;
 	}
 
+	template<typename T>
+	inline void SolidVector<T>::reserve(uint32_t capacity) noexcept
+	{
+		m_data.reserve(capacity);
+		m_forwardMap.reserve(capacity);
+		m_backwardMap.reserve(capacity);
+		m_occupied.reserve(capacity);
+	}
+
 }; // engi namespace
\ No newline at end of file
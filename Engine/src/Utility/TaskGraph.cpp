@@ -0,0 +1,135 @@
+#include "Utility/TaskGraph.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "Core/CommonDefinitions.h"
+
+namespace engi
+{
+
+	TaskGraph::TaskGraph()
+	{
+		this->clear();
+	}
+
+	uint32_t TaskGraph::addTask(const std::string& name, resource_mask reads, resource_mask writes, const task_func_type& func) noexcept
+	{
+		ENGI_ASSERT(func && "Task function should not be empty");
+
+		uint32_t taskIndex = this->getNumTasks();
+		Task& task = m_tasks.emplace_back();
+		task.name = name;
+		task.reads = reads;
+		task.writes = writes;
+		task.func = func;
+
+		for (uint32_t resource = 0; resource < MAX_RESOURCES; ++resource)
+		{
+			resource_mask bit = resource_mask(1) << resource;
+			if (!((reads | writes) & bit))
+				continue;
+
+			// Read-after-write and write-after-write
+			if (m_lastWriter[resource] != uint32_t(-1))
+				task.dependencies.push_back(m_lastWriter[resource]);
+
+			if (writes & bit)
+			{
+				// Write-after-read
+				std::vector<uint32_t>& readers = m_readersSinceWrite[resource];
+				task.dependencies.insert(task.dependencies.end(), readers.begin(), readers.end());
+				readers.clear();
+				m_lastWriter[resource] = taskIndex;
+			}
+			else
+			{
+				m_readersSinceWrite[resource].push_back(taskIndex);
+			}
+		}
+
+		std::ranges::sort(task.dependencies);
+		auto [first, last] = std::ranges::unique(task.dependencies);
+		task.dependencies.erase(first, last);
+
+		for (uint32_t dependency : task.dependencies)
+			m_tasks[dependency].successors.push_back(taskIndex);
+
+		// Counters are reallocated lazily on the next execution
+		m_remainingDependencies.reset();
+		return taskIndex;
+	}
+
+	void TaskGraph::clear() noexcept
+	{
+		ENGI_ASSERT(m_counter.isDone() && "Cannot clear the graph during the execution");
+
+		m_tasks.clear();
+		m_remainingDependencies.reset();
+		for (uint32_t resource = 0; resource < MAX_RESOURCES; ++resource)
+		{
+			m_lastWriter[resource] = uint32_t(-1);
+			m_readersSinceWrite[resource].clear();
+		}
+
+		m_criticalPathTime = 0.0f;
+		m_totalTime = 0.0f;
+	}
+
+	void TaskGraph::execute() noexcept
+	{
+		uint32_t numTasks = this->getNumTasks();
+		if (numTasks == 0)
+			return;
+
+		if (!m_remainingDependencies)
+			m_remainingDependencies.reset(new std::atomic<uint32_t>[numTasks]);
+
+		for (uint32_t i = 0; i < numTasks; ++i)
+			m_remainingDependencies[i].store(static_cast<uint32_t>(m_tasks[i].dependencies.size()), std::memory_order_relaxed);
+
+		JobSystem& jobSystem = JobSystem::get();
+		for (uint32_t i = 0; i < numTasks; ++i)
+		{
+			if (!m_tasks[i].dependencies.empty())
+				continue;
+
+			jobSystem.schedule(m_counter, [this, i](uint32_t) { this->runTask(i); });
+		}
+		jobSystem.wait(m_counter);
+
+		// Tasks are topologically sorted by construction, thus a single forward pass is enough
+		std::vector<float> finishTimes(numTasks, 0.0f);
+		m_criticalPathTime = 0.0f;
+		m_totalTime = 0.0f;
+		for (uint32_t i = 0; i < numTasks; ++i)
+		{
+			const Task& task = m_tasks[i];
+			float startTime = 0.0f;
+			for (uint32_t dependency : task.dependencies)
+				startTime = std::max(startTime, finishTimes[dependency]);
+
+			finishTimes[i] = startTime + task.time;
+			m_criticalPathTime = std::max(m_criticalPathTime, finishTimes[i]);
+			m_totalTime += task.time;
+		}
+	}
+
+	void TaskGraph::runTask(uint32_t taskIndex) noexcept
+	{
+		using clock = std::chrono::steady_clock;
+
+		Task& task = m_tasks[taskIndex];
+		clock::time_point begin = clock::now();
+		task.func();
+		task.time = std::chrono::duration_cast<std::chrono::duration<float>>(clock::now() - begin).count();
+
+		JobSystem& jobSystem = JobSystem::get();
+		for (uint32_t successor : task.successors)
+		{
+			if (m_remainingDependencies[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+				jobSystem.schedule(m_counter, [this, successor](uint32_t) { this->runTask(successor); });
+		}
+	}
+
+}; // engi namespace
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <functional>
+
+#include "Utility/Memory.h"
+#include "Utility/JobSystem.h"
+
+namespace engi
+{
+
+	// Declarative graph of coarse tasks. Each task declares a mask of resources it reads and writes, dependencies are derived
+	// from the order of insertion: a task waits for the previous writer of everything it touches and, if it writes, for all readers since then.
+	// Independent tasks are executed concurrently on the JobSystem
+	class TaskGraph
+	{
+	public:
+		using resource_mask = uint64_t;
+		using task_func_type = std::function<void()>;
+
+		static constexpr uint32_t MAX_RESOURCES = 64;
+
+		TaskGraph();
+		TaskGraph(const TaskGraph&) = delete;
+		TaskGraph& operator=(const TaskGraph&) = delete;
+
+		uint32_t addTask(const std::string& name, resource_mask reads, resource_mask writes, const task_func_type& func) noexcept;
+		void clear() noexcept;
+
+		// Executes the whole graph and blocks the caller until every task is finished. The caller participates in the execution
+		void execute() noexcept;
+
+		inline uint32_t getNumTasks() const noexcept { return static_cast<uint32_t>(m_tasks.size()); }
+		inline const std::string& getTaskName(uint32_t taskIndex) const noexcept { return m_tasks[taskIndex].name; }
+		inline float getTaskTime(uint32_t taskIndex) const noexcept { return m_tasks[taskIndex].time; }
+		inline const std::vector<uint32_t>& getTaskDependencies(uint32_t taskIndex) const noexcept { return m_tasks[taskIndex].dependencies; }
+
+		// Longest chain of dependent tasks of the last execution, in seconds
+		inline float getCriticalPathTime() const noexcept { return m_criticalPathTime; }
+
+		// Sum of all task times of the last execution, in seconds
+		inline float getTotalTime() const noexcept { return m_totalTime; }
+
+	private:
+		struct Task
+		{
+			std::string name;
+			resource_mask reads = 0;
+			resource_mask writes = 0;
+			task_func_type func;
+			std::vector<uint32_t> dependencies;
+			std::vector<uint32_t> successors;
+			float time = 0.0f;
+		};
+
+		void runTask(uint32_t taskIndex) noexcept;
+
+		std::vector<Task> m_tasks;
+		UniqueHandle<std::atomic<uint32_t>[]> m_remainingDependencies;
+		JobCounter m_counter;
+
+		uint32_t m_lastWriter[MAX_RESOURCES];
+		std::vector<uint32_t> m_readersSinceWrite[MAX_RESOURCES];
+
+		float m_criticalPathTime = 0.0f;
+		float m_totalTime = 0.0f;
+	};
+
+}; // engi namespace
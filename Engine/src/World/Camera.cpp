@@ -144,6 +144,8 @@ namespace engi
 		fc.pixelHeight = fc.nearTopLeftDir.length() / m_projComp.height;
 		fc.nearBottomRightDir.normalize();
 		fc.nearTopLeftDir.normalize();
+
+		updateFrustum();
 	}
 
 	void Camera::updateProjection()
@@ -160,6 +162,13 @@ namespace engi
 
 		Mat4x4 shadowProj = m_shadowProjComp.getLHReversedDepthProjection();
 		m_shadowProjInv = shadowProj.inverse();
+
+		updateFrustum();
+	}
+
+	void Camera::updateFrustum()
+	{
+		m_frustum = Frustum::fromMatrix(m_view * m_proj);
 	}
 
 	Ray Camera::castRay(const Vec2& windowPos) const
@@ -77,9 +77,12 @@ namespace engi
 		math::Vec3 getPosition() const;
 		math::Vec3 getDirection() const;
 		const FrustumComponent& getFrustumComponent() const noexcept { return m_frustumComp; }
+		const math::Frustum& getFrustum() const noexcept { return m_frustum; }
 		std::array<math::Vec3, 8> getShadowFrustumCorners() const noexcept;
 
 	private:
+		void updateFrustum();
+
 		bool m_updatedBasis = false;
 		bool m_updatedProj = false;
 		math::Mat4x4 m_view;
@@ -92,6 +95,7 @@ namespace engi
 		ProjectionComponent m_projComp;
 		ProjectionComponent m_shadowProjComp;
 		FrustumComponent m_frustumComp;
+		math::Frustum m_frustum; // world-space planes of the view frustum
 	}; // EulersCamera class
 
 }; // engi namespace
\ No newline at end of file
@@ -18,7 +18,7 @@ namespace engi
 		this->normalMap = texture;
 	}
 
-	void DecalInstance::setParentInstance(InstanceTable* instanceTable, uint32_t parentInstanceID) noexcept
+	void DecalInstance::setParentInstance(const InstanceTable* instanceTable, uint32_t parentInstanceID) noexcept
 	{
 		ENGI_ASSERT(instanceTable && "Provided instnace table cannot be nullptr");
 		ENGI_ASSERT(parentInstanceID != uint32_t(-1) && instanceTable->isOccupied(parentInstanceID) && "Wrong instance ID is provided for a decal");
@@ -31,7 +31,7 @@ namespace engi
 		ENGI_ASSERT(this->instanceTable && "Instance table is needed in order to set local space transform from world space transform");
 		ENGI_ASSERT(this->parentInstanceID != uint32_t(-1) && this->instanceTable->isOccupied(parentInstanceID) && "Wrong instance ID is provided for a decal instance");
 
-		InstanceData& instanceData = this->instanceTable->getInstanceData(this->parentInstanceID);
+		const InstanceData& instanceData = this->instanceTable->getInstanceData(this->parentInstanceID);
 		math::Mat4x4 decalToInstance = decalToWorld * instanceData.worldToModel;
 
 		this->decalToInstance = decalToInstance;
@@ -43,7 +43,7 @@ namespace engi
 		ENGI_ASSERT(this->instanceTable && "Instance table is needed in order to set local space transform from world space transform");
 		ENGI_ASSERT(this->parentInstanceID != uint32_t(-1) && this->instanceTable->isOccupied(parentInstanceID) && "Wrong instance ID is provided for a decal instance");
 
-		InstanceData& instanceData = this->instanceTable->getInstanceData(this->parentInstanceID);
+		const InstanceData& instanceData = this->instanceTable->getInstanceData(this->parentInstanceID);
 		return instanceData.worldToModel * this->instanceToDecal;
 	}
 
@@ -52,7 +52,7 @@ namespace engi
 		ENGI_ASSERT(this->instanceTable && "Instance table is needed in order to set local space transform from world space transform");
 		ENGI_ASSERT(this->parentInstanceID != uint32_t(-1) && this->instanceTable->isOccupied(parentInstanceID) && "Wrong instance ID is provided for a decal instance");
 
-		InstanceData& instanceData = this->instanceTable->getInstanceData(this->parentInstanceID);
+		const InstanceData& instanceData = this->instanceTable->getInstanceData(this->parentInstanceID);
 		return this->decalToInstance * instanceData.modelToWorld;
 	}
 
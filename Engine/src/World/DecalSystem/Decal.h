@@ -17,7 +17,7 @@ namespace engi
 		inline constexpr bool isValid() const noexcept { return normalMap && instanceTable && parentInstanceID != uint32_t(-1); }
 
 		void setNormalMap(Texture2D* texture) noexcept;
-		void setParentInstance(InstanceTable* instanceTable, uint32_t parentInstanceID) noexcept;
+		void setParentInstance(const InstanceTable* instanceTable, uint32_t parentInstanceID) noexcept;
 		void setLocalSpaceTransform(const math::Mat4x4& decalToWorld) noexcept;
 
 		math::Mat4x4 getWorldToDecal() const noexcept;
@@ -30,7 +30,7 @@ namespace engi
 
 		Texture2D* normalMap = nullptr;
 
-		InstanceTable* instanceTable = nullptr; // InstanceTable may be used to access instance's data
+		const InstanceTable* instanceTable = nullptr; // InstanceTable may be used to access instance's data
 		uint32_t parentInstanceID = uint32_t(-1);
 
 		math::Vec3 albedo;
@@ -153,8 +153,7 @@ namespace engi
 		m_renderer->bindShaderResource2D(depthBufferResource, 26, gfx::PIXEL_SHADER);
 		m_renderer->bindShaderResource2D(gbufferNormalResource, 27, gfx::PIXEL_SHADER);
 		m_decalMaterial->bind();
-		m_unitCubeModel->getIBO()->bind(0);
-		m_unitCubeModel->getVBO()->bind(0, 0);
+		m_renderer->getModelRegistry()->getGeometryPool()->bind();
 		m_instanceBuffer->bind(1, 0);
 
 		GpuDecalGlobalProperties properties;
@@ -170,7 +169,8 @@ namespace engi
 			uint32_t numInstances = static_cast<uint32_t>(renderGroup.decalIDs.size());
 
 			const MeshRange& range = m_unitCubeModel->getStaticMeshEntries()[0].range;
-			m_renderer->drawInstancedIndexed(range.numIndices, numInstances, range.iboOffset, range.vboOffset, numRenderedInstances);
+			GeometryRange geometry = m_unitCubeModel->getGeometryRange();
+			m_renderer->drawInstancedIndexed(range.numIndices, numInstances, geometry.baseIndex + range.iboOffset, geometry.baseVertex + range.vboOffset, numRenderedInstances);
 			numRenderedInstances += numInstances;
 		}
 
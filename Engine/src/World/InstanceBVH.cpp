@@ -0,0 +1,252 @@
+#include "World/InstanceBVH.h"
+
+#include <algorithm>
+
+namespace engi
+{
+
+	using namespace math;
+
+	namespace
+	{
+
+		inline AABB combine(const AABB& a, const AABB& b) noexcept
+		{
+			return AABB(Vec3::min(a.min, b.min), Vec3::max(a.max, b.max));
+		}
+
+		// Half of the surface area, only ratios matter for the insertion cost
+		inline float area(const AABB& aabb) noexcept
+		{
+			Vec3 d = aabb.max - aabb.min;
+			return d.x * d.y + d.y * d.z + d.z * d.x;
+		}
+
+		inline bool containsAABB(const AABB& outer, const AABB& inner) noexcept
+		{
+			return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z
+				&& inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+		}
+
+		inline AABB enlarge(const AABB& aabb) noexcept
+		{
+			Vec3 margin = aabb.size() * ENGI_INSTANCEBVH_FAT_MARGIN;
+			return AABB(aabb.min - margin, aabb.max + margin);
+		}
+
+	}; // anonymous namespace
+
+	uint32_t InstanceBVH::insert(const AABB& aabb, uint32_t userID) noexcept
+	{
+		uint32_t leaf = allocateNode();
+		Node& node = m_nodes[leaf];
+		node.aabb = enlarge(aabb);
+		node.userID = userID;
+		node.height = 0;
+
+		insertLeaf(leaf);
+		return leaf;
+	}
+
+	void InstanceBVH::remove(uint32_t proxy) noexcept
+	{
+		ENGI_ASSERT(proxy < m_nodes.size() && m_nodes[proxy].isLeaf() && m_nodes[proxy].height == 0);
+
+		removeLeaf(proxy);
+		freeNode(proxy);
+	}
+
+	bool InstanceBVH::update(uint32_t proxy, const AABB& aabb) noexcept
+	{
+		ENGI_ASSERT(proxy < m_nodes.size() && m_nodes[proxy].isLeaf() && m_nodes[proxy].height == 0);
+
+		if (containsAABB(m_nodes[proxy].aabb, aabb))
+			return false;
+
+		removeLeaf(proxy);
+		m_nodes[proxy].aabb = enlarge(aabb);
+		insertLeaf(proxy);
+		return true;
+	}
+
+	void InstanceBVH::clear() noexcept
+	{
+		m_nodes.clear();
+		m_root = INVALID_INDEX;
+		m_freeList = INVALID_INDEX;
+	}
+
+	uint32_t InstanceBVH::allocateNode() noexcept
+	{
+		if (m_freeList == INVALID_INDEX)
+		{
+			m_nodes.emplace_back();
+			m_nodes.back().height = 0;
+			return static_cast<uint32_t>(m_nodes.size() - 1);
+		}
+
+		uint32_t index = m_freeList;
+		m_freeList = m_nodes[index].parent;
+		m_nodes[index] = Node();
+		m_nodes[index].height = 0;
+		return index;
+	}
+
+	void InstanceBVH::freeNode(uint32_t index) noexcept
+	{
+		Node& node = m_nodes[index];
+		node.parent = m_freeList;
+		node.children = { INVALID_INDEX, INVALID_INDEX };
+		node.userID = INVALID_INDEX;
+		node.height = -1;
+		m_freeList = index;
+	}
+
+	void InstanceBVH::insertLeaf(uint32_t leaf) noexcept
+	{
+		if (m_root == INVALID_INDEX)
+		{
+			m_root = leaf;
+			m_nodes[leaf].parent = INVALID_INDEX;
+			return;
+		}
+
+		// Descend to the sibling that minimizes the increase of the total area (branch-and-bound over two children)
+		const AABB leafAABB = m_nodes[leaf].aabb;
+		uint32_t index = m_root;
+		while (!m_nodes[index].isLeaf())
+		{
+			const Node& node = m_nodes[index];
+			float combinedArea = area(combine(node.aabb, leafAABB));
+
+			// Cost of making a new parent for this node and the leaf, and the cost that is pushed down to the children otherwise
+			float cost = 2.0f * combinedArea;
+			float inheritanceCost = 2.0f * (combinedArea - area(node.aabb));
+
+			float childCosts[2];
+			for (uint32_t i = 0; i < 2; ++i)
+			{
+				const Node& child = m_nodes[node.children[i]];
+				float childArea = area(combine(child.aabb, leafAABB));
+				childCosts[i] = (child.isLeaf() ? childArea : childArea - area(child.aabb)) + inheritanceCost;
+			}
+
+			if (cost < childCosts[0] && cost < childCosts[1])
+				break;
+
+			index = (childCosts[0] < childCosts[1]) ? node.children[0] : node.children[1];
+		}
+
+		uint32_t sibling = index;
+		uint32_t oldParent = m_nodes[sibling].parent;
+		uint32_t newParent = allocateNode(); // might reallocate nodes, thus no references are held across this call
+		m_nodes[newParent].parent = oldParent;
+		m_nodes[newParent].aabb = combine(leafAABB, m_nodes[sibling].aabb);
+		m_nodes[newParent].height = m_nodes[sibling].height + 1;
+		m_nodes[newParent].children = { sibling, leaf };
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
+
+		if (oldParent == INVALID_INDEX)
+		{
+			m_root = newParent;
+		}
+		else
+		{
+			Node& parent = m_nodes[oldParent];
+			parent.children[parent.children[0] == sibling ? 0 : 1] = newParent;
+		}
+
+		refitAncestors(newParent);
+	}
+
+	void InstanceBVH::removeLeaf(uint32_t leaf) noexcept
+	{
+		if (leaf == m_root)
+		{
+			m_root = INVALID_INDEX;
+			return;
+		}
+
+		uint32_t parent = m_nodes[leaf].parent;
+		uint32_t grandParent = m_nodes[parent].parent;
+		uint32_t sibling = (m_nodes[parent].children[0] == leaf) ? m_nodes[parent].children[1] : m_nodes[parent].children[0];
+
+		m_nodes[sibling].parent = grandParent;
+		freeNode(parent);
+		if (grandParent == INVALID_INDEX)
+		{
+			m_root = sibling;
+			return;
+		}
+
+		Node& grandParentNode = m_nodes[grandParent];
+		grandParentNode.children[grandParentNode.children[0] == parent ? 0 : 1] = sibling;
+		refitAncestors(grandParent);
+	}
+
+	void InstanceBVH::refitAncestors(uint32_t index) noexcept
+	{
+		while (index != INVALID_INDEX)
+		{
+			index = balance(index);
+
+			Node& node = m_nodes[index];
+			const Node& left = m_nodes[node.children[0]];
+			const Node& right = m_nodes[node.children[1]];
+			node.height = 1 + std::max(left.height, right.height);
+			node.aabb = combine(left.aabb, right.aabb);
+			index = node.parent;
+		}
+	}
+
+	uint32_t InstanceBVH::balance(uint32_t indexA) noexcept
+	{
+		Node& a = m_nodes[indexA];
+		if (a.isLeaf() || a.height < 2)
+			return indexA;
+
+		// If one subtree is higher than the other one by more than 1, the higher child is rotated up, so that it takes A's place
+		int32_t heightDiff = m_nodes[a.children[1]].height - m_nodes[a.children[0]].height;
+		if (heightDiff >= -1 && heightDiff <= 1)
+			return indexA;
+
+		uint32_t highSide = (heightDiff > 1) ? 1 : 0;
+		uint32_t indexLow = a.children[1 - highSide];
+		uint32_t indexHigh = a.children[highSide];
+		Node& low = m_nodes[indexLow];
+		Node& high = m_nodes[indexHigh];
+
+		// The taller grandchild stays with the rotated node, the shorter one is given to A instead of the rotated node
+		uint32_t indexTall = high.children[0];
+		uint32_t indexShort = high.children[1];
+		if (m_nodes[indexTall].height < m_nodes[indexShort].height)
+			std::swap(indexTall, indexShort);
+
+		Node& tall = m_nodes[indexTall];
+		Node& shorter = m_nodes[indexShort];
+
+		high.parent = a.parent;
+		if (high.parent == INVALID_INDEX)
+		{
+			m_root = indexHigh;
+		}
+		else
+		{
+			Node& parent = m_nodes[high.parent];
+			parent.children[parent.children[0] == indexA ? 0 : 1] = indexHigh;
+		}
+
+		high.children = { indexA, indexTall };
+		a.parent = indexHigh;
+		a.children[highSide] = indexShort;
+		shorter.parent = indexA;
+
+		a.aabb = combine(low.aabb, shorter.aabb);
+		a.height = 1 + std::max(low.height, shorter.height);
+		high.aabb = combine(a.aabb, tall.aabb);
+		high.height = 1 + std::max(a.height, tall.height);
+		return indexHigh;
+	}
+
+}; // engi namespace
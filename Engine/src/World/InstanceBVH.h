@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <utility>
+#include <vector>
+#include "Core/CommonDefinitions.h"
+#include "Math/Math.h"
+
+// Leaves store bounds enlarged by this fraction of their size, so that small movements do not touch the tree
+#define ENGI_INSTANCEBVH_FAT_MARGIN 0.1f
+
+namespace engi
+{
+
+	// Dynamic bounding volume hierarchy over world-space AABBs of instances, used as a broadphase for ray picking.
+	// Leaves are inserted and removed incrementally (branch-and-bound insertion with rotations to keep the tree balanced),
+	// thus moving an instance costs O(log n) and does not require a rebuild
+	class InstanceBVH
+	{
+	public:
+		static constexpr uint32_t INVALID_INDEX = uint32_t(-1);
+		static constexpr uint32_t MAX_DEPTH = 64; // bounds the traversal stack
+
+		struct Node
+		{
+			math::AABB aabb;
+			uint32_t parent = INVALID_INDEX; // next free node if the node is not used
+			std::array<uint32_t, 2> children = { INVALID_INDEX, INVALID_INDEX };
+			uint32_t userID = INVALID_INDEX;
+			int32_t height = -1; // 0 for leaves, -1 for free nodes
+
+			inline constexpr bool isLeaf() const noexcept { return children[0] == INVALID_INDEX; }
+		};
+
+		InstanceBVH() = default;
+		InstanceBVH(const InstanceBVH&) = delete;
+		InstanceBVH& operator=(const InstanceBVH&) = delete;
+		~InstanceBVH() = default;
+
+		// Returns the leaf (proxy) index, which should be used to update or to remove the bounds later
+		uint32_t insert(const math::AABB& aabb, uint32_t userID) noexcept;
+		void remove(uint32_t proxy) noexcept;
+
+		// Returns true if the leaf had to be reinserted, otherwise new bounds still fit into the enlarged ones
+		bool update(uint32_t proxy, const math::AABB& aabb) noexcept;
+		void clear() noexcept;
+
+		// Visits leaves approximately front-to-back and skips every node that starts further than the closest hit.
+		// func is called as float(uint32_t userID, float tMax) and should return the hit distance or infinity on a miss
+		template<typename Func>
+		void raycast(const math::Ray& ray, Func&& func) const noexcept;
+
+		inline uint32_t getRoot() const noexcept { return m_root; }
+		inline uint32_t getHeight() const noexcept { return m_root == INVALID_INDEX ? 0 : static_cast<uint32_t>(m_nodes[m_root].height); }
+		inline const Node& getNode(uint32_t index) const noexcept { return m_nodes[index]; }
+
+	private:
+		uint32_t allocateNode() noexcept;
+		void freeNode(uint32_t index) noexcept;
+		void insertLeaf(uint32_t leaf) noexcept;
+		void removeLeaf(uint32_t leaf) noexcept;
+		void refitAncestors(uint32_t index) noexcept;
+		uint32_t balance(uint32_t index) noexcept;
+
+		std::vector<Node> m_nodes;
+		uint32_t m_root = INVALID_INDEX;
+		uint32_t m_freeList = INVALID_INDEX;
+	};
+
+	template<typename Func>
+	inline void InstanceBVH::raycast(const math::Ray& ray, Func&& func) const noexcept
+	{
+		if (m_root == INVALID_INDEX)
+			return;
+
+		auto entryDistance = [&ray](const Node& node) -> float
+			{
+				float t;
+				if (!ray.intersects(node.aabb, &t))
+					return math::Numeric::infinity();
+
+				return (t > 0.0f) ? t : 0.0f;
+			};
+
+		struct StackEntry
+		{
+			uint32_t nodeIndex;
+			float t;
+		};
+
+		float closest = math::Numeric::infinity();
+		std::array<StackEntry, MAX_DEPTH> stack;
+		uint32_t stackSize = 0;
+		stack[stackSize++] = StackEntry{ m_root, entryDistance(m_nodes[m_root]) };
+		while (stackSize > 0)
+		{
+			StackEntry entry = stack[--stackSize];
+			if (!(entry.t < closest))
+				continue;
+
+			const Node& node = m_nodes[entry.nodeIndex];
+			if (node.isLeaf())
+			{
+				float t = func(node.userID, closest);
+				closest = (t < closest) ? t : closest;
+				continue;
+			}
+
+			// Push the further child first, so that the closer one is popped next
+			StackEntry nearEntry = StackEntry{ node.children[0], entryDistance(m_nodes[node.children[0]]) };
+			StackEntry farEntry = StackEntry{ node.children[1], entryDistance(m_nodes[node.children[1]]) };
+			if (farEntry.t < nearEntry.t)
+				std::swap(nearEntry, farEntry);
+
+			ENGI_ASSERT(stackSize + 2 <= MAX_DEPTH && "InstanceBVH is deeper than expected");
+			if (farEntry.t < closest)
+				stack[stackSize++] = farEntry;
+
+			if (nearEntry.t < closest)
+				stack[stackSize++] = nearEntry;
+		}
+	}
+
+}; // engi namespace
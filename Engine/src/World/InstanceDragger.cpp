@@ -31,21 +31,9 @@ namespace engi
 	{
 		ENGI_ASSERT(m_registry);
 
-		InstanceIntersection result;
-		result.meshIntersection.reset();
-		uint32_t modelInstanceID = uint32_t(-1);
-
 		// TODO: Right now instance dragger stores ModelInstance* to drag an instnace. It might become a dangling pointer, thus it needs to be changed!
-		for (uint32_t currentModelInstanceID : m_registry->getAllModelInstanceIDs())
-		{
-			ModelInstance* modelInstance = m_registry->getModelInstance(currentModelInstanceID);
-			InstanceIntersection i = modelInstance->intersect(ray);
-			if (result > i)
-			{
-				result = i;
-				modelInstanceID = currentModelInstanceID;
-			}
-		}
+		uint32_t modelInstanceID = uint32_t(-1);
+		InstanceIntersection result = m_registry->intersect(ray, &modelInstanceID);
 
 		if (result.isValid())
 		{
@@ -63,6 +51,8 @@ namespace engi
 
 		m_t = intersection.meshIntersection.t;
 		m_modelInstanceID = modelInstanceID;
+		m_releasedMobility = modelInstance->getMobility();
+		modelInstance->setMobility(INSTANCE_MOBILITY_DYNAMIC);
 		math::Vec3 instancePos = data.modelToWorld.getTranslation();
 		m_delta = instancePos - intersection.meshIntersection.hitpos;
 	}
@@ -84,12 +74,18 @@ namespace engi
 		data.modelToWorld.addTranslation(offset);
 		data.worldToModel = data.modelToWorld.inverse();
 		modelInstance->updateMeshData();
+		m_registry->updateInstanceBounds(m_modelInstanceID);
 	}
 
 	void InstanceDragger::performRelease()
 	{
 		//ENGI_ASSERT(m_instance != && "Instance cannot be nullptr");
 		m_active = false;
+
+		// Instance might have been removed while dragged
+		ModelInstance* modelInstance = m_registry->getModelInstance(m_modelInstanceID);
+		if (modelInstance)
+			modelInstance->setMobility(m_releasedMobility);
 	}
 
 }; // engi namespace
\ No newline at end of file
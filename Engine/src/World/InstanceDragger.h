@@ -20,6 +20,7 @@ namespace engi
 		
 		ModelInstanceRegistry* m_registry = nullptr;
 		uint32_t m_modelInstanceID = uint32_t(-1);
+		InstanceMobility m_releasedMobility = INSTANCE_MOBILITY_STATIC; // instance is dynamic while dragged, then its mobility is restored
 		math::Vec3 m_delta;
 		math::Vec3 m_hitpos;
 		float m_t = -1.0f;
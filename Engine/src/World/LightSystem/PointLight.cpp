@@ -18,7 +18,7 @@ namespace engi
         return this->getRelativePosition() * this->getEntityToLight();
     }
 
-    void PointLight::setEntityID(InstanceTable* dataTable, uint32_t entityID) noexcept
+    void PointLight::setEntityID(const InstanceTable* dataTable, uint32_t entityID) noexcept
     {
         m_dataTable = dataTable;
         m_entityID = entityID;
@@ -52,7 +52,7 @@ namespace engi
 
     math::Mat4x4 PointLight::getProjection() const noexcept
     {
-        return math::Mat4x4::perspectiveProjectionLH(math::toRadians(90.0f), 1.0f, 30.0f, 0.01f);
+        return math::Mat4x4::perspectiveProjectionLH(math::toRadians(90.0f), 1.0f, SHADOW_RANGE, 0.01f);
     }
 
     const math::Mat4x4& PointLight::getEntityToLight() const noexcept
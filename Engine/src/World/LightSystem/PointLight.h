@@ -11,6 +11,9 @@ namespace engi
 	class PointLight : public LightBase
 	{
 	public:
+		// Distance at which the shadow cube ends, casters beyond it are culled
+		static constexpr float SHADOW_RANGE = 30.0f;
+
 		PointLight() = default;
 		PointLight(uint32_t arraySlice, const math::Vec3& color, float intensity, float radius, const math::Vec3& position = math::Vec3());
 
@@ -18,7 +21,7 @@ namespace engi
 		const math::Vec3& getRelativePosition() const noexcept { return m_position; }
 		math::Vec3 getPosition() const noexcept;
 
-		void setEntityID(InstanceTable* dataTable, uint32_t entityID) noexcept;
+		void setEntityID(const InstanceTable* dataTable, uint32_t entityID) noexcept;
 		uint32_t getEntityID() const noexcept { return m_entityID; }
 		bool hasEntity() const noexcept { return m_dataTable != nullptr && m_dataTable->isOccupied(m_entityID); }
 
@@ -31,7 +34,7 @@ namespace engi
 	private:
 		const math::Mat4x4& getEntityToLight() const noexcept;
 
-		InstanceTable* m_dataTable = nullptr;
+		const InstanceTable* m_dataTable = nullptr;
 		uint32_t m_entityID = uint32_t(-1);
 		math::Vec3 m_position = math::Vec3();
 		uint32_t m_depthmapArrayslice = uint32_t(-1);
@@ -21,7 +21,7 @@ namespace engi
 		return this->getRelativePosition() * this->getEntityToLight();
 	}
 
-	void SpotLight::setEntityID(InstanceTable* dataTable, uint32_t entityID) noexcept
+	void SpotLight::setEntityID(const InstanceTable* dataTable, uint32_t entityID) noexcept
 	{
 		m_dataTable = dataTable;
 		m_entityID = entityID;
@@ -32,7 +32,7 @@ namespace engi
 		float& getSmoothing() noexcept { return m_smoothing; }
 		float getSmoothing() const noexcept { return m_smoothing; }
 
-		void setEntityID(InstanceTable* dataTable, uint32_t entityID) noexcept;
+		void setEntityID(const InstanceTable* dataTable, uint32_t entityID) noexcept;
 		uint32_t getEntityID() const noexcept { return m_entityID; }
 		bool hasEntity() const noexcept { return m_dataTable != nullptr && m_dataTable->isOccupied(m_entityID); }
 
@@ -45,7 +45,7 @@ namespace engi
 	private:
 		const math::Mat4x4& getEntityToLight() const noexcept;
 
-		InstanceTable* m_dataTable = nullptr;
+		const InstanceTable* m_dataTable = nullptr;
 		uint32_t m_entityID = uint32_t(-1);
 		Texture2D* m_cookie = nullptr;
 		math::Vec3 m_position = math::Vec3();
@@ -47,19 +47,37 @@ namespace engi
 		meshManager->getInstanceTable()->removeInstanceData(m_instanceID);
 	}
 
-	bool ModelInstance::init(const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& data) noexcept
+	bool ModelInstance::init(const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& data, InstanceMobility mobility) noexcept
+	{
+		initInstanceData(model, materials, data, mobility);
+
+		MeshManager* meshManager = m_sceneRenderer->getMeshManager();
+		uint32_t numMeshes = getNumMeshInstances();
+		for (uint32_t meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
+		{
+			const MaterialInstance& materialInstance = m_meshInstances[meshIndex].materialInstance;
+			if (!meshManager->submitInstance(model, meshIndex, materialInstance, m_instanceID))
+			{
+				ENGI_LOG_WARN("Failed to submit instance of mesh {} pf {} model", meshIndex, model->getPath());
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void ModelInstance::initInstanceData(const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& data, InstanceMobility mobility) noexcept
 	{
 		ENGI_ASSERT(model && model->getNumStaticMeshes() > 0 && "Weird model");
 		uint32_t numMeshes = model->getNumStaticMeshes();
 		uint32_t numMaterials = static_cast<uint32_t>(materials.size());
 		ENGI_ASSERT(numMaterials > 0);
 
-		MeshManager* meshManager = m_sceneRenderer->getMeshManager();
 		m_model = model;
 		m_meshInstances.reserve(numMeshes);
 
-		InstanceTable* instanceTable = meshManager->getInstanceTable();
-		m_instanceID = instanceTable->addInstanceData(data);
+		InstanceTable* instanceTable = m_sceneRenderer->getMeshManager()->getInstanceTable();
+		m_instanceID = instanceTable->addInstanceData(data, mobility);
 
 		InstanceData& emplacedData = instanceTable->getInstanceData(m_instanceID);
 		emplacedData.instanceID = m_instanceID;
@@ -67,17 +85,8 @@ namespace engi
 		for (uint32_t meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
 		{
 			uint32_t materialIndex = (meshIndex >= numMaterials) ? numMaterials - 1 : meshIndex;
-			const MaterialInstance& materialInstance = materials[materialIndex];
-			// std::cout << std::format("Submitting mesh index {} with material instance {}", materialIndex, materialInstance.getName()) << std::endl;
-			m_meshInstances.emplace_back(StaticMeshInstance(&model->getStaticMeshEntries()[meshIndex].mesh, materialInstance));
-			if (!meshManager->submitInstance(model, meshIndex, materialInstance, m_instanceID))
-			{
-				ENGI_LOG_WARN("Failed to submit instance of mesh {} pf {} model", meshIndex, model->getPath());
-				return false;
-			}
+			m_meshInstances.emplace_back(StaticMeshInstance(&model->getStaticMeshEntries()[meshIndex].mesh, materials[materialIndex]));
 		}
-
-		return true;
 	}
 
 	InstanceData& ModelInstance::getData() noexcept
@@ -90,7 +99,26 @@ namespace engi
 
 	const InstanceData& ModelInstance::getData() const noexcept
 	{
-		return const_cast<ModelInstance*>(this)->getData();
+		ENGI_ASSERT(m_instanceID != uint32_t(-1) && "Not initted");
+
+		const MeshManager* meshManager = m_sceneRenderer->getMeshManager();
+		return meshManager->getInstanceTable()->getInstanceData(m_instanceID);
+	}
+
+	InstanceMobility ModelInstance::getMobility() const noexcept
+	{
+		ENGI_ASSERT(m_instanceID != uint32_t(-1) && "Not initted");
+
+		const MeshManager* meshManager = m_sceneRenderer->getMeshManager();
+		return meshManager->getInstanceTable()->getMobility(m_instanceID);
+	}
+
+	void ModelInstance::setMobility(InstanceMobility mobility) noexcept
+	{
+		ENGI_ASSERT(m_instanceID != uint32_t(-1) && "Not initted");
+
+		MeshManager* meshManager = m_sceneRenderer->getMeshManager();
+		meshManager->getInstanceTable()->setMobility(m_instanceID, mobility);
 	}
 
 	MaterialInstance ModelInstance::getMaterialInstance(uint32_t meshIndex) const noexcept
@@ -297,7 +325,7 @@ namespace engi
 
 	InstanceIntersection ModelInstance::intersect(const math::Ray& ray) const noexcept
 	{
-		StaticMeshTriangleOctree::IntersectionType intersection;
+		StaticMeshBVH::IntersectionType intersection;
 		intersection.reset();
 		uint32_t intersectedMeshIndex = uint32_t(-1);
 
@@ -313,7 +341,7 @@ namespace engi
 			math::Vec3 meshPos = modelRay.origin * entry.mesh.getModelToMesh();
 			math::Vec4 meshDir = math::Vec4(modelRay.direction, 0.0f) * entry.mesh.getModelToMesh();
 			math::Ray meshRay(meshPos, math::Vec3(&meshDir.x));
-			StaticMeshTriangleOctree::IntersectionType i = entry.bvh.intersect(meshRay);
+			StaticMeshBVH::IntersectionType i = entry.bvh.intersect(meshRay);
 			if (i < intersection)
 			{
 				intersection = i;
@@ -328,6 +356,12 @@ namespace engi
 			math::Vec3 worldHitpos = (intersection.hitpos * entry.mesh.getMeshToModel()) * data.modelToWorld;
 			float t = math::Vec3::distance(ray.origin, worldHitpos);
 
+			// normals are transformed with the inverse-transpose of mesh-to-world
+			math::Mat4x4 normalMatrix = (data.worldToModel * entry.mesh.getModelToMesh()).transpose();
+			math::Vec4 worldNormal = math::Vec4(intersection.normal, 0.0f) * normalMatrix;
+			intersection.normal = math::Vec3(&worldNormal.x);
+			intersection.normal.normalize();
+
 			intersection.t = t;
 			intersection.hitpos = worldHitpos;
 		}
@@ -34,9 +34,11 @@ namespace engi
 		ModelInstance(SceneRenderer* sceneRenderer, const std::string& name = "Unknown model instance");
 		~ModelInstance();
 
-		bool init(const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& data) noexcept;
+		bool init(const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& data, InstanceMobility mobility = INSTANCE_MOBILITY_STATIC) noexcept;
 		InstanceData& getData() noexcept;
 		const InstanceData& getData() const noexcept;
+		InstanceMobility getMobility() const noexcept;
+		void setMobility(InstanceMobility mobility) noexcept;
 		inline constexpr uint32_t getInstanceID() const noexcept { return m_instanceID; }
 
 		MaterialInstance getMaterialInstance(uint32_t meshIndex) const noexcept;
@@ -71,6 +73,12 @@ namespace engi
 		InstanceIntersection intersect(const math::Ray& ray) const noexcept;
 
 	private:
+		// Bulk spawning creates the instances first and submits their meshes to MeshManager all at once
+		friend class ModelInstanceRegistry;
+
+		// Adds the instance data and mesh instances, meshes are not submitted to MeshManager
+		void initInstanceData(const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& data, InstanceMobility mobility) noexcept;
+
 		std::string m_name;
 		SceneRenderer* m_sceneRenderer;
 
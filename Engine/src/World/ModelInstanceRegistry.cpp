@@ -14,7 +14,7 @@ namespace engi
 		ENGI_ASSERT(sceneRenderer);
 	}
 
-	uint32_t ModelInstanceRegistry::addInstance(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& data) noexcept
+	uint32_t ModelInstanceRegistry::addInstance(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& data, InstanceMobility mobility) noexcept
 	{
 		uint32_t modelInstanceID = uint32_t(-1);
 		if (!model)
@@ -24,7 +24,7 @@ namespace engi
 		}
 
 		ModelInstance* mi = new ModelInstance(m_sceneRenderer, name);
-		if (!mi->init(model, materials, data))
+		if (!mi->init(model, materials, data, mobility))
 		{
 			ENGI_LOG_WARN("Failed to init model instance {}", name);
 			delete mi;
@@ -32,14 +32,76 @@ namespace engi
 		}
 
 		modelInstanceID = m_modelInstances.insert(std::move(makeUnique<ModelInstance>(mi)));
+		if (modelInstanceID >= m_bvhProxies.size())
+			m_bvhProxies.resize(static_cast<size_t>(modelInstanceID) + 1, InstanceBVH::INVALID_INDEX);
+
+		m_bvhProxies[modelInstanceID] = m_bvh.insert(mi->getAABB(), modelInstanceID);
 		return modelInstanceID;
 	}
 
+	std::vector<uint32_t> ModelInstanceRegistry::addInstances(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, ArrayView<const math::Transformation> transforms, const InstanceData& data, InstanceMobility mobility) noexcept
+	{
+		std::vector<uint32_t> modelInstanceIDs;
+		if (!model || materials.empty())
+		{
+			ENGI_LOG_WARN("Failed to init model instances {}", name);
+			return modelInstanceIDs;
+		}
+
+		uint32_t numInstances = static_cast<uint32_t>(transforms.size());
+		if (numInstances == 0)
+			return modelInstanceIDs;
+
+		MeshManager* meshManager = m_sceneRenderer->getMeshManager();
+		InstanceTable* instanceTable = meshManager->getInstanceTable();
+		instanceTable->reserve(instanceTable->getNumInstances() + numInstances);
+		m_modelInstances.reserve(m_modelInstances.size() + numInstances);
+		modelInstanceIDs.reserve(numInstances);
+
+		std::vector<uint32_t> instanceIDs;
+		instanceIDs.reserve(numInstances);
+
+		uint32_t maxModelInstanceID = 0;
+		for (const math::Transformation& transform : transforms)
+		{
+			InstanceData instanceData = data;
+			instanceData.modelToWorld = math::Mat4x4::toWorld(transform.translation, transform.rotation, transform.scale);
+			instanceData.worldToModel = instanceData.modelToWorld.inverse();
+
+			ModelInstance* mi = new ModelInstance(m_sceneRenderer, name);
+			mi->initInstanceData(model, materials, instanceData, mobility);
+			instanceIDs.push_back(mi->getInstanceID());
+
+			uint32_t modelInstanceID = m_modelInstances.insert(std::move(makeUnique<ModelInstance>(mi)));
+			modelInstanceIDs.push_back(modelInstanceID);
+			maxModelInstanceID = std::max(maxModelInstanceID, modelInstanceID);
+		}
+
+		// Every instance of the group has the same materials, thus a mesh goes to a single batch
+		ModelInstance* firstInstance = m_modelInstances[modelInstanceIDs.front()].get();
+		for (uint32_t meshIndex = 0; meshIndex < firstInstance->getNumMeshInstances(); ++meshIndex)
+		{
+			const MaterialInstance& materialInstance = firstInstance->getMeshInstances()[meshIndex].materialInstance;
+			if (!meshManager->submitInstances(model, meshIndex, materialInstance, viewOf(instanceIDs.data(), numInstances)))
+				ENGI_LOG_WARN("Failed to submit instances of mesh {} of {} model", meshIndex, model->getPath());
+		}
+
+		if (maxModelInstanceID >= m_bvhProxies.size())
+			m_bvhProxies.resize(static_cast<size_t>(maxModelInstanceID) + 1, InstanceBVH::INVALID_INDEX);
+
+		for (uint32_t modelInstanceID : modelInstanceIDs)
+			m_bvhProxies[modelInstanceID] = m_bvh.insert(m_modelInstances[modelInstanceID]->getAABB(), modelInstanceID);
+
+		return modelInstanceIDs;
+	}
+
 	void ModelInstanceRegistry::removeInstance(uint32_t modelInstanceID) noexcept
 	{
 		if (!this->isValidID(modelInstanceID))
 			return;
 
+		m_bvh.remove(m_bvhProxies[modelInstanceID]);
+		m_bvhProxies[modelInstanceID] = InstanceBVH::INVALID_INDEX;
 		m_modelInstances.erase(modelInstanceID);
 	}
 
@@ -51,4 +113,35 @@ namespace engi
 		return m_modelInstances[modelInstanceID].get();
 	}
 
+	void ModelInstanceRegistry::updateInstanceBounds(uint32_t modelInstanceID) noexcept
+	{
+		if (!this->isValidID(modelInstanceID))
+			return;
+
+		m_bvh.update(m_bvhProxies[modelInstanceID], m_modelInstances[modelInstanceID]->getAABB());
+	}
+
+	InstanceIntersection ModelInstanceRegistry::intersect(const math::Ray& ray, uint32_t* modelInstanceID) const noexcept
+	{
+		InstanceIntersection result;
+		result.meshIntersection.reset();
+		uint32_t intersectedModelInstanceID = uint32_t(-1);
+
+		m_bvh.raycast(ray, [&](uint32_t candidateID, float tMax) -> float
+			{
+				InstanceIntersection i = m_modelInstances[candidateID]->intersect(ray);
+				if (!i.isValid() || i.meshIntersection.t >= tMax)
+					return math::Numeric::infinity();
+
+				result = i;
+				intersectedModelInstanceID = candidateID;
+				return i.meshIntersection.t;
+			});
+
+		if (modelInstanceID)
+			*modelInstanceID = intersectedModelInstanceID;
+
+		return result;
+	}
+
 }; // engi namespace
\ No newline at end of file
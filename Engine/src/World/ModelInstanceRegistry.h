@@ -8,6 +8,7 @@
 #include "Renderer/MaterialInstance.h"
 #include "Renderer/InstanceData.h"
 #include "World/ModelInstance.h"
+#include "World/InstanceBVH.h"
 
 namespace engi
 {
@@ -22,7 +23,12 @@ namespace engi
 		ModelInstanceRegistry& operator=(const ModelInstanceRegistry&) = delete;
 		~ModelInstanceRegistry() = default;
 
-		uint32_t addInstance(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& data) noexcept;
+		uint32_t addInstance(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& data, InstanceMobility mobility = INSTANCE_MOBILITY_STATIC) noexcept;
+
+		// Adds an instance per transformation, every other field of InstanceData is copied from data. Storage is reserved once and each
+		// mesh of the model is submitted to its batch in one go, thus instance buffers are resized at most once for the whole group.
+		// Returns modelInstanceIDs in the order of transformations, empty if the instances could not be added
+		std::vector<uint32_t> addInstances(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, ArrayView<const math::Transformation> transforms, const InstanceData& data = InstanceData(), InstanceMobility mobility = INSTANCE_MOBILITY_STATIC) noexcept;
 
 		// Remark: modelInstanceID != ModelInstance::getInstanceID(). Those are different IDs for different registries
 		// Latter is used to access InstanceData information of the instance
@@ -37,9 +43,18 @@ namespace engi
 
 		const auto& getAllModelInstanceIDs() const noexcept { return m_modelInstances.getAllIDs(); }
 
+		// Should be called whenever the transformation of the instance was changed, so that the broadphase stays conservative
+		void updateInstanceBounds(uint32_t modelInstanceID) noexcept;
+
+		// Finds the closest intersected instance. Only instances whose bounds are hit are tested, closest first,
+		// and the search stops as soon as no remaining bounds can contain a closer hit
+		InstanceIntersection intersect(const math::Ray& ray, uint32_t* modelInstanceID) const noexcept;
+
 	private:
 		SceneRenderer* m_sceneRenderer;
 		SolidVector<UniqueHandle<ModelInstance>> m_modelInstances;
+		InstanceBVH m_bvh;
+		std::vector<uint32_t> m_bvhProxies; // indexed by modelInstanceID
 	};
 
 }; // engi namespace
\ No newline at end of file
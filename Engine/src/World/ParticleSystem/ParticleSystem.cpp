@@ -37,7 +37,7 @@ namespace engi
 		float rotation;
 	};
 
-	SmokeEmitter::SmokeEmitter(Renderer* renderer, InstanceTable* instanceTable, uint32_t entityID)
+	SmokeEmitter::SmokeEmitter(Renderer* renderer, const InstanceTable* instanceTable, uint32_t entityID)
 		: m_renderer(renderer)
 		, m_instanceTable(instanceTable)
 		, m_entityID(entityID)
@@ -175,9 +175,12 @@ namespace engi
 			addParticle(particle);
 		}
 
-		math::Mat4x4 worldToEntity = this->getWorldToEntity();
-		this->sortAliveParticles(worldToEntity, cameraPos);
+		this->sortAliveParticles(this->getWorldToEntity(), cameraPos);
+	}
 
+	void SmokeEmitter::updateBuffer() noexcept
+	{
+		const math::Mat4x4& worldToEntity = this->getWorldToEntity();
 		GPUBillboardParticle* particles = reinterpret_cast<GPUBillboardParticle*>(m_instanceBuffer->map());
 		uint32_t numParticles = (uint32_t)m_particles.size();
 		for (uint32_t i = 0; i < numParticles; ++i)
@@ -295,6 +298,14 @@ namespace engi
 		}
 	}
 
+	void ParticleSystem::updateBuffers() noexcept
+	{
+		for (SmokeEmitter& emitter : m_smokeEmitters)
+		{
+			emitter.updateBuffer();
+		}
+	}
+
 	void ParticleSystem::render(Texture2D* depthResource) noexcept
 	{
 		ENGI_ASSERT(depthResource);
@@ -48,13 +48,17 @@ namespace engi
 	{
 	public:
 		SmokeEmitter() = default;
-		SmokeEmitter(Renderer* renderer, InstanceTable* instanceTable, uint32_t entityID);
+		SmokeEmitter(Renderer* renderer, const InstanceTable* instanceTable, uint32_t entityID);
 		SmokeEmitter(const SmokeEmitter&);
 		SmokeEmitter& operator=(const SmokeEmitter&);
 		~SmokeEmitter();
 
 		bool init(const EmitterSettings& settings, Texture2D* mvea, Texture2D* dbf, Texture2D* rlu) noexcept;
+		// Simulates and sorts particles on the CPU without touching GPU resources
 		void update(float timestep, const math::Vec3& cameraPos) noexcept;
+
+		// Uploads alive particles to the instance buffer
+		void updateBuffer() noexcept;
 		void render() noexcept;
 		
 		inline constexpr void setRelativePosition(const math::Vec3& position) noexcept { m_position = position; }
@@ -71,7 +75,7 @@ namespace engi
 		void sortAliveParticles(const math::Mat4x4& worldToEntity, const math::Vec3& cameraPos) noexcept;
 
 		Renderer* m_renderer = nullptr;
-		InstanceTable* m_instanceTable = nullptr;
+		const InstanceTable* m_instanceTable = nullptr;
 		uint32_t m_entityID;
 
 		math::Vec3 m_position;
@@ -95,6 +99,7 @@ namespace engi
 
 		bool init() noexcept;
 		void update(float timestep, const math::Vec3& cameraPos) noexcept;
+		void updateBuffers() noexcept;
 		void render(Texture2D* depthResource) noexcept;
 		uint32_t addEmitter(InstanceTable* instanceTable, uint32_t entityID, Texture2D* mvea, Texture2D* dbf, Texture2D* rlu, const EmitterSettings& settings = ParticleSystem::getGlobalEmitterSettings()) noexcept;
 
@@ -176,7 +176,7 @@ namespace engi
 		return lm->getDirLight(m_dirLightID);
 	}
 
-	uint32_t Scene::addInstance(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& instanceData) noexcept
+	uint32_t Scene::addInstance(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& instanceData, InstanceMobility mobility) noexcept
 	{
 		uint32_t modelInstanceID = uint32_t(-1);
 		if (!model)
@@ -191,7 +191,7 @@ namespace engi
 		}
 
 		ModelInstanceRegistry* instanceRegistry = m_sceneRenderer->getInstanceRegistry();
-		modelInstanceID = instanceRegistry->addInstance(name, model, materials, instanceData);
+		modelInstanceID = instanceRegistry->addInstance(name, model, materials, instanceData, mobility);
 		if (!instanceRegistry->isValidID(modelInstanceID))
 		{
 			ENGI_LOG_WARN("Scene::addInstance() -> failed to add an instance to the instance registry. Returning nullptr");
@@ -201,6 +201,21 @@ namespace engi
 		return modelInstanceID;
 	}
 
+	std::vector<uint32_t> Scene::addInstances(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, ArrayView<const math::Transformation> transforms, const InstanceData& instanceData, InstanceMobility mobility) noexcept
+	{
+		if (!model)
+		{
+			ENGI_LOG_INFO("Scene::addInstances() -> provided model is nullptr. Doing nothing");
+			return {};
+		}
+
+		std::vector<uint32_t> modelInstanceIDs = m_sceneRenderer->getInstanceRegistry()->addInstances(name, model, materials, transforms, instanceData, mobility);
+		if (modelInstanceIDs.size() != transforms.size())
+			ENGI_LOG_WARN("Scene::addInstances() -> failed to add instances to the instance registry");
+
+		return modelInstanceIDs;
+	}
+
 	uint32_t Scene::spawnInstance(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const math::Vec3& color) noexcept
 	{
 		Camera& camera = getCameraManager()->getCamera();
@@ -211,7 +226,7 @@ namespace engi
 
 		InstanceData instanceData(transform);
 		instanceData.color = color;
-		instanceData.time = 0.0f;
+		instanceData.spawnTime = m_sceneRenderer->getTime();
 		instanceData.emission = Random::GenerateFloat3(math::Vec3(0.125f), math::Vec3(1.0f));
 		instanceData.emissionPower = 8.0f;
 
@@ -273,7 +288,7 @@ namespace engi
 		InstanceData& data = instance->getData();
 		data.sphereOrigin = hitpos * data.worldToModel;
 		data.sphereRadiusMax = radius;
-		data.time = 0.0f;
+		data.spawnTime = m_sceneRenderer->getTime();
 		data.emission = Random::GenerateFloat3(math::Vec3(0.125f), math::Vec3(1.0f));
 		data.emissionPower = 8.0f;
 
@@ -286,6 +301,27 @@ namespace engi
 		return instanceRegistry->getModelInstance(modelInstanceID);
 	}
 
+	uint32_t Scene::addInstanceGroup(const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, ArrayView<const math::Transformation> transforms, const math::Vec3& color) noexcept
+	{
+		if (!model)
+		{
+			ENGI_LOG_INFO("Scene::addInstanceGroup() -> provided model is nullptr. Doing nothing");
+			return MeshManager::INVALID_GROUP;
+		}
+
+		return m_sceneRenderer->getMeshManager()->addInstanceGroup(model, materials, transforms, color);
+	}
+
+	void Scene::removeInstanceGroup(uint32_t groupID) noexcept
+	{
+		m_sceneRenderer->getMeshManager()->removeInstanceGroup(groupID);
+	}
+
+	InstanceGroup* Scene::getInstanceGroupByID(uint32_t groupID) noexcept
+	{
+		return m_sceneRenderer->getMeshManager()->getInstanceGroup(groupID);
+	}
+
 	math::Transformation Scene::getTransformForInstanceSpawn(const Camera& camera) const noexcept
 	{
 		math::Vec3 eyeDir = camera.getDirection();
@@ -434,7 +470,8 @@ namespace engi
 					return true;
 				}
 		
-				if (instance->getData().time < getDissolutionTime())
+				const ModelInstance* constInstance = instance;
+				if (constInstance->getData().getTime(m_sceneRenderer->getTime()) < getDissolutionTime())
 					return false;
 
 				// Update the material instance
@@ -465,7 +502,8 @@ namespace engi
 					return true;
 				}
 
-				if (instance->getData().time < this->getIncinerationTime())
+				const ModelInstance* constInstance = instance;
+				if (constInstance->getData().getTime(m_sceneRenderer->getTime()) < this->getIncinerationTime())
 					return false;
 
 				ENGI_LOG_INFO("Removing an instance {} from removed instances queue", instance->getName());
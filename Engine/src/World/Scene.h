@@ -57,12 +57,18 @@ namespace engi
 		inline constexpr float getDissolutionTime() const noexcept { return m_sceneRenderer->getDissolutionTime(); }
 		inline constexpr float getIncinerationTime() const noexcept { return m_sceneRenderer->getIncinerationTime(); }
 
-		uint32_t addInstance(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& instanceData) noexcept;
+		uint32_t addInstance(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const InstanceData& instanceData, InstanceMobility mobility = INSTANCE_MOBILITY_STATIC) noexcept;
+		std::vector<uint32_t> addInstances(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, ArrayView<const math::Transformation> transforms, const InstanceData& instanceData = InstanceData(), InstanceMobility mobility = INSTANCE_MOBILITY_STATIC) noexcept;
 		uint32_t spawnInstance(const std::string& name, const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, const math::Vec3& color) noexcept;
 		void removeInstance(uint32_t modelInstanceID, const math::Vec3& hitpos) noexcept;
 
 		ModelInstance* getModelInstanceByID(uint32_t modelInstanceID) noexcept;
 
+		// Instance groups are meant for large amounts of props (foliage, rocks) that do not need to be picked or to own lights
+		uint32_t addInstanceGroup(const SharedHandle<Model>& model, ArrayView<const MaterialInstance> materials, ArrayView<const math::Transformation> transforms, const math::Vec3& color = math::Vec3()) noexcept;
+		void removeInstanceGroup(uint32_t groupID) noexcept;
+		InstanceGroup* getInstanceGroupByID(uint32_t groupID) noexcept;
+
 		math::Transformation getTransformForInstanceSpawn(const Camera& camera) const noexcept;
 		void copyMaterialInstanceForDissolution(std::vector<MaterialInstance>& dissolutionMaterials, ArrayView<const MaterialInstance> materials) const noexcept;
 		
@@ -1,6 +1,5 @@
 #include "SceneRenderer.h"
 
-#include "Utility/Timer.h"
 #include "Core/CommonDefinitions.h"
 #include "Core/Logger.h"
 #include "Renderer/Renderer.h"
@@ -88,13 +87,13 @@ namespace engi
 		ShaderLibrary* shaderLibrary = m_renderer->getShaderLibrary();
 		ShaderProgram* shader = nullptr;
 		shader = shaderLibrary->createProgram("NormalVis.hlsl", true, false);
-		shader->setAttributeLayout(MeshManager::getInputAttributes(0, 1));
+		shader->setAttributeLayout(MeshManager::getInputAttributes(0, 1, 3));
 		m_normalVisMaterial = materialRegistry->registerMaterial("ENGI_NormalVis");
 		m_normalVisMaterial->setShader(shader);
 		m_normalVisMaterial->init();
 
 		shader = shaderLibrary->createProgram("Depthmap_Texture2D.hlsl", false, false, false);
-		shader->setAttributeLayout(MeshManager::getInputAttributes(0, 1));
+		shader->setAttributeLayout(MeshManager::getInputAttributes(0, 1, 3));
 		m_depthmap2DMaterial = materialRegistry->registerMaterial("ENGI_Depthmap2D");
 		m_depthmap2DMaterial->setShader(shader);
 		m_depthmap2DMaterial->getRasterizerState().depthBias = -4;
@@ -103,7 +102,7 @@ namespace engi
 		m_depthmap2DMaterial->init();
 
 		shader = shaderLibrary->createProgram("Depthmap_TextureCube.hlsl", true, false, false);
-		shader->setAttributeLayout(MeshManager::getInputAttributes(0, 1));
+		shader->setAttributeLayout(MeshManager::getInputAttributesWithViewMask(0, 1, 3, 2));
 		m_depthmapCubeMaterial = materialRegistry->registerMaterial("ENGI_DepthmapCube");
 		m_depthmapCubeMaterial->setShader(shader);
 		m_depthmapCubeMaterial->getRasterizerState().depthBias = -64;
@@ -167,6 +166,7 @@ namespace engi
 		}
 
 		this->initSamplers();
+		this->initUpdateGraph();
 
 		return true;
 	}
@@ -177,48 +177,87 @@ namespace engi
 		this->initRenderPasses(width, height);
 	}*/
 
-	void SceneRenderer::update(float timestep) noexcept
+	void SceneRenderer::initUpdateGraph() noexcept
 	{
-		ENGI_ASSERT(m_dissolutionTexture && "Set a dissolution texture, please");
-		ENGI_ASSERT(m_cameraManager && "We do not update without a camera");
-		
-		m_frameTimestep = timestep;
-
-		if (m_instanceTable)
+		// Resources that are shared between update stages. Every stage that maps a GPU buffer writes GPU_CONTEXT,
+		// as the immediate context cannot be used concurrently
+		enum UpdateResource : TaskGraph::resource_mask
 		{
-			for (InstanceData& data : m_instanceTable->getAllInstanceData())
+			INSTANCE_TABLE = 1 << 0,
+			DECAL_BUFFER = 1 << 1,
+			EMITTERS = 1 << 2,
+			LIGHTS = 1 << 3,
+			GPU_CONTEXT = 1 << 4,
+		};
+
+		m_updateGraph.clear();
+		m_updateGraph.addTask("Instances", 0, INSTANCE_TABLE, [this]()
 			{
-				data.time += timestep;
-				data.timestep = timestep;
-			}
+				if (!m_instanceTable)
+					return;
 
-			// Mesh manager is using a bit deprecated API with buffer update stuff. Will be changed sometime in future
-			if (m_meshManager)
-				m_meshManager->requestBufferUpdate();
+				// Instance time is derived from the scene time on the GPU, thus only modified instances are reuploaded.
+				// Mesh manager is using a bit deprecated API with buffer update stuff. Will be changed sometime in future
+				if (m_meshManager)
+					m_meshManager->requestBufferUpdate();
 
-			if (m_decalManager)
-				m_decalManager->update();
+				// Camera instance is only touched when the camera has moved, so that idle frames upload nothing
+				if (m_cameraManager && m_cameraInstanceID != uint32_t(-1))
+				{
+					const Camera& camera = m_cameraManager->getCamera();
+					const InstanceTable& instanceTable = *m_instanceTable;
+					if (instanceTable.getInstanceData(m_cameraInstanceID).modelToWorld != camera.getView())
+					{
+						InstanceData& cameraData = m_instanceTable->getInstanceData(m_cameraInstanceID);
+						cameraData.modelToWorld = camera.getView();
+						cameraData.worldToModel = camera.getViewInv();
+					}
+				}
+			});
 
-			if (m_cameraManager && m_cameraInstanceID != uint32_t(-1))
+		m_updateGraph.addTask("LightAnchors", 0, LIGHTS, [this]()
 			{
-				const Camera& camera = m_cameraManager->getCamera();
-				InstanceData& cameraData = m_instanceTable->getInstanceData(m_cameraInstanceID);
-				cameraData.modelToWorld = camera.getView();
-				cameraData.worldToModel = camera.getViewInv();
-			}
-		}
+				if (!m_lightManager)
+					return;
 
-		if (m_particleSystem)
-			m_particleSystem->update(timestep, m_cameraManager->getCamera().getPosition());
+				// Set depth anchors before the light buffers are applied to the GPU
+				for (DirectionalLight& light : m_lightManager->getAllDirLights())
+					light.setDepthAnchor(m_cameraManager->getCamera());
+			});
 
-		if (m_lightManager)
-		{
-			// Set depth anchors and apply them to the GPU before rendering all the stuff
-			for (DirectionalLight& light : m_lightManager->getAllDirLights())
-				light.setDepthAnchor(m_cameraManager->getCamera());
+		m_updateGraph.addTask("ParticleSimulation", INSTANCE_TABLE, EMITTERS, [this]()
+			{
+				if (m_particleSystem)
+					m_particleSystem->update(m_frameTimestep, m_cameraManager->getCamera().getPosition());
+			});
 
-			m_lightManager->update();
-		}
+		m_updateGraph.addTask("DecalUpload", INSTANCE_TABLE, DECAL_BUFFER | GPU_CONTEXT, [this]()
+			{
+				if (m_instanceTable && m_decalManager)
+					m_decalManager->update();
+			});
+
+		m_updateGraph.addTask("ParticleUpload", INSTANCE_TABLE | EMITTERS, GPU_CONTEXT, [this]()
+			{
+				if (m_particleSystem)
+					m_particleSystem->updateBuffers();
+			});
+
+		m_updateGraph.addTask("LightUpload", INSTANCE_TABLE | LIGHTS, GPU_CONTEXT, [this]()
+			{
+				if (m_lightManager)
+					m_lightManager->update();
+			});
+	}
+
+	void SceneRenderer::update(float timestep) noexcept
+	{
+		ENGI_ASSERT(m_dissolutionTexture && "Set a dissolution texture, please");
+		ENGI_ASSERT(m_cameraManager && "We do not update without a camera");
+		
+		m_frameTimestep = timestep;
+		m_time += timestep;
+		m_updateGraph.execute();
 	}
 
 	void SceneRenderer::render(bool debugPass) noexcept
@@ -227,16 +266,19 @@ namespace engi
 
 		this->setSamplers();
 		this->setSceneConstant();
+		m_meshManager->resetUploadStatistics();
 
 		LightManager* lightManager = this->getLightManager();
 		if (lightManager->isShadowmappingEnabled())
 		{
+			// Shadow casters might be outside of the camera frustum, each light culls them against its own volume
 			this->renderShadowsForDirectionalLight();
 			this->renderShadowsForSpotLights();
 			this->renderShadowsForPointLights();
 		}
 
 		// Main shading stage
+		m_meshManager->setCullingFrustum(m_cameraManager->getCamera().getFrustum());
 		this->deferredPass();
 		this->forwardPass();
 
@@ -291,7 +333,7 @@ namespace engi
 
 		LightManager* lightManager = this->getLightManager();
 		SceneConstant sceneConstant;
-		sceneConstant.time = Timer::getTime();
+		sceneConstant.time = getTime();
 		sceneConstant.timestep = m_frameTimestep;
 		sceneConstant.dissolutionTime = this->getDissolutionTime();
 		sceneConstant.numDirLights = lightManager->getNumDirLights();
@@ -324,6 +366,7 @@ namespace engi
 			view.viewsInv[0] = light.getView().inverse();
 			view.proj = light.getProjection();
 			this->setViewConstant(view);
+			m_meshManager->setCullingFrustum(math::Frustum::fromMatrix(view.views[0] * view.proj));
 
 			uint32_t width = dirDepthmapArray->getWidth();
 			uint32_t height = dirDepthmapArray->getHeight();
@@ -355,6 +398,13 @@ namespace engi
 				view.views[i] = light.getView(i);
 			}
 			this->setViewConstant(view);
+
+			// Casters are culled by the shadow range and get a mask of cube faces they are visible from, other faces are skipped by the geometry shader
+			std::array<math::Frustum, 6> faces;
+			for (uint32_t i = 0; i < 6; ++i)
+				faces[i] = math::Frustum::fromMatrix(view.views[i] * view.proj);
+
+			m_meshManager->setCullingVolume(CullingVolume::fromCube(light.getPosition(), PointLight::SHADOW_RANGE, faces));
 			
 			uint32_t width = pointDepthmapArray->getWidth();
 			uint32_t height = pointDepthmapArray->getHeight();
@@ -382,6 +432,9 @@ namespace engi
 			view.proj = light.getProjection();
 			this->setViewConstant(view);
 
+			// Perspective frustum of the spot light encloses its cone
+			m_meshManager->setCullingFrustum(math::Frustum::fromMatrix(view.views[0] * view.proj));
+
 			uint32_t width = spotDepthmapArray->getWidth();
 			uint32_t height = spotDepthmapArray->getHeight();
 
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "Utility/Memory.h"
+#include "Utility/TaskGraph.h"
 #include "World/ParticleSystem/ParticleSystem.h"
 #include "World/LightSystem/LightManager.h"
 #include "World/ModelInstanceRegistry.h"
@@ -50,6 +51,12 @@ namespace engi
 		inline constexpr float getDissolutionTime() const noexcept { return m_dissolutionTime; }
 		inline constexpr float getIncinerationTime() const noexcept { return m_incinerationTime; }
 
+		// Sum of all update timesteps, it is the g_time of shaders. Instance time is derived from it with InstanceData::getTime()
+		inline constexpr float getTime() const noexcept { return static_cast<float>(m_time); }
+
+		// Stages of SceneRenderer::update with their timings from the last frame
+		inline const TaskGraph& getUpdateGraph() const noexcept { return m_updateGraph; }
+
 		inline bool& isIBLEnabled() noexcept { return m_reflectionCapture->shouldUseIBL(); }
 
 		inline Skybox* getSkybox() noexcept { return m_skybox.get(); }
@@ -63,6 +70,7 @@ namespace engi
 
 	private:
 		bool initSamplers() noexcept;
+		void initUpdateGraph() noexcept;
 
 		void setSamplers() noexcept;
 		void setSceneConstant() noexcept;
@@ -81,6 +89,8 @@ namespace engi
 		CameraManager* m_cameraManager = nullptr;
 		
 		float m_frameTimestep = 0.0f;
+		double m_time = 0.0; // a float sum drops more and more of every small timestep as it grows
+		TaskGraph m_updateGraph;
 		UniqueHandle<ParticleSystem> m_particleSystem;
 		UniqueHandle<LightManager> m_lightManager;
 
@@ -0,0 +1,498 @@
+#include "EngineBenchmarks.h"
+
+#include <chrono>
+#include <filesystem>
+#include <cmath>
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <algorithm>
+#include "Core/Logger.h"
+#include "Utility/JobSystem.h"
+#include "Utility/Parallel.h"
+#include "Renderer/Renderer.h"
+#include "Renderer/Model.h"
+#include "Renderer/ModelLoader.h"
+#include "Renderer/MaterialRegistry.h"
+#include "Renderer/StaticMeshBVH.h"
+#include "Renderer/MeshCache.h"
+#include "Math/TrianglePacket.h"
+#include "EngineTests.h"
+
+using namespace engi;
+
+namespace
+{
+
+	using Clock = std::chrono::steady_clock;
+
+	// Returns the fastest of numRuns runs in milliseconds, the fastest run is the least disturbed by the OS
+	template<typename Func>
+	double measureMilliseconds(uint32_t numRuns, Func&& func)
+	{
+		double best = 0.0;
+		for (uint32_t run = 0; run < numRuns; ++run)
+		{
+			Clock::time_point start = Clock::now();
+			func();
+			double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			best = (run == 0 || elapsed < best) ? elapsed : best;
+		}
+		return best;
+	}
+
+	// Reference executor that has the design of the ParallelExecutor that JobSystem replaced: persistent threads, a single dispatch
+	// in flight, tasks type-erased through std::function and batches taken from one global atomic counter. Caller only waits
+	class SharedCounterExecutor
+	{
+	public:
+		using execution_func_type = std::function<void(uint32_t, uint32_t)>;
+
+		SharedCounterExecutor(uint32_t numThreads)
+		{
+			for (uint32_t i = 0; i < numThreads; ++i)
+				m_threads.emplace_back([this, i]() { workLoop(i); });
+		}
+
+		~SharedCounterExecutor()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_isLooping = false;
+				++m_generation;
+			}
+			m_workCV.notify_all();
+			for (std::thread& thread : m_threads)
+				thread.join();
+		}
+
+		void execute(const execution_func_type& func, uint32_t numTasks, uint32_t tasksPerBatch)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_func = &func;
+				m_numTasks = numTasks;
+				m_tasksPerBatch = tasksPerBatch;
+				m_nextBatch = 0;
+				m_numFinished = 0;
+				++m_generation;
+			}
+			m_workCV.notify_all();
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_doneCV.wait(lock, [this]() { return m_numFinished == m_threads.size(); });
+		}
+
+	private:
+		void workLoop(uint32_t threadIndex)
+		{
+			uint64_t generation = 0;
+			while (true)
+			{
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_workCV.wait(lock, [&]() { return m_generation != generation; });
+					generation = m_generation;
+					if (!m_isLooping)
+						return;
+				}
+
+				uint32_t numBatches = (m_numTasks + m_tasksPerBatch - 1) / m_tasksPerBatch;
+				while (true)
+				{
+					uint32_t batchIndex = m_nextBatch.fetch_add(1);
+					if (batchIndex >= numBatches)
+						break;
+
+					uint32_t begin = batchIndex * m_tasksPerBatch;
+					uint32_t end = std::min(begin + m_tasksPerBatch, m_numTasks);
+					for (uint32_t taskIndex = begin; taskIndex < end; ++taskIndex)
+						std::invoke(*m_func, threadIndex, taskIndex);
+				}
+
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					++m_numFinished;
+				}
+				m_doneCV.notify_one();
+			}
+		}
+
+		std::vector<std::thread> m_threads;
+		std::mutex m_mutex;
+		std::condition_variable m_workCV;
+		std::condition_variable m_doneCV;
+		bool m_isLooping = true;
+		uint64_t m_generation = 0;
+		size_t m_numFinished = 0;
+
+		const execution_func_type* m_func = nullptr;
+		uint32_t m_numTasks = 0;
+		uint32_t m_tasksPerBatch = 1;
+		std::atomic<uint32_t> m_nextBatch = 0;
+	};
+
+	// Task of a configurable cost that cannot be optimized away
+	float computeTask(uint32_t taskIndex, uint32_t numIterations) noexcept
+	{
+		float value = static_cast<float>(taskIndex);
+		for (uint32_t i = 0; i < numIterations; ++i)
+			value = std::sqrt(value + static_cast<float>(i));
+		return value;
+	}
+
+	ParsedModelInfo* loadBundledModel(Renderer* renderer, const std::string& filename) noexcept
+	{
+		std::string filepath = GetBundledModelPath(filename);
+		SharedHandle<Material> material = renderer->getMaterialRegistry()->getMaterial(MATERIAL_BRDF_PBR);
+		ParsedModelInfo* info = renderer->getModelLoader()->loadFromFBX(filepath, filename, material);
+		if (!info)
+			ENGI_LOG_ERROR("Failed to load the {} model", filepath);
+
+		return info;
+	}
+
+	// Rays start on a sphere around the box and aim at random points inside of it, so that most of them hit the mesh
+	std::vector<math::Ray> generateRays(const math::AABB& aabb, uint32_t numRays, uint32_t seed) noexcept
+	{
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		math::Vec3 center = (aabb.min + aabb.max) * 0.5f;
+		float radius = (aabb.max - aabb.min).length();
+
+		std::vector<math::Ray> rays;
+		rays.reserve(numRays);
+		for (uint32_t i = 0; i < numRays; ++i)
+		{
+			math::Vec3 direction(unit(generator) * 2.0f - 1.0f, unit(generator) * 2.0f - 1.0f, unit(generator) * 2.0f - 1.0f);
+			if (direction.length() < 0.001f)
+				direction = math::Vec3(0.0f, 0.0f, 1.0f);
+
+			direction.normalize();
+			math::Vec3 target = aabb.min + (aabb.max - aabb.min) * math::Vec3(unit(generator), unit(generator), unit(generator));
+			math::Vec3 origin = center + direction * radius;
+			rays.emplace_back(origin, target - origin);
+		}
+		return rays;
+	}
+
+	// Closest hit over every triangle of the mesh, infinity if none was hit
+	float intersectBruteForce(const StaticMesh& mesh, const math::Ray& ray) noexcept
+	{
+		const StaticMesh::VertexContainerType& vertices = mesh.getVertices();
+		float closest = math::Numeric::infinity();
+		for (const StaticMeshTriangle& triangle : mesh.getTriangles())
+		{
+			float t;
+			if (ray.intersects(vertices[triangle.indices[0]].position, vertices[triangle.indices[1]].position, vertices[triangle.indices[2]].position, &t) && t < closest)
+				closest = t;
+		}
+		return closest;
+	}
+
+}; // anonymous namespace
+
+void BenchmarkJobSystem() noexcept
+{
+	struct Workload
+	{
+		const char* name;
+		uint32_t numTasks;
+		uint32_t tasksPerBatch;
+		uint32_t numIterations; // cost of a single task
+	};
+
+	static constexpr Workload workloads[] = {
+		Workload{ "fine-grained", 1u << 20, 64, 4 },
+		Workload{ "coarse-grained", 512, 1, 20000 },
+	};
+
+	JobSystem& jobSystem = JobSystem::get();
+	SharedCounterExecutor executor(jobSystem.numThreads());
+	for (const Workload& workload : workloads)
+	{
+		std::vector<float> results(workload.numTasks);
+		auto task = [&](uint32_t, uint32_t taskIndex) { results[taskIndex] = computeTask(taskIndex, workload.numIterations); };
+
+		double serialTime = measureMilliseconds(5, [&]()
+			{
+				for (uint32_t taskIndex = 0; taskIndex < workload.numTasks; ++taskIndex)
+					task(0, taskIndex);
+			});
+
+		SharedCounterExecutor::execution_func_type erasedTask = task;
+		double executorTime = measureMilliseconds(5, [&]() { executor.execute(erasedTask, workload.numTasks, workload.tasksPerBatch); });
+
+		double jobSystemTime = measureMilliseconds(5, [&]()
+			{
+				JobCounter counter;
+				jobSystem.dispatch(counter, workload.numTasks, workload.tasksPerBatch, task);
+				jobSystem.wait(counter);
+			});
+
+		ENGI_LOG_INFO("JobSystem benchmark ({}, {} tasks, {} threads): serial {:.3f} ms, shared counter executor {:.3f} ms, job system {:.3f} ms ({:.2f}x)",
+			workload.name, workload.numTasks, jobSystem.numThreads(), serialTime, executorTime, jobSystemTime, executorTime / jobSystemTime);
+	}
+}
+
+void BenchmarkParallelPrimitives(uint32_t numElements) noexcept
+{
+	std::vector<float> input(numElements);
+	std::vector<float> output(numElements);
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> distribution(0.0f, 100.0f);
+	for (float& value : input)
+		value = distribution(generator);
+
+	auto transform = [&](uint32_t i) { output[i] = std::sqrt(input[i]) * 0.5f + std::sin(input[i]); };
+	double serialTransform = measureMilliseconds(5, [&]()
+		{
+			for (uint32_t i = 0; i < numElements; ++i)
+				transform(i);
+		});
+	double parallelTransform = measureMilliseconds(5, [&]() { parallelFor(0, numElements, transform); });
+
+	// Reduction over doubles, so that the difference between serial and parallel results only comes from the order of operations
+	auto element = [&](uint32_t i) -> double { return static_cast<double>(input[i]); };
+	auto sum = [](double a, double b) -> double { return a + b; };
+	double serialResult = 0.0;
+	double parallelResult = 0.0;
+	double serialReduce = measureMilliseconds(5, [&]()
+		{
+			serialResult = 0.0;
+			for (uint32_t i = 0; i < numElements; ++i)
+				serialResult += element(i);
+		});
+	double parallelReduceTime = measureMilliseconds(5, [&]() { parallelResult = parallelReduce(0u, numElements, 0.0, element, sum); });
+
+	double serialSort = measureMilliseconds(3, [&]()
+		{
+			output = input;
+			std::sort(output.begin(), output.end());
+		});
+	double parallelSortTime = measureMilliseconds(3, [&]()
+		{
+			output = input;
+			parallelSort(ArrayView<float>(output));
+		});
+	bool isSorted = std::is_sorted(output.begin(), output.end());
+
+	ENGI_LOG_INFO("Parallel primitives benchmark ({} elements, {} threads)", numElements, JobSystem::get().numThreads());
+	ENGI_LOG_INFO("  transform: serial {:.3f} ms, parallelFor {:.3f} ms ({:.2f}x)", serialTransform, parallelTransform, serialTransform / parallelTransform);
+	ENGI_LOG_INFO("  reduce: serial {:.3f} ms, parallelReduce {:.3f} ms ({:.2f}x), results {} and {}",
+		serialReduce, parallelReduceTime, serialReduce / parallelReduceTime, serialResult, parallelResult);
+	ENGI_LOG_INFO("  sort: std::sort {:.3f} ms, parallelSort {:.3f} ms ({:.2f}x), sorted {}", serialSort, parallelSortTime, serialSort / parallelSortTime, isSorted);
+}
+
+void BenchmarkMeshBVH() noexcept
+{
+	static constexpr uint32_t numRays = 100000;
+	static constexpr uint32_t numBruteForceRays = 500; // brute force is only run on a subset, it is too slow otherwise
+
+	UniqueHandle<Renderer> renderer = CreateHeadlessRenderer();
+	if (!renderer)
+		return;
+
+	for (const char* filename : { "Samurai/Samurai.fbx", "Knight/Knight.fbx" })
+	{
+		ParsedModelInfo* info = loadBundledModel(renderer.get(), filename);
+		if (!info)
+			continue;
+
+		uint32_t numTriangles = 0;
+		uint32_t numMismatches = 0;
+		double buildTime = 0.0;
+		double queryTime = 0.0;
+		double bruteForceTime = 0.0;
+		for (const StaticMeshEntry& entry : info->model->getStaticMeshEntries())
+		{
+			const StaticMesh& mesh = entry.mesh;
+			numTriangles += mesh.getNumTriangles();
+
+			StaticMeshBVH bvh;
+			buildTime += measureMilliseconds(3, [&]() { bvh = StaticMeshBVH(); bvh.initialize(&mesh); });
+
+			std::vector<math::Ray> rays = generateRays(mesh.getAABB(), numRays, 1337);
+			std::vector<float> hits(numRays);
+			queryTime += measureMilliseconds(3, [&]()
+				{
+					for (uint32_t i = 0; i < numRays; ++i)
+						hits[i] = bvh.intersect(rays[i]).t;
+				});
+
+			std::vector<float> referenceHits(numBruteForceRays);
+			bruteForceTime += measureMilliseconds(1, [&]()
+				{
+					for (uint32_t i = 0; i < numBruteForceRays; ++i)
+						referenceHits[i] = intersectBruteForce(mesh, rays[i]);
+				});
+
+			for (uint32_t i = 0; i < numBruteForceRays; ++i)
+			{
+				bool isHit = math::Numeric::isFinite(hits[i]);
+				bool isReferenceHit = math::Numeric::isFinite(referenceHits[i]);
+				if (isHit != isReferenceHit || (isHit && std::abs(hits[i] - referenceHits[i]) > 1e-3f * std::max(1.0f, referenceHits[i])))
+					++numMismatches;
+			}
+		}
+
+		// Every ray is tested against every mesh of the model, as picking does
+		uint32_t numMeshes = static_cast<uint32_t>(info->model->getStaticMeshEntries().size());
+		double queryPerRay = queryTime * 1000.0 / numRays;
+		double bruteForcePerRay = bruteForceTime * 1000.0 / numBruteForceRays;
+		ENGI_LOG_INFO("Mesh BVH benchmark ({}, {} meshes, {} triangles): build {:.3f} ms, {:.3f} us per ray with BVH, {:.3f} us per ray with brute force ({:.1f}x), {} mismatches",
+			filename, numMeshes, numTriangles, buildTime, queryPerRay, bruteForcePerRay, bruteForcePerRay / queryPerRay, numMismatches);
+	}
+}
+
+void BenchmarkRayKernels() noexcept
+{
+	static constexpr uint32_t numTriangles = 1u << 14; // multiple of every packet width
+	static constexpr uint32_t numBoxes = 1u << 14;
+	static constexpr uint32_t numRays = 256;
+	using TrianglePacket = math::TrianglePacketN;
+
+	// Small triangles and boxes scattered in a unit cube, rays cross the cube in random directions
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	auto randomPoint = [&]() { return math::Vec3(unit(generator), unit(generator), unit(generator)); };
+
+	std::vector<math::Vec3> vertices(numTriangles * 3);
+	std::vector<TrianglePacket> packets(numTriangles / TrianglePacket::WIDTH);
+	for (uint32_t i = 0; i < numTriangles; ++i)
+	{
+		math::Vec3 base = randomPoint();
+		vertices[i * 3 + 0] = base;
+		vertices[i * 3 + 1] = base + randomPoint() * 0.1f;
+		vertices[i * 3 + 2] = base + randomPoint() * 0.1f;
+		packets[i / TrianglePacket::WIDTH].set(i % TrianglePacket::WIDTH, vertices[i * 3 + 0], vertices[i * 3 + 1], vertices[i * 3 + 2]);
+	}
+
+	// SIMD slab test reads 4 floats of both corners
+	std::vector<math::AABB> boxes(numBoxes);
+	std::vector<std::array<float, 8>> simdBoxes(numBoxes);
+	for (uint32_t i = 0; i < numBoxes; ++i)
+	{
+		math::Vec3 min = randomPoint();
+		math::Vec3 max = min + randomPoint() * 0.05f;
+		boxes[i] = math::AABB(min, max);
+		simdBoxes[i] = { min.x, min.y, min.z, 0.0f, max.x, max.y, max.z, 0.0f };
+	}
+
+	std::vector<math::Ray> rays;
+	rays.reserve(numRays);
+	for (uint32_t i = 0; i < numRays; ++i)
+		rays.emplace_back(randomPoint() - math::Vec3(0.5f), randomPoint() - math::Vec3(0.5f));
+
+	// Hits are accumulated, so that none of the loops can be optimized away
+	uint32_t scalarTriangleHits = 0;
+	double scalarTriangles = measureMilliseconds(3, [&]()
+		{
+			scalarTriangleHits = 0;
+			for (const math::Ray& ray : rays)
+			{
+				for (uint32_t i = 0; i < numTriangles; ++i)
+				{
+					float t;
+					scalarTriangleHits += ray.intersects(vertices[i * 3 + 0], vertices[i * 3 + 1], vertices[i * 3 + 2], &t) ? 1 : 0;
+				}
+			}
+		});
+
+	// Packet kernel only keeps the closest hit, thus the closest distance is reset before every packet to count every hit
+	uint32_t packetTriangleHits = 0;
+	double packetTriangles = measureMilliseconds(3, [&]()
+		{
+			packetTriangleHits = 0;
+			for (const math::Ray& ray : rays)
+			{
+				math::RayPacketN rayPacket(ray);
+				for (const TrianglePacket& packet : packets)
+				{
+					math::TriangleHit hit;
+					packetTriangleHits += math::intersects(rayPacket, packet, hit) ? 1 : 0;
+				}
+			}
+		});
+
+	uint32_t scalarBoxHits = 0;
+	double scalarBoxTime = measureMilliseconds(3, [&]()
+		{
+			scalarBoxHits = 0;
+			for (const math::Ray& ray : rays)
+			{
+				for (const math::AABB& box : boxes)
+				{
+					float t;
+					scalarBoxHits += ray.intersects(box, &t) ? 1 : 0;
+				}
+			}
+		});
+
+	uint32_t simdBoxHits = 0;
+	double simdBoxTime = measureMilliseconds(3, [&]()
+		{
+			simdBoxHits = 0;
+			for (const math::Ray& ray : rays)
+			{
+				math::RaySSE raySSE(ray);
+				for (const std::array<float, 8>& box : simdBoxes)
+					simdBoxHits += math::Numeric::isFinite(math::intersectBox(raySSE, box.data(), box.data() + 4, math::Numeric::infinity())) ? 1 : 0;
+			}
+		});
+
+	double numTriangleTests = static_cast<double>(numRays) * numTriangles;
+	double numBoxTests = static_cast<double>(numRays) * numBoxes;
+	ENGI_LOG_INFO("Ray kernels benchmark ({} rays, {} triangles, {} boxes, packet width {})", numRays, numTriangles, numBoxes, TrianglePacket::WIDTH);
+	ENGI_LOG_INFO("  triangle: scalar {:.2f} ns, packet {:.2f} ns per triangle ({} and {} packets hit)",
+		scalarTriangles * 1e6 / numTriangleTests, packetTriangles * 1e6 / numTriangleTests, scalarTriangleHits, packetTriangleHits);
+	ENGI_LOG_INFO("  box: scalar {:.2f} ns, SSE {:.2f} ns per box ({} and {} hits)",
+		scalarBoxTime * 1e6 / numBoxTests, simdBoxTime * 1e6 / numBoxTests, scalarBoxHits, simdBoxHits);
+}
+
+void BenchmarkMeshCache() noexcept
+{
+	for (const char* filename : { "Samurai/Samurai.fbx", "Knight/Knight.fbx" })
+	{
+		std::filesystem::path sourcePath = GetBundledModelPath(filename);
+		std::filesystem::path cookedPath = MeshCache::getCookedPath(sourcePath);
+
+		// Every load goes through a new renderer, so that the model loader has not seen the model yet. Texture loading is included in every case
+		auto timeLoad = [&]() -> double
+			{
+				UniqueHandle<Renderer> renderer = CreateHeadlessRenderer();
+				if (!renderer)
+					return 0.0;
+
+				ParsedModelInfo* info = nullptr;
+				double time = measureMilliseconds(1, [&]() { info = loadBundledModel(renderer.get(), filename); });
+				return info ? time : 0.0;
+			};
+
+		// The cooked file is removed to force an Assimp import, which writes it again
+		std::error_code error;
+		std::filesystem::remove(cookedPath, error);
+		double assimpTime = timeLoad();
+		if (!std::filesystem::exists(cookedPath))
+		{
+			ENGI_LOG_ERROR("Mesh cache benchmark: the {} model was not cooked", filename);
+			continue;
+		}
+
+		double coldTime = timeLoad();
+		double warmTime = timeLoad();
+
+		CookedModel cookedModel;
+		double cacheOnlyTime = measureMilliseconds(5, [&]() { cookedModel = CookedModel(); MeshCache::load(sourcePath, cookedModel); });
+
+		ENGI_LOG_INFO("Mesh cache benchmark ({}, {} KB cooked): Assimp {:.2f} ms, first cooked load {:.2f} ms, second cooked load {:.2f} ms, MeshCache::load alone {:.2f} ms",
+			filename, std::filesystem::file_size(cookedPath, error) / 1024, assimpTime, coldTime, warmTime, cacheOnlyTime);
+	}
+}
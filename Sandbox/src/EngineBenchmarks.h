@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+// Benchmarks of engine subsystems against simple reference implementations. Results are only logged,
+// each benchmark is meant to be called from engi::Main before the application is initialized
+
+// Throughput of the JobSystem against an executor with a single global batch counter and std::function tasks
+void BenchmarkJobSystem() noexcept;
+
+// parallelFor, parallelReduce and parallelSort against their serial counterparts on arrays of numElements elements
+void BenchmarkParallelPrimitives(uint32_t numElements) noexcept;
+
+// Build and query time of StaticMeshBVH on the meshes of the bundled Samurai and Knight models, queries are compared to a brute-force loop
+void BenchmarkMeshBVH() noexcept;
+
+// Cost of a single ray-triangle and ray-box test of the scalar Ray functions and of the SIMD packet kernels
+void BenchmarkRayKernels() noexcept;
+
+// Load time of the bundled models through Assimp and through the cooked mesh cache. The cooked file is written right before it is loaded,
+// thus loads from a cold OS file cache are not covered
+void BenchmarkMeshCache() noexcept;
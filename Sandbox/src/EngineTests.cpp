@@ -0,0 +1,1064 @@
+#include "EngineTests.h"
+
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <filesystem>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <cmath>
+#include <random>
+#include <span>
+#include "Core/Logger.h"
+#include "Core/FileSystem.h"
+#include "GFX/Definitions.h"
+#include "GFX/Null/Null_Device.h"
+#include "GFX/Null/Null_Resources.h"
+#include "GFX/GPUBuffer.h"
+#include "GFX/GPUSampler.h"
+#include "GFX/GPUDescriptor.h"
+#include "Utility/Memory.h"
+#include "Utility/ArrayView.h"
+#include "Utility/OffsetAllocator.h"
+#include "Math/TrianglePacket.h"
+#include "Renderer/Renderer.h"
+#include "Renderer/Model.h"
+#include "Renderer/ModelRegistry.h"
+#include "Renderer/MaterialRegistry.h"
+#include "Renderer/MeshManager.h"
+#include "Renderer/InstanceTable.h"
+#include "Renderer/InstanceData.h"
+#include "Renderer/InstanceGroup.h"
+#include "Renderer/ModelLoader.h"
+#include "Renderer/MeshCache.h"
+#include "Renderer/ShaderBytecodeCache.h"
+#include "Renderer/GeometryPool.h"
+
+using namespace engi;
+
+// Expects a local bool passed in the calling function
+#define SANDBOX_CHECK(expr) do { if (!(expr)) { ENGI_LOG_ERROR("{} (line {}): check failed: {}", __func__, __LINE__, #expr); passed = false; } } while (false)
+
+namespace
+{
+
+	gfx::NullDevice* getNullDevice(Renderer* renderer) noexcept
+	{
+		return static_cast<gfx::NullDevice*>(renderer->getDevice());
+	}
+
+	// Renders a frame of the mesh manager and returns the number of bytes that reached the device
+	uint64_t renderFrame(MeshManager& meshManager, gfx::NullDevice* device) noexcept
+	{
+		uint64_t bytesBefore = device->getStats().bytesUploaded;
+		meshManager.resetUploadStatistics();
+		meshManager.requestBufferUpdate();
+		meshManager.render();
+		return device->getStats().bytesUploaded - bytesBefore;
+	}
+
+	// Instances on a line along the X axis. Mesh managers of the tests have no culling volume, thus all of them are visible
+	std::vector<uint32_t> addLineOfInstances(InstanceTable& instanceTable, uint32_t numInstances, InstanceMobility mobility = INSTANCE_MOBILITY_STATIC) noexcept
+	{
+		std::vector<uint32_t> ids;
+		ids.reserve(numInstances);
+		for (uint32_t i = 0; i < numInstances; ++i)
+		{
+			math::Transformation transform(math::Vec3(i * 2.0f, 0.0f, 0.0f), math::Vec3(), math::Vec3(1.0f));
+			ids.push_back(instanceTable.addInstanceData(InstanceData(transform), mobility));
+		}
+		return ids;
+	}
+
+	template<typename T>
+	bool isBitwiseEqual(const std::vector<T>& a, const std::vector<T>& b) noexcept
+	{
+		return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+	}
+
+	// Imports the model with Assimp on a new renderer, as its cooked file is removed first
+	SharedHandle<Model> importBundledModel(UniqueHandle<Renderer>& renderer, const char* filename) noexcept
+	{
+		renderer = CreateHeadlessRenderer();
+		if (!renderer)
+			return nullptr;
+
+		std::error_code error;
+		std::filesystem::remove(MeshCache::getCookedPath(GetBundledModelPath(filename)), error);
+		SharedHandle<Material> material = renderer->getMaterialRegistry()->getMaterial(MATERIAL_BRDF_PBR);
+		ParsedModelInfo* info = renderer->getModelLoader()->loadFromFBX(GetBundledModelPath(filename), filename, material);
+		return info ? info->model : nullptr;
+	}
+
+	bool writeTextFile(const std::filesystem::path& filepath, std::string_view contents) noexcept
+	{
+		std::ofstream stream(filepath, std::ios::binary | std::ios::trunc);
+		return stream && stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+	}
+
+}; // anonymous namespace
+
+UniqueHandle<Renderer> CreateHeadlessRenderer() noexcept
+{
+	UniqueHandle<Renderer> renderer = makeUnique<Renderer>(new Renderer());
+	if (!renderer->init(nullptr, 800, 600, gfx::GPU_BACKEND_NULL))
+	{
+		ENGI_LOG_ERROR("Failed to initialize a headless renderer");
+		return nullptr;
+	}
+	return renderer;
+}
+
+std::string GetBundledModelPath(const std::string& filename) noexcept
+{
+	return (FileSystem::getInstance().getAssetsPath() / "Models" / filename).string();
+}
+
+bool TestInstanceUploads() noexcept
+{
+	UniqueHandle<Renderer> renderer = CreateHeadlessRenderer();
+	if (!renderer)
+		return false;
+
+	bool passed = true;
+	gfx::NullDevice* device = getNullDevice(renderer.get());
+	InstanceTable instanceTable;
+	MeshManager meshManager(renderer.get(), &instanceTable);
+	SANDBOX_CHECK(meshManager.init());
+
+	static constexpr uint32_t numInstances = 100;
+	SharedHandle<Model> cube = renderer->getModelRegistry()->getModel(MODEL_TYPE_CUBE);
+	MaterialInstance material("TestInstanceUploads", renderer->getMaterialRegistry()->getMaterial(MATERIAL_BRDF_PBR));
+	std::vector<uint32_t> ids = addLineOfInstances(instanceTable, numInstances);
+	SANDBOX_CHECK(meshManager.submitInstances(cube, 0, material, viewOf(ids.data(), ids.size())));
+
+	// Every instance is new, thus the whole layout is uploaded
+	uint64_t firstFrameBytes = renderFrame(meshManager, device);
+	SANDBOX_CHECK(meshManager.getNumUploadedBytes() >= numInstances * sizeof(GpuInstanceData));
+	SANDBOX_CHECK(firstFrameBytes >= meshManager.getNumUploadedBytes());
+	SANDBOX_CHECK(!instanceTable.hasDirtyData());
+
+	uint64_t idleFrameBytes = renderFrame(meshManager, device);
+	SANDBOX_CHECK(meshManager.getNumUploadedBytes() == 0);
+	SANDBOX_CHECK(idleFrameBytes == 0);
+
+	// Moving a static instance reuploads its slot of the transform stream only, animation data has not changed
+	math::Transformation moved(math::Vec3(0.0f, 5.0f, 0.0f), math::Vec3(), math::Vec3(1.0f));
+	instanceTable.getInstanceData(ids[numInstances / 2]).modelToWorld = InstanceData(moved).modelToWorld;
+	uint64_t movedFrameBytes = renderFrame(meshManager, device);
+	SANDBOX_CHECK(meshManager.getNumUploadedBytes() == sizeof(GpuInstanceData));
+	SANDBOX_CHECK(movedFrameBytes == sizeof(GpuInstanceData));
+
+	// Touching an instance without changing it marks it as dirty, but the mirror of the buffer filters it out
+	instanceTable.getInstanceData(ids[0]);
+	SANDBOX_CHECK(renderFrame(meshManager, device) == 0);
+
+	ENGI_LOG_INFO("TestInstanceUploads {}: first frame {} bytes, idle frame {} bytes, single moved instance {} bytes",
+		passed ? "passed" : "failed", firstFrameBytes, idleFrameBytes, movedFrameBytes);
+	return passed;
+}
+
+bool TestAsyncModelLoading() noexcept
+{
+	UniqueHandle<Renderer> renderer = CreateHeadlessRenderer();
+	if (!renderer)
+		return false;
+
+	bool passed = true;
+	ModelLoader* modelLoader = renderer->getModelLoader();
+	SharedHandle<Material> material = renderer->getMaterialRegistry()->getMaterial(MATERIAL_BRDF_PBR);
+	static constexpr const char* filenames[] = { "Samurai/Samurai.fbx", "Knight/Knight.fbx", "KnightHorse/KnightHorse.fbx", "EastTower/EastTower.fbx" };
+
+	std::vector<ModelLoadHandle> handles;
+	for (const char* filename : filenames)
+	{
+		std::error_code error;
+		std::filesystem::remove(MeshCache::getCookedPath(GetBundledModelPath(filename)), error);
+		handles.push_back(modelLoader->loadModelAsync(GetBundledModelPath(filename), filename, material));
+	}
+
+	// Model that is in flight is not requested twice
+	ModelLoadHandle duplicate = modelLoader->loadModelAsync(GetBundledModelPath(filenames[0]), filenames[0], material);
+	SANDBOX_CHECK(duplicate == handles[0]);
+
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point start = Clock::now();
+	auto isDone = [&handles]() { return std::ranges::all_of(handles, [](const ModelLoadHandle& handle) { return handle->isDone(); }); };
+	while (!isDone() && Clock::now() - start < std::chrono::seconds(120))
+	{
+		modelLoader->update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	std::chrono::duration<double, std::milli> loadTime = Clock::now() - start;
+
+	for (const ModelLoadHandle& handle : handles)
+	{
+		SANDBOX_CHECK(handle->isReady());
+		if (!handle->isReady())
+			continue;
+
+		ParsedModelInfo* info = handle->getResult();
+		SANDBOX_CHECK(info && info->model);
+		if (!info || !info->model)
+			continue;
+
+		SANDBOX_CHECK(info->model->isResident());
+		SANDBOX_CHECK(info->materials.size() == info->model->getNumStaticMeshes());
+		for (const StaticMeshEntry& entry : info->model->getStaticMeshEntries())
+			SANDBOX_CHECK(entry.isValid() && entry.bvh.isInitialized());
+
+		// Finished models are served from the loader right away, both synchronously and asynchronously
+		SANDBOX_CHECK(modelLoader->loadFromFBX(handle->getPath(), "", material) == info);
+		SANDBOX_CHECK(modelLoader->loadModelAsync(handle->getPath(), "", material)->getResult() == info);
+	}
+
+	ENGI_LOG_INFO("TestAsyncModelLoading {}: {} models loaded in {:.2f} ms", passed ? "passed" : "failed", handles.size(), loadTime.count());
+	return passed;
+}
+
+bool TestParallelImport() noexcept
+{
+	bool passed = true;
+	for (const char* filename : { "Samurai/Samurai.fbx", "EastTower/EastTower.fbx" })
+	{
+		UniqueHandle<Renderer> firstRenderer;
+		UniqueHandle<Renderer> secondRenderer;
+		SharedHandle<Model> first = importBundledModel(firstRenderer, filename);
+		SharedHandle<Model> second = importBundledModel(secondRenderer, filename);
+		SANDBOX_CHECK(first && second);
+		if (!first || !second)
+			continue;
+
+		// Ranges of the meshes follow each other in the order of the meshes
+		MeshRange expected = MeshRange{ 0, 0, 0, 0 };
+		for (const StaticMeshEntry& entry : first->getStaticMeshEntries())
+		{
+			const StaticMesh& mesh = entry.mesh;
+			SANDBOX_CHECK(entry.isValid());
+			SANDBOX_CHECK(entry.range.vboOffset == expected.vboOffset && entry.range.iboOffset == expected.iboOffset);
+			SANDBOX_CHECK(entry.range.numVertices == mesh.getNumVertices() && entry.range.numIndices == mesh.getNumTriangles() * 3);
+			expected.vboOffset += entry.range.numVertices;
+			expected.iboOffset += entry.range.numIndices;
+
+			bool isIndexValid = std::ranges::all_of(mesh.getTriangles(), [&mesh](const StaticMeshTriangle& triangle)
+				{
+					return std::ranges::all_of(triangle.indices, [&mesh](uint32_t index) { return index < mesh.getNumVertices(); });
+				});
+			SANDBOX_CHECK(isIndexValid);
+
+			// Every triangle ends up in exactly one leaf of the BVH
+			std::vector<uint32_t> numReferences(mesh.getNumTriangles(), 0);
+			for (uint32_t triangleIndex : entry.bvh.getPacketTriangleIndices())
+			{
+				if (triangleIndex != uint32_t(-1) && triangleIndex < numReferences.size())
+					++numReferences[triangleIndex];
+			}
+			SANDBOX_CHECK(std::ranges::all_of(numReferences, [](uint32_t n) { return n == 1; }));
+		}
+
+		const auto& firstEntries = first->getStaticMeshEntries();
+		const auto& secondEntries = second->getStaticMeshEntries();
+		SANDBOX_CHECK(firstEntries.size() == secondEntries.size());
+		for (size_t i = 0; i < std::min(firstEntries.size(), secondEntries.size()); ++i)
+		{
+			const StaticMeshEntry& a = firstEntries[i];
+			const StaticMeshEntry& b = secondEntries[i];
+			SANDBOX_CHECK(a.mesh.getName() == b.mesh.getName());
+			SANDBOX_CHECK(std::memcmp(&a.range, &b.range, sizeof(MeshRange)) == 0);
+			SANDBOX_CHECK(isBitwiseEqual(a.mesh.getVertices(), b.mesh.getVertices()));
+			SANDBOX_CHECK(isBitwiseEqual(a.mesh.getTriangles(), b.mesh.getTriangles()));
+			SANDBOX_CHECK(isBitwiseEqual(a.bvh.getNodes(), b.bvh.getNodes()));
+			SANDBOX_CHECK(isBitwiseEqual(a.bvh.getPacketTriangleIndices(), b.bvh.getPacketTriangleIndices()));
+		}
+
+		ENGI_LOG_INFO("TestParallelImport: {} has {} meshes, {} vertices and {} indices", filename, firstEntries.size(), expected.vboOffset, expected.iboOffset);
+	}
+
+	ENGI_LOG_INFO("TestParallelImport {}", passed ? "passed" : "failed");
+	return passed;
+}
+
+bool TestShaderBytecodeCache() noexcept
+{
+	bool passed = true;
+	std::filesystem::path folder = FileSystem::getInstance().getCachePath() / "ShaderBytecodeCacheTest";
+	std::error_code error;
+	std::filesystem::remove_all(folder, error);
+	std::filesystem::create_directories(folder / "Common", error);
+
+	// Main.hlsl -> Common/Common.hlsli -> Common/Lighting.hlsli, the last include is resolved relative to the including file
+	std::filesystem::path shaderPath = folder / "Main.hlsl";
+	std::filesystem::path lightingPath = folder / "Common" / "Lighting.hlsli";
+	bool isWritten = writeTextFile(shaderPath, "#include \"Common/Common.hlsli\"\nfloat4 main() : SV_TARGET { return shade(); }\n")
+		&& writeTextFile(folder / "Common" / "Common.hlsli", "  #  include <Lighting.hlsli>\n")
+		&& writeTextFile(lightingPath, "float4 shade() { return 1.0f; }\n");
+	SANDBOX_CHECK(isWritten);
+
+	// Stub compiler produces bytecode that depends on the key, as if the key was the whole input
+	uint32_t numCompilations = 0;
+	ShaderBytecodeCache cache(folder / "Blobs", 1);
+	auto compile = [&](ShaderBytecodeCache& bytecodeCache, const std::string& entrypoint, const std::string& target, uint32_t flags, uint64_t& key) -> std::vector<uint8_t>
+		{
+			std::vector<uint8_t> bytecode;
+			if (!bytecodeCache.computeKey(shaderPath, entrypoint, target, flags, key))
+				return bytecode;
+
+			if (bytecodeCache.load(key, bytecode))
+				return bytecode;
+
+			++numCompilations;
+			bytecode.resize(64);
+			for (size_t i = 0; i < bytecode.size(); ++i)
+				bytecode[i] = static_cast<uint8_t>(key >> ((i % 8) * 8));
+
+			bytecodeCache.store(key, bytecode.data(), bytecode.size());
+			return bytecode;
+		};
+
+	uint64_t key = 0;
+	std::vector<uint8_t> compiled = compile(cache, "main", "ps_5_0", 0, key);
+	SANDBOX_CHECK(!compiled.empty() && numCompilations == 1);
+	SANDBOX_CHECK(std::filesystem::exists(cache.getBlobPath(key)));
+
+	uint64_t cachedKey = 0;
+	std::vector<uint8_t> cached = compile(cache, "main", "ps_5_0", 0, cachedKey);
+	SANDBOX_CHECK(cachedKey == key && cached == compiled && numCompilations == 1);
+
+	// Every compile parameter is a part of the key
+	uint64_t otherKey = 0;
+	compile(cache, "mainAlt", "ps_5_0", 0, otherKey);
+	SANDBOX_CHECK(otherKey != key && numCompilations == 2);
+	compile(cache, "main", "vs_5_0", 0, otherKey);
+	SANDBOX_CHECK(otherKey != key && numCompilations == 3);
+	compile(cache, "main", "ps_5_0", 1, otherKey);
+	SANDBOX_CHECK(otherKey != key && numCompilations == 4);
+
+	ShaderBytecodeCache otherCompilerCache(folder / "Blobs", 2);
+	compile(otherCompilerCache, "main", "ps_5_0", 0, otherKey);
+	SANDBOX_CHECK(otherKey != key && numCompilations == 5);
+
+	// Editing a file that is only included transitively misses the cache, restoring it hits the old blob again
+	SANDBOX_CHECK(writeTextFile(lightingPath, "float4 shade() { return 0.5f; } // edited\n"));
+	compile(cache, "main", "ps_5_0", 0, otherKey);
+	SANDBOX_CHECK(otherKey != key && numCompilations == 6);
+	SANDBOX_CHECK(writeTextFile(lightingPath, "float4 shade() { return 1.0f; }\n"));
+	compile(cache, "main", "ps_5_0", 0, otherKey);
+	SANDBOX_CHECK(otherKey == key && numCompilations == 6);
+
+	// Corrupted blob fails the checksum and is recompiled
+	{
+		std::fstream stream(cache.getBlobPath(key), std::ios::binary | std::ios::in | std::ios::out | std::ios::ate);
+		stream.seekp(-1, std::ios::end);
+		stream.put('\x7f');
+	}
+	cached = compile(cache, "main", "ps_5_0", 0, cachedKey);
+	SANDBOX_CHECK(cached == compiled && numCompilations == 7);
+
+	// Missing include makes the shader uncacheable
+	std::filesystem::remove(lightingPath, error);
+	SANDBOX_CHECK(!cache.computeKey(shaderPath, "main", "ps_5_0", 0, otherKey));
+
+	std::vector<std::string> includes;
+	ShaderBytecodeCache::parseIncludes("#include \"A.hlsli\"\n\t# include <B.hlsli>\n#define X\n// #include \"C.hlsli\"\n#include D.hlsli\n", includes);
+	SANDBOX_CHECK((includes == std::vector<std::string>{ "A.hlsli", "B.hlsli" }));
+
+	std::filesystem::remove_all(folder, error);
+	ENGI_LOG_INFO("TestShaderBytecodeCache {}: {} stub compilations", passed ? "passed" : "failed", numCompilations);
+	return passed;
+}
+
+bool TestGpuStateCache() noexcept
+{
+	using namespace gfx;
+
+	bool passed = true;
+	NullDevice device;
+	device.setRecording(true);
+
+	GpuBufferDesc vertexDesc;
+	vertexDesc.bytes = 256;
+	vertexDesc.pipelineFlags = VERTEX_BUFFER;
+	GpuBufferDesc constantDesc;
+	constantDesc.bytes = 4 * CONSTANT_BUFFER_RANGE_ALIGNMENT;
+	constantDesc.pipelineFlags = CONSTANT_BUFFER;
+
+	IGpuBuffer* vertexBuffers[2] = { device.createBuffer("VertexBuffer0", vertexDesc, nullptr), device.createBuffer("VertexBuffer1", vertexDesc, nullptr) };
+	IGpuBuffer* constantBuffer = device.createBuffer("ConstantBuffer", constantDesc, nullptr);
+	IGpuSampler* sampler = device.createSampler("Sampler", GpuSamplerDesc());
+	IGpuDescriptor* srv = device.createSRV("SRV", GpuSrvDesc(), vertexBuffers[0]);
+	device.reset();
+
+	auto numRecorded = [&device](NullCommandType type) -> uint32_t
+		{
+			return static_cast<uint32_t>(std::ranges::count_if(device.getCommands(), [type](const NullCommand& command) { return command.type == type; }));
+		};
+
+	// Vertex buffers are compared with their stride and offset
+	device.setVertexBuffer(vertexBuffers[0], 0, 32, 0);
+	device.setVertexBuffer(vertexBuffers[0], 0, 32, 0);
+	SANDBOX_CHECK(numRecorded(NULL_COMMAND_SET_VERTEX_BUFFER) == 1);
+	device.setVertexBuffer(vertexBuffers[0], 0, 32, 64);
+	device.setVertexBuffer(vertexBuffers[1], 0, 32, 64);
+	device.setVertexBuffer(vertexBuffers[1], 1, 32, 64);
+	SANDBOX_CHECK(numRecorded(NULL_COMMAND_SET_VERTEX_BUFFER) == 4);
+
+	// Only the stages that do not have the buffer yet reach the backend
+	device.setConstantBuffer(constantBuffer, 0, VERTEX_SHADER | PIXEL_SHADER);
+	device.setConstantBuffer(constantBuffer, 0, PIXEL_SHADER);
+	device.setConstantBuffer(constantBuffer, 0, VERTEX_SHADER | PIXEL_SHADER | COMPUTE_SHADER);
+	SANDBOX_CHECK(numRecorded(NULL_COMMAND_SET_CONSTANT_BUFFER) == 2);
+	SANDBOX_CHECK(device.getCommands().back().args[1] == COMPUTE_SHADER);
+
+	// Ranges of the same buffer are different states, rebinding the whole buffer is not filtered out either
+	device.setConstantBufferRange(constantBuffer, 0, VERTEX_SHADER, CONSTANT_BUFFER_RANGE_ALIGNMENT, CONSTANT_BUFFER_RANGE_ALIGNMENT);
+	device.setConstantBufferRange(constantBuffer, 0, VERTEX_SHADER, CONSTANT_BUFFER_RANGE_ALIGNMENT, CONSTANT_BUFFER_RANGE_ALIGNMENT);
+	device.setConstantBufferRange(constantBuffer, 0, VERTEX_SHADER, 2 * CONSTANT_BUFFER_RANGE_ALIGNMENT, CONSTANT_BUFFER_RANGE_ALIGNMENT);
+	device.setConstantBuffer(constantBuffer, 0, VERTEX_SHADER);
+	SANDBOX_CHECK(numRecorded(NULL_COMMAND_SET_CONSTANT_BUFFER) == 5);
+
+	// Unbinding is a state change as well
+	device.setSRV(srv, 3, PIXEL_SHADER);
+	device.setSRV(srv, 3, PIXEL_SHADER);
+	device.setSRV(nullptr, 3, PIXEL_SHADER);
+	device.setSRV(nullptr, 3, PIXEL_SHADER);
+	SANDBOX_CHECK(numRecorded(NULL_COMMAND_SET_SRV) == 2);
+
+	device.setSampler(sampler, 0, PIXEL_SHADER);
+	device.setSampler(sampler, 0, PIXEL_SHADER);
+	SANDBOX_CHECK(numRecorded(NULL_COMMAND_SET_SAMPLER) == 1);
+
+	// Every stage of a bind is counted, both by the cache and by the device
+	GpuStateCacheStats stats = device.getStateCache().getStats();
+	SANDBOX_CHECK(stats.numBinds == 21 && stats.numFiltered == 8);
+	SANDBOX_CHECK(device.getStats().numBinds == stats.numBinds - stats.numFiltered);
+
+	// States bound in the previous render pass are not trusted in the next one
+	device.beginRenderPass(GpuRenderPassDesc());
+	device.setVertexBuffer(vertexBuffers[1], 1, 32, 64);
+	device.setSampler(sampler, 0, PIXEL_SHADER);
+	SANDBOX_CHECK(numRecorded(NULL_COMMAND_SET_VERTEX_BUFFER) == 5);
+	SANDBOX_CHECK(numRecorded(NULL_COMMAND_SET_SAMPLER) == 2);
+
+	IGpuResource* resources[] = { vertexBuffers[0], vertexBuffers[1], constantBuffer, sampler, srv };
+	for (IGpuResource* resource : resources)
+		device.destroy(resource);
+
+	ENGI_LOG_INFO("TestGpuStateCache {}: {} binds, {} filtered", passed ? "passed" : "failed", stats.numBinds, stats.numFiltered);
+	return passed;
+}
+
+bool TestGpuInstancePacking() noexcept
+{
+	bool passed = true;
+
+	// Halfs keep 11 significant bits, thus the relative error of a channel is below 2^-11
+	auto isHalfEqual = [](float packed, float expected) -> bool { return std::abs(packed - expected) <= std::abs(expected) / 1024.0f; };
+
+	InstanceData data(math::Transformation(math::Vec3(12.5f, -3.0f, 1000.0f), math::Vec3(30.0f, 45.0f, -60.0f), math::Vec3(0.5f, 2.0f, 3.0f)),
+		math::Vec3(4.0f, 0.25f, 12.0f), math::Vec3(2.0f, 0.0f, 0.125f), 3.5f);
+	data.spawnTime = 1.5f;
+	data.timeRate = 0.5f;
+	data.sphereOrigin = math::Vec3(1.0f, 2.0f, 3.0f);
+	data.sphereRadiusMax = 4.0f;
+	data.instanceID = 1234;
+
+	InstanceData unpacked;
+	GpuInstanceData::pack(data).unpack(unpacked);
+	GpuInstanceAnimation::pack(data).unpack(unpacked);
+
+	// Transform is stored in full precision, only the constant column is dropped. worldToModel is recomputed from the same matrix
+	for (uint32_t row = 0; row < 4; ++row)
+	{
+		for (uint32_t column = 0; column < 4; ++column)
+		{
+			SANDBOX_CHECK(unpacked.modelToWorld.m[row][column] == data.modelToWorld.m[row][column]);
+			SANDBOX_CHECK(unpacked.worldToModel.m[row][column] == data.worldToModel.m[row][column]);
+		}
+	}
+
+	// Colors above 1 are allowed by the editor and should survive packing
+	SANDBOX_CHECK(isHalfEqual(unpacked.color.x, data.color.x) && isHalfEqual(unpacked.color.y, data.color.y) && isHalfEqual(unpacked.color.z, data.color.z));
+	SANDBOX_CHECK(isHalfEqual(unpacked.emission.x, data.emission.x) && isHalfEqual(unpacked.emission.y, data.emission.y) && isHalfEqual(unpacked.emission.z, data.emission.z));
+	SANDBOX_CHECK(isHalfEqual(unpacked.emissionPower, data.emissionPower));
+
+	SANDBOX_CHECK(unpacked.spawnTime == data.spawnTime && unpacked.timeRate == data.timeRate);
+	SANDBOX_CHECK(unpacked.sphereOrigin.x == data.sphereOrigin.x && unpacked.sphereOrigin.y == data.sphereOrigin.y && unpacked.sphereOrigin.z == data.sphereOrigin.z);
+	SANDBOX_CHECK(unpacked.sphereRadiusMax == data.sphereRadiusMax);
+	SANDBOX_CHECK(unpacked.instanceID == data.instanceID);
+
+	ENGI_LOG_INFO("TestGpuInstancePacking {}: color ({}, {}, {}) restored as ({}, {}, {})", passed ? "passed" : "failed",
+		data.color.x, data.color.y, data.color.z, unpacked.color.x, unpacked.color.y, unpacked.color.z);
+	return passed;
+}
+
+bool TestDrawConstants() noexcept
+{
+	using namespace gfx;
+
+	UniqueHandle<Renderer> renderer = CreateHeadlessRenderer();
+	if (!renderer)
+		return false;
+
+	bool passed = true;
+	NullDevice* device = getNullDevice(renderer.get());
+	InstanceTable instanceTable;
+	MeshManager meshManager(renderer.get(), &instanceTable);
+	SANDBOX_CHECK(meshManager.init());
+
+	// Three batches of two meshes and two material instances, thus four constants entries
+	SharedHandle<Model> cube = renderer->getModelRegistry()->getModel(MODEL_TYPE_CUBE);
+	SharedHandle<Model> sphere = renderer->getModelRegistry()->getModel(MODEL_TYPE_SPHERE);
+	SharedHandle<Material> pbr = renderer->getMaterialRegistry()->getMaterial(MATERIAL_BRDF_PBR);
+	MaterialInstance rough("TestDrawConstants_Rough", pbr);
+	rough.setRoughness(0.9f);
+	MaterialInstance smooth("TestDrawConstants_Smooth", pbr);
+	smooth.setRoughness(0.1f);
+	std::vector<uint32_t> ids = addLineOfInstances(instanceTable, 30);
+	SANDBOX_CHECK(meshManager.submitInstances(cube, 0, rough, viewOf(ids.data(), 10)));
+	SANDBOX_CHECK(meshManager.submitInstances(cube, 0, smooth, viewOf(ids.data() + 10, 10)));
+	SANDBOX_CHECK(meshManager.submitInstances(sphere, 0, rough, viewOf(ids.data() + 20, 10)));
+
+	device->setRecording(true);
+	auto countCommands = [device](NullCommandType type, const void* object) -> uint32_t
+		{
+			return static_cast<uint32_t>(std::ranges::count_if(device->getCommands(), [type, object](const NullCommand& command) { return command.type == type && command.object == object; }));
+		};
+
+	// Draw constants are the only buffer bound by range at b1
+	device->reset();
+	renderFrame(meshManager, device);
+	const void* drawConstants = nullptr;
+	std::vector<uint32_t> meshOffsets;
+	std::vector<uint32_t> materialOffsets;
+	for (const NullCommand& command : device->getCommands())
+	{
+		if (command.type != NULL_COMMAND_SET_CONSTANT_BUFFER || command.args[3] != CONSTANT_BUFFER_RANGE_ALIGNMENT)
+			continue;
+
+		drawConstants = command.object;
+		(command.args[0] == 1 ? meshOffsets : materialOffsets).push_back(command.args[2]);
+	}
+	SANDBOX_CHECK(drawConstants != nullptr);
+	SANDBOX_CHECK(countCommands(NULL_COMMAND_MAP_BUFFER, drawConstants) == 1);
+
+	// Draws are sorted by mesh, so both cube draws share the bound mesh entry, while the material entry changes with every draw
+	SANDBOX_CHECK(meshOffsets.size() == 2 && materialOffsets.size() == 3);
+	std::vector<uint32_t> offsets = meshOffsets;
+	offsets.insert(offsets.end(), materialOffsets.begin(), materialOffsets.end());
+	std::ranges::sort(offsets);
+	SANDBOX_CHECK(std::ranges::unique(offsets).begin() - offsets.begin() == 4);
+	uint64_t numDraws = device->getStats().numDraws;
+
+	// Nothing has changed, thus the same draws are issued without uploading any constants
+	device->reset();
+	SANDBOX_CHECK(renderFrame(meshManager, device) == 0);
+	SANDBOX_CHECK(countCommands(NULL_COMMAND_MAP_BUFFER, drawConstants) == 0);
+	SANDBOX_CHECK(device->getStats().numDraws == numDraws);
+
+	// A new batch resorts the draws and uploads all of the constants once more
+	std::vector<uint32_t> newIds = addLineOfInstances(instanceTable, 10);
+	SANDBOX_CHECK(meshManager.submitInstances(sphere, 0, smooth, viewOf(newIds.data(), newIds.size())));
+	device->reset();
+	renderFrame(meshManager, device);
+	SANDBOX_CHECK(countCommands(NULL_COMMAND_MAP_BUFFER, drawConstants) == 1);
+	SANDBOX_CHECK(device->getStats().numDraws == numDraws + 1);
+
+	ENGI_LOG_INFO("TestDrawConstants {}: {} draws, {} mesh binds, {} material binds", passed ? "passed" : "failed", numDraws, meshOffsets.size(), materialOffsets.size());
+	return passed;
+}
+
+bool TestIdleFrames() noexcept
+{
+	UniqueHandle<Renderer> renderer = CreateHeadlessRenderer();
+	if (!renderer)
+		return false;
+
+	bool passed = true;
+	gfx::NullDevice* device = getNullDevice(renderer.get());
+	InstanceTable instanceTable;
+	MeshManager meshManager(renderer.get(), &instanceTable);
+	SANDBOX_CHECK(meshManager.init());
+
+	static constexpr uint32_t numInstances = 50;
+	static constexpr uint32_t numFrames = 10;
+	static constexpr float timestep = 1.0f / 60.0f;
+	SharedHandle<Model> sphere = renderer->getModelRegistry()->getModel(MODEL_TYPE_SPHERE);
+	MaterialInstance material("TestIdleFrames", renderer->getMaterialRegistry()->getMaterial(MATERIAL_BRDF_PBR));
+	std::vector<uint32_t> ids = addLineOfInstances(instanceTable, numInstances);
+	for (uint32_t i = 0; i < numInstances; ++i)
+		instanceTable.getInstanceData(ids[i]).timeRate = 1.0f + i * 0.1f;
+
+	SANDBOX_CHECK(meshManager.submitInstances(sphere, 0, material, viewOf(ids.data(), ids.size())));
+	renderFrame(meshManager, device);
+
+	// Scene time advances as SceneRenderer::update does it, instances are only read through const access
+	const InstanceTable& constTable = instanceTable;
+	float sceneTime = 0.0f;
+	uint64_t idleBytes = 0;
+	for (uint32_t frame = 0; frame < numFrames; ++frame)
+	{
+		sceneTime += timestep;
+		const InstanceData& last = constTable.getInstanceData(ids.back());
+		SANDBOX_CHECK(last.getTime(sceneTime) == (sceneTime - last.spawnTime) * last.timeRate);
+		SANDBOX_CHECK(!instanceTable.hasDirtyData());
+		idleBytes += renderFrame(meshManager, device);
+		idleBytes += meshManager.getNumUploadedBytes();
+	}
+	SANDBOX_CHECK(idleBytes == 0);
+
+	// Restarting the animation of an instance reuploads its animation stream only
+	instanceTable.getInstanceData(ids[0]).spawnTime = sceneTime;
+	SANDBOX_CHECK(constTable.getInstanceData(ids[0]).getTime(sceneTime) == 0.0f);
+	uint64_t restartBytes = renderFrame(meshManager, device);
+	SANDBOX_CHECK(meshManager.getNumUploadedBytes() == sizeof(GpuInstanceAnimation));
+	SANDBOX_CHECK(restartBytes == sizeof(GpuInstanceAnimation));
+
+	ENGI_LOG_INFO("TestIdleFrames {}: {} idle frames uploaded {} bytes, restarted animation {} bytes", passed ? "passed" : "failed", numFrames, idleBytes, restartBytes);
+	return passed;
+}
+
+bool TestOffsetAllocator() noexcept
+{
+	bool passed = true;
+
+	// Freed ranges are merged with their free neighbours, thus the whole capacity is a single range again once everything is freed
+	OffsetAllocator allocator(1000);
+	std::vector<OffsetAllocator::Allocation> allocations;
+	for (uint32_t i = 0; i < 10; ++i)
+		allocations.push_back(allocator.allocate(100));
+
+	SANDBOX_CHECK(std::ranges::all_of(allocations, [](const OffsetAllocator::Allocation& allocation) { return allocation.isValid(); }));
+	SANDBOX_CHECK(allocator.getNumFreeUnits() == 0 && !allocator.allocate(1).isValid());
+	for (uint32_t i = 0; i < allocations.size(); i += 2)
+		allocator.free(allocations[i]);
+
+	SANDBOX_CHECK(allocator.getNumFreeUnits() == 500 && allocator.getLargestFreeRange() == 100);
+	SANDBOX_CHECK(!allocator.allocate(101).isValid());
+	for (uint32_t i = 1; i < allocations.size(); i += 2)
+		allocator.free(allocations[i]);
+
+	SANDBOX_CHECK(allocator.getNumAllocations() == 0 && allocator.getLargestFreeRange() == 1000);
+
+	// Random allocations and frees, every unit is owned by at most one allocation
+	static constexpr uint32_t capacity = 1u << 16;
+	static constexpr uint32_t numOperations = 20000;
+	allocator.reset(capacity);
+	allocations.clear();
+	std::vector<uint8_t> isUsed(capacity, 0);
+	std::mt19937 generator(42);
+	uint32_t numUsedUnits = 0;
+	uint32_t numFailed = 0;
+	for (uint32_t i = 0; i < numOperations; ++i)
+	{
+		if (allocations.empty() || generator() % 3 != 0)
+		{
+			OffsetAllocator::Allocation allocation = allocator.allocate(1 + generator() % 1000);
+			if (!allocation.isValid())
+			{
+				++numFailed;
+				continue;
+			}
+
+			auto units = std::span(isUsed).subspan(allocation.offset, allocation.size);
+			SANDBOX_CHECK(allocation.offset + allocation.size <= capacity && std::ranges::count(units, 1) == 0);
+			std::ranges::fill(units, 1);
+			numUsedUnits += allocation.size;
+			allocations.push_back(allocation);
+		}
+		else
+		{
+			size_t index = generator() % allocations.size();
+			std::swap(allocations[index], allocations.back());
+			std::ranges::fill(std::span(isUsed).subspan(allocations.back().offset, allocations.back().size), 0);
+			numUsedUnits -= allocations.back().size;
+			allocator.free(allocations.back());
+			allocations.pop_back();
+		}
+		SANDBOX_CHECK(allocator.getNumFreeUnits() == capacity - numUsedUnits);
+	}
+	SANDBOX_CHECK(allocator.getNumAllocations() == allocations.size());
+
+	for (const OffsetAllocator::Allocation& allocation : allocations)
+		allocator.free(allocation);
+
+	SANDBOX_CHECK(allocator.getNumFreeUnits() == capacity && allocator.getLargestFreeRange() == capacity);
+
+	// Growing keeps the allocations and appends the new space to the free range at the end, if there is one
+	OffsetAllocator full(100);
+	OffsetAllocator::Allocation first = full.allocate(60);
+	OffsetAllocator::Allocation second = full.allocate(40);
+	full.grow(250);
+	OffsetAllocator::Allocation appended = full.allocate(150);
+	SANDBOX_CHECK(appended.isValid() && appended.offset == 100 && full.getNumFreeUnits() == 0);
+	full.free(second);
+	full.free(appended);
+	SANDBOX_CHECK(full.getLargestFreeRange() == 190 && first.offset == 0);
+
+	OffsetAllocator partial(100);
+	partial.allocate(50);
+	partial.grow(200);
+	SANDBOX_CHECK(partial.getLargestFreeRange() == 150);
+
+	ENGI_LOG_INFO("TestOffsetAllocator {}: {} random operations, {} failed allocations, {} allocations left", passed ? "passed" : "failed", numOperations, numFailed, allocations.size());
+	return passed;
+}
+
+bool TestGeometryPool() noexcept
+{
+	using namespace gfx;
+
+	bool passed = true;
+	NullDevice device;
+	device.setRecording(true);
+	GeometryPool pool("TestGeometryPool", &device);
+	SANDBOX_CHECK(pool.init(64, 96));
+
+	// Every vertex and index of a mesh is tagged, so that its range can be found in the arenas after it was moved
+	struct TestMesh
+	{
+		uint32_t id;
+		std::vector<StaticMeshVertex> vertices;
+		std::vector<uint32_t> indices;
+	};
+	auto allocateMesh = [&pool](uint32_t tag, uint32_t numVertices, uint32_t numIndices) -> TestMesh
+		{
+			TestMesh mesh;
+			mesh.vertices.resize(numVertices);
+			for (uint32_t i = 0; i < numVertices; ++i)
+				mesh.vertices[i].position = math::Vec3(static_cast<float>(tag), static_cast<float>(i), 0.0f);
+
+			for (uint32_t i = 0; i < numIndices; ++i)
+				mesh.indices.push_back(tag * 1000 + i);
+
+			mesh.id = pool.allocate(mesh.vertices.data(), numVertices, mesh.indices.data(), numIndices);
+			return mesh;
+		};
+
+	// Arenas are read back from the buffers that GeometryPool::bind() has bound last
+	auto isStored = [&pool, &device](const TestMesh& mesh) -> bool
+		{
+			pool.bind();
+			const void* arenas[2] = {};
+			for (const NullCommand& command : device.getCommands())
+			{
+				if (command.type == NULL_COMMAND_SET_VERTEX_BUFFER || command.type == NULL_COMMAND_SET_INDEX_BUFFER)
+					arenas[command.type == NULL_COMMAND_SET_INDEX_BUFFER] = command.object;
+			}
+
+			GeometryRange range = pool.getRange(mesh.id);
+			const StaticMeshVertex* vertices = reinterpret_cast<const StaticMeshVertex*>(static_cast<NullBuffer*>(const_cast<void*>(arenas[0]))->getStorage()) + range.baseVertex;
+			const uint32_t* indices = reinterpret_cast<const uint32_t*>(static_cast<NullBuffer*>(const_cast<void*>(arenas[1]))->getStorage()) + range.baseIndex;
+			return std::memcmp(vertices, mesh.vertices.data(), mesh.vertices.size() * sizeof(StaticMeshVertex)) == 0
+				&& std::memcmp(indices, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t)) == 0;
+		};
+
+	// The first two meshes fill the arenas, the third one grows both of them
+	TestMesh a = allocateMesh(1, 32, 48);
+	TestMesh b = allocateMesh(2, 32, 48);
+	SANDBOX_CHECK(pool.getVertexCapacity() == 64 && pool.getIndexCapacity() == 96);
+	TestMesh c = allocateMesh(3, 16, 24);
+	SANDBOX_CHECK(pool.getVertexCapacity() == 128 && pool.getIndexCapacity() == 192);
+	SANDBOX_CHECK(pool.getRange(c.id).baseVertex == 64 && pool.getRange(c.id).baseIndex == 96);
+	SANDBOX_CHECK(isStored(a) && isStored(b) && isStored(c));
+
+	// Freed range is the smallest one that fits, thus it is reused without growing the arenas
+	pool.free(b.id);
+	SANDBOX_CHECK(pool.getNumVertices() == 48 && pool.getNumIndices() == 72);
+	TestMesh d = allocateMesh(4, 8, 12);
+	SANDBOX_CHECK(pool.getRange(d.id).baseVertex == 32 && pool.getRange(d.id).baseIndex == 48);
+	SANDBOX_CHECK(pool.getVertexCapacity() == 128 && pool.getIndexCapacity() == 192);
+
+	// Defragmentation packs the live ranges in the order of their offsets and keeps the capacity
+	pool.defragment();
+	SANDBOX_CHECK(pool.getRange(a.id).baseVertex == 0 && pool.getRange(d.id).baseVertex == 32 && pool.getRange(c.id).baseVertex == 40);
+	SANDBOX_CHECK(pool.getRange(a.id).baseIndex == 0 && pool.getRange(d.id).baseIndex == 48 && pool.getRange(c.id).baseIndex == 60);
+	SANDBOX_CHECK(pool.getVertexCapacity() == 128 && pool.getIndexCapacity() == 192);
+	SANDBOX_CHECK(isStored(a) && isStored(c) && isStored(d));
+
+	ENGI_LOG_INFO("TestGeometryPool {}: {} vertices and {} indices in arenas of {} and {}", passed ? "passed" : "failed",
+		pool.getNumVertices(), pool.getNumIndices(), pool.getVertexCapacity(), pool.getIndexCapacity());
+	return passed;
+}
+
+bool TestInstanceMobility() noexcept
+{
+	UniqueHandle<Renderer> renderer = CreateHeadlessRenderer();
+	if (!renderer)
+		return false;
+
+	bool passed = true;
+	gfx::NullDevice* device = getNullDevice(renderer.get());
+	InstanceTable instanceTable;
+	MeshManager meshManager(renderer.get(), &instanceTable);
+	SANDBOX_CHECK(meshManager.init());
+
+	static constexpr uint32_t numStatic = 20;
+	static constexpr uint32_t numDynamic = 5;
+	static constexpr uint32_t slotBytes = sizeof(GpuInstanceData) + sizeof(GpuInstanceAnimation);
+	SharedHandle<Model> cube = renderer->getModelRegistry()->getModel(MODEL_TYPE_CUBE);
+	MaterialInstance material("TestInstanceMobility", renderer->getMaterialRegistry()->getMaterial(MATERIAL_BRDF_PBR));
+	std::vector<uint32_t> staticIds = addLineOfInstances(instanceTable, numStatic);
+	std::vector<uint32_t> dynamicIds = addLineOfInstances(instanceTable, numDynamic, INSTANCE_MOBILITY_DYNAMIC);
+	SANDBOX_CHECK(meshManager.submitInstances(cube, 0, material, viewOf(staticIds.data(), staticIds.size())));
+	SANDBOX_CHECK(meshManager.submitInstances(cube, 0, material, viewOf(dynamicIds.data(), dynamicIds.size())));
+
+	// A single batch is drawn twice, once from each stream
+	uint64_t drawsBefore = device->getStats().numDraws;
+	renderFrame(meshManager, device);
+	SANDBOX_CHECK(meshManager.getNumStaticSlots() == numStatic && meshManager.getNumDynamicSlots() == numDynamic);
+	SANDBOX_CHECK(device->getStats().numDraws - drawsBefore == 2);
+
+	// Dynamic stream is not rewritten unless one of its instances has changed
+	SANDBOX_CHECK(renderFrame(meshManager, device) == 0);
+
+	// Moving a dynamic instance rewrites the dynamic stream as a whole, static one is left untouched
+	math::Transformation moved(math::Vec3(0.0f, 5.0f, 0.0f), math::Vec3(), math::Vec3(1.0f));
+	instanceTable.getInstanceData(dynamicIds[0]).modelToWorld = InstanceData(moved).modelToWorld;
+	renderFrame(meshManager, device);
+	uint32_t dynamicMoveBytes = meshManager.getNumUploadedBytes();
+	SANDBOX_CHECK(dynamicMoveBytes == numDynamic * slotBytes);
+
+	instanceTable.getInstanceData(staticIds[0]).modelToWorld = InstanceData(moved).modelToWorld;
+	renderFrame(meshManager, device);
+	SANDBOX_CHECK(meshManager.getNumUploadedBytes() == sizeof(GpuInstanceData));
+
+	// Partition is stable, thus the last static instance becoming dynamic leaves slots of the others as they are and only the dynamic stream is rewritten
+	uint32_t mobilityVersion = instanceTable.getMobilityVersion();
+	instanceTable.setMobility(staticIds.back(), INSTANCE_MOBILITY_DYNAMIC);
+	SANDBOX_CHECK(instanceTable.getMobilityVersion() != mobilityVersion);
+	renderFrame(meshManager, device);
+	uint32_t mobilityChangeBytes = meshManager.getNumUploadedBytes();
+	SANDBOX_CHECK(meshManager.getNumStaticSlots() == numStatic - 1 && meshManager.getNumDynamicSlots() == numDynamic + 1);
+	SANDBOX_CHECK(mobilityChangeBytes == (numDynamic + 1) * slotBytes);
+
+	// Setting the same mobility again is not a change
+	mobilityVersion = instanceTable.getMobilityVersion();
+	instanceTable.setMobility(staticIds.back(), INSTANCE_MOBILITY_DYNAMIC);
+	SANDBOX_CHECK(instanceTable.getMobilityVersion() == mobilityVersion && !instanceTable.hasDirtyData());
+
+	// Back to static, the instance returns to its old slot. Mirror of the static buffer still holds it there, thus only the dynamic stream is rewritten
+	instanceTable.setMobility(staticIds.back(), INSTANCE_MOBILITY_STATIC);
+	renderFrame(meshManager, device);
+	SANDBOX_CHECK(meshManager.getNumStaticSlots() == numStatic && meshManager.getNumDynamicSlots() == numDynamic);
+	SANDBOX_CHECK(meshManager.getNumUploadedBytes() == numDynamic * slotBytes);
+	SANDBOX_CHECK(renderFrame(meshManager, device) == 0);
+
+	ENGI_LOG_INFO("TestInstanceMobility {}: moved dynamic instance {} bytes, mobility change {} bytes", passed ? "passed" : "failed", dynamicMoveBytes, mobilityChangeBytes);
+	return passed;
+}
+
+bool TestInstanceGroups() noexcept
+{
+	UniqueHandle<Renderer> renderer = CreateHeadlessRenderer();
+	if (!renderer)
+		return false;
+
+	bool passed = true;
+	gfx::NullDevice* device = getNullDevice(renderer.get());
+	InstanceTable instanceTable;
+	MeshManager meshManager(renderer.get(), &instanceTable);
+	SANDBOX_CHECK(meshManager.init());
+
+	// Grid of 32x32 unit cubes two units apart, clusters of 64 instances are expected to be 8x8 blocks of the grid
+	static constexpr uint32_t gridSize = 32;
+	static constexpr uint32_t numInstances = gridSize * gridSize;
+	std::vector<math::Transformation> transforms;
+	for (uint32_t x = 0; x < gridSize; ++x)
+	{
+		for (uint32_t z = 0; z < gridSize; ++z)
+			transforms.emplace_back(math::Vec3(x * 2.0f, 0.0f, z * 2.0f), math::Vec3(), math::Vec3(1.0f));
+	}
+
+	SharedHandle<Model> cube = renderer->getModelRegistry()->getModel(MODEL_TYPE_CUBE);
+	MaterialInstance material("TestInstanceGroups", renderer->getMaterialRegistry()->getMaterial(MATERIAL_BRDF_PBR));
+	uint32_t groupId = meshManager.addInstanceGroup(cube, viewOf(material), viewOf(transforms.data(), transforms.size()));
+	SANDBOX_CHECK(groupId != MeshManager::INVALID_GROUP);
+	InstanceGroup* group = meshManager.getInstanceGroup(groupId);
+	if (!group)
+		return false;
+
+	// Group instances take slots of the group buffer only, instance table is not involved
+	uint64_t firstFrameBytes = renderFrame(meshManager, device);
+	SANDBOX_CHECK(meshManager.getNumGroupSlots() == numInstances && meshManager.getNumStaticSlots() == 0 && instanceTable.getNumInstances() == 0);
+	SANDBOX_CHECK(meshManager.getNumUploadedBytes() >= numInstances * sizeof(GpuInstanceData));
+	SANDBOX_CHECK(meshManager.getNumVisibleInstances() == numInstances);
+
+	SANDBOX_CHECK(group->getNumClusters() == numInstances / InstanceGroup::CLUSTER_SIZE);
+	for (const InstanceGroup::Cluster& cluster : group->getClusters())
+	{
+		math::Vec3 extent = cluster.worldAABB.max - cluster.worldAABB.min;
+		SANDBOX_CHECK(cluster.count == InstanceGroup::CLUSTER_SIZE && extent.x <= 15.0f && extent.z <= 15.0f);
+	}
+
+	SANDBOX_CHECK(renderFrame(meshManager, device) == 0);
+
+	// Moving an instance within its cluster reuploads its slot only
+	math::Transformation moved = group->getTransformation(0);
+	moved.translation.y += 1.0f;
+	group->setTransformation(0, moved);
+	meshManager.updateInstanceGroup(groupId);
+	renderFrame(meshManager, device);
+	SANDBOX_CHECK(meshManager.getNumUploadedBytes() == sizeof(GpuInstanceData));
+
+	// Box that only contains the first 8 columns of the grid. Clusters are culled as a whole, thus exactly 4 of them are left
+	math::Frustum box;
+	box.planes[math::Frustum::PLANE_LEFT] = math::Vec4(1.0f, 0.0f, 0.0f, 1.0f);
+	box.planes[math::Frustum::PLANE_RIGHT] = math::Vec4(-1.0f, 0.0f, 0.0f, 15.0f);
+	box.planes[math::Frustum::PLANE_BOTTOM] = math::Vec4(0.0f, 1.0f, 0.0f, 100.0f);
+	box.planes[math::Frustum::PLANE_TOP] = math::Vec4(0.0f, -1.0f, 0.0f, 100.0f);
+	box.planes[math::Frustum::PLANE_NEAR] = math::Vec4(0.0f, 0.0f, 1.0f, 100.0f);
+	box.planes[math::Frustum::PLANE_FAR] = math::Vec4(0.0f, 0.0f, -1.0f, 100.0f);
+	meshManager.setCullingFrustum(box);
+	SANDBOX_CHECK(renderFrame(meshManager, device) == 0);
+	uint32_t numVisible = meshManager.getNumVisibleInstances();
+	SANDBOX_CHECK(numVisible == 4 * InstanceGroup::CLUSTER_SIZE);
+
+	// Different number of instances relays the group out
+	group->setInstances(viewOf(transforms.data(), 100));
+	meshManager.updateInstanceGroup(groupId);
+	renderFrame(meshManager, device);
+	SANDBOX_CHECK(meshManager.getNumGroupSlots() == 100 && group->getNumClusters() == 2);
+
+	meshManager.removeInstanceGroup(groupId);
+	renderFrame(meshManager, device);
+	SANDBOX_CHECK(meshManager.getNumGroupSlots() == 0 && meshManager.getInstanceGroup(groupId) == nullptr);
+
+	ENGI_LOG_INFO("TestInstanceGroups {}: first frame {} bytes, {} of {} instances visible after culling", passed ? "passed" : "failed", firstFrameBytes, numVisible, numInstances);
+	return passed;
+}
+
+bool TestFrustumCulling() noexcept
+{
+	using namespace gfx;
+
+	UniqueHandle<Renderer> renderer = CreateHeadlessRenderer();
+	if (!renderer)
+		return false;
+
+	bool passed = true;
+	NullDevice* device = getNullDevice(renderer.get());
+	InstanceTable instanceTable;
+	MeshManager meshManager(renderer.get(), &instanceTable);
+	SANDBOX_CHECK(meshManager.init());
+
+	// Camera at the origin looking along +Z with a reversed depth projection, as Camera builds it
+	static constexpr float fov = math::Numeric::pi() / 3.0f;
+	static constexpr float nearPlane = 0.1f;
+	static constexpr float farPlane = 100.0f;
+	const float halfWidthPerDepth = std::tan(fov / 2.0f);
+	math::Mat4x4 proj = math::Mat4x4::perspectiveProjectionLH(fov, 1.0f, farPlane, nearPlane);
+	math::Frustum forward = math::Frustum::fromMatrix(math::Mat4x4::lookAtLH(math::Vec3(0.0f), math::Vec3(0.0f, 0.0f, 1.0f)) * proj);
+	math::Frustum backward = math::Frustum::fromMatrix(math::Mat4x4::lookAtLH(math::Vec3(0.0f), math::Vec3(0.0f, 0.0f, -1.0f)) * proj);
+
+	SANDBOX_CHECK(forward.intersects(math::Vec3(0.0f, 0.0f, 10.0f), 0.01f));
+	SANDBOX_CHECK(!forward.intersects(math::Vec3(0.0f, 0.0f, -1.0f), 0.01f) && !forward.intersects(math::Vec3(0.0f, 0.0f, farPlane + 1.0f), 0.01f));
+	SANDBOX_CHECK(!forward.intersects(math::Vec3(10.0f * halfWidthPerDepth + 1.0f, 0.0f, 10.0f), 0.01f));
+	SANDBOX_CHECK(backward.intersects(math::Vec3(0.0f, 0.0f, -10.0f), 0.01f) && !backward.intersects(math::Vec3(0.0f, 0.0f, 10.0f), 0.01f));
+
+	// Instances are submitted in groups, so that each group occupies its own run of slots: inside, straddling the right plane,
+	// behind the camera and beyond the far plane. Runs are longer than MAX_DRAW_GAP, thus culled runs are never merged into draws
+	static constexpr uint32_t numInside = 10;
+	static constexpr uint32_t numStraddling = 3;
+	static constexpr uint32_t numBehind = 5;
+	static constexpr uint32_t numBeyond = 5;
+	std::vector<math::Vec3> positions;
+	for (uint32_t i = 0; i < numInside; ++i)
+		positions.emplace_back(0.0f, 0.0f, 10.0f + i * 2.0f);
+	for (uint32_t i = 0; i < numStraddling; ++i)
+	{
+		float depth = 10.0f * (i + 1);
+		positions.emplace_back(depth * halfWidthPerDepth, 0.0f, depth);
+	}
+	for (uint32_t i = 0; i < numBehind; ++i)
+		positions.emplace_back(0.0f, 0.0f, -5.0f - i * 2.0f);
+	for (uint32_t i = 0; i < numBeyond; ++i)
+		positions.emplace_back(0.0f, 0.0f, farPlane + 20.0f + i * 2.0f);
+
+	std::vector<uint32_t> ids;
+	for (const math::Vec3& position : positions)
+		ids.push_back(instanceTable.addInstanceData(InstanceData(math::Transformation(position, math::Vec3(), math::Vec3(1.0f)))));
+
+	SharedHandle<Model> cube = renderer->getModelRegistry()->getModel(MODEL_TYPE_CUBE);
+	MaterialInstance material("TestFrustumCulling", renderer->getMaterialRegistry()->getMaterial(MATERIAL_BRDF_PBR));
+	SANDBOX_CHECK(meshManager.submitInstances(cube, 0, material, viewOf(ids.data(), ids.size())));
+
+	// Culling only changes what is drawn, every instance keeps its uploaded slot
+	struct DrawnSlots
+	{
+		uint32_t numInstances = 0;
+		uint32_t first = uint32_t(-1);
+	};
+	device->setRecording(true);
+	auto renderCulled = [&](const math::Frustum& frustum, uint64_t& uploadedBytes) -> DrawnSlots
+		{
+			meshManager.setCullingFrustum(frustum);
+			device->reset();
+			uploadedBytes = renderFrame(meshManager, device);
+			DrawnSlots drawn;
+			for (const NullCommand& command : device->getCommands())
+			{
+				if (command.type != NULL_COMMAND_DRAW_INDEXED_INSTANCED)
+					continue;
+
+				drawn.numInstances += command.args[1];
+				drawn.first = std::min(drawn.first, command.args[4]);
+			}
+			return drawn;
+		};
+
+	uint64_t uploadedBytes = 0;
+	DrawnSlots drawn = renderCulled(forward, uploadedBytes);
+	uint32_t numVisibleForward = meshManager.getNumVisibleInstances();
+	SANDBOX_CHECK(numVisibleForward == numInside + numStraddling);
+	SANDBOX_CHECK(meshManager.getNumStaticSlots() == positions.size());
+	SANDBOX_CHECK(drawn.numInstances == numInside + numStraddling && drawn.first == 0);
+
+	// Turning around only redraws other slots, nothing is reuploaded
+	drawn = renderCulled(backward, uploadedBytes);
+	uint32_t numVisibleBackward = meshManager.getNumVisibleInstances();
+	SANDBOX_CHECK(numVisibleBackward == numBehind);
+	SANDBOX_CHECK(uploadedBytes == 0);
+	SANDBOX_CHECK(drawn.numInstances == numBehind && drawn.first == numInside + numStraddling);
+
+	ENGI_LOG_INFO("TestFrustumCulling {}: {} of {} instances visible looking forward, {} looking backward", passed ? "passed" : "failed",
+		numVisibleForward, positions.size(), numVisibleBackward);
+	return passed;
+}
+
+bool TestTinyTriangles() noexcept
+{
+	bool passed = true;
+
+	// Edges of 1e-4 give a determinant of 1e-8, which is far below float epsilon but is still a valid triangle
+	static constexpr float edge = 1e-4f;
+	const math::Vec3 tri0(0.0f, 0.0f, 1.0f);
+	const math::Vec3 tri1(edge, 0.0f, 1.0f);
+	const math::Vec3 tri2(0.0f, edge, 1.0f);
+	math::Ray inside(math::Vec3(edge * 0.25f, edge * 0.25f, 0.0f), math::Vec3(0.0f, 0.0f, 1.0f));
+	math::Ray outside(math::Vec3(edge, edge, 0.0f), math::Vec3(0.0f, 0.0f, 1.0f));
+	auto isHitAt = [](float t, float u, float v) -> bool { return std::abs(t - 1.0f) < 1e-5f && std::abs(u - 0.25f) < 1e-3f && std::abs(v - 0.25f) < 1e-3f; };
+
+	float t = 0.0f;
+	math::Vec2 barycentrics;
+	SANDBOX_CHECK(inside.intersects(tri0, tri1, tri2, &t, &barycentrics) && isHitAt(t, barycentrics.x, barycentrics.y));
+	SANDBOX_CHECK(!outside.intersects(tri0, tri1, tri2, &t));
+
+	// Packet kernels follow the same rule, the rest of the lanes are cleared and are never hit
+	math::TrianglePacket<4> packetSSE;
+	packetSSE.set(1, tri0, tri1, tri2);
+	math::TriangleHit hitSSE;
+	SANDBOX_CHECK(math::intersects(math::RaySSE(inside), packetSSE, hitSSE) && hitSSE.lane == 1 && isHitAt(hitSSE.t, hitSSE.u, hitSSE.v));
+	math::TriangleHit missSSE;
+	SANDBOX_CHECK(!math::intersects(math::RaySSE(outside), packetSSE, missSSE));
+
+	math::TrianglePacketN packet;
+	packet.set(math::TrianglePacketN::WIDTH - 1, tri0, tri1, tri2);
+	math::TriangleHit hit;
+	SANDBOX_CHECK(math::intersects(math::RayPacketN(inside), packet, hit) && hit.lane == math::TrianglePacketN::WIDTH - 1 && isHitAt(hit.t, hit.u, hit.v));
+
+	ENGI_LOG_INFO("TestTinyTriangles {}: triangle with edges of {} tested with scalar, 4-wide and {}-wide kernels", passed ? "passed" : "failed",
+		edge, math::TrianglePacketN::WIDTH);
+	return passed;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include "Utility/Memory.h"
+
+namespace engi { class Renderer; }
+
+// Self-checks of engine subsystems. Every failed check is logged as an error, the functions return whether all of their checks passed.
+// Headless tests create their own renderer with the null backend, thus they are meant to be called from engi::Main before the application is initialized
+
+// Renderer with the null backend, nullptr if it failed to initialize. Shared by the headless tests and benchmarks
+engi::UniqueHandle<engi::Renderer> CreateHeadlessRenderer() noexcept;
+
+// Full path of a model from Assets/Models, e.g. "Samurai/Samurai.fbx"
+std::string GetBundledModelPath(const std::string& filename) noexcept;
+
+// Uploaded bytes of MeshManager on the first frame, on an idle frame and after a single instance has moved
+bool TestInstanceUploads() noexcept;
+
+// Bundled models are requested at once (one of them twice) and finalized with ModelLoader::update(). Cooked files of the models are removed first,
+// so that the Assimp importers of several threads are used concurrently
+bool TestAsyncModelLoading() noexcept;
+
+// Multi-mesh models are imported with Assimp twice. Meshes should be merged in order and both imports should be identical, no matter how jobs were scheduled
+bool TestParallelImport() noexcept;
+
+// ShaderBytecodeCache with a stub compile function on a small include graph written into the cache folder: hits, misses after edits of
+// any included file or of compile parameters, and recovery from a corrupted blob
+bool TestShaderBytecodeCache() noexcept;
+
+// GpuStateCache behind the recording null device: redundant binds and stages are dropped, changed ones are not, and a render pass invalidates the cache
+bool TestGpuStateCache() noexcept;
+
+// GpuInstanceData and GpuInstanceAnimation are packed and unpacked back: transform and IDs are restored exactly, HDR color and emission within half precision
+bool TestGpuInstancePacking() noexcept;
+
+// Mesh and material instance constants of a few batches on the recording null device: one entry per unique mesh and material instance,
+// a single upload after the draws are sorted and none on an idle frame
+bool TestDrawConstants() noexcept;
+
+// Scene time advances over several frames while instances are only read. Instance time is derived from it, thus no instance gets dirty
+// and nothing is uploaded until an animation is restarted
+bool TestIdleFrames() noexcept;
+
+// OffsetAllocator on fixed and random sequences of allocations and frees: ranges never overlap, freed neighbours are merged and growing keeps the allocations
+bool TestOffsetAllocator() noexcept;
+
+// GeometryPool on the recording null device: contents of the meshes survive growing, freed ranges are reused and defragment() packs the rest in order
+bool TestGeometryPool() noexcept;
+
+// Static and dynamic instances of a batch: slot counts of both streams, what is uploaded when either kind of instance moves and when mobility changes
+bool TestInstanceMobility() noexcept;
+
+// Instance group of a grid of cubes: group buffer slots, compact clusters, per-slot reuploads, culling of whole clusters, relayout and removal
+bool TestInstanceGroups() noexcept;
+
+// Instances inside, outside and straddling a frustum built from a view-projection matrix: visible count, drawn slots and no reuploads when the view turns
+bool TestFrustumCulling() noexcept;
+
+// Triangle with edges of 1e-4 has to be hit by the scalar and packet ray-triangle kernels
+bool TestTinyTriangles() noexcept;
@@ -2,6 +2,11 @@
 
 #include <iostream>
 #include <format>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "EngineBenchmarks.h"
+#include "EngineTests.h"
 
 #define KNIGHT_INSTANCE_TESTING() (resourcePanel.LoadFromFBX("Knight/Knight.fbx"))
 #define SAMURAI_INSTANCE_TESTING() (resourcePanel.LoadFromFBX("Samurai/Samurai.fbx"))
@@ -22,9 +27,55 @@ void TestFibonacciPointDistribution(uint32_t n) noexcept
 #endif
 }
 
+// Compares spawning of n instances one by one against a single bulk spawn. Both groups stay in the scene, placed on a grid next to each other
+void BenchmarkInstanceSpawning(engi::SceneInspector& sceneInspector, const engi::SharedHandle<engi::Model>& model, engi::ArrayView<const engi::MaterialInstance> materials, uint32_t n) noexcept
+{
+	using namespace engi;
+	using Clock = std::chrono::steady_clock;
+
+	uint32_t gridSize = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(n))));
+	std::vector<math::Transformation> transforms;
+	transforms.reserve(n);
+	for (uint32_t i = 0; i < n; ++i)
+		transforms.emplace_back(math::Vec3((i % gridSize) * 3.0f, -10.0f, (i / gridSize) * 3.0f), math::Vec3(), math::Vec3(0.5f));
+
+	Clock::time_point start = Clock::now();
+	for (const math::Transformation& transform : transforms)
+		sceneInspector.AddInstance("Benchmark_Single", model, materials, InstanceData(transform));
+	std::chrono::duration<double, std::milli> single = Clock::now() - start;
+
+	for (math::Transformation& transform : transforms)
+		transform.translation.y -= 10.0f;
+
+	start = Clock::now();
+	sceneInspector.AddInstances("Benchmark_Bulk", model, materials, viewOf(transforms.data(), transforms.size()));
+	std::chrono::duration<double, std::milli> bulk = Clock::now() - start;
+
+	ENGI_LOG_INFO("Spawning {} instances one by one took {:.3f} ms, in bulk {:.3f} ms", n, single.count(), bulk.count());
+}
+
 void engi::Main(char* cmdline, int32_t cmdshow)
 {
 	// TestFibonacciPointDistribution(300);
+	// BenchmarkJobSystem();
+	// BenchmarkParallelPrimitives(1u << 22);
+	// BenchmarkMeshBVH();
+	// BenchmarkRayKernels();
+	// BenchmarkMeshCache();
+	// TestInstanceUploads();
+	// TestAsyncModelLoading();
+	// TestParallelImport();
+	// TestShaderBytecodeCache();
+	// TestGpuStateCache();
+	// TestGpuInstancePacking();
+	// TestDrawConstants();
+	// TestIdleFrames();
+	// TestOffsetAllocator();
+	// TestGeometryPool();
+	// TestInstanceMobility();
+	// TestInstanceGroups();
+	// TestFrustumCulling();
+	// TestTinyTriangles();
 
 	Application& app = Application::get();
 	app.init(WindowSpecs("DX11 Engi Window", 800, 600));
@@ -49,6 +100,9 @@ void engi::Main(char* cmdline, int32_t cmdshow)
 	sceneInspector.AddInstance("Sphere_Rust", Sphere_Rust->model, Sphere_Rust->materials, InstanceData(math::Transformation(math::Vec3(6.0f, 0.0f, 0.0f))));
 	sceneInspector.AddInstance("Sphere_Scratched", Sphere_Scratched->model, Sphere_Scratched->materials, InstanceData(math::Transformation(math::Vec3(9.0f, 0.0f, 0.0f))));
 
+	// BenchmarkInstanceSpawning(sceneInspector, Sphere_Gold->model, Sphere_Gold->materials, 10000);
+	// BenchmarkInstanceSpawning(sceneInspector, Sphere_Gold->model, Sphere_Gold->materials, 100000);
+
 	// uint32_t numKnights = 2;
 	// for (uint32_t x = 0; x < numKnights; ++x)
 	// {